@@ -9,6 +9,12 @@ check_symbol_exists(__SSE__ xmmintrin.h HAVE_MSSE)
 check_symbol_exists(__SSE2__ emmintrin.h HAVE_MSSE2)
 check_symbol_exists(__SSE3__ pmmintrin.h HAVE_MSSE3)
 check_symbol_exists(__AVX2__ immintrin.h HAVE_MAVX2)
+# The above tell what the default flags enable.  These tell whether single
+# sources can be built for an instruction set chosen at run time.
+if(NOT MSVC)
+  check_cxx_compiler_flag(-msse2 HAVE_FLAG_MSSE2)
+  check_cxx_compiler_flag(-mavx2 HAVE_FLAG_MAVX2)
+endif()
 check_symbol_exists(__ARM_NEON__ arm_neon.h HAVE_ARM_NEON)
 if(HAVE_ARM_NEON)
   check_cxx_compiler_flag(-mfpu=neon HAVE_MFPU_NEON)
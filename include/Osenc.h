@@ -357,6 +357,44 @@ private:
   bool m_ok;
 };
 
+//--------------------------------------------------------------------------
+//      Osenc_instreamMapped definition
+//      Maps the whole SENC file into memory, so that records can be parsed
+//      in place instead of being read and copied one at a time.
+//      Falls back to a single read into memory if the file cannot be mapped.
+//      The file keeps the oSENC 200 layout: S57Obj, PolyTessGeo and the
+//      edge tables own copies of their data, so aligned, offset indexed
+//      records to use in place would not spare those copies.
+//--------------------------------------------------------------------------
+class Osenc_instreamMapped : public Osenc_instream {
+public:
+  Osenc_instreamMapped();
+  ~Osenc_instreamMapped();
+
+  bool Open(const wxString &senc_file_name);
+  void Close();
+
+  Osenc_instream &Read(void *buffer, size_t size);
+  bool IsOk();
+  bool isAvailable();
+  void Shutdown();
+
+  //  Return the next size bytes in place and step over them, NULL at EOF
+  const unsigned char *Consume(size_t size);
+
+private:
+  void Init();
+
+  const unsigned char *m_data;
+  size_t m_size;
+  size_t m_pos;
+  bool m_mapped;  // m_data is a file mapping, else a heap copy
+#ifdef __WXMSW__
+  void *m_hMapping;
+#endif
+  bool m_ok;
+};
+
 //--------------------------------------------------------------------------
 //      Osenc_outstream definition
 //--------------------------------------------------------------------------
@@ -416,6 +454,8 @@ public:
 
   //  SENC creation, by Version desired...
   void SetLODMeters(double meters) { m_LOD_meters = meters; }
+  //  Number of threads tessellating area features during createSenc200()
+  void SetTessThreads(int n) { m_tess_threads = n; }
   void setRegistrar(S57ClassRegistrar *registrar) { m_poRegistrar = registrar; }
   void setRefLocn(double lat, double lon) {
     m_ref_lat = lat;
@@ -423,6 +463,8 @@ public:
   }
   void setOutstream(Osenc_outstream *stream) { m_pauxOutstream = stream; }
   void setInstream(Osenc_instream *stream) { m_pauxInstream = stream; }
+  //  Storage for the ingested objects, NULL for the heap
+  void setArena(ChartArena *arena) { m_arena = arena; }
 
   wxString getUpdateDate() { return m_LastUpdateDate; }
   wxString getBaseDate() { return m_sdate000; }
@@ -487,6 +529,8 @@ private:
 
   bool CreateSENCRecord200(OGRFeature *pFeature, Osenc_outstream *stream,
                            int mode, S57Reader *poReader);
+  bool CreateSENCRecordBatch200(std::vector<OGRFeature *> &batch,
+                                Osenc_outstream *stream, S57Reader *poReader);
   bool WriteFIDRecord200(Osenc_outstream *stream, int nOBJL, int featureID,
                          int prim);
   bool WriteHeaderRecord200(Osenc_outstream *stream, int recordType,
@@ -509,6 +553,8 @@ private:
 
   PolyTessGeo *BuildPolyTessGeo(_OSENC_AreaGeometry_Record_Payload *record,
                                 unsigned char **bytes_consumed);
+  unsigned char *getRecordPayload(Osenc_instreamMapped &stream, size_t length);
+  void *allocIndexTable(size_t size);
   bool CalculateExtent(S57Reader *poReader, S57ClassRegistrar *poRegistrar);
 
   wxString errorMessage;
@@ -541,6 +587,8 @@ private:
       m_ref_lon;  // Common reference point, derived from FullExtent
   std::unordered_map<int, int> m_vector_helper_hash;
   double m_LOD_meters;
+  int m_tess_threads;
+  PolyTessGeo *m_pretess;  // Area tessellated ahead of its feature record
   S57ClassRegistrar *m_poRegistrar;
   wxArrayString m_tmpup_array;
 
@@ -573,6 +621,7 @@ private:
 
   Osenc_outstream *m_pauxOutstream;
   Osenc_instream *m_pauxInstream;
+  ChartArena *m_arena;
 
   Osenc_outstream *m_pOutstream;
   Osenc_instream *m_pInstream;
@@ -25,7 +25,10 @@
 #ifndef __QUIT_H__
 #define __QUIT_H__
 
+#include <map>
+
 #include "LLRegion.h"
+#include "LLRTree.h"
 #include "OCPNRegion.h"
 #include "chcanv.h"
 #include "viewport.h"
@@ -130,6 +133,7 @@ public:
     m_bcomposed = false;
     m_vp_quilt.Invalidate();
     m_zout_dbindex = -1;
+    InvalidateCache();
 
     //  Quilting of skewed raster charts is allowed for OpenGL only
     m_bquiltskew = g_bopengl;
@@ -191,7 +195,12 @@ public:
   bool DoesQuiltContainPlugins(void);
 
   LLRegion GetHiliteRegion();
-  static LLRegion GetChartQuiltRegion(const ChartTableEntry &cte, ViewPort &vp);
+  static LLRegion GetChartQuiltRegion(const ChartTableEntry &cte,
+                                      ViewPort &vp) {
+    return GetChartQuiltRegion(cte, vp.GetBBox());
+  }
+  static LLRegion GetChartQuiltRegion(const ChartTableEntry &cte,
+                                      const LLBBox &box);
 
   int GetNomScaleMin(int scale, ChartTypeEnum type, ChartFamilyEnum family);
   int GetNomScaleMax(int scale, ChartTypeEnum type, ChartFamilyEnum family);
@@ -215,6 +224,11 @@ private:
 
   bool IsChartS57Overlay(int db_index);
 
+  void InvalidateCache();
+  void BuildChartIndex(int reference_family, int quilt_proj);
+  void SearchChartIndex(const LLBBox &box, std::vector<int> &ids);
+  bool IsChartRegionInBox(int db_index, const LLBBox &box);
+
   LLRegion m_covered_region;
   OCPNRegion m_rendered_region;  // used only in dc mode
 
@@ -259,6 +273,31 @@ private:
   bool m_bquiltanyproj;
   ChartFamilyEnum m_preferred_family;
   ChartCanvas *m_parent;
+
+  //  What stays the same while panning at one scale over the same charts,
+  //  so that Compose() only clips it to each new viewport.
+
+  //  The charts a quilt of the reference family and projection may use,
+  //  by their boxes, and the settings they were picked with
+  LLRTree m_chart_index;
+  std::vector<int> m_chart_ids;
+  ChartDB *m_index_db;
+  int m_index_entries;
+  int m_index_group;
+  int m_index_family;
+  int m_index_proj;
+  bool m_index_anyproj;
+  bool m_index_skew;
+
+  //  Chart quilt regions clipped to a box around the viewport, computed
+  //  as charts come near it
+  LLBBox m_region_extent;
+  std::map<int, LLRegion> m_chart_regions;
+
+  //  The patch regions before clipping to the viewport, and the region
+  //  they cover, for the patches listed in m_patch_key
+  std::vector<int> m_patch_key;
+  std::vector<LLRegion> m_patch_regions;
 };
 
 #endif
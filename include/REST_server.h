@@ -29,6 +29,7 @@
 #include <string>
 #include <unordered_map>
 #include <fstream>
+#include <mutex>
 
 #include <wx/event.h>
 
@@ -78,6 +79,9 @@ public:
   void SetThreadRunFlag(int run) { m_Thread_run_flag = run; }
 
   std::string GetCertificateDirectory(){ return m_certificate_directory; }
+
+  /** True if key was issued to source.  May be called from any thread. */
+  bool IsApiKeyValid(const std::string& source, const std::string& key);
   int m_Thread_run_flag;
 
   std::string m_cert_file;
@@ -91,6 +95,7 @@ private:
   bool m_bsec_thread_active;
   std::string m_certificate_directory;
   std::unordered_map<std::string, std::string> m_key_map;
+  std::mutex m_key_mutex;  // m_key_map is also read by the server thread
   PINCreateDialog *m_PINCreateDialog;
   wxString m_sPIN;
   int m_dPIN;
@@ -0,0 +1,151 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S57 Chart render culling index
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __S57FEATURESTORE_H__
+#define __S57FEATURESTORE_H__
+
+#include <cstddef>
+#include <vector>
+
+#include "s52s57.h"
+
+class LLBBox;
+
+/**
+ * Per frame culling parameters, see S57FeatureStore::MakeCullParms().
+ */
+struct S57CullParms {
+  bool use_box;    // false: no position culling at all
+  float lat_min, lat_max, lon_min, lon_max;  // view box, with margin
+  double chart_scale;  // 0: no SCAMIN culling
+  char display_category;  // 0: no display category culling
+};
+
+/**
+ * The fields of one object the culling looks at, see S57FeatureStore::Add().
+ */
+struct S57FeatureInfo {
+  bool has_box;  // false: never culled by position
+  double lat_min, lat_max, lon_min, lon_max;
+  int scamin;             // 0: no SCAMIN
+  DisCat category;        // display category, as last evaluated
+  bool category_mutable;  // a CS procedure may change the category
+};
+
+/**
+ * The rules of one chart, copied from the razRules[][] lists into arrays
+ * with the fields needed to reject an object laid out contiguously.
+ *
+ * The render passes use ForEach() to walk a list, in list order, and only
+ * touch the ObjRazRules and S57Obj of objects that may be visible.  The
+ * test is conservative: every survivor still goes through the usual
+ * s52plib checks, so the store only saves work on objects that s52plib
+ * would have rejected anyway.
+ *
+ *  - Lines and areas are tested against the view box, grown by a margin
+ *    which covers the symbols and text s52plib adds to their boxes.
+ *    Point boxes are resized by rendering, so points are never culled by
+ *    position.
+ *  - SCAMIN culls objects beyond eight times their SCAMIN, the largest
+ *    zoom modifier allowance, unless their LUP exempts them.
+ *  - Display category culls objects whose category is fixed, for the
+ *    DISPLAYBASE and STANDARD settings only.
+ *
+ * The store goes stale whenever the lists change; the owner calls
+ * Invalidate() and rebuilds it before the next render.
+ */
+class S57FeatureStore {
+public:
+  S57FeatureStore();
+
+  void Build(ObjRazRules *const rules[PRIO_NUM][LUPNAME_NUM]);
+  /** Empty all lists, Build() is Clear() and Add() for every object. */
+  void Clear();
+  /** Append rules, with the fields of its object, to a list. */
+  void Add(int prio, int lup_type, ObjRazRules *rules,
+           const S57FeatureInfo &info);
+  void Invalidate() { m_valid = false; }
+  bool IsValid() const { return m_valid; }
+
+  size_t GetCount(int prio, int lup_type) const {
+    return m_lists[prio][lup_type].rules.size();
+  }
+
+  /**
+   * Culling parameters for the current s52plib state and the view box
+   * vp_box at view_scale_ppm pixels per meter.
+   */
+  static S57CullParms MakeCullParms(const LLBBox &vp_box,
+                                    double view_scale_ppm,
+                                    double chart_scale);
+
+  /** Call f(ObjRazRules *) for each possibly visible object of a list. */
+  template <typename F>
+  void ForEach(int prio, int lup_type, const S57CullParms &cull, F f) const {
+    const FeatureList &list = m_lists[prio][lup_type];
+    const size_t n = list.rules.size();
+    const bool test_box = cull.use_box && list.has_box;
+    for (size_t i = 0; i < n; i++) {
+      if (cull.chart_scale > 0 && list.scamin_limit[i] > 0 &&
+          cull.chart_scale > list.scamin_limit[i])
+        continue;
+      if (cull.display_category && !CategoryVisible(list.category[i], cull))
+        continue;
+      if (test_box && !BoxVisible(list, i, cull)) continue;
+      f(list.rules[i]);
+    }
+  }
+
+private:
+  struct FeatureList {
+    bool has_box;
+    std::vector<float> lat_min, lat_max, lon_min, lon_max;
+    std::vector<float> scamin_limit;  // 0: never culled by SCAMIN
+    std::vector<char> category;       // 0: never culled by category
+    std::vector<ObjRazRules *> rules;
+  };
+
+  static bool CategoryVisible(char category, const S57CullParms &cull) {
+    if (!category || category == DISPLAYBASE) return true;
+    return cull.display_category == STANDARD && category == STANDARD;
+  }
+
+  static bool BoxVisible(const FeatureList &list, size_t i,
+                         const S57CullParms &cull) {
+    if (cull.lat_max < list.lat_min[i] || cull.lat_min > list.lat_max[i])
+      return false;
+    for (float shift = -360.f; shift <= 360.f; shift += 360.f) {
+      if (cull.lon_max >= list.lon_min[i] + shift &&
+          cull.lon_min <= list.lon_max[i] + shift)
+        return true;
+    }
+    return false;
+  }
+
+  FeatureList m_lists[PRIO_NUM][LUPNAME_NUM];
+  bool m_valid;
+};
+
+#endif
@@ -26,8 +26,12 @@
 #ifndef __SENCMGR_H__
 #define __SENCMGR_H__
 
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 
+#include "bbox.h"
+
 // ----------------------------------------------------------------------------
 // Useful Prototypes
 // ----------------------------------------------------------------------------
@@ -73,6 +77,8 @@ public:
   wxString m_SENCFileName;
   double ref_lat, ref_lon;
   double m_LOD_meters;
+  LLBBox m_box;           // Cell extent, for scheduling
+  double m_native_scale;  // Cell compilation scale, for scheduling
 
   SENCBuildThread *m_thread;
 
@@ -114,10 +120,27 @@ public:
   bool IsChartInTicketlist(s57chart *chart);
   bool SetChartPointer(s57chart *chart, void *new_ptr);
   int GetJobCount();
+  void SetViewPriority(const LLBBox &box, double chart_scale);
+
+  //  Called by the pool workers
+  SENCJobTicket *WaitForJob(SENCBuildThread *thread);
+  int GetTessThreads();
+  void WorkerExit();
 
   int m_max_jobs;
 
   std::vector<SENCJobTicket *> ticket_list;
+
+private:
+  SENCJobTicket *PickJob();
+  double JobScore(SENCJobTicket *ticket);
+
+  std::mutex m_mutex;  // Guards the ticket list and everything below
+  std::condition_variable m_job_cond;
+  int m_nworkers;
+  int m_nidle;
+  LLBBox m_view_box;
+  double m_view_scale;
 };
 
 //----------------------------------------------------------------------------
@@ -125,14 +148,13 @@ public:
 //----------------------------------------------------------------------------
 class SENCBuildThread : public wxThread {
 public:
-  SENCBuildThread(SENCJobTicket *ticket, SENCThreadManager *manager);
+  SENCBuildThread(SENCThreadManager *manager);
   void *Entry();
 
-  wxString m_FullPath000;
-  wxString m_SENCFileName;
-  s57chart *m_chart;
   SENCThreadManager *m_manager;
-  SENCJobTicket *m_ticket;
+
+private:
+  void BuildJob(SENCJobTicket *ticket);
 };
 
 #endif
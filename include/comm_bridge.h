@@ -70,6 +70,8 @@ public:
   bool HandleN2K_129026(std::shared_ptr<const Nmea2000Msg> n2k_msg);
   bool HandleN2K_127250(std::shared_ptr<const Nmea2000Msg> n2k_msg);
   bool HandleN2K_129540(std::shared_ptr<const Nmea2000Msg> n2k_msg);
+  bool HandleN2K_128267(std::shared_ptr<const Nmea2000Msg> n2k_msg);
+  bool HandleN2K_130306(std::shared_ptr<const Nmea2000Msg> n2k_msg);
 
   bool HandleN0183_RMC(std::shared_ptr<const Nmea0183Msg> n0183_msg);
   bool HandleN0183_HDT(std::shared_ptr<const Nmea0183Msg> n0183_msg);
@@ -80,6 +82,9 @@ public:
   bool HandleN0183_GGA(std::shared_ptr<const Nmea0183Msg> n0183_msg);
   bool HandleN0183_GLL(std::shared_ptr<const Nmea0183Msg> n0183_msg);
   bool HandleN0183_AIVDO(std::shared_ptr<const Nmea0183Msg> n0183_msg);
+  bool HandleN0183_DPT(std::shared_ptr<const Nmea0183Msg> n0183_msg);
+  bool HandleN0183_DBT(std::shared_ptr<const Nmea0183Msg> n0183_msg);
+  bool HandleN0183_MWV(std::shared_ptr<const Nmea0183Msg> n0183_msg);
 
   bool HandleSignalK(std::shared_ptr<const SignalkMsg> sK_msg);
 
@@ -107,6 +112,8 @@ public:
   ObservableListener listener_N2K_129026;
   ObservableListener listener_N2K_127250;
   ObservableListener listener_N2K_129540;
+  ObservableListener listener_N2K_128267;
+  ObservableListener listener_N2K_130306;
 
   ObservableListener listener_N0183_RMC;
   ObservableListener listener_N0183_HDT;
@@ -117,6 +124,9 @@ public:
   ObservableListener listener_N0183_GGA;
   ObservableListener listener_N0183_GLL;
   ObservableListener listener_N0183_AIVDO;
+  ObservableListener listener_N0183_DPT;
+  ObservableListener listener_N0183_DBT;
+  ObservableListener listener_N0183_MWV;
 
   ObservableListener listener_SignalK;
 
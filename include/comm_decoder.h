@@ -67,6 +67,10 @@ public:
   bool DecodeGSV(std::string s, NavData& temp_data);
   bool DecodeGGA(std::string s, NavData& temp_data);
   bool DecodeGLL(std::string s, NavData& temp_data);
+  // Depth in meters, wind angle in degrees and speed in knots.
+  bool DecodeDPT(std::string s, double& depth);
+  bool DecodeDBT(std::string s, double& depth);
+  bool DecodeMWV(std::string s, double& angle, double& speed, bool& is_true);
 
   bool ParsePosition(const LATLONG& Position, double& lat, double& lon);
 
@@ -78,6 +82,9 @@ public:
   bool DecodePGN129029(std::vector<unsigned char> v,  NavData& temp_data);
   bool DecodePGN127250(std::vector<unsigned char> v,  NavData& temp_data);
   bool DecodePGN129540(std::vector<unsigned char> v,  NavData& temp_data);
+  bool DecodePGN128267(std::vector<unsigned char> v, double& depth);
+  bool DecodePGN130306(std::vector<unsigned char> v, double& angle,
+                       double& speed, bool& is_true);
 
   // SignalK
   bool DecodeSignalK(std::string s, NavData& temp_data);
@@ -32,6 +32,7 @@
 
 extern bool g_bGarminHostUpload;
 extern bool g_bWplUsePosition;
+extern bool g_bNavHistory;
 
 extern double g_UserVar;
 
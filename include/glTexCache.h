@@ -29,6 +29,8 @@
 #include <wx/ffile.h>
 #include <wx/timer.h>
 #include <stdint.h>
+#include <memory>
+#include <vector>
 
 #include "ocpn_types.h"
 #include "color_types.h"
@@ -36,8 +38,11 @@
 #include "viewport.h"
 
 class glTextureDescriptor;
+class glTexCacheMap;
+class glTexPrefetch;
+struct glTexDecodeJob;
 
-#define COMPRESSED_CACHE_MAGIC 0xf013  // change this when the format changes
+#define COMPRESSED_CACHE_MAGIC 0xf014  // change this when the format changes
 
 #define FACTORY_TIMER 10000
 
@@ -47,14 +52,18 @@ void HalfScaleChartBits(int width, int height, unsigned char *source,
 class ChartBaseBSB;
 class ChartPlugInWrapper;
 
+//  A cache is two files, both starting with this header.  The tile file
+//  only ever grows by the compressed tiles appended to it, and the index
+//  file (the same path with ".idx" added) by a catalog entry for each tile
+//  once the tile is written.  Anything cut short by a crash is found by the
+//  checksums and built again.
 struct CompressedCacheHeader {
   uint32_t magic;
   uint32_t format;
   uint32_t chartdate;
-  uint32_t m_nentries;
-  uint32_t catalog_offset;
   uint32_t chartfile_date;
   uint32_t chartfile_size;
+  uint32_t serial;  // changed when the cache is rewritten
 };
 
 struct CatalogEntryKey {
@@ -67,9 +76,10 @@ struct CatalogEntryKey {
 struct CatalogEntryValue {
   int texture_offset;
   uint32_t compressed_size;
+  uint32_t checksum;  // of the compressed data
 };
 
-#define CATALOG_ENTRY_SERIAL_SIZE 6 * sizeof(uint32_t)
+#define CATALOG_ENTRY_SERIAL_SIZE 8 * sizeof(uint32_t)
 
 class CatalogEntry {
 public:
@@ -78,7 +88,7 @@ public:
   CatalogEntry(int level, int x0, int y0, ColorScheme colorscheme);
   int GetSerialSize();
   void Serialize(unsigned char *);
-  void DeSerialize(unsigned char *);
+  bool DeSerialize(unsigned char *);
   CatalogEntryKey k;
   CatalogEntryValue v;
 };
@@ -141,6 +151,21 @@ public:
   glTextureDescriptor *GetpTD(wxRect &rect);
 
   void PrepareTiles(const ViewPort &vp, bool use_norm_vp, ChartBase *pChart);
+
+  /**
+   * Rewrite the cache files with only the tiles still in use, if at least
+   * a quarter of the tile file is tiles replaced or lost in a crash.
+   */
+  bool CompactCache();
+
+  /**
+   * Start decompressing, in the background, the cached tiles the next
+   * frames are expected to need: those in view first, then those ahead of
+   * the pan and, while zooming, the next mipmap level.  GetTextureLevel()
+   * then only picks up the decompressed buffers.
+   */
+  void PrefetchTiles(const ViewPort &vp, const LLBBox &box, int base_level,
+                     ColorScheme color_scheme);
   glTexTile **GetTiles(int &num) {
     num = m_ntex;
     return m_tiles;
@@ -150,7 +175,12 @@ public:
 private:
   bool LoadCatalog(void);
   bool LoadHeader(void);
-  bool WriteCatalogAndHeader();
+  bool CreateCache();
+  bool AppendIndex();
+  bool RewriteIndex();
+  bool WriteIndex(wxFFile &file, const CompressedCacheHeader &hdr);
+  void MakeHeader(CompressedCacheHeader &hdr, uint32_t serial) const;
+  void ClearCatalog();
 
   bool UpdateCachePrecomp(unsigned char *data, int data_size,
                           const wxRect &rect, int level,
@@ -168,6 +198,13 @@ private:
   }
   void ArrayXY(wxRect *r, int index) const;
 
+  const unsigned char *GetCacheData(const CatalogEntryValue *p);
+  const unsigned char *GetCheckedCacheData(const CatalogEntryValue *p,
+                                           std::vector<unsigned char> &buf);
+  void DropCacheEntry(CatalogEntryValue *p);
+  void WantPrefetch(int index, int level, ColorScheme color_scheme,
+                    std::vector<glTexDecodeJob> &jobs);
+
   int n_catalog_entries;
 
   CatalogEntryValue *m_cache[N_COLOR_SCHEMES][MAX_TEX_LEVEL];
@@ -175,15 +212,23 @@ private:
   wxString m_ChartPath;
   wxString m_HashKey;
   wxString m_CompressedCacheFilePath;
+  wxString m_IndexFilePath;
 
-  int m_catalog_offset;
+  wxFileOffset m_data_end;  // where the next tile goes
+  uint32_t m_serial;
+  std::vector<unsigned char> m_index_pending;  // entries not written yet
   bool m_hdrOK;
   bool m_catalogOK;
   bool m_newCatalog;
 
   bool m_catalogCorrupted;
 
-  wxFFile *m_fs;
+  wxFFile *m_fs;        // the tiles
+  wxFFile *m_index_fs;  // their catalog
+  std::shared_ptr<glTexCacheMap> m_map;  // the cache file, for reading
+  bool m_map_failed;
+  std::shared_ptr<glTexPrefetch> m_prefetch;
+  double m_prefetch_lat, m_prefetch_lon, m_prefetch_ppm;  // last view
   uint32_t m_chart_date_binary;
   uint32_t m_chartfile_date_binary;
   uint32_t m_chartfile_size;
@@ -48,6 +48,12 @@
 #define GPU_TEXTURE_UNCOMPRESSED 1
 #define GPU_TEXTURE_COMPRESSED 2
 
+//  Compressed texture tiles come and go at a high rate while panning, so
+//  their buffers are recycled instead of going back to the heap each time.
+//  comp_array buffers must come from, and go back to, these.
+unsigned char *AllocCompTile(size_t size);
+void FreeCompTile(unsigned char *tile);
+
 class glTexFactory;
 class glTextureDescriptor {
 public:
@@ -0,0 +1,103 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Split GPX files into objects without loading the document
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __GPX_STREAM_READER_H__
+#define __GPX_STREAM_READER_H__
+
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+/**
+ * Splits a GPX document, fed in arbitrary pieces, into small XML fragments
+ * which can each be parsed on their own, so a file of any size is read
+ * with memory for one fragment:
+ *
+ *  - every child of the gpx root except trk, e.g. wpt or rte, whole;
+ *  - for a trk, its trkpt elements in batches of at most batch_size,
+ *    wrapped in a trkseg element, and after the last one the trk element
+ *    itself with everything but its trkseg children.
+ *
+ * This is only a tokenizer: it tracks element nesting, skipping comments,
+ * processing instructions and the DOCTYPE, and passes CDATA sections and
+ * entities through.  Well formedness is checked only as far as nesting;
+ * fragments are expected to go to an XML parser.
+ */
+class GpxStreamReader {
+public:
+  struct Handler {
+    /** The gpx root element, e.g. for its creator attribute. */
+    std::function<void(const std::string &xml)> on_root;
+    /** A complete top level object other than a track. */
+    std::function<void(const std::string &xml)> on_object;
+    /** A trk starts. */
+    std::function<void()> on_track_begin;
+    /**
+     * A batch of trkpt elements of segment number segment, counting from 1
+     * in each track.  A segment without points sends one empty batch.
+     */
+    std::function<void(const std::string &xml, int segment)> on_points;
+    /** The trk ends, xml holds it without its trkseg elements. */
+    std::function<void(const std::string &xml, int n_segments)> on_track_end;
+  };
+
+  GpxStreamReader(const Handler &handler, size_t batch_size = 4096);
+
+  /** Feed the next piece of the file, false on a nesting error. */
+  bool Feed(const char *data, size_t size);
+  /** After the last piece: false unless the document was complete. */
+  bool Finish();
+
+  /** Read a whole file through Feed(), false on read or nesting errors. */
+  bool ReadFile(const std::string &path);
+  /** Likewise from an open file, to the end, which is left open. */
+  bool Read(FILE *f);
+
+private:
+  bool ProcessTag(const char *tag, size_t size);
+  void Append(const char *data, size_t size);
+  void FlushPoints();
+
+  Handler m_handler;
+  size_t m_batch_size;
+
+  std::string m_pending;  // unprocessed input, at most one partial tag
+  int m_depth;
+  bool m_error;
+  bool m_done;
+
+  bool m_in_track;
+  bool m_in_segment;
+  int m_segment;
+  size_t m_n_points;
+  bool m_segment_sent;
+
+  std::string m_object;  // the object being collected
+  std::string m_header;  // the trk without its segments
+  std::string m_points;  // the current batch, a trkseg element
+};
+
+#endif
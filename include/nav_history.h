@@ -0,0 +1,148 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Own ship and sensor history database
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef _NAV_HISTORY_H
+#define _NAV_HISTORY_H
+
+#include <time.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SQLite {
+class Database;
+}
+
+/** One value of a history series. */
+struct NavHistorySample {
+  time_t time;
+  double value;
+};
+
+/**
+ * Own ship and sensor data kept in a SQLite database, so speed, heading,
+ * depth and wind can be looked at over whole passages.
+ *
+ * Samples are queued by Add(), which never waits for the database, and
+ * written in batches by a background thread.  Each series is stored in
+ * chunks of samples, times and values delta encoded apart.  Samples older
+ * than a week are replaced by their means per minute, and those older than
+ * half a year by their means per 15 minutes.
+ *
+ * Query() may be called from any thread, which keeps a connection of its
+ * own to the database.  It sees the samples written, at most kFlushSeconds
+ * behind.
+ */
+class NavHistory {
+public:
+  enum class Series {
+    Lat,    // degrees
+    Lon,    // degrees
+    Sog,    // knots
+    Cog,    // degrees true
+    Hdt,    // degrees true
+    Depth,  // meters below the surface, or the transducer if unknown
+    Aws,    // apparent wind speed, knots
+    Awa,    // apparent wind angle, degrees from the bow clockwise
+    Tws,    // true wind speed, knots
+    Twa,    // true wind angle, degrees from the bow clockwise
+    Count
+  };
+
+  static const int kFlushSeconds = 10;
+
+  static NavHistory& GetInstance();
+
+  /** Open or create the database at path and start recording. */
+  bool Start(const std::string& path);
+
+  /** Write all pending samples and stop recording. */
+  void Stop();
+
+  bool IsRunning() const { return m_running; }
+
+  /** Queue a sample.  Only the first sample in each second is kept. */
+  void Add(Series series, time_t time, double value);
+
+  /** Write all pending samples and apply the retention policy now. */
+  void Flush();
+
+  /** Names of the series, as used by Query(). */
+  static std::vector<std::string> GetSeriesNames();
+
+  /** Decimals the values of series are stored with, -1 if no such series. */
+  static int GetSeriesDecimals(const std::string& name);
+
+  /**
+   * Samples of series in the time range [from, to], oldest first.  When
+   * step > 0 they are averaged over step seconds.  Empty if the series is
+   * unknown or nothing was recorded.
+   */
+  std::vector<NavHistorySample> Query(const std::string& series, time_t from,
+                                      time_t to, int step = 0);
+
+private:
+  struct Pending {
+    Series series;
+    time_t time;
+    double value;
+  };
+  struct OpenChunk {
+    long long id;  // row, 0 if not written yet
+    std::vector<NavHistorySample> samples;
+  };
+
+  NavHistory();
+  ~NavHistory();
+  NavHistory(const NavHistory&) = delete;
+  NavHistory& operator=(const NavHistory&) = delete;
+
+  void Worker();
+  void Write(const std::vector<Pending>& pending);
+  void WriteChunk(int series, int tier, OpenChunk& chunk);
+  void Compact(time_t now);
+
+  std::string m_path;
+  int m_generation;  // of m_path, one more on each Start()
+  std::unique_ptr<SQLite::Database> m_db;  // of the worker
+  std::vector<OpenChunk> m_open;           // per series, of the worker
+  time_t m_last_compact;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::vector<Pending> m_pending;
+  std::vector<time_t> m_last_time;  // per series, of the samples queued
+  std::thread m_thread;
+  std::atomic<bool> m_running;
+  bool m_stop;
+  int m_flush_request;
+  int m_flush_done;
+};
+
+#endif  // _NAV_HISTORY_H
@@ -25,6 +25,8 @@
 #ifndef _NAVOBJECTCOLLECTION_H__
 #define _NAVOBJECTCOLLECTION_H__
 
+#include <cstdio>
+#include <ctime>
 #include <memory>
 #include <vector>
 
@@ -111,6 +113,13 @@ public:
   bool CreateAllGPXObjects();
   bool LoadAllGPXObjects(bool b_full_viz, int &wpt_duplicates,
                          bool b_compute_bbox = false);
+  /**
+   * Import the GPX file at path like load_file() and LoadAllGPXObjects()
+   * would, without loading the document: objects are read one at a time,
+   * track points in batches parsed on worker threads.  Names and objects
+   * are made visible unless OpenCPN created the file.
+   */
+  bool LoadGPXStream(const wxString &path, int &wpt_duplicates);
   int LoadAllGPXObjectsAsLayer(int layer_id, bool b_layerviz,
                                wxCheckBoxState b_namesviz);
 
@@ -122,6 +131,10 @@ public:
 
   LLBBox BBox;
   bool m_bSkipChangeSetUpdate;
+
+private:
+  void LoadGPXObject(pugi::xml_node object, bool b_full_viz,
+                     int &wpt_duplicates, bool b_compute_bbox);
 };
 
 class NavObjectChanges : public NavObjectCollection1 {
@@ -138,10 +151,18 @@ public:
     return instance;
   }
 
-  void Init(const wxString& path) {
-      m_filename = path;
-      m_changes_file = fopen(m_filename.mb_str(), "a");
-  }
+  /** Open the journal file at path for appending changes. */
+  void Init(const wxString& path);
+  /** Write any track points still waiting for their group commit. */
+  void Flush();
+  void Close();
+  /**
+   * Move the journal to old_path and start an empty one, for a compaction
+   * of everything up to here into navobj.xml.
+   */
+  bool Rotate(const wxString& old_path);
+  /** Bytes in the journal file. */
+  long GetJournalSize() { return m_journal_size; }
 
   NavObjectChanges(const NavObjectChanges&) = delete;
   void operator=(const NavObjectChanges&) = delete;
@@ -185,12 +206,22 @@ private:
   NavObjectChanges() : NavObjectCollection1() {
     m_changes_file = 0;
     m_bdirty = false;
+    m_bpending = false;
+    m_journal_size = 0;
+    m_last_flush = 0;
   }
   NavObjectChanges(wxString file_name);
 
+  void WriteChange(pugi::xml_node object, bool flush_now);
+
+  static const int kJournalFlushSeconds = 5;
+
   wxString m_filename;
   FILE *m_changes_file;
   bool m_bdirty;
+  bool m_bpending;  // written, not yet flushed
+  long m_journal_size;
+  time_t m_last_flush;
 };
 
 #endif  // _NAVOBJECTCOLLECTION_H__
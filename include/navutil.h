@@ -26,6 +26,9 @@
 #ifndef __NAVUTIL__
 #define __NAVUTIL__
 
+#include <atomic>
+#include <thread>
+
 #include <wx/config.h>
 #include <wx/confbase.h>
 #include <wx/fileconf.h>
@@ -173,6 +176,12 @@ public:
   virtual void UpdateSettings();
   virtual void UpdateNavObj(bool bRecreate = false);
   virtual bool IsChangesFileDirty();
+  /**
+   * Periodic upkeep of the navobj.xml.changes journal: commit pending
+   * track points, and once the journal has grown large, compact it into
+   * navobj.xml on a background thread.
+   */
+  void CheckNavObjJournal();
 
   bool LoadLayers(wxString &path);
   int LoadMyConfigRaw(bool bAsTemplate = false);
@@ -184,6 +193,13 @@ public:
 
   NavObjectChanges *m_pNavObjectChangesSet;
   NavObjectCollection1 *m_pNavObjectInputSet;
+
+private:
+  void WaitNavObjCompaction();
+
+  wxString m_sNavObjSetOldChangesFile;  // journal being compacted
+  std::thread m_compact_thread;
+  std::atomic<bool> m_compact_running;
 };
 
 void SwitchInlandEcdisMode(bool Switch);
@@ -1679,6 +1679,35 @@ extern DECL_EXP std::string GetN2000Source(NMEA2000Id id, ObservedEvt ev);
 /** Return payload in a received n0183 message of type id in ev. */
 extern DECL_EXP std::string GetN0183Payload(NMEA0183Id id, ObservedEvt ev);
 
+/*  Parsed message access
+ *
+ *  The functions below return messages already parsed, as immutable
+ *  shared objects.  A message is parsed once however many plugins listen
+ *  to it, and the result is shared by all of them; nothing is copied per
+ *  plugin.  Keep the returned pointer for as long as the data is needed.
+ */
+
+class wxJSONValue;
+
+/**
+ * Fields of a received n0183 message of type id in ev: the address field
+ * without its leading '$' or '!' (for example "GPGGA"), then the data
+ * fields, without the checksum.
+ */
+extern DECL_EXP std::shared_ptr<const std::vector<std::string>> GetN0183Fields(
+    NMEA0183Id id, ObservedEvt ev);
+
+/** Payload of a received n2000 message of type id in ev, not copied. */
+extern DECL_EXP std::shared_ptr<const std::vector<uint8_t>>
+GetN2000PayloadPtr(NMEA2000Id id, ObservedEvt ev);
+
+/**
+ * Document of a received Signal K message in ev, or an empty pointer if
+ * the message is not valid JSON.
+ */
+extern DECL_EXP std::shared_ptr<const wxJSONValue> GetSignalkDocument(
+    SignalkId id, ObservedEvt ev);
+
 /** Facade for BasicNavDataMsg. */
 struct NavDataId {
   const int type;
@@ -1702,6 +1731,35 @@ struct PluginNavdata {
 /** Return BasicNavDataMsg decoded data available in ev */
 extern DECL_EXP PluginNavdata GetEventNavdata(ObservedEvt ev);
 
+/*  Nav history
+ *
+ *  Own ship and sensor data is kept in a database over whole passages.
+ *  Samples older than a week are kept as means per minute, and those older
+ *  than half a year as means per 15 minutes.
+ */
+
+/** One value of a nav history series. */
+struct PluginNavHistorySample {
+  time_t time;
+  double value;
+};
+
+/**
+ * Names of the recorded series: "lat", "lon" (degrees), "sog" (knots),
+ * "cog", "hdt" (degrees true), "depth" (meters), "aws", "tws" (knots),
+ * "awa", "twa" (degrees from the bow).
+ */
+extern DECL_EXP std::vector<std::string> GetNavHistorySeries();
+
+/**
+ * Samples of series between from and to, oldest first, averaged over step
+ * seconds if step > 0.  Empty if the series is unknown or history is not
+ * recorded.  The database is read in the calling thread; avoid asking for
+ * long ranges without a step from the GUI thread.
+ */
+extern DECL_EXP std::vector<PluginNavHistorySample> GetNavHistory(
+    const std::string &series, time_t from, time_t to, int step = 0);
+
 /* Plugin API supporting direct access to comm drivers for output purposes
  *
  * Plugins may access comm ports for direct output.
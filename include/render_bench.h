@@ -0,0 +1,122 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Offscreen S57/S52 DC rendering benchmark
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef _RENDER_BENCH_H__
+#define _RENDER_BENCH_H__
+
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+/**
+ * Offscreen benchmark of the S57 chart DC render path, run with
+ * opencpn --render_bench <script>.
+ *
+ * The script is a line oriented text file, '#' starts a comment:
+ *
+ *     cell    <path to .000 cell, relative to the script>
+ *     view    <lat> <lon> <scale denominator> <width> <height> [<rot deg>]
+ *     repeat  <count>
+ *     spans
+ *     reload  <count>
+ *     heap
+ *     store
+ *     bands
+ *     quilt   <count>
+ *
+ * Every cell is loaded, then every view is rendered <count> times into a
+ * wxMemoryDC with no window involved.  The per-phase timings collected
+ * through s57chart::SetRenderStats() are printed as one line per view,
+ * suitable for diffing between builds.
+ *
+ * With "spans", all views are first rendered with the portable area span
+ * fill routines, then with the SIMD ones, to compare the "areas" column
+ * on the same data, typically large DEPARE sets.
+ *
+ * With "reload", every cell is opened again <count> times from its cached
+ * SENC and the mean load time is printed, before the views are rendered.
+ *
+ * With "heap", malloc statistics are printed before the cells are loaded,
+ * once loaded and after they are freed again, with the size of the chart
+ * arenas holding their objects and rules.  Where the C library offers no
+ * statistics, only the arena sizes are printed.
+ *
+ * With "store", all views are also rendered with the feature store culling
+ * turned off, see s57chart::SetUseFeatureStore(), to compare the object
+ * passes with and without it.
+ *
+ * With "bands", all views are also rendered with the area fill limited to
+ * 1, 2 and 4 threads, see s57chart::SetMaxAreaBands(), to see how the
+ * "areas" column scales with the number of bands.
+ *
+ * With "quilt", the region algebra of Quilt::Compose() is run <count>
+ * times per view on the coverage of the cells, largest scale first, and
+ * the mean time per composition is printed.
+ */
+class RenderBench {
+public:
+  struct View {
+    double lat;
+    double lon;
+    double scale;
+    int width;
+    int height;
+    double rotation;
+  };
+
+  RenderBench(const wxString& script);
+
+  /** Parse the script.  On errors, returns false and sets GetError(). */
+  bool Load();
+
+  /** Load cells, render all views and print the report to stdout. */
+  bool Run();
+
+  const std::string& GetError() const { return m_error; }
+  const std::vector<wxString>& GetCells() const { return m_cells; }
+  const std::vector<View>& GetViews() const { return m_views; }
+  int GetRepeat() const { return m_repeat; }
+  bool GetCompareSpans() const { return m_compare_spans; }
+  int GetReload() const { return m_reload; }
+  bool GetHeapStats() const { return m_heap_stats; }
+  bool GetCompareStore() const { return m_compare_store; }
+  bool GetCompareBands() const { return m_compare_bands; }
+  int GetQuilt() const { return m_quilt; }
+
+private:
+  wxString m_script;
+  std::vector<wxString> m_cells;
+  std::vector<View> m_views;
+  int m_repeat;
+  bool m_compare_spans;
+  int m_reload;
+  bool m_heap_stats;
+  bool m_compare_store;
+  bool m_compare_bands;
+  int m_quilt;
+  std::string m_error;
+};
+
+#endif  // _RENDER_BENCH_H__
@@ -61,6 +61,12 @@ const wxColour GpxxColors[] = {
     wxColour(0x00, 0xFF, 0x00), wxColour(0xF0, 0xF0, 0x00),
     wxColour(0x00, 0x00, 0xFF), wxColour(0xFE, 0x00, 0xFE),
     wxColour(0x00, 0xFF, 0xFF), wxColour(0xFF, 0xFF, 0xFF)};
+/**
+ * The colour of a GpxxColorNames entry, looked up in a hash table built
+ * on first use.  An invalid wxColour for unknown names.
+ */
+wxColour GetGpxxColor(const wxString &name);
+
 const int StyleValues[] = {-1,          wxSOLID,      wxDOT,
                            wxLONG_DASH, wxSHORT_DASH, wxDOT_DASH};
 const int WidthValues[] = {-1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
@@ -48,6 +48,9 @@
 #include "ocpndc.h"
 #include "viewport.h"
 #include "SencManager.h"
+#include "ChartArena.h"
+#include "LLRTree.h"
+#include "S57FeatureStore.h"
 #include <memory>
 #include "ocpn_plugin.h"
 #include <unordered_map>
@@ -109,6 +112,31 @@ WX_DECLARE_OBJARRAY(S57Obj, ArrayOfS57Obj);
 
 WX_DECLARE_LIST(ObjRazRules, ListOfObjRazRules);
 
+//----------------------------------------------------------------------------
+// Per-phase DC render timings, collected while installed with
+// s57chart::SetRenderStats().  All times in milliseconds.
+//----------------------------------------------------------------------------
+struct S57RenderStats {
+  S57RenderStats() { Reset(); }
+  void Reset() {
+    rules_ms = areas_ms = boundaries_ms = lines_ms = symbols_ms = text_ms =
+        0.;
+    n_rects = 0;
+  }
+  double Total() const {
+    return rules_ms + areas_ms + boundaries_ms + lines_ms + symbols_ms +
+           text_ms;
+  }
+
+  double rules_ms;       // LUP and rules rebuild
+  double areas_ms;       // area fills into the private render canvas
+  double boundaries_ms;  // area boundaries
+  double lines_ms;       // line objects
+  double symbols_ms;     // point objects
+  double text_ms;        // text-only pass
+  int n_rects;           // number of rectangles rendered
+};
+
 //----------------------------------------------------------------------------
 // s57 Chart object class
 //----------------------------------------------------------------------------
@@ -213,6 +241,7 @@ public:
 
   void ClearRenderedTextCache();
 
+  const ChartArena &GetArena() const { return m_arena; }
   double GetCalculatedSafetyContour(void) { return m_next_safe_cnt; }
 
   virtual bool RenderRegionViewOnGL(const wxGLContext &glc,
@@ -281,12 +310,32 @@ public:
 
   SENCThreadStatus m_SENCthreadStatus;
 
+  /** Install (or with NULL, remove) the DC render phase timing sink. */
+  static void SetRenderStats(S57RenderStats *stats) { s_render_stats = stats; }
+
+  /** Cull the render passes through the feature store, on by default. */
+  static void SetUseFeatureStore(bool use) { s_use_feature_store = use; }
+
+  /** Fill areas in at most n threads, 8 by default; 1 fills serially. */
+  static void SetMaxAreaBands(int n) { s_max_area_bands = n; }
+
+  /** Make the next render rebuild the rules as on a plib state change. */
+  void InvalidateRules() { m_plib_state_hash = 0; }
+
 protected:
   void AssembleLineGeometry(void);
 
   ObjRazRules *razRules[PRIO_NUM][LUPNAME_NUM];
   double m_next_safe_cnt;
 
+  //  Owns the objects and rules of razRules, see FreeObjectsAndRules()
+  ChartArena m_arena;
+
+  //  Culling index over razRules, rebuilt after the lists change
+  S57FeatureStore m_feature_store;
+  const S57FeatureStore &GetFeatureStore();
+  S57CullParms GetCullParms(const ViewPort &vp);
+
 private:
   int GetLineFeaturePointArray(S57Obj *obj, void **ret_array);
   void SetSafetyContour(void);
@@ -342,6 +391,25 @@ private:
   void CreateChartContext();
   void PopulateObjectsWithContext();
 
+  //  Spatial indices for GetObjRuleListAtLatLon() and
+  //  GetLightsObjRuleListVisibleAtLatLon(), over the razRules lists
+  struct PickEntry {
+    ObjRazRules *rules;
+    int prio;
+    int lup_type;
+    double lat, lon, range;  // sector lights only
+  };
+  void BuildPickIndex();
+  static void SearchPickIndex(const LLRTree &tree, double lat, double lon,
+                              double margin, std::vector<int> &ids);
+
+  LLRTree m_pick_tree;  // line and area objects
+  std::vector<PickEntry> m_pick_entries;
+  std::vector<int> m_pick_unindexed;  // no valid box, always tested
+  LLRTree m_light_tree;  // sector lights, boxes cover their nominal range
+  std::vector<PickEntry> m_light_entries;
+  bool m_pick_index_valid;
+
   // Private Data
   char *hdr_buf;
   char *mybuf_ptr;
@@ -396,6 +464,10 @@ private:
   wxString m_TempFilePath;
   bool m_disableBackgroundSENC;
 
+  static S57RenderStats *s_render_stats;
+  static bool s_use_feature_store;
+  static int s_max_area_bands;
+
 protected:
   sm_parms vp_transform;
 };
@@ -28,8 +28,10 @@
 
 #include <wx/progdlg.h>
 
+#include <cstdint>
 #include <deque>
 #include <list>
+#include <string>
 #include <vector>
 
 #include "bbox.h"
@@ -47,6 +49,12 @@ struct SubTrack {
   double m_scale;
 };
 
+/**
+ * A track point is kept small, since logged tracks run to millions of
+ * them: the time is held as seconds since the epoch, parsed from and
+ * formatted to GPX text only on import and export.  The points themselves
+ * are carved from shared blocks rather than allocated one by one.
+ */
 class TrackPoint {
 public:
   TrackPoint(double lat, double lon, wxString ts = "");
@@ -54,22 +62,23 @@ public:
   TrackPoint(TrackPoint *orig);
   ~TrackPoint();
 
+  static void *operator new(size_t size);
+  static void operator delete(void *p, size_t size);
+
   wxDateTime GetCreateTime(void);
   void SetCreateTime(wxDateTime dt);
-  const char *GetTimeString() { return m_stimestring.c_str(); }
-  bool HasValidTimestamp() {
-    if (m_stimestring.size() != strlen("YYYY-MM-DDTHH:MM:SSZ"))
-      return false;
-    return true;
-  };
+  /** GPX style "YYYY-MM-DDTHH:MM:SSZ" time, empty without a timestamp. */
+  std::string GetTimeString();
+  bool HasValidTimestamp() { return m_time != kNoTime; }
 
   double m_lat, m_lon;
   int m_GPXTrkSegNo;
 
-
 private:
+  static const int64_t kNoTime;
+
   void SetCreateTime(wxString ts);
-  std::string m_stimestring;
+  int64_t m_time;
 };
 
 //----------------------------------------------------------------------------
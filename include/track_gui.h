@@ -26,7 +26,7 @@
 #ifndef _TRACK_GUI_H
 #define _TRACK_GUI_H
 
-#include <list>
+#include <vector>
 
 #include "bbox.h"
 #include "chcanv.h"
@@ -43,28 +43,53 @@ private:
 };
 
 
+/**
+ * The screen polylines of a track, stored flat: all points in one array,
+ * with the index of the first point of each line.  Draw() keeps one of
+ * these for all tracks, so the arrays are only grown, never reallocated
+ * per frame.
+ */
+struct TrackLines {
+  std::vector<wxPoint> points;
+  std::vector<size_t> starts;
+
+  void Clear() {
+    points.clear();
+    starts.clear();
+  }
+  /** Start a new line, unless the current one is still empty. */
+  void NewLine() {
+    if (starts.empty() || starts.back() != points.size())
+      starts.push_back(points.size());
+  }
+  size_t GetCount() const { return starts.size(); }
+  size_t LineSize(size_t i) const {
+    size_t end = i + 1 < starts.size() ? starts[i + 1] : points.size();
+    return end - starts[i];
+  }
+  wxPoint *Line(size_t i) { return &points[starts[i]]; }
+  size_t BackSize() const {
+    return starts.empty() ? 0 : LineSize(starts.size() - 1);
+  }
+};
+
 class TrackGui {
 public:
   TrackGui(Track& track) : m_track(track) {}
   void Draw(ChartCanvas* cc, ocpnDC& dc, ViewPort& VP, const LLBBox& box);
 
 protected:
-  void Segments(ChartCanvas *cc, std::list<std::list<wxPoint> > &pointlists,
-                const LLBBox &box, double scale);
+  void Segments(ChartCanvas *cc, TrackLines &lines, const LLBBox &box,
+                double scale);
 
 private:
   Track& m_track;
-  void GetPointLists(ChartCanvas *cc,
-                     std::list<std::list<wxPoint> > &pointlists, ViewPort &VP,
+  void GetPointLists(ChartCanvas *cc, TrackLines &lines, ViewPort &VP,
                      const LLBBox &box);
   void Finalize();
-  void Assemble(ChartCanvas *cc, std::list<std::list<wxPoint> > &pointlists,
-                const LLBBox &box, double scale, int &last, int level, int pos);
-  void AddPointToList(ChartCanvas *cc,
-                      std::list<std::list<wxPoint> > &pointlists, int n);
-  void AddPointToLists(ChartCanvas *cc,
-                       std::list<std::list<wxPoint> > &pointlists, int &last,
-                       int n);
+  void Assemble(ChartCanvas *cc, TrackLines &lines, const LLBBox &box,
+                double scale, int &last, int level, int pos);
+  void AddPointToList(ChartCanvas *cc, TrackLines &lines, int n);
 
 };
 
@@ -0,0 +1,119 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Static R-tree over Latitude and Longitude boxes
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "LLRTree.h"
+
+//  Children per node
+static const int kNodeSize = 16;
+
+LLRTree::LLRTree() : m_built(false) {}
+
+void LLRTree::Clear() {
+  m_items.clear();
+  m_levels.clear();
+  m_built = false;
+}
+
+void LLRTree::Insert(double minlat, double minlon, double maxlat,
+                     double maxlon, int id) {
+  Node n = {minlat, minlon, maxlat, maxlon, id, 0};
+  m_items.push_back(n);
+  m_built = false;
+}
+
+//  Sort-Tile-Recursive: order the nodes of a level into vertical slices by
+//  longitude, each slice by latitude, and give every run of kNodeSize
+//  nodes one parent.
+void LLRTree::Pack(std::vector<Node> &level, std::vector<Node> &parents) {
+  size_t n = level.size();
+  size_t n_parents = (n + kNodeSize - 1) / kNodeSize;
+  size_t n_slices = (size_t)ceil(sqrt((double)n_parents));
+  size_t slice_size = n_slices * kNodeSize;
+
+  std::sort(level.begin(), level.end(), [](const Node &a, const Node &b) {
+    return a.minlon + a.maxlon < b.minlon + b.maxlon;
+  });
+  for (size_t s = 0; s < n; s += slice_size) {
+    size_t e = std::min(s + slice_size, n);
+    std::sort(level.begin() + s, level.begin() + e,
+              [](const Node &a, const Node &b) {
+                return a.minlat + a.maxlat < b.minlat + b.maxlat;
+              });
+  }
+
+  parents.clear();
+  for (size_t s = 0; s < n; s += kNodeSize) {
+    size_t e = std::min(s + (size_t)kNodeSize, n);
+    Node p = level[s];
+    for (size_t i = s + 1; i < e; i++) {
+      p.minlat = std::min(p.minlat, level[i].minlat);
+      p.minlon = std::min(p.minlon, level[i].minlon);
+      p.maxlat = std::max(p.maxlat, level[i].maxlat);
+      p.maxlon = std::max(p.maxlon, level[i].maxlon);
+    }
+    p.first = (int)s;
+    p.count = (int)(e - s);
+    parents.push_back(p);
+  }
+}
+
+void LLRTree::Build() {
+  m_levels.clear();
+  m_levels.push_back(m_items);
+
+  while (m_levels.back().size() > 1) {
+    std::vector<Node> parents;
+    Pack(m_levels.back(), parents);
+    m_levels.push_back(parents);
+  }
+  m_built = true;
+}
+
+void LLRTree::SearchNode(int level, int index, double minlat, double minlon,
+                         double maxlat, double maxlon,
+                         std::vector<int> &ids) const {
+  const Node &n = m_levels[level][index];
+  if (n.maxlat < minlat || n.minlat > maxlat || n.maxlon < minlon ||
+      n.minlon > maxlon)
+    return;
+
+  if (level == 0) {
+    ids.push_back(n.first);
+    return;
+  }
+  for (int i = n.first; i < n.first + n.count; i++)
+    SearchNode(level - 1, i, minlat, minlon, maxlat, maxlon, ids);
+}
+
+void LLRTree::Search(double minlat, double minlon, double maxlat,
+                     double maxlon, std::vector<int> &ids) const {
+  if (!m_built || m_levels.empty() || m_levels[0].empty()) return;
+  int top = (int)m_levels.size() - 1;
+  for (int i = 0; i < (int)m_levels[top].size(); i++)
+    SearchNode(top, i, minlat, minlon, maxlat, maxlon, ids);
+}
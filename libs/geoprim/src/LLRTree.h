@@ -0,0 +1,78 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Static R-tree over Latitude and Longitude boxes
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __LLRTREE_H__
+#define __LLRTREE_H__
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * R-tree over lat/lon boxes, each carrying an integer id.
+ *
+ * The tree is bulk loaded once: Insert() all boxes, then Build() packs
+ * them with the Sort-Tile-Recursive method.  Search() may then be called
+ * any number of times, Insert() after Build() needs another Build().
+ *
+ * Boxes are plain coordinate ranges, there is no date line handling here.
+ * Callers searching near the date line search again with the longitudes
+ * shifted by 360 degrees, as LLBBox::ContainsMarge() effectively does.
+ */
+class LLRTree {
+public:
+  LLRTree();
+
+  void Clear();
+  void Insert(double minlat, double minlon, double maxlat, double maxlon,
+              int id);
+  void Build();
+
+  bool IsBuilt() const { return m_built; }
+  size_t GetCount() const { return m_items.size(); }
+
+  /**
+   * Append to ids the id of every box intersecting the given one, edges
+   * included, in no particular order.
+   */
+  void Search(double minlat, double minlon, double maxlat, double maxlon,
+              std::vector<int> &ids) const;
+
+private:
+  struct Node {
+    double minlat, minlon, maxlat, maxlon;
+    int first;  // first child in the level below, or the id in level 0
+    int count;  // number of children, 0 in level 0
+  };
+
+  void Pack(std::vector<Node> &level, std::vector<Node> &parents);
+  void SearchNode(int level, int index, double minlat, double minlon,
+                  double maxlat, double maxlon, std::vector<int> &ids) const;
+
+  std::vector<Node> m_items;
+  std::vector<std::vector<Node> > m_levels;  // m_levels[0] is the leaves
+  bool m_built;
+};
+
+#endif
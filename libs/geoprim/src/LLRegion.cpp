@@ -29,24 +29,7 @@
 #include <string.h>
 #include <math.h>
 
-#if defined(__OCPN__ANDROID__)
- //#include <GLES2/gl2.h>
- #include <qopengl.h>
- #include <GL/gl_private.h>  // this is a cut-down version of gl.h
- #include <GLES2/gl2.h>
-#elif defined(__MSVC__)
- #include "glew.h"
- #include <GL/glu.h>
- //typedef void (__stdcall * _GLUfuncptr)(void);
-#elif defined(__WXOSX__)
- #include <OpenGL/gl.h>
- #include <OpenGL/glu.h>
- typedef void (*  _GLUfuncptr)();
- #define GL_COMPRESSED_RGB_FXT1_3DFX       0x86B0
-#elif defined(__WXQT__) || defined(__WXGTK__)
- #include <GL/glew.h>
- #include <GL/glu.h>
-#endif
+#include <vector>
 
 #include "LLRegion.h"
 
@@ -238,77 +221,13 @@ bool LLRegion::Contains(float lat, float lon) const {
   return cnt & 1;
 }
 
-struct work {
-  work(LLRegion &r) : region(r) { tobj = gluNewTess(); }
-
-  ~work() {
-    gluDeleteTess(tobj);
-    for (std::list<double *>::iterator i = data.begin(); i != data.end(); i++)
-      delete[] * i;
-    data.clear();
-  }
-
-  double *NewData() {
-    double *d = new double[3];
-    data.push_back(d);
-    return d;
-  }
-
-  void PutVertex(const contour_pt &j) {
-    double *p = NewData();
-    p[0] = j.x, p[1] = j.y, p[2] = 0;
-    gluTessVertex(tobj, p, p);
-  }
-
-  std::list<double *> data;
-  poly_contour contour;
-  GLUtesselator *tobj;
-  LLRegion &region;
-};
-
-static void /*APIENTRY*/ LLvertexCallback(GLvoid *vertex, void *user_data) {
-  work *w = (work *)user_data;
-  const GLdouble *pointer = (GLdouble *)vertex;
-  contour_pt p;
-  p.x = pointer[0], p.y = pointer[1];
-  w->contour.push_back(p);
-}
-
-static void /*APIENTRY*/ LLbeginCallback(GLenum which) {}
-
-static void /*APIENTRY*/ LLendCallback(void *user_data) {
-  work *w = (work *)user_data;
-  if (w->contour.size()) {
-    w->region.contours.push_back(w->contour);
-    w->contour.clear();
-  }
-}
-
-static void /*APIENTRY*/ LLcombineCallback(GLdouble coords[3],
-                                           GLdouble *vertex_data[4],
-                                           GLfloat weight[4],
-                                           GLdouble **dataOut,
-                                           void *user_data) {
-  work *w = (work *)user_data;
-  GLdouble *vertex = w->NewData();
-  memcpy(vertex, coords, 3 * (sizeof *coords));
-  *dataOut = vertex;
-}
-
-static void /*APIENTRY*/ LLerrorCallback(GLenum errorCode) {
-  const GLubyte *estring;
-  estring = gluErrorString(errorCode);
-  //LOG_INFO("Tessellation Error: %s\n", estring);
-  // exit (0);
-}
-
 void LLRegion::Intersect(const LLRegion &region) {
   if (NoIntersection(region)) {
     Clear();
     return;
   }
 
-  Put(region, GLU_TESS_WINDING_ABS_GEQ_TWO, false);
+  Put(region, PolyClipper::INTERSECTION);
 }
 
 void LLRegion::Union(const LLRegion &region) {
@@ -317,13 +236,13 @@ void LLRegion::Union(const LLRegion &region) {
     return;
   }
 
-  Put(region, GLU_TESS_WINDING_POSITIVE, false);
+  Put(region, PolyClipper::UNION);
 }
 
 void LLRegion::Subtract(const LLRegion &region) {
   if (NoIntersection(region)) return;
 
-  Put(region, GLU_TESS_WINDING_POSITIVE, true);
+  Put(region, PolyClipper::DIFFERENCE);
 }
 
 void LLRegion::Reduce(double factor) {
@@ -452,42 +371,41 @@ bool LLRegion::NoIntersection(const LLRegion &region) const {
          region.NoIntersection(box);
 }
 
-void LLRegion::PutContours(work &w, const LLRegion &region, bool reverse) {
+static void PutContours(PolyClipper &clipper, int polygon,
+                        const LLRegion &region, std::vector<double> &xy) {
   for (std::list<poly_contour>::const_iterator i = region.contours.begin();
        i != region.contours.end(); i++) {
-    gluTessBeginContour(w.tobj);
-    if (reverse)
-      for (poly_contour::const_reverse_iterator j = i->rbegin(); j != i->rend();
-           j++)
-        w.PutVertex(*j);
-    else
-      for (poly_contour::const_iterator j = i->begin(); j != i->end(); j++)
-        w.PutVertex(*j);
-    gluTessEndContour(w.tobj);
+    xy.clear();
+    for (poly_contour::const_iterator j = i->begin(); j != i->end(); j++) {
+      xy.push_back(j->x);
+      xy.push_back(j->y);
+    }
+    clipper.AddContour(polygon, i->size(), xy.data());
   }
 }
 
-void LLRegion::Put(const LLRegion &region, int winding_rule, bool reverse) {
-  work w(*this);
-
-  gluTessCallback(w.tobj, GLU_TESS_VERTEX_DATA, (_GLUfuncptr)&LLvertexCallback);
-  gluTessCallback(w.tobj, GLU_TESS_BEGIN, (_GLUfuncptr)&LLbeginCallback);
-  gluTessCallback(w.tobj, GLU_TESS_COMBINE_DATA,
-                  (_GLUfuncptr)&LLcombineCallback);
-  gluTessCallback(w.tobj, GLU_TESS_END_DATA, (_GLUfuncptr)&LLendCallback);
-  gluTessCallback(w.tobj, GLU_TESS_ERROR, (_GLUfuncptr)&LLerrorCallback);
-  gluTessProperty(w.tobj, GLU_TESS_WINDING_RULE, winding_rule);
-  gluTessProperty(w.tobj, GLU_TESS_BOUNDARY_ONLY, GL_TRUE);
-  //    gluTessProperty(w.tobj, GLU_TESS_TOLERANCE, 1e-5);
+void LLRegion::Put(const LLRegion &region, PolyClipper::Operation op) {
+  // Regions are combined many times for each quilt, keep the clipper and
+  // its memory
+  static thread_local PolyClipper clipper;
+  static thread_local std::vector<double> xy;
+  static thread_local std::vector<size_t> starts;
 
-  gluTessNormal(w.tobj, 0, 0, 1);
+  clipper.Clear();
+  PutContours(clipper, 0, *this, xy);
+  PutContours(clipper, 1, region, xy);
+  clipper.Execute(op, xy, starts);
 
-  gluTessBeginPolygon(w.tobj, &w);
-
-  PutContours(w, *this);
-  PutContours(w, region, reverse);
   contours.clear();
-  gluTessEndPolygon(w.tobj);
+  for (size_t i = 0; i + 1 < starts.size(); i++) {
+    poly_contour c;
+    for (size_t j = starts[i]; j < starts[i + 1]; j++) {
+      contour_pt p;
+      p.x = xy[2 * j], p.y = xy[2 * j + 1];
+      c.push_back(p);
+    }
+    contours.push_back(c);
+  }
 
   Optimize();
   m_box.Invalidate();
@@ -30,6 +30,7 @@
 #include <list>
 
 #include "bbox.h"
+#include "poly_clip.h"
 
 struct contour_pt {
   double y, x;
@@ -42,7 +43,6 @@ struct contour_pt {
 typedef std::list<contour_pt> poly_contour;
 class LLBBox;
 
-struct work;
 class LLRegion {
 public:
   LLRegion() {}
@@ -75,8 +75,7 @@ public:
 private:
   bool NoIntersection(const LLBBox& box) const;
   bool NoIntersection(const LLRegion& region) const;
-  void PutContours(work& w, const LLRegion& region, bool reverse = false);
-  void Put(const LLRegion& region, int winding_rule, bool reverse = false);
+  void Put(const LLRegion& region, PolyClipper::Operation op);
   void Combine(const LLRegion& region);
   void InitBox(float minlat, float minlon, float maxlat, float maxlon);
   void InitPoints(size_t n, const double* points);
@@ -0,0 +1,492 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Boolean operations on polygons
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "poly_clip.h"
+
+//  Points closer than this, relative to the largest coordinate, are the
+//  same point when edges are split.  Well above the rounding error of a
+//  crossing, well below the 6e-6 degrees LLRegion rounds its points to.
+static const double kRelEps = 1e-12;
+
+//  Which coordinates of a point are exact: those of the polygon points,
+//  and those taken from a vertical or horizontal edge it lies on.
+enum { EXACT_X = 1, EXACT_Y = 2, EXACT = EXACT_X | EXACT_Y };
+
+template <typename P>
+static inline bool PointLess(const P &a, const P &b) {
+  return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+template <typename P>
+static inline bool PointEqual(const P &a, const P &b) {
+  return a.x == b.x && a.y == b.y;
+}
+
+template <typename P>
+static inline double Dist2(const P &a, const P &b) {
+  return (b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y);
+}
+
+//  Twice the signed area of a b c, positive when counter clockwise
+template <typename P>
+static inline double Orient(const P &a, const P &b, const P &c) {
+  return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+PolyClipper::PolyClipper() : m_eps(0) {}
+
+void PolyClipper::Clear() { m_edges.clear(); }
+
+void PolyClipper::AddEdge(int polygon, const Point &a, const Point &b) {
+  if (PointEqual(a, b)) return;
+  Edge e = {a, b, polygon};
+  m_edges.push_back(e);
+}
+
+void PolyClipper::AddContour(int polygon, size_t n, const double *xy) {
+  if (n < 3) return;
+  for (size_t i = 0; i < n; i++) {
+    size_t k = i + 1 < n ? i + 1 : 0;
+    Point a = {xy[2 * i], xy[2 * i + 1]}, b = {xy[2 * k], xy[2 * k + 1]};
+    AddEdge(polygon, a, b);
+  }
+}
+
+void PolyClipper::AddContour(int polygon, size_t n, const float *xy) {
+  if (n < 3) return;
+  for (size_t i = 0; i < n; i++) {
+    size_t k = i + 1 < n ? i + 1 : 0;
+    Point a = {xy[2 * i], xy[2 * i + 1]}, b = {xy[2 * k], xy[2 * k + 1]};
+    AddEdge(polygon, a, b);
+  }
+}
+
+//  Record where edges i and j cross, or where an end of one lies on the
+//  other.  Collinear edges overlapping each other get split at each
+//  other's ends, so the overlap becomes equal pieces.
+void PolyClipper::SplitPair(size_t i, size_t j) {
+  const Edge &e = m_edges[i], &f = m_edges[j];
+
+  auto on_edge = [this](size_t k, const Point &p) {
+    const Edge &g = m_edges[k];
+    double len2 = Dist2(g.a, g.b);
+    double d = Orient(g.a, g.b, p);
+    if (d * d > m_eps * m_eps * len2) return false;
+    if (Dist2(p, g.a) <= m_eps * m_eps || Dist2(p, g.b) <= m_eps * m_eps)
+      return true;
+    double t =
+        ((p.x - g.a.x) * (g.b.x - g.a.x) + (p.y - g.a.y) * (g.b.y - g.a.y)) /
+        len2;
+    if (t <= 0 || t >= 1) return false;
+    Split s = {k, t, p, EXACT};
+    m_splits.push_back(s);
+    return true;
+  };
+
+  bool touch = on_edge(j, e.a);
+  touch = on_edge(j, e.b) || touch;
+  touch = on_edge(i, f.a) || touch;
+  touch = on_edge(i, f.b) || touch;
+  if (touch) return;
+
+  double d1 = Orient(f.a, f.b, e.a), d2 = Orient(f.a, f.b, e.b);
+  if ((d1 > 0) == (d2 > 0)) return;
+  double d3 = Orient(e.a, e.b, f.a), d4 = Orient(e.a, e.b, f.b);
+  if ((d3 > 0) == (d4 > 0)) return;
+
+  //  Both pieces get the very same point
+  double t = d1 / (d1 - d2);
+  Point p = {e.a.x + t * (e.b.x - e.a.x), e.a.y + t * (e.b.y - e.a.y)};
+  //  Pieces of vertical and horizontal edges must stay exactly so, the
+  //  sweep tells them apart by comparing coordinates
+  int exact = 0;
+  if (e.a.x == e.b.x)
+    p.x = e.a.x, exact |= EXACT_X;
+  else if (f.a.x == f.b.x)
+    p.x = f.a.x, exact |= EXACT_X;
+  if (e.a.y == e.b.y)
+    p.y = e.a.y, exact |= EXACT_Y;
+  else if (f.a.y == f.b.y)
+    p.y = f.a.y, exact |= EXACT_Y;
+  Split se = {i, t, p, exact}, sf = {j, d3 / (d3 - d4), p, exact};
+  m_splits.push_back(se);
+  m_splits.push_back(sf);
+}
+
+void PolyClipper::SplitEdges() {
+  double max_coord = 0;
+  for (const Edge &e : m_edges)
+    max_coord = std::max(max_coord, std::max(std::max(std::abs(e.a.x),
+                                                      std::abs(e.a.y)),
+                                             std::max(std::abs(e.b.x),
+                                                      std::abs(e.b.y))));
+  m_eps = kRelEps * max_coord;
+
+  m_splits.clear();
+  m_order.resize(m_edges.size());
+  for (size_t i = 0; i < m_order.size(); i++) m_order[i] = i;
+
+  auto min_x = [this](size_t i) {
+    return std::min(m_edges[i].a.x, m_edges[i].b.x);
+  };
+  std::sort(m_order.begin(), m_order.end(),
+            [&](size_t i, size_t j) { return min_x(i) < min_x(j); });
+
+  //  Only edges whose x ranges overlap can meet
+  for (size_t oi = 0; oi < m_order.size(); oi++) {
+    const Edge &e = m_edges[m_order[oi]];
+    double max_x = std::max(e.a.x, e.b.x) + m_eps;
+    double min_y = std::min(e.a.y, e.b.y) - m_eps;
+    double max_y = std::max(e.a.y, e.b.y) + m_eps;
+    for (size_t oj = oi + 1; oj < m_order.size(); oj++) {
+      if (min_x(m_order[oj]) > max_x) break;
+      const Edge &f = m_edges[m_order[oj]];
+      if (std::max(f.a.y, f.b.y) < min_y || std::min(f.a.y, f.b.y) > max_y)
+        continue;
+      SplitPair(m_order[oi], m_order[oj]);
+    }
+  }
+}
+
+void PolyClipper::BuildSegments() {
+  std::sort(m_splits.begin(), m_splits.end(),
+            [](const Split &a, const Split &b) {
+              return a.edge < b.edge || (a.edge == b.edge && a.t < b.t);
+            });
+
+  m_segments.clear();
+  m_snap.clear();
+  auto add = [this](int polygon, const Point &a, int exact_a, const Point &b,
+                    int exact_b) {
+    if (PointEqual(a, b)) return;
+    Segment s = {a, b, {0, 0}, {0, 0}, {0, 0}};
+    s.wind[polygon] = 1;
+    if (PointLess(b, a)) {
+      s.l = b, s.r = a;
+      s.wind[polygon] = -1;
+    }
+    m_segments.push_back(s);
+    SnapPoint sa = {a, exact_a}, sb = {b, exact_b};
+    m_snap.push_back(sa);
+    m_snap.push_back(sb);
+  };
+
+  size_t k = 0;
+  for (size_t i = 0; i < m_edges.size(); i++) {
+    const Edge &e = m_edges[i];
+    Point from = e.a;
+    int exact = EXACT;
+    for (; k < m_splits.size() && m_splits[k].edge == i; k++) {
+      add(e.polygon, from, exact, m_splits[k].p, m_splits[k].exact);
+      from = m_splits[k].p;
+      exact = m_splits[k].exact;
+    }
+    add(e.polygon, from, exact, e.b, EXACT);
+  }
+
+  //  Crossings worked out from different edges may miss each other, or a
+  //  polygon point, by a rounding error; make such points one, so the
+  //  pieces meet again.  The point they become keeps the exact coordinates
+  //  of any of them, so no vertical or horizontal piece gets tilted.
+  std::sort(m_snap.begin(), m_snap.end(),
+            [](const SnapPoint &a, const SnapPoint &b) {
+              return PointLess(a.p, b.p);
+            });
+  m_points.clear();
+  m_exact.clear();
+  for (const SnapPoint &sp : m_snap) {
+    if (!m_points.empty() && PointEqual(m_points.back(), sp.p)) {
+      m_exact.back() |= sp.exact;
+      continue;
+    }
+    m_points.push_back(sp.p);
+    m_exact.push_back(sp.exact);
+  }
+
+  m_cluster.resize(m_points.size());
+  for (size_t i = 0; i < m_points.size(); i++) m_cluster[i] = i;
+  auto find = [this](size_t i) {
+    while (m_cluster[i] != i) i = m_cluster[i] = m_cluster[m_cluster[i]];
+    return i;
+  };
+  for (size_t i = 1; i < m_points.size(); i++) {
+    const Point &p = m_points[i];
+    for (size_t j = i; j-- > 0 && p.x - m_points[j].x <= m_eps;) {
+      if (std::abs(p.y - m_points[j].y) <= m_eps) {
+        size_t ri = find(i), rj = find(j);
+        if (ri != rj) m_cluster[std::max(ri, rj)] = std::min(ri, rj);
+      }
+    }
+  }
+  m_snapped = m_points;
+  for (size_t i = 0; i < m_points.size(); i++) {
+    size_t r = find(i);
+    if (r == i) continue;
+    if ((m_exact[i] & EXACT_X) && !(m_exact[r] & EXACT_X)) {
+      m_snapped[r].x = m_points[i].x;
+      m_exact[r] |= EXACT_X;
+    }
+    if ((m_exact[i] & EXACT_Y) && !(m_exact[r] & EXACT_Y)) {
+      m_snapped[r].y = m_points[i].y;
+      m_exact[r] |= EXACT_Y;
+    }
+  }
+  for (size_t i = 0; i < m_points.size(); i++)
+    m_snapped[i] = m_snapped[find(i)];
+
+  auto snap = [this](Point &p) {
+    p = m_snapped[std::lower_bound(m_points.begin(), m_points.end(), p,
+                                   PointLess<Point>) -
+                  m_points.begin()];
+  };
+  for (Segment &s : m_segments) {
+    snap(s.l);
+    snap(s.r);
+    if (PointLess(s.r, s.l)) {
+      std::swap(s.l, s.r);
+      s.wind[0] = -s.wind[0];
+      s.wind[1] = -s.wind[1];
+    }
+  }
+
+  //  Merge equal pieces, dropping those whose edges cancel out
+  std::sort(m_segments.begin(), m_segments.end(),
+            [](const Segment &a, const Segment &b) {
+              if (!PointEqual(a.l, b.l)) return PointLess(a.l, b.l);
+              return PointLess(a.r, b.r);
+            });
+  size_t n = 0;
+  for (size_t i = 0; i < m_segments.size(); i++) {
+    const Segment &s = m_segments[i];
+    if (PointEqual(s.l, s.r)) continue;
+    if (n > 0 && PointEqual(m_segments[n - 1].l, s.l) &&
+        PointEqual(m_segments[n - 1].r, s.r)) {
+      m_segments[n - 1].wind[0] += s.wind[0];
+      m_segments[n - 1].wind[1] += s.wind[1];
+    } else {
+      if (n > 0 && !m_segments[n - 1].wind[0] && !m_segments[n - 1].wind[1])
+        n--;
+      m_segments[n++] = s;
+    }
+  }
+  if (n > 0 && !m_segments[n - 1].wind[0] && !m_segments[n - 1].wind[1]) n--;
+  m_segments.resize(n);
+}
+
+//  The pieces no longer cross, so between two consecutive x values where
+//  a piece starts or ends they are ordered by y.  The winding numbers just
+//  above a piece are the same along all its length; for a new piece those
+//  below it are the ones above the piece under it.  Left of a vertical
+//  piece they are those above the highest piece passing under its middle.
+void PolyClipper::Sweep() {
+  m_sweep.clear();
+  m_xs.clear();
+  m_verticals.clear();
+  for (size_t i = 0; i < m_segments.size(); i++) {
+    const Segment &s = m_segments[i];
+    if (s.l.x == s.r.x) {
+      m_verticals.push_back(i);  // already by x
+      continue;
+    }
+    SweepSegment w = {s.l.x, s.l.y, s.r.x, s.r.y, {s.wind[0], s.wind[1]},
+                      {0, 0}, {0, 0}, i};
+    m_sweep.push_back(w);
+    m_xs.push_back(s.l.x);
+    m_xs.push_back(s.r.x);
+  }
+  std::sort(m_xs.begin(), m_xs.end());
+  m_xs.erase(std::unique(m_xs.begin(), m_xs.end()), m_xs.end());
+
+  //  m_segments is sorted by l, so m_sweep is by x0
+  m_ends.resize(m_sweep.size());
+  for (size_t i = 0; i < m_ends.size(); i++) m_ends[i] = i;
+  std::sort(m_ends.begin(), m_ends.end(), [this](size_t a, size_t b) {
+    return m_sweep[a].x1 < m_sweep[b].x1;
+  });
+
+  //  Vertical pieces up to x, with the pieces of the slab left of x
+  size_t next_vertical = 0;
+  auto do_verticals = [this, &next_vertical](double x) {
+    for (; next_vertical < m_verticals.size(); next_vertical++) {
+      Segment &v = m_segments[m_verticals[next_vertical]];
+      const double vx = v.l.x, mid = (v.l.y + v.r.y) / 2;
+      if (vx > x) break;
+      auto under = std::partition_point(
+          m_active.begin(), m_active.end(), [this, vx, mid](size_t a) {
+            const SweepSegment &s = m_sweep[a];
+            return s.y0 + (s.y1 - s.y0) * (vx - s.x0) / (s.x1 - s.x0) < mid;
+          });
+      for (int p = 0; p < 2; p++) {
+        v.left[p] =
+            under == m_active.begin() ? 0 : m_sweep[*(under - 1)].above[p];
+        v.right[p] = v.left[p] - v.wind[p];
+      }
+    }
+  };
+
+  m_active.clear();
+  size_t next = 0, next_end = 0;
+  for (size_t k = 0; k < m_xs.size(); k++) {
+    const double x = m_xs[k];
+    do_verticals(x);
+    if (k + 1 == m_xs.size()) break;
+    const double mid = (x + m_xs[k + 1]) / 2;
+
+    if (next_end < m_ends.size() && m_sweep[m_ends[next_end]].x1 == x) {
+      while (next_end < m_ends.size() && m_sweep[m_ends[next_end]].x1 == x)
+        next_end++;
+      m_active.erase(std::remove_if(m_active.begin(), m_active.end(),
+                                    [this, x](size_t a) {
+                                      return m_sweep[a].x1 <= x;
+                                    }),
+                     m_active.end());
+    }
+
+    auto y_at = [this, mid](size_t a) {
+      const SweepSegment &s = m_sweep[a];
+      return s.y0 + (s.y1 - s.y0) * (mid - s.x0) / (s.x1 - s.x0);
+    };
+    //  A slab may be too thin for its middle to fall inside it, pieces
+    //  starting at the same point then go by slope
+    auto slope = [this](size_t a) {
+      const SweepSegment &s = m_sweep[a];
+      return (s.y1 - s.y0) / (s.x1 - s.x0);
+    };
+    auto below = [&](size_t a, size_t b) {
+      double ya = y_at(a), yb = y_at(b);
+      if (ya != yb) return ya < yb;
+      double sa = slope(a), sb = slope(b);
+      return sa < sb || (sa == sb && a < b);
+    };
+
+    size_t first = next;
+    for (; next < m_sweep.size() && m_sweep[next].x0 == x; next++)
+      m_active.insert(
+          std::upper_bound(m_active.begin(), m_active.end(), next, below),
+          next);
+    if (first == next) continue;
+
+    int wind[2] = {0, 0};  // above the piece before
+    for (size_t a : m_active) {
+      SweepSegment &s = m_sweep[a];
+      if (a >= first && a < next) {
+        for (int p = 0; p < 2; p++) {
+          s.below[p] = wind[p];
+          s.above[p] = wind[p] + s.wind[p];
+        }
+      }
+      wind[0] = s.above[0], wind[1] = s.above[1];
+    }
+  }
+  m_active.clear();
+  do_verticals(HUGE_VAL);  // only with no other pieces at all
+
+  //  Left of a piece from l to r is above it
+  for (const SweepSegment &w : m_sweep) {
+    Segment &s = m_segments[w.segment];
+    std::copy(w.above, w.above + 2, s.left);
+    std::copy(w.below, w.below + 2, s.right);
+  }
+}
+
+void PolyClipper::LinkResult(Operation op, std::vector<double> &xy,
+                             std::vector<size_t> &starts) {
+  auto inside = [op](const int *wind) {
+    bool a = wind[0] != 0, b = wind[1] != 0;
+    switch (op) {
+      case INTERSECTION:
+        return a && b;
+      case UNION:
+        return a || b;
+      default:
+        return a && !b;
+    }
+  };
+
+  //  The result's edges, with its inside on their left
+  m_from.clear();
+  m_to.clear();
+  for (const Segment &s : m_segments) {
+    bool left = inside(s.left), right = inside(s.right);
+    if (left == right) continue;
+    m_from.push_back(left ? s.l : s.r);
+    m_to.push_back(left ? s.r : s.l);
+  }
+
+  const size_t n = m_from.size();
+  m_order.resize(n);
+  for (size_t i = 0; i < n; i++) m_order[i] = i;
+  std::sort(m_order.begin(), m_order.end(), [this](size_t a, size_t b) {
+    return PointLess(m_from[a], m_from[b]);
+  });
+  m_used.assign(n, false);
+
+  xy.clear();
+  starts.clear();
+  starts.push_back(0);
+  for (size_t oi = 0; oi < n; oi++) {
+    size_t e = m_order[oi];
+    if (m_used[e]) continue;
+
+    const size_t first = xy.size();
+    const Point start = m_from[e];
+    while (true) {
+      m_used[e] = true;
+      xy.push_back(m_from[e].x);
+      xy.push_back(m_from[e].y);
+      const Point to = m_to[e];
+      if (PointEqual(to, start)) break;
+
+      //  Where contours touch there is more than one way on
+      auto it = std::lower_bound(
+          m_order.begin(), m_order.end(), to,
+          [this](size_t k, const Point &p) { return PointLess(m_from[k], p); });
+      e = n;
+      for (; it != m_order.end() && PointEqual(m_from[*it], to); ++it) {
+        if (!m_used[*it]) {
+          e = *it;
+          break;
+        }
+      }
+      if (e == n) break;
+    }
+
+    if (xy.size() - first >= 6)
+      starts.push_back(xy.size() / 2);
+    else
+      xy.resize(first);
+  }
+}
+
+void PolyClipper::Execute(Operation op, std::vector<double> &xy,
+                          std::vector<size_t> &starts) {
+  SplitEdges();
+  BuildSegments();
+  Sweep();
+  LinkResult(op, xy, starts);
+}
@@ -0,0 +1,131 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Boolean operations on polygons
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __POLY_CLIP_H__
+#define __POLY_CLIP_H__
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Intersection, union and difference of two polygons, A and B, each given
+ * as any number of closed contours.  A point is inside a polygon when the
+ * winding number of its contours around the point is not zero, so holes
+ * are contours running the other way.
+ *
+ * The edges of both polygons are split where they cross or touch, equal
+ * pieces merged, and a sweep line over the pieces finds the winding
+ * numbers on both sides of each.  The pieces with the result inside on
+ * exactly one side are linked into the result contours.  Vertical pieces
+ * get their winding numbers from the pieces beside them in the same sweep.
+ *
+ * Crossings worked out from different edges are made one when they are
+ * within a rounding error, relative to the largest coordinate, of each
+ * other or of a polygon point.  Polygon points and crossings on vertical
+ * or horizontal edges keep their exact coordinates when they do.
+ *
+ * The result has counter clockwise outer contours and clockwise holes,
+ * with x to the right and y up.  All working memory is kept from one
+ * Execute() to the next, so a clipper used for many operations soon stops
+ * allocating.
+ */
+class PolyClipper {
+public:
+  enum Operation { INTERSECTION, UNION, DIFFERENCE };
+
+  PolyClipper();
+
+  /** Drop all contours, keeping the memory. */
+  void Clear();
+
+  /** Add a contour of n points, x and y interleaved, to polygon 0 or 1. */
+  void AddContour(int polygon, size_t n, const double *xy);
+  void AddContour(int polygon, size_t n, const float *xy);
+
+  /**
+   * Compute A op B.  Contour i of the result is the points from
+   * starts[i] to starts[i + 1], x and y interleaved in xy, and
+   * starts.back() is the number of points.
+   */
+  void Execute(Operation op, std::vector<double> &xy,
+               std::vector<size_t> &starts);
+
+private:
+  struct Point {
+    double x, y;
+  };
+  struct Edge {
+    Point a, b;
+    int polygon;
+  };
+  struct Split {
+    size_t edge;
+    double t;  // position along the edge, 0 to 1
+    Point p;
+    int exact;  // coordinates of p known exactly
+  };
+  struct SnapPoint {
+    Point p;
+    int exact;
+  };
+  struct Segment {
+    Point l, r;  // l before r by x, then by y
+    int wind[2];  // change of each winding number crossing from right to left
+    int left[2], right[2];  // the winding numbers on both sides
+  };
+  struct SweepSegment {
+    double x0, y0, x1, y1;  // x0 < x1
+    int wind[2];
+    int below[2], above[2];
+    size_t segment;
+  };
+
+  void AddEdge(int polygon, const Point &a, const Point &b);
+  void SplitEdges();
+  void SplitPair(size_t i, size_t j);
+  void BuildSegments();
+  void Sweep();
+  void LinkResult(Operation op, std::vector<double> &xy,
+                  std::vector<size_t> &starts);
+
+  std::vector<Edge> m_edges;
+  std::vector<Split> m_splits;
+  std::vector<size_t> m_order;
+  std::vector<Segment> m_segments;
+  double m_eps;  // points closer than this are one
+  std::vector<SnapPoint> m_snap;
+  std::vector<Point> m_points, m_snapped;  // piece ends, and where they go
+  std::vector<int> m_exact;
+  std::vector<size_t> m_cluster;  // of points made one
+  std::vector<SweepSegment> m_sweep;
+  std::vector<double> m_xs;
+  std::vector<size_t> m_ends;
+  std::vector<size_t> m_active;
+  std::vector<size_t> m_verticals;
+  std::vector<Point> m_from, m_to;
+  std::vector<bool> m_used;
+};
+
+#endif
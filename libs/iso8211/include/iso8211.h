@@ -120,11 +120,30 @@ class DDFModule
     // This is just for DDFRecord.
     FILE        *GetFP() { return fpDDF; }
 
+    // Also for DDFRecord: reading from the in memory image of the file.
+    const char  *ReadData( int nBytes );
+    long        GetBytesLeft() { return nFileSize - nFilePos; }
+    long        Tell() { return nFilePos; }
+    void        Seek( long nOffset );
+
+    /** TRUE if the file read is mapped rather than copied into memory. */
+    int         IsFileMapped() { return bFileMapped; }
+
   private:
+    int         LoadFile( const char *pszFilename );
+    void        UnloadFile();
+
     FILE        *fpDDF;
     int         bReadOnly;
     long        nFirstRecordOffset;
 
+    // The whole file being read, mapped or else read into memory.
+    char        *pachFileData;
+    long        nFileSize;
+    long        nFilePos;
+    int         bFileMapped;
+    void        *hFileMapping;
+
     char        _interchangeLevel;
     char        _inlineCodeExtensionIndicator;
     char        _versionNumber;
@@ -450,6 +469,7 @@ class DDFRecord
   private:
 
     int         ReadHeader();
+    void        OwnData();
 
     DDFModule   *poModule;
 
@@ -463,6 +483,7 @@ class DDFRecord
 
     int         nDataSize;      // Whole record except leader with header
     char        *pachData;
+    int         bDataBorrowed;  // pachData points into the module's file image
 
     int         nFieldCount;
     DDFField    *paoFields;
@@ -82,6 +82,15 @@
 #include "gdal/cpl_conv.h"
 #include "iso8211.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 /************************************************************************/
 /*                             DDFModule()                              */
 /************************************************************************/
@@ -102,6 +111,13 @@ DDFModule::DDFModule()
 
     fpDDF = NULL;
     bReadOnly = TRUE;
+    nFirstRecordOffset = 0;
+
+    pachFileData = NULL;
+    nFileSize = 0;
+    nFilePos = 0;
+    bFileMapped = FALSE;
+    hFileMapping = NULL;
 
     _interchangeLevel = '\0';
     _inlineCodeExtensionIndicator = '\0';
@@ -185,6 +201,174 @@ void DDFModule::Close()
     CPLFree( papoFieldDefns );
     papoFieldDefns = NULL;
     nFieldDefnCount = 0;
+
+/* -------------------------------------------------------------------- */
+/*      Release the file image, now nothing refers to it.               */
+/* -------------------------------------------------------------------- */
+    UnloadFile();
+}
+
+/************************************************************************/
+/*                              LoadFile()                              */
+/*                                                                      */
+/*      Map the whole file into memory, or failing that read it all     */
+/*      in one go.  Records are then parsed in place, instead of        */
+/*      with several small reads each.  The mapping is copy on          */
+/*      write, so nothing written through a record can reach the        */
+/*      file.                                                           */
+/************************************************************************/
+
+int DDFModule::LoadFile( const char *pszFilename )
+
+{
+#ifdef _WIN32
+    HANDLE hFile = CreateFileA( pszFilename, GENERIC_READ, FILE_SHARE_READ,
+                                NULL, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    if( hFile != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER nSize;
+
+        if( GetFileSizeEx( hFile, &nSize ) && nSize.QuadPart > 0
+            && nSize.QuadPart < 0x7fffffff )
+        {
+            HANDLE hMapping = CreateFileMapping( hFile, NULL, PAGE_WRITECOPY,
+                                                 0, 0, NULL );
+            if( hMapping != NULL )
+            {
+                void *pView = MapViewOfFile( hMapping, FILE_MAP_COPY, 0, 0, 0 );
+                if( pView != NULL )
+                {
+                    pachFileData = (char *) pView;
+                    nFileSize = (long) nSize.QuadPart;
+                    hFileMapping = hMapping;
+                    bFileMapped = TRUE;
+                }
+                else
+                    CloseHandle( hMapping );
+            }
+        }
+        CloseHandle( hFile );   // the mapping keeps its own reference
+    }
+#else
+    int fd = open( pszFilename, O_RDONLY );
+    if( fd >= 0 )
+    {
+        struct stat sStat;
+
+        if( fstat( fd, &sStat ) == 0 && sStat.st_size > 0
+            && sStat.st_size < 0x7fffffff )
+        {
+            void *pView = mmap( NULL, sStat.st_size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE, fd, 0 );
+            if( pView != MAP_FAILED )
+            {
+                madvise( pView, sStat.st_size, MADV_SEQUENTIAL );
+                pachFileData = (char *) pView;
+                nFileSize = (long) sStat.st_size;
+                bFileMapped = TRUE;
+            }
+        }
+        close( fd );            // the mapping stays valid
+    }
+#endif
+
+/* -------------------------------------------------------------------- */
+/*      No mapping, e.g. on some network file systems.                  */
+/* -------------------------------------------------------------------- */
+    if( !bFileMapped )
+    {
+        FILE *fp = VSIFOpen( pszFilename, "rb" );
+        if( fp == NULL )
+            return FALSE;
+
+        VSIFSeek( fp, 0, SEEK_END );
+        nFileSize = VSIFTell( fp );
+        VSIFSeek( fp, 0, SEEK_SET );
+
+        if( nFileSize > 0 )
+        {
+            pachFileData = (char *) VSIMalloc( nFileSize );
+            if( pachFileData == NULL
+                || (long) VSIFRead( pachFileData, 1, nFileSize, fp )
+                   != nFileSize )
+            {
+                VSIFClose( fp );
+                UnloadFile();
+                return FALSE;
+            }
+        }
+        VSIFClose( fp );
+    }
+
+    nFilePos = 0;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                             UnloadFile()                             */
+/************************************************************************/
+
+void DDFModule::UnloadFile()
+
+{
+    if( pachFileData != NULL )
+    {
+        if( bFileMapped )
+        {
+#ifdef _WIN32
+            UnmapViewOfFile( pachFileData );
+            CloseHandle( (HANDLE) hFileMapping );
+#else
+            munmap( pachFileData, nFileSize );
+#endif
+        }
+        else
+            VSIFree( pachFileData );
+    }
+
+    pachFileData = NULL;
+    nFileSize = 0;
+    nFilePos = 0;
+    bFileMapped = FALSE;
+    hFileMapping = NULL;
+}
+
+/************************************************************************/
+/*                              ReadData()                              */
+/*                                                                      */
+/*      Return the next nBytes of the file image and step past them,    */
+/*      or NULL, having stepped to the end, if the file is short.       */
+/************************************************************************/
+
+const char *DDFModule::ReadData( int nBytes )
+
+{
+    if( nBytes < 0 || nBytes > nFileSize - nFilePos )
+    {
+        nFilePos = nFileSize;
+        return NULL;
+    }
+
+    const char *pachResult = pachFileData + nFilePos;
+    nFilePos += nBytes;
+
+    return pachResult;
+}
+
+/************************************************************************/
+/*                                Seek()                                */
+/************************************************************************/
+
+void DDFModule::Seek( long nOffset )
+
+{
+    if( nOffset < 0 )
+        nOffset = 0;
+    else if( nOffset > nFileSize )
+        nOffset = nFileSize;
+
+    nFilePos = nOffset;
 }
 
 /************************************************************************/
@@ -216,15 +400,13 @@ int DDFModule::Open( const char * pszFilename, int bFailQuietly )
 /* -------------------------------------------------------------------- */
 /*      Close the existing file if there is one.                        */
 /* -------------------------------------------------------------------- */
-    if( fpDDF != NULL )
+    if( fpDDF != NULL || pachFileData != NULL )
         Close();
 
 /* -------------------------------------------------------------------- */
-/*      Open the file.                                                  */
+/*      Load the file.                                                  */
 /* -------------------------------------------------------------------- */
-    fpDDF = VSIFOpen( pszFilename, "rb" );
-
-    if( fpDDF == NULL )
+    if( !LoadFile( pszFilename ) )
     {
         if( !bFailQuietly )
             CPLError( CE_Failure, CPLE_OpenFailed,
@@ -236,12 +418,11 @@ int DDFModule::Open( const char * pszFilename, int bFailQuietly )
 /* -------------------------------------------------------------------- */
 /*      Read the 24 byte leader.                                        */
 /* -------------------------------------------------------------------- */
-    char        achLeader[nLeaderSize];
+    const char  *achLeader = ReadData( nLeaderSize );
 
-    if( VSIFRead( achLeader, 1, nLeaderSize, fpDDF ) != nLeaderSize )
+    if( achLeader == NULL )
     {
-        VSIFClose( fpDDF );
-        fpDDF = NULL;
+        UnloadFile();
 
         if( !bFailQuietly )
             CPLError( CE_Failure, CPLE_FileIO,
@@ -306,8 +487,7 @@ int DDFModule::Open( const char * pszFilename, int bFailQuietly )
 /* -------------------------------------------------------------------- */
     if( !bValid )
     {
-        VSIFClose( fpDDF );
-        fpDDF = NULL;
+        UnloadFile();
 
         if( !bFailQuietly )
             CPLError( CE_Failure, CPLE_AppDefined,
@@ -318,16 +498,14 @@ int DDFModule::Open( const char * pszFilename, int bFailQuietly )
     }
 
 /* -------------------------------------------------------------------- */
-/*      Read the whole record info memory.                              */
+/*      The whole record is in memory, just after the leader.           */
 /* -------------------------------------------------------------------- */
-    char        *pachRecord;
+    const char  *pachRecord = achLeader;
 
-    pachRecord = (char *) CPLMalloc(_recLength);
-    memcpy( pachRecord, achLeader, nLeaderSize );
-
-    if( VSIFRead( pachRecord+nLeaderSize, 1, _recLength-nLeaderSize, fpDDF )
-        != _recLength - nLeaderSize )
+    if( ReadData( _recLength - nLeaderSize ) == NULL )
     {
+        UnloadFile();
+
         if( !bFailQuietly )
             CPLError( CE_Failure, CPLE_FileIO,
                       "Header record is short on DDF file `%s'.",
@@ -376,13 +554,11 @@ int DDFModule::Open( const char * pszFilename, int bFailQuietly )
         AddField( poFDefn );
     }
 
-    CPLFree( pachRecord );
-
 /* -------------------------------------------------------------------- */
 /*      Record the current file offset, the beginning of the first      */
 /*      data record.                                                    */
 /* -------------------------------------------------------------------- */
-    nFirstRecordOffset = VSIFTell( fpDDF );
+    nFirstRecordOffset = nFilePos;
 
     return TRUE;
 }
@@ -745,10 +921,10 @@ void DDFModule::Rewind( long nOffset )
     if( nOffset == -1 )
         nOffset = nFirstRecordOffset;
 
-    if( fpDDF == NULL )
+    if( pachFileData == NULL )
         return;
 
-    VSIFSeek( fpDDF, nOffset, SEEK_SET );
+    Seek( nOffset );
 
     if( nOffset == nFirstRecordOffset && poRecord != NULL )
         poRecord->Clear();
@@ -139,6 +139,7 @@ DDFRecord::DDFRecord( DDFModule * poModuleIn )
 
     nDataSize = 0;
     pachData = NULL;
+    bDataBorrowed = FALSE;
 
     nFieldCount = 0;
     paoFields = NULL;
@@ -222,18 +223,13 @@ int DDFRecord::Read()
 /*      the previous records data without disturbing the rest of the    */
 /*      record.                                                         */
 /* -------------------------------------------------------------------- */
-    size_t      nReadBytes;
+    const char  *pachNewData;
 
-    nReadBytes = VSIFRead( pachData + nFieldOffset, 1,
-                           nDataSize - nFieldOffset,
-                           poModule->GetFP() );
-    if( nReadBytes != (size_t) (nDataSize - nFieldOffset)
-        && nReadBytes == 0
-        && VSIFEof( poModule->GetFP() ) )
-    {
+    if( poModule->GetBytesLeft() == 0 )
         return FALSE;
-    }
-    else if( nReadBytes != (size_t) (nDataSize - nFieldOffset) )
+
+    pachNewData = poModule->ReadData( nDataSize - nFieldOffset );
+    if( pachNewData == NULL )
     {
         CPLError( CE_Failure, CPLE_FileIO,
                   "Data record is short on DDF file.\n" );
@@ -241,6 +237,8 @@ int DDFRecord::Read()
         return FALSE;
     }
 
+    memcpy( pachData + nFieldOffset, pachNewData, nDataSize - nFieldOffset );
+
     // notdef: eventually we may have to do something at this point to
     // notify the DDFField's that their data values have changed.
 
@@ -320,14 +318,46 @@ void DDFRecord::Clear()
     paoFields = NULL;
     nFieldCount = 0;
 
-    if( pachData != NULL )
+    if( pachData != NULL && !bDataBorrowed )
         CPLFree( pachData );
 
     pachData = NULL;
+    bDataBorrowed = FALSE;
     nDataSize = 0;
     nReuseHeader = FALSE;
 }
 
+/************************************************************************/
+/*                              OwnData()                               */
+/*                                                                      */
+/*      Records are normally read in place, with pachData pointing      */
+/*      into the module's image of the file.  Take a private copy       */
+/*      before changing the data, or keeping it beyond the next read.   */
+/************************************************************************/
+
+void DDFRecord::OwnData()
+
+{
+    if( !bDataBorrowed )
+        return;
+
+    const char *pachOldData = pachData;
+
+    pachData = (char *) CPLMalloc(nDataSize);
+    memcpy( pachData, pachOldData, nDataSize );
+    bDataBorrowed = FALSE;
+
+    for( int i = 0; i < nFieldCount; i++ )
+    {
+        int     nOffset;
+
+        nOffset = paoFields[i].GetData() - pachOldData;
+        paoFields[i].Initialize( paoFields[i].GetFieldDefn(),
+                                 pachData + nOffset,
+                                 paoFields[i].GetDataSize() );
+    }
+}
+
 /************************************************************************/
 /*                             ReadHeader()                             */
 /*                                                                      */
@@ -347,15 +377,13 @@ int DDFRecord::ReadHeader()
 /* -------------------------------------------------------------------- */
 /*      Read the 24 byte leader.                                        */
 /* -------------------------------------------------------------------- */
-    char        achLeader[nLeaderSize];
-    int         nReadBytes;
+    const char  *achLeader;
 
-    nReadBytes = VSIFRead(achLeader,1,nLeaderSize,poModule->GetFP());
-    if( nReadBytes == 0 && VSIFEof( poModule->GetFP() ) )
-    {
+    if( poModule->GetBytesLeft() == 0 )
         return FALSE;
-    }
-    else if( nReadBytes != (int) nLeaderSize )
+
+    achLeader = poModule->ReadData( nLeaderSize );
+    if( achLeader == NULL )
     {
         CPLError( CE_Failure, CPLE_FileIO,
                   "Leader is short on DDF file." );
@@ -411,19 +439,20 @@ int DDFRecord::ReadHeader()
 /* ==================================================================== */
     if(_recLength != 0) {
 /* -------------------------------------------------------------------- */
-/*      Read the remainder of the record.                               */
+/*      The remainder of the record is used where it lies.              */
 /* -------------------------------------------------------------------- */
         nDataSize = _recLength - nLeaderSize;
-        pachData = (char *) CPLMalloc(nDataSize);
+        pachData = (char *) poModule->ReadData( nDataSize );
 
-        if( VSIFRead( pachData, 1, nDataSize, poModule->GetFP()) !=
-            (size_t) nDataSize )
+        if( pachData == NULL )
         {
+            nDataSize = 0;
             CPLError( CE_Failure, CPLE_FileIO,
                       "Data record is short on DDF file." );
 
             return FALSE;
         }
+        bDataBorrowed = TRUE;
 
 #if 0
 /* -------------------------------------------------------------------- */
@@ -457,6 +486,7 @@ int DDFRecord::ReadHeader()
     {
         if( (pachData[nDataSize-2] == DDF_FIELD_TERMINATOR) && (pachData[nDataSize-1] == 0) )
         {
+            OwnData();
             nDataSize++;
             pachData = (char *) CPLRealloc(pachData,nDataSize);
             pachData[nDataSize-1] = DDF_FIELD_TERMINATOR;
@@ -525,6 +555,12 @@ int DDFRecord::ReadHeader()
                                      nFieldLength );
         }
 
+/* -------------------------------------------------------------------- */
+/*      Following records only overlay their field data on this one.    */
+/* -------------------------------------------------------------------- */
+        if( nReuseHeader )
+            OwnData();
+
         return TRUE;
     }
 /* ==================================================================== */
@@ -558,13 +594,14 @@ int DDFRecord::ReadHeader()
         // and keep on reading...
         do {
             // read an Entry:
-            if(nFieldEntryWidth !=
-               (int) VSIFRead(tmpBuf, 1, nFieldEntryWidth, poModule->GetFP())) {
+            const char *pachEntry = poModule->ReadData(nFieldEntryWidth);
+            if(pachEntry == NULL) {
                 CPLError(CE_Failure, CPLE_FileIO,
                          "Data record is short on DDF file.");
                 CPLFree(tmpBuf);
                 return FALSE;
             }
+            memcpy(tmpBuf, pachEntry, nFieldEntryWidth);
 
             // move this temp buffer into more permanent storage:
             char *newBuf = (char*)CPLMalloc(nDataSize+nFieldEntryWidth);
@@ -584,9 +621,7 @@ int DDFRecord::ReadHeader()
 
         // Now, rewind a little.  Only the TERMINATOR should have been read:
         int rewindSize = nFieldEntryWidth - 1;
-        FILE *fp = poModule->GetFP();
-        long pos = ftell(fp) - rewindSize;
-        fseek(fp, pos, SEEK_SET);
+        poModule->Seek(poModule->Tell() - rewindSize);
         nDataSize -= rewindSize;
 
         // --------------------------------------------------------------------
@@ -596,23 +631,20 @@ int DDFRecord::ReadHeader()
             int nEntryOffset = (i*nFieldEntryWidth) + _sizeFieldTag;
             int nFieldLength = DDFScanInt(pachData + nEntryOffset,
                                           _sizeFieldLength);
-            char *tmpBuf = (char*)CPLMalloc(nFieldLength);
-
             // read an Entry:
-            if(nFieldLength !=
-               (int) VSIFRead(tmpBuf, 1, nFieldLength, poModule->GetFP())) {
+            const char *pachEntry = poModule->ReadData(nFieldLength);
+            if(pachEntry == NULL) {
                 CPLError(CE_Failure, CPLE_FileIO,
                          "Data record is short on DDF file.");
                 CPLFree(tmpBuf);
                 return FALSE;
             }
 
-            // move this temp buffer into more permanent storage:
+            // move this entry into more permanent storage:
             char *newBuf = (char*)CPLMalloc(nDataSize+nFieldLength);
             memcpy(newBuf, pachData, nDataSize);
             CPLFree(pachData);
-            memcpy(&newBuf[nDataSize], tmpBuf, nFieldLength);
-            CPLFree(tmpBuf);
+            memcpy(&newBuf[nDataSize], pachEntry, nFieldLength);
             pachData = newBuf;
             nDataSize += nFieldLength;
         }
@@ -1191,6 +1223,8 @@ int DDFRecord::ResizeField( DDFField *poField, int nNewDataSize )
         return FALSE;
     }
 
+    OwnData();
+
 /* -------------------------------------------------------------------- */
 /*      Reallocate the data buffer accordingly.                         */
 /* -------------------------------------------------------------------- */
@@ -1375,6 +1409,8 @@ DDFRecord::SetFieldRaw( DDFField *poField, int iIndexWithinField,
     if( iIndexWithinField < 0 || iIndexWithinField > nRepeatCount )
         return FALSE;
 
+    OwnData();
+
 /* -------------------------------------------------------------------- */
 /*      Are we adding an instance?  This is easier and different        */
 /*      than replacing an existing instance.                            */
@@ -1536,6 +1572,8 @@ DDFRecord::UpdateFieldRaw( DDFField *poField, int iIndexWithinField,
     if( iIndexWithinField < 0 || iIndexWithinField >= nRepeatCount )
         return FALSE;
 
+    OwnData();
+
 /* -------------------------------------------------------------------- */
 /*      Figure out how much pre and post data there is.                 */
 /* -------------------------------------------------------------------- */
@@ -1604,6 +1642,8 @@ int DDFRecord::ResetDirectory()
 {
     int iField;
 
+    OwnData();
+
 /* -------------------------------------------------------------------- */
 /*      Eventually we should try to optimize the size of offset and     */
 /*      field length.  For now we will use 5 for each which is          */
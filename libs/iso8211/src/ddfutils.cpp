@@ -59,21 +59,30 @@
 /*                             DDFScanInt()                             */
 /*                                                                      */
 /*      Read up to nMaxChars from the passed string, and interpret      */
-/*      as an integer.                                                  */
+/*      as an integer.  This is called for every directory entry of     */
+/*      every record, so the digits are converted directly, the way     */
+/*      atoi() would, rather than copied out for atoi().                */
 /************************************************************************/
 
 long DDFScanInt( const char * pszString, int nMaxChars )
 
 {
-    char        szWorking[33];
+    int         i = 0, bNegative = FALSE;
+    long        nValue = 0;
 
     if( nMaxChars > 32 || nMaxChars == 0 )
         nMaxChars = 32;
 
-    memcpy( szWorking, pszString, nMaxChars );
-    szWorking[nMaxChars] = '\0';
+    while( i < nMaxChars && isspace( (unsigned char) pszString[i] ) )
+        i++;
 
-    return( atoi(szWorking) );
+    if( i < nMaxChars && (pszString[i] == '-' || pszString[i] == '+') )
+        bNegative = pszString[i++] == '-';
+
+    for( ; i < nMaxChars && pszString[i] >= '0' && pszString[i] <= '9'; i++ )
+        nValue = nValue * 10 + (pszString[i] - '0');
+
+    return( bNegative ? -nValue : nValue );
 }
 
 /************************************************************************/
@@ -0,0 +1,85 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Per chart arena allocator for S57 objects and rules
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+
+#include <cstdlib>
+
+#include "ChartArena.h"
+
+//  Every allocation is aligned as malloc() would align it
+static const size_t kArenaAlign = alignof(std::max_align_t);
+
+ChartArena::ChartArena(size_t block_size)
+    : m_next(NULL),
+      m_left(0),
+      m_block_size(block_size),
+      m_nalloc(0),
+      m_used(0),
+      m_reserved(0) {}
+
+ChartArena::~ChartArena() { Release(); }
+
+void *ChartArena::Alloc(size_t size) {
+  size = (size + kArenaAlign - 1) & ~(kArenaAlign - 1);
+  if (size == 0) size = kArenaAlign;
+
+  if (size > m_left) {
+    //  Large requests get a block of their own, so the current one can
+    //  still be used for what follows
+    if (size > m_block_size / 4) {
+      char *block = (char *)malloc(size);
+      if (!block) throw std::bad_alloc();
+      m_blocks.push_back(block);
+      m_reserved += size;
+      m_nalloc++;
+      m_used += size;
+      return block;
+    }
+
+    char *block = (char *)malloc(m_block_size);
+    if (!block) throw std::bad_alloc();
+    m_blocks.push_back(block);
+    m_reserved += m_block_size;
+    m_next = block;
+    m_left = m_block_size;
+  }
+
+  void *p = m_next;
+  m_next += size;
+  m_left -= size;
+  m_nalloc++;
+  m_used += size;
+  return p;
+}
+
+void ChartArena::Release() {
+  for (size_t i = 0; i < m_blocks.size(); i++) free(m_blocks[i]);
+  m_blocks.clear();
+  m_next = NULL;
+  m_left = 0;
+  m_nalloc = 0;
+  m_used = 0;
+  m_reserved = 0;
+}
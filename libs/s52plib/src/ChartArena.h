@@ -0,0 +1,76 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Per chart arena allocator for S57 objects and rules
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+
+#ifndef __CHARTARENA_H__
+#define __CHARTARENA_H__
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * A bump allocator owning the storage of one chart's S57Obj instances,
+ * their attributes and geometry index tables, and its ObjRazRules nodes.
+ *
+ * Memory is carved out of large blocks and is never freed piecewise;
+ * Release() returns everything to the heap in one step.  Destructors of
+ * objects built in the arena are not run by Release(), so owners must
+ * call them first where needed.  Not thread safe.
+ */
+class ChartArena {
+public:
+  ChartArena(size_t block_size = 256 * 1024);
+  ~ChartArena();
+
+  void *Alloc(size_t size);
+  template <typename T, typename... Args>
+  T *New(Args &&... args) {
+    return new (Alloc(sizeof(T))) T(std::forward<Args>(args)...);
+  }
+
+  void Release();
+
+  size_t GetAllocCount() const { return m_nalloc; }
+  size_t GetBytesUsed() const { return m_used; }
+  size_t GetBytesReserved() const { return m_reserved; }
+  size_t GetBlockCount() const { return m_blocks.size(); }
+
+private:
+  ChartArena(const ChartArena &) = delete;
+  ChartArena &operator=(const ChartArena &) = delete;
+
+  std::vector<char *> m_blocks;
+  char *m_next;
+  size_t m_left;
+  size_t m_block_size;
+
+  size_t m_nalloc;
+  size_t m_used;
+  size_t m_reserved;
+};
+
+#endif
@@ -0,0 +1,162 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 Look-Up table attribute matching
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <wx/wx.h>
+
+#include "LUPMatcher.h"
+
+ObjAttIndex::ObjAttIndex(const char *att_array, int n_attr) {
+  m_count = att_array ? n_attr : 0;
+  m_codes = m_local;
+  if (m_count > 32) m_codes = (uint64_t *)malloc(m_count * sizeof(uint64_t));
+
+  for (int i = 0; i < m_count; i++) m_codes[i] = LUPAttCode(att_array + 6 * i);
+}
+
+ObjAttIndex::~ObjAttIndex() {
+  if (m_codes != m_local) free(m_codes);
+}
+
+void CompileLUPAttributes(LUPrec *LUP) {
+  free(LUP->ATTCond);
+  LUP->ATTCond = NULL;
+
+  size_t n = LUP->ATTArray.size();
+  if (!n) return;
+
+  LUP->ATTCond = (LUPAttCond *)calloc(n, sizeof(LUPAttCond));
+
+  for (size_t i = 0; i < n; i++) {
+    LUPAttCond *cond = &LUP->ATTCond[i];
+    char *slatc = LUP->ATTArray[i];
+
+    // LUP attribute value not UTF8 convertible (never seen in PLIB 3.x)
+    if (!slatc || (strlen(slatc) < 6)) {
+      cond->kind = LUPATT_NONE;
+      continue;
+    }
+
+    char *slatv = slatc + 6;
+    cond->code = LUPAttCode(slatc);
+    cond->sval = slatv;
+
+    if (slatv[0] == ' ')
+      cond->kind = LUPATT_ANY;
+    else if (slatv[0] == '?')
+      cond->kind = LUPATT_UNDEF;
+    else {
+      cond->kind = LUPATT_VALUE;
+      cond->ival = atoi(slatv);
+      cond->fval = atof(slatv);
+    }
+  }
+}
+
+//  S57 attribute type 'L' list: comma separated integer.
+//  Object ingestion stores such lists as OGR_STR, so this is only kept
+//  verbatim for completeness.
+static bool MatchIntListValue(const char *slatv, S57attVal *v) {
+  bool attValMatch = false;
+  int a;
+  char ss[41];
+  strncpy(ss, slatv, 39);
+  ss[40] = '\0';
+  char *s = &ss[0];
+
+  int *b = (int *)v->value;
+  sscanf(s, "%d", &a);
+
+  while (*s != '\0') {
+    if (a == *b) {
+      sscanf(++s, "%d", &a);
+      b++;
+      attValMatch = true;
+
+    } else
+      attValMatch = false;
+  }
+  return attValMatch;
+}
+
+int CountLUPAttMatches(const LUPrec *LUP, const ObjAttIndex &index,
+                       wxArrayOfS57attVal *attVal) {
+  int countATT = 0;
+  size_t n = LUP->ATTArray.size();
+
+  for (size_t i = 0; i < n; i++) {
+    const LUPAttCond *cond = &LUP->ATTCond[i];
+    if (cond->kind == LUPATT_NONE) continue;
+
+    int attIdx = index.Find(cond->code);
+    if (attIdx < 0) continue;
+
+    if (cond->kind == LUPATT_ANY) {
+      ++countATT;
+      continue;
+    }
+
+    //  Match if the object does NOT contain this attribute
+    if (cond->kind == LUPATT_UNDEF) continue;
+
+    // checking against object attribute value
+    S57attVal *v = attVal->Item(attIdx);
+    bool attValMatch = false;
+
+    switch (v->valType) {
+      case OGR_INT:  // S57 attribute type 'E' enumerated, 'I' integer
+        attValMatch = (cond->ival == *(int *)(v->value));
+        break;
+
+      case OGR_INT_LST:
+        attValMatch = MatchIntListValue(cond->sval, v);
+        break;
+
+      case OGR_REAL:  // S57 attribute type'F' float
+      {
+        double obj_val = *(double *)(v->value);
+        if (fabs(obj_val - cond->fval) < 1e-6)
+          if (obj_val == cond->fval) attValMatch = true;
+        break;
+      }
+
+      case OGR_STR:  // S57 attribute type'A' code string, 'S' free text
+        //    Strings must be exact match
+        attValMatch = !strcmp((char *)v->value, cond->sval);
+        break;
+
+      default:
+        break;
+    }
+
+    if (attValMatch) ++countATT;
+  }
+
+  return countATT;
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 Look-Up table attribute matching
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __LUPMATCHER_H__
+#define __LUPMATCHER_H__
+
+#include <cstdint>
+
+#include "s52s57.h"
+
+//  Kind of a compiled LUP attribute condition
+typedef enum _LUPAttKind {
+  LUPATT_NONE = 0,  // unusable attribute string, never matches
+  LUPATT_ANY,       // " " wild card, any object value matches (S52 8.3.3.4)
+  LUPATT_UNDEF,     // "?" undefined value, never counted as a match
+  LUPATT_VALUE      // compare against the object value
+} LUPAttKind;
+
+/**
+ * One LUP attribute condition ("DRVAL1 5.0", "CATLAM1"...) with the
+ * acronym packed into an integer and the value pre-converted, so that
+ * FindBestLUP() needs no string work per object.
+ */
+struct LUPAttCond {
+  uint64_t code;     // packed acronym, see LUPAttCode()
+  LUPAttKind kind;
+  int ival;          // value as OGR_INT
+  float fval;        // value as OGR_REAL
+  const char *sval;  // value as OGR_STR, points into LUPrec::ATTArray
+};
+
+/** Pack a 6 character attribute acronym into an integer code. */
+inline uint64_t LUPAttCode(const char *acronym) {
+  uint64_t code = 0;
+  for (int i = 0; i < 6; i++) {
+    if (!acronym[i]) break;
+    code |= (uint64_t)(unsigned char)acronym[i] << (8 * i);
+  }
+  return code;
+}
+
+/**
+ * Attribute acronyms of one S57Obj, as integer codes, built once per
+ * LUP lookup of the object.
+ */
+class ObjAttIndex {
+public:
+  ObjAttIndex(const char *att_array, int n_attr);
+  ~ObjAttIndex();
+
+  /** Index of the first object attribute with this code, or -1. */
+  int Find(uint64_t code) const {
+    for (int i = 0; i < m_count; i++)
+      if (m_codes[i] == code) return i;
+    return -1;
+  }
+
+private:
+  uint64_t m_local[32];
+  uint64_t *m_codes;
+  int m_count;
+};
+
+/** Build LUP->ATTCond from LUP->ATTArray.  Safe to call again. */
+void CompileLUPAttributes(LUPrec *LUP);
+
+/**
+ * Number of LUP attribute conditions satisfied by an object, with the
+ * same rules the PLIB string matcher has always used.
+ */
+int CountLUPAttMatches(const LUPrec *LUP, const ObjAttIndex &index,
+                       wxArrayOfS57attVal *attVal);
+
+#endif
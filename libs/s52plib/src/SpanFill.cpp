@@ -0,0 +1,155 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 area rendering, horizontal span fill routines
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "SpanFill.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+void SpanFill_24_generic(unsigned char *dst, int count,
+                         const unsigned char *c) {
+  while (count-- > 0) {
+    *dst++ = c[0];
+    *dst++ = c[1];
+    *dst++ = c[2];
+  }
+}
+
+void SpanFill_32_generic(unsigned char *dst, int count, uint32_t color) {
+  uint32_t *p = (uint32_t *)dst;
+  while (count-- > 0) *p++ = color;
+}
+
+//  The former floating point blend, (unsigned char)(d * (1 - a/256.) +
+//  p * a/256.), is exact in double, so this integer form gives the same
+//  bytes.
+void SpanPattern_24_generic(unsigned char *dst, int count,
+                            const unsigned char *patt_row, int patt_x,
+                            int patt_w) {
+  while (count-- > 0) {
+    const unsigned char *pp = patt_row + (patt_x * 4);
+    unsigned int alpha = pp[3];
+    unsigned int ialpha = 256 - alpha;
+
+    dst[0] = (unsigned char)((dst[0] * ialpha + pp[0] * alpha) >> 8);
+    dst[1] = (unsigned char)((dst[1] * ialpha + pp[1] * alpha) >> 8);
+    dst[2] = (unsigned char)((dst[2] * ialpha + pp[2] * alpha) >> 8);
+    dst += 3;
+
+    if (++patt_x == patt_w) patt_x = 0;
+  }
+}
+
+void SpanPattern_32_generic(unsigned char *dst, int count,
+                            const unsigned char *patt_row, int patt_x,
+                            int patt_w) {
+  while (count-- > 0) {
+    const unsigned char *pp = patt_row + (patt_x * 4);
+    unsigned int alpha = pp[3];
+    if (alpha > 128) {
+      dst[0] = (unsigned char)((pp[0] * alpha) >> 8);
+      dst[1] = (unsigned char)((pp[1] * alpha) >> 8);
+      dst[2] = (unsigned char)((pp[2] * alpha) >> 8);
+    }
+    dst += 4;
+
+    if (++patt_x == patt_w) patt_x = 0;
+  }
+}
+
+const SpanRoutines *SpanFill_generic_routines() {
+  static const SpanRoutines routines = {
+      "generic", SpanFill_24_generic, SpanFill_32_generic,
+      SpanPattern_24_generic, SpanPattern_32_generic};
+  return &routines;
+}
+
+void (*SpanFill_24)(unsigned char *dst, int count,
+                    const unsigned char *c) = SpanFill_24_generic;
+void (*SpanFill_32)(unsigned char *dst, int count,
+                    uint32_t color) = SpanFill_32_generic;
+void (*SpanPattern_24)(unsigned char *dst, int count,
+                       const unsigned char *patt_row, int patt_x,
+                       int patt_w) = SpanPattern_24_generic;
+void (*SpanPattern_32)(unsigned char *dst, int count,
+                       const unsigned char *patt_row, int patt_x,
+                       int patt_w) = SpanPattern_32_generic;
+
+static bool CpuHasSSE2() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  int info[4];
+  __cpuid(info, 1);
+  return (info[3] & (1 << 26)) != 0;
+#else
+  return false;
+#endif
+}
+
+static bool CpuHasAVX2() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) return false;
+
+  //  The OS must save the AVX registers as well
+  __cpuid(info, 1);
+  const int osxsave_avx = (1 << 27) | (1 << 28);
+  if ((info[2] & osxsave_avx) != osxsave_avx) return false;
+  if ((_xgetbv(0) & 6) != 6) return false;
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return false;
+#endif
+}
+
+const char *SpanFill_ResolveRoutines(bool use_simd) {
+  const SpanRoutines *routines = SpanFill_generic_routines();
+
+  if (use_simd) {
+    //  Test the CPU first, the variants are built with wider instruction
+    //  sets than the rest of the library
+    if (CpuHasSSE2() && SpanFill_sse2_routines())
+      routines = SpanFill_sse2_routines();
+    if (CpuHasAVX2() && SpanFill_avx2_routines())
+      routines = SpanFill_avx2_routines();
+  }
+
+  SpanFill_24 = routines->fill_24;
+  SpanFill_32 = routines->fill_32;
+  SpanPattern_24 = routines->pattern_24;
+  SpanPattern_32 = routines->pattern_32;
+
+  return routines->name;
+}
@@ -0,0 +1,81 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 area rendering, horizontal span fill routines
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __SPANFILL_H__
+#define __SPANFILL_H__
+
+#include <cstdint>
+
+/**
+ * One set of span routines, as used by s52plib::dda_tri() to fill a
+ * horizontal run of `count` pixels starting at `dst`.
+ *
+ * Pattern routines read one row of an RGBA pattern buffer, starting at
+ * column `patt_x` and wrapping at `patt_w`.  The 32 bit variant copies
+ * pattern pixels with alpha > 128, scaled by alpha, and leaves the fourth
+ * byte of the target alone.  The 24 bit variant alpha blends.
+ */
+struct SpanRoutines {
+  const char *name;
+  void (*fill_24)(unsigned char *dst, int count, const unsigned char *c);
+  void (*fill_32)(unsigned char *dst, int count, uint32_t color);
+  void (*pattern_24)(unsigned char *dst, int count,
+                     const unsigned char *patt_row, int patt_x, int patt_w);
+  void (*pattern_32)(unsigned char *dst, int count,
+                     const unsigned char *patt_row, int patt_x, int patt_w);
+};
+
+extern void (*SpanFill_24)(unsigned char *dst, int count,
+                           const unsigned char *c);
+extern void (*SpanFill_32)(unsigned char *dst, int count, uint32_t color);
+extern void (*SpanPattern_24)(unsigned char *dst, int count,
+                              const unsigned char *patt_row, int patt_x,
+                              int patt_w);
+extern void (*SpanPattern_32)(unsigned char *dst, int count,
+                              const unsigned char *patt_row, int patt_x,
+                              int patt_w);
+
+/**
+ * Select the fastest routines this CPU supports, or with use_simd false,
+ * the portable ones.  Returns the name of the selected set.
+ */
+const char *SpanFill_ResolveRoutines(bool use_simd = true);
+
+void SpanFill_24_generic(unsigned char *dst, int count,
+                         const unsigned char *c);
+void SpanFill_32_generic(unsigned char *dst, int count, uint32_t color);
+void SpanPattern_24_generic(unsigned char *dst, int count,
+                            const unsigned char *patt_row, int patt_x,
+                            int patt_w);
+void SpanPattern_32_generic(unsigned char *dst, int count,
+                            const unsigned char *patt_row, int patt_x,
+                            int patt_w);
+
+//  Instruction set specific sets, NULL if not built for this target
+const SpanRoutines *SpanFill_generic_routines();
+const SpanRoutines *SpanFill_sse2_routines();
+const SpanRoutines *SpanFill_avx2_routines();
+
+#endif
@@ -0,0 +1,120 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 area rendering, AVX2 span fill routines
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "SpanFill.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+static void SpanFill_24_avx2(unsigned char *dst, int count,
+                             const unsigned char *c) {
+  if (count >= 32) {
+    //  32 pixels are exactly three vectors
+    unsigned char rep[96];
+    for (int i = 0; i < 96; i += 3) {
+      rep[i] = c[0];
+      rep[i + 1] = c[1];
+      rep[i + 2] = c[2];
+    }
+    __m256i v0 = _mm256_loadu_si256((const __m256i *)rep);
+    __m256i v1 = _mm256_loadu_si256((const __m256i *)(rep + 32));
+    __m256i v2 = _mm256_loadu_si256((const __m256i *)(rep + 64));
+
+    for (; count >= 32; count -= 32, dst += 96) {
+      _mm256_storeu_si256((__m256i *)dst, v0);
+      _mm256_storeu_si256((__m256i *)(dst + 32), v1);
+      _mm256_storeu_si256((__m256i *)(dst + 64), v2);
+    }
+  }
+  SpanFill_24_generic(dst, count, c);
+}
+
+static void SpanFill_32_avx2(unsigned char *dst, int count, uint32_t color) {
+  __m256i v = _mm256_set1_epi32((int)color);
+  for (; count >= 8; count -= 8, dst += 32)
+    _mm256_storeu_si256((__m256i *)dst, v);
+  SpanFill_32_generic(dst, count, color);
+}
+
+static void SpanPattern_32_avx2(unsigned char *dst, int count,
+                                const unsigned char *patt_row, int patt_x,
+                                int patt_w) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i threshold = _mm256_set1_epi32(128);
+  const __m256i rgb = _mm256_set1_epi32(0x00ffffff);
+
+  while (count > 0) {
+    //  Vectorize each run up to the right edge of the pattern
+    int run = patt_w - patt_x;
+    if (run > count) run = count;
+    count -= run;
+
+    const unsigned char *pp = patt_row + (patt_x * 4);
+    for (; run >= 8; run -= 8, pp += 32, dst += 32) {
+      __m256i p = _mm256_loadu_si256((const __m256i *)pp);
+      __m256i d = _mm256_loadu_si256((const __m256i *)dst);
+
+      __m256i mask = _mm256_cmpgt_epi32(_mm256_srli_epi32(p, 24), threshold);
+      mask = _mm256_and_si256(mask, rgb);
+
+      //  (component * alpha) >> 8; unpack and pack both work per 128 bit
+      //  lane, so the pixel order is preserved
+      __m256i lo = _mm256_unpacklo_epi8(p, zero);
+      __m256i hi = _mm256_unpackhi_epi8(p, zero);
+      __m256i alo = _mm256_shufflehi_epi16(
+          _mm256_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)),
+          _MM_SHUFFLE(3, 3, 3, 3));
+      __m256i ahi = _mm256_shufflehi_epi16(
+          _mm256_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)),
+          _MM_SHUFFLE(3, 3, 3, 3));
+      lo = _mm256_srli_epi16(_mm256_mullo_epi16(lo, alo), 8);
+      hi = _mm256_srli_epi16(_mm256_mullo_epi16(hi, ahi), 8);
+      __m256i s = _mm256_packus_epi16(lo, hi);
+
+      d = _mm256_or_si256(_mm256_and_si256(mask, s),
+                          _mm256_andnot_si256(mask, d));
+      _mm256_storeu_si256((__m256i *)dst, d);
+    }
+
+    int done = (int)(pp - patt_row) / 4;
+    SpanPattern_32_generic(dst, run, patt_row, done, patt_w);
+    dst += run * 4;
+    patt_x = 0;
+  }
+}
+
+const SpanRoutines *SpanFill_avx2_routines() {
+  static const SpanRoutines routines = {
+      "avx2", SpanFill_24_avx2, SpanFill_32_avx2, SpanPattern_24_generic,
+      SpanPattern_32_avx2};
+  return &routines;
+}
+
+#else
+
+const SpanRoutines *SpanFill_avx2_routines() { return 0; }
+
+#endif
@@ -0,0 +1,119 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 area rendering, SSE2 span fill routines
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "SpanFill.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+
+#include <emmintrin.h>
+
+static void SpanFill_24_sse2(unsigned char *dst, int count,
+                             const unsigned char *c) {
+  if (count >= 16) {
+    //  16 pixels are exactly three vectors
+    unsigned char rep[48];
+    for (int i = 0; i < 48; i += 3) {
+      rep[i] = c[0];
+      rep[i + 1] = c[1];
+      rep[i + 2] = c[2];
+    }
+    __m128i v0 = _mm_loadu_si128((const __m128i *)rep);
+    __m128i v1 = _mm_loadu_si128((const __m128i *)(rep + 16));
+    __m128i v2 = _mm_loadu_si128((const __m128i *)(rep + 32));
+
+    for (; count >= 16; count -= 16, dst += 48) {
+      _mm_storeu_si128((__m128i *)dst, v0);
+      _mm_storeu_si128((__m128i *)(dst + 16), v1);
+      _mm_storeu_si128((__m128i *)(dst + 32), v2);
+    }
+  }
+  SpanFill_24_generic(dst, count, c);
+}
+
+static void SpanFill_32_sse2(unsigned char *dst, int count, uint32_t color) {
+  __m128i v = _mm_set1_epi32((int)color);
+  for (; count >= 4; count -= 4, dst += 16)
+    _mm_storeu_si128((__m128i *)dst, v);
+  SpanFill_32_generic(dst, count, color);
+}
+
+static void SpanPattern_32_sse2(unsigned char *dst, int count,
+                                const unsigned char *patt_row, int patt_x,
+                                int patt_w) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i threshold = _mm_set1_epi32(128);
+  const __m128i rgb = _mm_set1_epi32(0x00ffffff);
+
+  while (count > 0) {
+    //  Vectorize each run up to the right edge of the pattern
+    int run = patt_w - patt_x;
+    if (run > count) run = count;
+    count -= run;
+
+    const unsigned char *pp = patt_row + (patt_x * 4);
+    for (; run >= 4; run -= 4, pp += 16, dst += 16) {
+      __m128i p = _mm_loadu_si128((const __m128i *)pp);
+      __m128i d = _mm_loadu_si128((const __m128i *)dst);
+
+      __m128i mask = _mm_cmpgt_epi32(_mm_srli_epi32(p, 24), threshold);
+      mask = _mm_and_si128(mask, rgb);
+
+      //  (component * alpha) >> 8, two pixels per half
+      __m128i lo = _mm_unpacklo_epi8(p, zero);
+      __m128i hi = _mm_unpackhi_epi8(p, zero);
+      __m128i alo = _mm_shufflehi_epi16(
+          _mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)),
+          _MM_SHUFFLE(3, 3, 3, 3));
+      __m128i ahi = _mm_shufflehi_epi16(
+          _mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)),
+          _MM_SHUFFLE(3, 3, 3, 3));
+      lo = _mm_srli_epi16(_mm_mullo_epi16(lo, alo), 8);
+      hi = _mm_srli_epi16(_mm_mullo_epi16(hi, ahi), 8);
+      __m128i s = _mm_packus_epi16(lo, hi);
+
+      d = _mm_or_si128(_mm_and_si128(mask, s), _mm_andnot_si128(mask, d));
+      _mm_storeu_si128((__m128i *)dst, d);
+    }
+
+    int done = (int)(pp - patt_row) / 4;
+    SpanPattern_32_generic(dst, run, patt_row, done, patt_w);
+    dst += run * 4;
+    patt_x = 0;
+  }
+}
+
+const SpanRoutines *SpanFill_sse2_routines() {
+  static const SpanRoutines routines = {
+      "sse2", SpanFill_24_sse2, SpanFill_32_sse2, SpanPattern_24_generic,
+      SpanPattern_32_sse2};
+  return &routines;
+}
+
+#else
+
+const SpanRoutines *SpanFill_sse2_routines() { return 0; }
+
+#endif
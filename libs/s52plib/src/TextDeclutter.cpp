@@ -0,0 +1,107 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 text declutter spatial index
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include <wx/wx.h>
+
+#include "TextDeclutter.h"
+#include "s52s57.h"
+
+//  Cell size, in pixels, as a power of two.  64 px is a few text lines
+//  high, so a typical label touches one to four cells.
+#define TEXT_GRID_SHIFT 6
+
+//  Rectangles covering more cells than this are kept on a side list
+//  and always tested, rather than smeared across the grid.
+#define TEXT_GRID_MAX_CELLS 64
+
+static inline int CellOf(int v) {
+  //  Floor division, so that off-screen negative coordinates work too
+  return v >= 0 ? (v >> TEXT_GRID_SHIFT)
+                : -((-v + (1 << TEXT_GRID_SHIFT) - 1) >> TEXT_GRID_SHIFT);
+}
+
+TextDeclutterGrid::TextDeclutterGrid() {}
+
+void TextDeclutterGrid::Clear() {
+  m_cells.clear();
+  m_members.clear();
+  m_memberList.clear();
+  m_oversize.clear();
+}
+
+bool TextDeclutterGrid::CellRange(const wxRect &rect, int &x0, int &y0,
+                                  int &x1, int &y1) const {
+  x0 = CellOf(rect.x);
+  y0 = CellOf(rect.y);
+  x1 = CellOf(rect.x + wxMax(rect.width, 1) - 1);
+  y1 = CellOf(rect.y + wxMax(rect.height, 1) - 1);
+
+  long ncells = (long)(x1 - x0 + 1) * (long)(y1 - y0 + 1);
+  return ncells <= TEXT_GRID_MAX_CELLS;
+}
+
+void TextDeclutterGrid::Add(S52_TextC *ptext) {
+  if (m_members.insert(ptext).second) m_memberList.push_back(ptext);
+
+  int x0, y0, x1, y1;
+  if (!CellRange(ptext->rText, x0, y0, x1, y1)) {
+    m_oversize.push_back(ptext);
+    return;
+  }
+
+  for (int cy = y0; cy <= y1; cy++) {
+    for (int cx = x0; cx <= x1; cx++) {
+      std::vector<S52_TextC *> &cell = m_cells[CellKey(cx, cy)];
+      if (cell.empty() || cell.back() != ptext) cell.push_back(ptext);
+    }
+  }
+}
+
+bool TextDeclutterGrid::Overlaps(const wxRect &test_rect,
+                                 const S52_TextC *ptext) const {
+  for (S52_TextC *oc : m_oversize) {
+    if ((oc != ptext) && oc->rText.Intersects(test_rect)) return true;
+  }
+
+  int x0, y0, x1, y1;
+  if (!CellRange(test_rect, x0, y0, x1, y1)) {
+    //  Huge query rectangle, the plain scan is cheaper than the grid walk
+    for (S52_TextC *oc : m_memberList) {
+      if ((oc != ptext) && oc->rText.Intersects(test_rect)) return true;
+    }
+    return false;
+  }
+
+  for (int cy = y0; cy <= y1; cy++) {
+    for (int cx = x0; cx <= x1; cx++) {
+      auto it = m_cells.find(CellKey(cx, cy));
+      if (it == m_cells.end()) continue;
+      for (S52_TextC *oc : it->second) {
+        if ((oc != ptext) && oc->rText.Intersects(test_rect)) return true;
+      }
+    }
+  }
+  return false;
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S52 text declutter spatial index
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __TEXTDECLUTTER_H__
+#define __TEXTDECLUTTER_H__
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <wx/gdicommon.h>
+
+class S52_TextC;
+
+/**
+ * Uniform hash grid over the screen rectangles of the texts drawn so far
+ * in the current frame, used by the S52 text declutter logic.
+ *
+ * Members are referenced by pointer, and the overlap test always uses the
+ * member's current rText, so a member whose rectangle changes must be
+ * re-added to be indexed under its new cells.  Stale cells are harmless.
+ */
+class TextDeclutterGrid {
+public:
+  TextDeclutterGrid();
+
+  /** Forget all members, typically once per frame. */
+  void Clear();
+
+  /** Index ptext under the cells covered by its current rText. */
+  void Add(S52_TextC *ptext);
+
+  /** True if ptext has been added since the last Clear(). */
+  bool Contains(const S52_TextC *ptext) const {
+    return m_members.count(ptext) != 0;
+  }
+
+  /**
+   * True if test_rect intersects the rText of any member except ptext.
+   * Same result as a linear scan over all members.
+   */
+  bool Overlaps(const wxRect &test_rect, const S52_TextC *ptext) const;
+
+  size_t GetCount() const { return m_members.size(); }
+
+private:
+  bool CellRange(const wxRect &rect, int &x0, int &y0, int &x1,
+                 int &y1) const;
+  static uint64_t CellKey(int cx, int cy) {
+    return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+  }
+
+  std::unordered_map<uint64_t, std::vector<S52_TextC *> > m_cells;
+  std::unordered_set<const S52_TextC *> m_members;
+  std::vector<S52_TextC *> m_memberList;
+  std::vector<S52_TextC *> m_oversize;  // rects spanning too many cells
+};
+
+#endif
@@ -55,6 +55,7 @@
 #endif
 
 #include "s52plib.h"
+#include "LUPMatcher.h"
 
 //--------------------------------------------------------------------------------------
 
@@ -489,6 +490,7 @@ void ChartSymbols::BuildLookup(Lookup &lookup) {
   memcpy(LUP->OBCL, lookup.name.mb_str(), 7);
 
   LUP->ATTArray = lookup.attributeCodeArray;
+  CompileLUPAttributes(LUP);
 
   LUP->INST = new wxString(lookup.instruction);
   LUP->LUCM = lookup.comment;
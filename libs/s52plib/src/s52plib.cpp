@@ -46,6 +46,8 @@ static const double WGS84_semimajor_axis_meters =
 static const double mercator_k0 = 0.9996;
 
 #include "s52plib.h"
+#include "LUPMatcher.h"
+#include "SpanFill.h"
 #include "mygeom.h"
 #include "s52utils.h"
 #include "chartsymbols.h"
@@ -60,6 +62,7 @@ static const double mercator_k0 = 0.9996;
 #include <wx/tokenzr.h>
 #include <wx/fileconf.h>
 #include <fstream>
+#include <vector>
 
 #ifndef PROJECTION_MERCATOR
 #define PROJECTION_MERCATOR 1
@@ -113,7 +116,6 @@ GLint S52AP_shader_program;
 
 //    Implement all lists
 #include <wx/listimpl.cpp>
-WX_DEFINE_LIST(TextObjList);
 
 //    Implement all arrays
 #include <wx/arrimpl.cpp>
@@ -270,6 +272,9 @@ s52plib::s52plib(const wxString &PLib, bool b_forceLegacy) {
   m_chartSymbols.SetTextureFormat(GL_TEXTURE_2D);
   InitializeNatsurHash();
 
+  //    Pick the SIMD span fill routines for this CPU
+  SpanFill_ResolveRoutines();
+
   m_bOK = !(S52_load_Plib(PLib, b_forceLegacy) == 0);
 
   m_bShowS57Text = false;
@@ -287,9 +292,6 @@ s52plib::s52plib(const wxString &PLib, bool b_forceLegacy) {
 
   UpdateMarinerParams();
 
-  ledge = new int[2000];
-  redge = new int[2000];
-
   //    Defaults
   m_VersionMajor = 3;
   m_VersionMinor = 2;
@@ -373,9 +375,6 @@ s52plib::~s52plib() {
 
   delete pOBJLArray;
 
-  delete[] ledge;
-  delete[] redge;
-
   m_chartSymbols.DeleteGlobals();
 
   delete HPGL;
@@ -495,6 +494,7 @@ void s52plib::DestroyLUP(LUPrec *pLUP) {
 
   for (unsigned int i = 0; i < pLUP->ATTArray.size(); i++)
     free(pLUP->ATTArray[i]);
+  free(pLUP->ATTCond);
 
   delete pLUP->INST;
 }
@@ -760,146 +760,41 @@ LUPrec *s52plib::FindBestLUP(wxArrayOfLUPrec *LUPArray, unsigned int startIndex,
     goto check_LUP;  // object has no attributes to compare, so return "best"
                      // LUP
 
-  for (unsigned int i = 0; i < count; ++i) {
-    LUPrec *LUPCandidate = LUPArray->Item(startIndex + i);
-
-    if (!LUPCandidate->ATTArray.size())
-      continue;  // this LUP has no attributes coded
-
-    countATT = 0;
-    char *currATT = pObj->att_array;
-    int attIdx = 0;
-
-    for (unsigned int iLUPAtt = 0; iLUPAtt < LUPCandidate->ATTArray.size();
-         iLUPAtt++) {
-      // Get the LUP attribute name
-      char *slatc = LUPCandidate->ATTArray[iLUPAtt];
-
-      if (slatc && (strlen(slatc) < 6))
-        goto next_LUP_Attr;  // LUP attribute value not UTF8 convertible (never
-                             // seen in PLIB 3.x)
-
-      if (slatc) {
-        char *slatv = slatc + 6;
-        while (attIdx < pObj->n_attr) {
-          if (0 == strncmp(slatc, currATT, 6)) {
-            // OK we have an attribute name match
-
-            bool attValMatch = false;
-
-            // special case (i)
-            if (!strncmp(slatv, " ", 1)) {  // any object value will match wild
-                                            // card (S52 para 8.3.3.4)
-              ++countATT;
-              goto next_LUP_Attr;
-            }
-
-            // special case (ii)
-            // TODO  Find an ENC with "UNKNOWN" DRVAL1 or DRVAL2 and debug this
-            // code
-            if (!strncmp(slatv, "?",
-                         1)) {  // if LUP attribute value is "undefined"
-
-              //  Match if the object does NOT contain this attribute
-              goto next_LUP_Attr;
-            }
-
-            // checking against object attribute value
-            S57attVal *v = (pObj->attVal->Item(attIdx));
-
-            switch (v->valType) {
-              case OGR_INT:  // S57 attribute type 'E' enumerated, 'I' integer
-              {
-                int LUP_att_val = atoi(slatv);
-                if (LUP_att_val == *(int *)(v->value)) attValMatch = true;
-                break;
-              }
-
-              case OGR_INT_LST:  // S57 attribute type 'L' list: comma separated
-                                 // integer
-              {
-                int a;
-                char ss[41];
-                strncpy(ss, slatv, 39);
-                ss[40] = '\0';
-                char *s = &ss[0];
-
-                int *b = (int *)v->value;
-                sscanf(s, "%d", &a);
-
-                while (*s != '\0') {
-                  if (a == *b) {
-                    sscanf(++s, "%d", &a);
-                    b++;
-                    attValMatch = true;
-
-                  } else
-                    attValMatch = false;
-                }
-                break;
-              }
-              case OGR_REAL:  // S57 attribute type'F' float
-              {
-                double obj_val = *(double *)(v->value);
-                float att_val = atof(slatv);
-                if (fabs(obj_val - att_val) < 1e-6)
-                  if (obj_val == att_val) attValMatch = true;
-                break;
-              }
-
-              case OGR_STR:  // S57 attribute type'A' code string, 'S' free text
-              {
-                //    Strings must be exact match
-                //    n.b. OGR_STR is used for S-57 attribute type 'L',
-                //    comma-separated list
-
-                // wxString cs( (char *) v->value, wxConvUTF8 ); // Attribute
-                // from object if( LATTC.Mid( 6 ) == cs )
-                if (!strcmp((char *)v->value, slatv)) attValMatch = true;
-                break;
-              }
-
-              default:
-                break;
-            }  // switch
-
-            // value match
-            if (attValMatch) ++countATT;
-
-            goto next_LUP_Attr;
-          }  // if attribute name match
+  {
+    //  Object attribute acronyms as integer codes, built once per lookup
+    ObjAttIndex attIndex(pObj->att_array, pObj->n_attr);
 
-          //  Advance to the next S57obj attribute
-          currATT += 6;
-          ++attIdx;
+    for (unsigned int i = 0; i < count; ++i) {
+      LUPrec *LUPCandidate = LUPArray->Item(startIndex + i);
 
-        }  // while
-      }    // if
+      if (!LUPCandidate->ATTArray.size())
+        continue;  // this LUP has no attributes coded
 
-    next_LUP_Attr:
+      //  LUPs are compiled at PLIB load, but be lenient for any created
+      //  elsewhere
+      if (!LUPCandidate->ATTCond) CompileLUPAttributes(LUPCandidate);
 
-      currATT = pObj->att_array;  // restart the object attribute list
-      attIdx = 0;
-    }  // for iLUPAtt
+      countATT = CountLUPAttMatches(LUPCandidate, attIndex, pObj->attVal);
 
-    //      Create a "match score", defined as fraction of candidate LUP
-    //      attributes actually matched by feature. Used later for resolving
-    //      "ties"
+      //      Create a "match score", defined as fraction of candidate LUP
+      //      attributes actually matched by feature. Used later for resolving
+      //      "ties"
 
-    int nattr_matching_on_candidate = countATT;
-    int nattrs_on_candidate = LUPCandidate->ATTArray.size();
-    double candidate_score =
-        (1. * nattr_matching_on_candidate) / (1. * nattrs_on_candidate);
+      int nattr_matching_on_candidate = countATT;
+      int nattrs_on_candidate = LUPCandidate->ATTArray.size();
+      double candidate_score =
+          (1. * nattr_matching_on_candidate) / (1. * nattrs_on_candidate);
 
-    //       According to S52 specs, match must be perfect,
-    //         and the first 100% match is selected
-    if (candidate_score == 1.0) {
-      LUP = LUPCandidate;
-      bmatch_found = true;
-      break;  // selects the first 100% match
-    }
+      //       According to S52 specs, match must be perfect,
+      //         and the first 100% match is selected
+      if (candidate_score == 1.0) {
+        LUP = LUPCandidate;
+        bmatch_found = true;
+        break;  // selects the first 100% match
+      }
 
-  }  // for loop
+    }  // for loop
+  }
 
 check_LUP:
   //  In strict mode, we require at least one attribute to match exactly
@@ -2288,17 +2183,7 @@ bool s52plib::RenderText(wxDC *pdc, S52_TextC *ptext, int x, int y,
 //    Return true if test_rect overlaps any rect in the current text rectangle
 //    list, except itself
 bool s52plib::CheckTextRectList(const wxRect &test_rect, S52_TextC *ptext) {
-  //    Iterate over the current object list, looking at rText
-
-  for (TextObjList::Node *node = m_textObjList.GetFirst(); node;
-       node = node->GetNext()) {
-    wxRect *pcurrent_rect = &(node->GetData()->rText);
-
-    if (pcurrent_rect->Intersects(test_rect)) {
-      if (node->GetData() != ptext) return true;
-    }
-  }
-  return false;
+  return m_textGrid.Overlaps(test_rect, ptext);
 }
 
 bool s52plib::TextRenderCheck(ObjRazRules *rzRules) {
@@ -2470,7 +2355,6 @@ int s52plib::RenderT_All(ObjRazRules *rzRules, Rules *rules,
     //  example.  There are others We need to cache only the first text
     //  structure, but should update the render rectangle to reflect all texts
     //  rendered for this object,  in order to process the declutter logic.
-    bool b_dupok = false;
     if (b_free_text) {
       delete text;
 
@@ -2482,29 +2366,16 @@ int s52plib::RenderT_All(ObjRazRules *rzRules, Rules *rules,
         wxRect r0 = text->rText;
         r0 = r0.Union(rect);
         text->rText = r0;
-
-        b_dupok = true;  // OK to add a duplicate text structure to the
-                         // declutter list, just for this case.
       }
     } else
       text->rText = rect;
 
     //      If this text was actually drawn, add a pointer to its rect to the
-    //      de-clutter list if it doesn't already exist
+    //      de-clutter list if it doesn't already exist.
+    //      A text already in the list may have just had its rect changed,
+    //      so it is re-indexed in that case too.
     if (m_bDeClutterText) {
-      if (bwas_drawn) {
-        bool b_found = false;
-        for (TextObjList::Node *node = m_textObjList.GetFirst(); node;
-             node = node->GetNext()) {
-          S52_TextC *oc = node->GetData();
-
-          if (oc == text) {
-            if (!b_dupok) b_found = true;
-            break;
-          }
-        }
-        if (!b_found) m_textObjList.Append(text);
-      }
+      if (bwas_drawn || m_textGrid.Contains(text)) m_textGrid.Add(text);
     }
 
     //  Update the object Bounding box
@@ -6936,6 +6807,24 @@ bool s52plib::inter_tri_rect(wxPoint *ptp, render_canvas_parms *pb_spec) {
   return false;  // no Intersection
 }
 
+//----------------------------------------------------------------------------------
+//
+//              Fast Basic Canvas Rendering
+//              Area fill scratch buffers, one set per rendering thread,
+//              reused from object to object and frame to frame
+//
+//----------------------------------------------------------------------------------
+struct area_scratch {
+  int ledge[2000];
+  int redge[2000];
+  std::vector<wxPoint> points;  // projected vertices of one TriPrim
+};
+
+static area_scratch &GetAreaScratch() {
+  static thread_local area_scratch scratch;
+  return scratch;
+}
+
 //----------------------------------------------------------------------------------
 //
 //              Fast Basic Canvas Rendering
@@ -6944,6 +6833,9 @@ bool s52plib::inter_tri_rect(wxPoint *ptp, render_canvas_parms *pb_spec) {
 //----------------------------------------------------------------------------------
 int s52plib::dda_tri(wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
                      render_canvas_parms *pPatt_spec) {
+  int *ledge = GetAreaScratch().ledge;
+  int *redge = GetAreaScratch().redge;
+
   unsigned char r = 0;
   unsigned char g = 0;
   unsigned char b = 0;
@@ -6971,6 +6863,7 @@ int s52plib::dda_tri(wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
 
   int color_int = 0;
   if (NULL != c) color_int = ((r) << 16) + ((g) << 8) + (b);
+  unsigned char rgb[3] = {b, g, r};  // 24 bit pixel byte order
 
   //      Determine ymin and ymax indices
 
@@ -7213,65 +7106,14 @@ int s52plib::dda_tri(wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
 
             unsigned char *pp0 = patt_s0 + (patt_y * patt_pitch);
 
-            while (ix <= ixm) {
-              int patt_x =
-                  abs(((ix - pPatt_spec->x) + x_stagger_off) % patt_size_x);
-
-              unsigned char *pp = pp0 + (patt_x * 4);
-              unsigned char alpha = pp[3];
-              double da = (double)alpha / 256.;
-
-              unsigned char r = (unsigned char)(*px * (1.0 - da) + pp[0] * da);
-              unsigned char g =
-                  (unsigned char)(*(px + 1) * (1.0 - da) + pp[1] * da);
-              unsigned char b =
-                  (unsigned char)(*(px + 2) * (1.0 - da) + pp[2] * da);
-
-              *px++ = r;
-              *px++ = g;
-              *px++ = b;
-              ix++;
-            }
+            int patt_x =
+                abs(((ix - pPatt_spec->x) + x_stagger_off) % patt_size_x);
+            SpanPattern_24(px, ixm - ix + 1, pp0, patt_x, patt_size_x);
           }
 
           else  // No Pattern
           {
-#if defined(__WXGTK__) && defined(__INTEL__)
-#define memset3(dest, value, count)       \
-  __asm__ __volatile__(                   \
-      "cmp $0,%2\n\t"                     \
-      "jg 2f\n\t"                         \
-      "je 3f\n\t"                         \
-      "jmp 4f\n\t"                        \
-      "2:\n\t"                            \
-      "movl  %0,(%1)\n\t"                 \
-      "add $3,%1\n\t"                     \
-      "dec %2\n\t"                        \
-      "jnz 2b\n\t"                        \
-      "3:\n\t"                            \
-      "movb %b0,(%1)\n\t"                 \
-      "inc %1\n\t"                        \
-      "movb %h0,(%1)\n\t"                 \
-      "inc %1\n\t"                        \
-      "shr $16,%0\n\t"                    \
-      "movb %b0,(%1)\n\t"                 \
-      "4:\n\t"                            \
-      :                                   \
-      : "a"(value), "D"(dest), "r"(count) \
-      :);
-
-            int count = ixm - ix;
-            memset3(px, color_int, count)
-#else
-
-            while (ix <= ixm) {
-              *px++ = b;
-              *px++ = g;
-              *px++ = r;
-
-              ix++;
-            }
-#endif
+            SpanFill_24(px, ixm - ix + 1, rgb);
           }
         }
       }
@@ -7319,55 +7161,14 @@ int s52plib::dda_tri(wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
 
             unsigned char *pp0 = patt_s0 + (patt_y * patt_pitch);
 
-            while (ix <= ixm) {
-              int patt_x =
-                  abs(((ix - pPatt_spec->x) + x_stagger_off) % patt_size_x);
-              /*
-               if(pPatt_spec->depth == 24)
-               {
-               unsigned char *pp = pp0 + (patt_x * 3);
-
-               //  Todo    This line assumes unused_color is always 0,0,0
-               if( pp[0] && pp[1] && pp[2] ) {
-               *px++ = *pp++;
-               *px++ = *pp++;
-               *px++ = *pp++;
-               px++;
-               } else {
-               px += 4;
-               //                                                      pp += 4;
-               }
-               }
-               else
-               */
-              {
-                unsigned char *pp = pp0 + (patt_x * 4);
-                unsigned char alpha = pp[3];
-                if (alpha > 128) {
-                  double da = (double)alpha / 256.;
-
-                  unsigned char r = (unsigned char)(pp[0] * da);
-                  unsigned char g = (unsigned char)(pp[1] * da);
-                  unsigned char b = (unsigned char)(pp[2] * da);
-
-                  *px++ = r;
-                  *px++ = g;
-                  *px++ = b;
-                  px++;
-                } else
-                  px += 4;
-              }
-              ix++;
-            }
+            int patt_x =
+                abs(((ix - pPatt_spec->x) + x_stagger_off) % patt_size_x);
+            SpanPattern_32(px, ixm - ix + 1, pp0, patt_x, patt_size_x);
           }
 
           else  // No Pattern
           {
-            int *pxi = (int *)px;
-            while (ix <= ixm) {
-              *pxi++ = color_int;
-              ix++;
-            }
+            SpanFill_32(px, ixm - ix + 1, color_int);
           }
         }
       }
@@ -7386,6 +7187,9 @@ inline int s52plib::dda_trap(wxPoint *segs, int lseg, int rseg, int ytop,
                              int ybot, S52color *c,
                              render_canvas_parms *pb_spec,
                              render_canvas_parms *pPatt_spec) {
+  int *ledge = GetAreaScratch().ledge;
+  int *redge = GetAreaScratch().redge;
+
   unsigned char r = 0, g = 0, b = 0;
 
   if (NULL != c) {
@@ -7801,6 +7605,22 @@ void s52plib::RenderToBufferFilledPolygon(ObjRazRules *rzRules, S57Obj *obj,
                                           S52color *c,
                                           render_canvas_parms *pb_spec,
                                           render_canvas_parms *pPatt_spec) {
+  S52color cp;
+  if (NULL != c) {
+    cp.R = c->R;
+    cp.G = c->G;
+    cp.B = c->B;
+  }
+
+  ProjectFilledPolygon(rzRules, obj, [&](wxPoint *pp3) {
+    dda_tri(pp3, &cp, pb_spec, pPatt_spec);
+  });
+}
+
+//  Call tri() with the canvas points of each triangle of the object in
+//  the view
+void s52plib::ProjectFilledPolygon(ObjRazRules *rzRules, S57Obj *obj,
+                                   const std::function<void(wxPoint *)> &tri) {
   LLBBox BBView = GetBBox();
   // please untangle this logic with the logic below
   if (BBView.GetMaxLon() + 180 < vp_plib.clon)
@@ -7810,21 +7630,16 @@ void s52plib::RenderToBufferFilledPolygon(ObjRazRules *rzRules, S57Obj *obj,
     BBView.Set(BBView.GetMinLat(), BBView.GetMinLon() - 360, BBView.GetMaxLat(),
                BBView.GetMaxLon() - 360);
 
-  S52color cp;
-  if (NULL != c) {
-    cp.R = c->R;
-    cp.G = c->G;
-    cp.B = c->B;
-  }
-
   if (obj->pPolyTessGeo) {
     if (!rzRules->obj->pPolyTessGeo->IsOk()) {  // perform deferred tesselation
       rzRules->obj->pPolyTessGeo->BuildDeferredTess();
     }
 
-    wxPoint *pp3 = (wxPoint *)malloc(3 * sizeof(wxPoint));
-    wxPoint *ptp = (wxPoint *)malloc((obj->pPolyTessGeo->GetnVertexMax() + 1) *
-                                     sizeof(wxPoint));
+    wxPoint pp3[3];
+    std::vector<wxPoint> &points = GetAreaScratch().points;
+    size_t n_points = obj->pPolyTessGeo->GetnVertexMax() + 1;
+    if (points.size() < n_points) points.resize(n_points);
+    wxPoint *ptp = points.data();
 
     PolyTriGroup *ppg = obj->pPolyTessGeo->Get_PolyTriGroup_head();
 
@@ -7875,7 +7690,7 @@ void s52plib::RenderToBufferFilledPolygon(ObjRazRules *rzRules, S57Obj *obj,
               pp3[2].x = ptp[it + 2].x;
               pp3[2].y = ptp[it + 2].y;
 
-              dda_tri(pp3, &cp, pb_spec, pPatt_spec);
+              tri(pp3);
             }
             break;
           }
@@ -7890,7 +7705,7 @@ void s52plib::RenderToBufferFilledPolygon(ObjRazRules *rzRules, S57Obj *obj,
               pp3[2].x = ptp[it + 2].x;
               pp3[2].y = ptp[it + 2].y;
 
-              dda_tri(pp3, &cp, pb_spec, pPatt_spec);
+              tri(pp3);
             }
             break;
           }
@@ -7905,7 +7720,7 @@ void s52plib::RenderToBufferFilledPolygon(ObjRazRules *rzRules, S57Obj *obj,
               pp3[2].x = ptp[it + 2].x;
               pp3[2].y = ptp[it + 2].y;
 
-              dda_tri(pp3, &cp, pb_spec, pPatt_spec);
+              tri(pp3);
             }
             break;
           }
@@ -7920,9 +7735,6 @@ void s52plib::RenderToBufferFilledPolygon(ObjRazRules *rzRules, S57Obj *obj,
         p_tp = p_tp->p_next;
 
     }  // while
-
-    free(ptp);
-    free(pp3);
   }  // if pPolyTessGeo
 }
 
@@ -9011,13 +8823,11 @@ render_canvas_parms *s52plib::CreatePatternBufferSpec(ObjRazRules *rzRules,
   return patt_spec;
 }
 
-int s52plib::RenderToBufferAP(ObjRazRules *rzRules, Rules *rules,
-                              render_canvas_parms *pb_spec) {
-  //if (vp->m_projection_type != PROJECTION_MERCATOR) return 1;
-
-  wxImage Image;
-
-  if (rules->razRule == NULL) return 0;
+//  Return the pattern buffer of an area pattern rule, building it for the
+//  current color table if needed
+render_canvas_parms *s52plib::GetAreaPatternSpec(ObjRazRules *rzRules,
+                                                 Rules *rules) {
+  if (rules->razRule == NULL) return NULL;
 
   if ((rules->razRule->pixelPtr == NULL) ||
       (rules->razRule->parm1 != m_colortable_index) ||
@@ -9034,20 +8844,30 @@ int s52plib::RenderToBufferAP(ObjRazRules *rzRules, Rules *rules,
 
   }  // Instantiation done
 
-  //  Render the Area using the pattern spec stored in the rules
-  render_canvas_parms *ppatt_spec =
-      (render_canvas_parms *)rules->razRule->pixelPtr;
+  return (render_canvas_parms *)rules->razRule->pixelPtr;
+}
+
+int s52plib::RenderToBufferAP(ObjRazRules *rzRules, Rules *rules,
+                              render_canvas_parms *pb_spec) {
+  //if (vp->m_projection_type != PROJECTION_MERCATOR) return 1;
+
+  render_canvas_parms *ppatt_spec = GetAreaPatternSpec(rzRules, rules);
+  if (!ppatt_spec) return 0;
+
+  //  Render the Area using a copy of the pattern spec stored in the rules,
+  //  so that the shared spec is never written while rendering
+  render_canvas_parms patt_spec = *ppatt_spec;
 
   //  Set the pattern reference point
 
   wxPoint r;
   GetPointPixSingle(rzRules, rzRules->obj->y, rzRules->obj->x, &r);
 
-  ppatt_spec->x =
+  patt_spec.x =
       r.x - 2000000;  // bias way down to avoid zero-crossing logic in dda
-  ppatt_spec->y = r.y - 2000000;
+  patt_spec.y = r.y - 2000000;
 
-  RenderToBufferFilledPolygon(rzRules, rzRules->obj, NULL, pb_spec, ppatt_spec);
+  RenderToBufferFilledPolygon(rzRules, rzRules->obj, NULL, pb_spec, &patt_spec);
 
   return 1;
 }
@@ -9153,6 +8973,131 @@ int s52plib::RenderAreaToDC(wxDC *pdcin, ObjRazRules *rzRules,
   return 1;
 }
 
+int s52plib::PrepareAreaToBuffer(ObjRazRules *rzRules) {
+  if (!ObjectRenderCheckRules(rzRules, true)) return 0;
+
+  //  Deferred tesselation
+  S57Obj *obj = rzRules->obj;
+  if (obj->pPolyTessGeo && !obj->pPolyTessGeo->IsOk())
+    obj->pPolyTessGeo->BuildDeferredTess();
+
+  int flags = AREA_PREP_DRAW;
+  Rules *rules = rzRules->LUP->ruleList;
+
+  //  Color lookups insert missing names, so resolve them here once too
+  while (rules != NULL) {
+    switch (rules->ruleType) {
+      case RUL_ARE_CO:
+        getColor((char *)rules->INSTstr);
+        break;
+      case RUL_ARE_PA:
+        GetAreaPatternSpec(rzRules, rules);
+        break;
+
+      case RUL_CND_SY: {
+        if (!obj->bCS_Added) {
+          obj->CSrules = NULL;
+          GetAndAddCSRules(rzRules, rules);
+          obj->bCS_Added = 1;  // mark the object
+        }
+
+        //  Same display category re-check as RenderAreaToDC()
+        if (ObjectRenderCheckCat(rzRules)) {
+          flags |= AREA_PREP_CS;
+          for (Rules *cs = obj->CSrules; cs; cs = cs->next) {
+            if (cs->ruleType == RUL_ARE_CO)
+              getColor((char *)cs->INSTstr);
+            else if (cs->ruleType == RUL_ARE_PA)
+              GetAreaPatternSpec(rzRules, cs);
+          }
+        }
+        break;
+      }
+
+      default:
+        break;
+    }
+    rules = rules->next;
+  }
+
+  return flags;
+}
+
+void s52plib::ProjectAreaToBuffer(ObjRazRules *rzRules, int prep_flags,
+                                  AreaBufferList &list) {
+  if (!(prep_flags & AREA_PREP_DRAW)) return;
+
+  Rules *rules = rzRules->LUP->ruleList;
+
+  while (rules != NULL) {
+    switch (rules->ruleType) {
+      case RUL_ARE_CO:
+      case RUL_ARE_PA:
+        ProjectToBufferArea(rzRules, rules, list);
+        break;
+
+      case RUL_CND_SY: {
+        //  As in RenderAreaToDC(), rendering the CS rules ends the walk
+        if ((prep_flags & AREA_PREP_CS) && rzRules->obj->CSrules) {
+          for (Rules *cs = rzRules->obj->CSrules; cs; cs = cs->next) {
+            if (cs->ruleType == RUL_ARE_CO || cs->ruleType == RUL_ARE_PA)
+              ProjectToBufferArea(rzRules, cs, list);
+          }
+          return;
+        }
+        break;
+      }
+
+      default:
+        break;
+    }
+    rules = rules->next;
+  }
+}
+
+//  Add an AC or AP rule fill, as RenderToBufferAC() or RenderToBufferAP()
+//  would draw it
+void s52plib::ProjectToBufferArea(ObjRazRules *rzRules, Rules *rules,
+                                  AreaBufferList &list) {
+  AreaBufferFill fill;
+  fill.color.R = fill.color.G = fill.color.B = 0;
+  fill.b_pattern = rules->ruleType == RUL_ARE_PA;
+  if (fill.b_pattern) {
+    render_canvas_parms *ppatt_spec = GetAreaPatternSpec(rzRules, rules);
+    if (!ppatt_spec) return;
+    fill.patt_spec = *ppatt_spec;
+
+    wxPoint r;
+    GetPointPixSingle(rzRules, rzRules->obj->y, rzRules->obj->x, &r);
+    fill.patt_spec.x = r.x - 2000000;  // as in RenderToBufferAP()
+    fill.patt_spec.y = r.y - 2000000;
+  } else {
+    S52color *c = getColor((char *)rules->INSTstr);
+    if (c) fill.color = *c;
+  }
+
+  fill.first = list.points.size();
+  ProjectFilledPolygon(rzRules, rzRules->obj, [&list](wxPoint *pp3) {
+    list.points.insert(list.points.end(), pp3, pp3 + 3);
+  });
+  fill.n_tris = (list.points.size() - fill.first) / 3;
+  if (fill.n_tris) list.fills.push_back(fill);
+}
+
+void s52plib::RasterAreaToBuffer(const AreaBufferList &list,
+                                 render_canvas_parms *pb_spec) {
+  for (const AreaBufferFill &fill : list.fills) {
+    //  dda_tri() takes writable arguments, give it copies
+    S52color c = fill.color;
+    render_canvas_parms patt_spec = fill.patt_spec;
+    const wxPoint *tri = &list.points[fill.first];
+    for (size_t i = 0; i < fill.n_tris; i++, tri += 3) {
+      wxPoint pp3[3] = {tri[0], tri[1], tri[2]};
+      dda_tri(pp3, &c, pb_spec, fill.b_pattern ? &patt_spec : NULL);
+    }
+  }
+}
+
 void s52plib::GetAndAddCSRules(ObjRazRules *rzRules, Rules *rules) {
   LUPrec *NewLUP;
   LUPrec *LUP;
@@ -9923,7 +9868,7 @@ void s52plib::SetQualityOfData(bool val) {
 
 void s52plib::ClearTextList(void) {
   //      Clear the current text rectangle list
-  m_textObjList.Clear();
+  m_textGrid.Clear();
 }
 
 bool s52plib::EnableGLLS(bool b_enable) {
@@ -9933,24 +9878,9 @@ bool s52plib::EnableGLLS(bool b_enable) {
 }
 
 void s52plib::AdjustTextList(int dx, int dy, int screenw, int screenh) {
+  //  Offsetting the declutter list on blit-scroll has been disabled for a
+  //  long time; the list is rebuilt on every full render instead.
   return;
-  wxRect rScreen(0, 0, screenw, screenh);
-  //    Iterate over the text rectangle list
-  //        1.  Apply the specified offset to the list elements
-  //        2.. Remove any list elements that are off screen after applied
-  //        offset
-
-  TextObjList::Node *node = m_textObjList.GetFirst();
-  TextObjList::Node *next;
-  while (node) {
-    next = node->GetNext();
-    wxRect *pcurrent = &(node->GetData()->rText);
-    pcurrent->Offset(dx, dy);
-    if (!pcurrent->Intersects(rScreen)) {
-      m_textObjList.DeleteNode(node);
-    }
-    node = next;
-  }
 }
 
 bool s52plib::GetPointPixArray(ObjRazRules *rzRules, wxPoint2DDouble *pd,
@@ -26,6 +26,7 @@
 #ifndef _S52PLIB_H_
 #define _S52PLIB_H_
 
+#include <functional>
 #include <vector>
 #include "s52s57.h"  //types
 
@@ -35,6 +36,7 @@ class wxGLContext;
 #include "DepthFont.h"
 #include "chartsymbols.h"
 #include "TexFont.h"
+#include "TextDeclutter.h"
 
 #include <wx/dcgraph.h>  // supplemental, for Mac
 #include <unordered_map>
@@ -107,7 +109,24 @@ WX_DECLARE_HASH_MAP(wxString, Rule *, wxStringHash, wxStringEqual, RuleHash);
 
 WX_DEFINE_SORTED_ARRAY(LUPrec *, wxArrayOfLUPrec);
 
-WX_DECLARE_LIST(S52_TextC, TextObjList);
+//    s52plib::PrepareAreaToBuffer() result flags
+#define AREA_PREP_DRAW 1  // object is visible, render its area rules
+#define AREA_PREP_CS 2    // ... including its conditional symbology rules
+
+//    Area fills projected to canvas triangles by
+//    s52plib::ProjectAreaToBuffer(), in drawing order
+struct AreaBufferFill {
+  S52color color;
+  bool b_pattern;
+  render_canvas_parms patt_spec;  // if b_pattern, placed for the object
+  size_t first;                   // first point in AreaBufferList::points
+  size_t n_tris;                  // three points each
+};
+
+struct AreaBufferList {
+  std::vector<AreaBufferFill> fills;
+  std::vector<wxPoint> points;
+};
 
 struct CARC_Buffer {
   unsigned char color[3][4];
@@ -250,6 +269,18 @@ public:
   int RenderAreaToDC(wxDC *pdc, ObjRazRules *rzRules,
                      render_canvas_parms *pb_spec);
 
+  //    RenderAreaToDC() split up, for rendering horizontal bands of the
+  //    area buffer concurrently.  PrepareAreaToBuffer() and
+  //    ProjectAreaToBuffer() must run on the GUI thread; the first does all
+  //    lazy instantiation and returns AREA_PREP_* flags, the second adds the
+  //    fills of the object to list.  RasterAreaToBuffer() then draws the
+  //    list into a band, only reading shared state.
+  int PrepareAreaToBuffer(ObjRazRules *rzRules);
+  void ProjectAreaToBuffer(ObjRazRules *rzRules, int prep_flags,
+                           AreaBufferList &list);
+  void RasterAreaToBuffer(const AreaBufferList &list,
+                          render_canvas_parms *pb_spec);
+
   // Accessors
   bool GetShowSoundings() { return m_bShowSoundg; }
   void SetShowSoundings(bool f) {
@@ -461,6 +492,10 @@ private:
   void RenderToBufferFilledPolygon(ObjRazRules *rzRules, S57Obj *obj,
                                    S52color *c, render_canvas_parms *pb_spec,
                                    render_canvas_parms *patt_spec);
+  void ProjectFilledPolygon(ObjRazRules *rzRules, S57Obj *obj,
+                            const std::function<void(wxPoint *)> &tri);
+  void ProjectToBufferArea(ObjRazRules *rzRules, Rules *rules,
+                           AreaBufferList &list);
 
   void draw_lc_poly(wxDC *pdc, wxColor &color, int width, wxPoint *ptp,
                     int *mask, int npt, float sym_len, float sym_factor,
@@ -483,6 +518,8 @@ private:
 
   int PrioritizeLineFeature(ObjRazRules *rzRules, int npriority);
 
+  render_canvas_parms *GetAreaPatternSpec(ObjRazRules *rzRules, Rules *rules);
+
   int dda_tri(wxPoint *ptp, S52color *c, render_canvas_parms *pb_spec,
               render_canvas_parms *pPatt_spec);
   int dda_trap(wxPoint *segs, int lseg, int rseg, int ytop, int ybot,
@@ -543,13 +580,10 @@ private:
   wxGLContext *m_glcc;
   //#endif
 
-  int *ledge;
-  int *redge;
-
   int m_colortable_index;
   int m_colortable_index_save;
 
-  TextObjList m_textObjList;
+  TextDeclutterGrid m_textGrid;
 
   wxString m_ColorScheme;
 
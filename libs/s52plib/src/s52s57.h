@@ -214,6 +214,8 @@ typedef struct _Rules {
 
 // LOOKUP MODULE CLASS
 
+struct LUPAttCond;  // compiled LUP attribute condition, see LUPMatcher.h
+
 class LUPrec {
 public:
   ~LUPrec() { ATTArray.clear(); };
@@ -231,6 +233,7 @@ public:
   int nSequence;    // A sequence number, indicating order of encounter in
                     //  the PLIB file
   Rules *ruleList;  // rasterization rule list
+  LUPAttCond *ATTCond;  // ATTArray compiled for matching, NULL until built
 };
 
 // Conditional Symbology
@@ -311,6 +314,7 @@ typedef struct _pt {
 //      Fwd References
 class s57chart;
 class S57Obj;
+class ChartArena;
 class OGRFeature;
 class PolyTessGeo;
 class line_segment_element;
@@ -356,7 +360,11 @@ public:
   S57Obj();
   ~S57Obj();
 
-  S57Obj(const char *featureName);
+  S57Obj(const char *featureName, ChartArena *arena = NULL);
+
+  //  Objects of a chart arena are built in it, and only destroyed here
+  static S57Obj *Create(const char *featureName, ChartArena *arena);
+  static void Destroy(S57Obj *obj);
 
   wxString GetAttrValueAsString(const char *attr);
   int GetAttributeIndex(const char *AttrSeek);
@@ -377,6 +385,8 @@ public:
   // Private Methods
 private:
   void Init();
+  void *ObjAlloc(size_t size);
+  void AddAttAcronym(const char *acronym);
 
 public:
   // Instance Data
@@ -448,6 +458,9 @@ public:
   int auxParm3;
 
   bool bBBObj_valid;
+
+  ChartArena *m_arena;  // Owner of the attribute and geometry storage
+                        // if not NULL
 };
 
 typedef std::vector<S57Obj *> S57ObjVector;
@@ -31,6 +31,8 @@
 #include <wx/wx.h>
 #endif  // precompiled headers
 
+#include <wx/filename.h>
+
 #include "baro_history.h"
 #include "wx28compat.h"
 
@@ -38,14 +40,28 @@
 #pragma hdrstop
 #endif
 
+// Channels of m_History
+enum { BH_PRESS, BH_SMOOTH_PRESS, BH_COUNT };
+
+// Minutes between the time lines of each tier
+static const int kTimeLineMinutes[] = {15, 180, 1440};
+
+static wxString GetHistoryPath(const wxString& key) {
+  wxFileName fn;
+  fn.SetPath(*GetpPrivateApplicationDataLocation());
+  fn.SetFullName(_T("dashboard_baro_history_") + key + _T(".dat"));
+  return fn.GetFullPath();
+}
+
 
 //************************************************************************************************************************
 // History of barometic pressure
 //************************************************************************************************************************
 
 DashboardInstrument_BaroHistory::DashboardInstrument_BaroHistory(
-    wxWindow* parent, wxWindowID id, wxString title)
-    : DashboardInstrument(parent, id, title, OCPN_DBP_STC_MDA) {
+    wxWindow* parent, wxWindowID id, wxString title, wxString key)
+    : DashboardInstrument(parent, id, title, OCPN_DBP_STC_MDA),
+      m_History(BH_COUNT, BARO_RECORD_COUNT) {
   SetDrawSoloInPane(true);
 
   m_MaxPress = 0;
@@ -61,21 +77,60 @@ DashboardInstrument_BaroHistory::DashboardInstrument_BaroHistory(
   m_SpdRecCnt = 0;
   m_SpdStartVal = -1;
   m_IsRunning = false;
-  m_SampleCount = 0;
   m_SetNewData = 0;
   m_LeftLegend = 3;
   m_RightLegend = 20;
-  for (int idx = 0; idx < BARO_RECORD_COUNT; idx++) {
-    m_ArrayPressHistory[idx] = -1;
-    m_ExpSmoothArrayPressure[idx] = -1;
-    m_ArrayRecTime[idx] = wxDateTime::Now().GetTm();
-    m_ArrayRecTime[idx].year = 999;
+  m_Tier = 0;
+  // carry on the history of the last run
+  m_HistoryPath = GetHistoryPath(key);
+  if (m_History.Load(m_HistoryPath)) {
+    for (int tier = 0; tier < m_History.GetTierCount(); tier++) {
+      if (!m_History.GetCount(tier)) continue;
+      m_TotalMaxPress =
+          wxMax(m_History.GetMax(BH_PRESS, tier), m_TotalMaxPress);
+      m_TotalMinPress =
+          wxMin(m_History.GetMin(BH_PRESS, tier), m_TotalMinPress);
+    }
   }
+  UpdateMinMax();
   alpha = 0.01;  // smoothing constant
   m_WindowRect = GetClientRect();
   m_DrawAreaRect = GetClientRect();
   m_DrawAreaRect.SetHeight(m_WindowRect.height - m_TopLineHeight -
                            m_TitleHeight);
+  Connect(wxEVT_LEFT_DCLICK,
+          wxMouseEventHandler(DashboardInstrument_BaroHistory::OnMouseDClick),
+          NULL, this);
+}
+
+DashboardInstrument_BaroHistory::~DashboardInstrument_BaroHistory(void) {
+  if (m_History.GetCount()) m_History.Save(m_HistoryPath);
+}
+
+void DashboardInstrument_BaroHistory::SetHistoryKey(const wxString& key) {
+  wxString path = GetHistoryPath(key);
+  if (path == m_HistoryPath) return;
+  //  Saved under the new key when closed, the old file is stale
+  if (wxFileExists(m_HistoryPath)) wxRemoveFile(m_HistoryPath);
+  m_HistoryPath = path;
+}
+
+//  Show the next longer span of history, back to the shortest
+void DashboardInstrument_BaroHistory::OnMouseDClick(wxMouseEvent& event) {
+  m_Tier = (m_Tier + 1) % m_History.GetTierCount();
+  UpdateMinMax();
+  Refresh();
+}
+
+//  Min and max pressure of the history shown, kept by m_History
+void DashboardInstrument_BaroHistory::UpdateMinMax() {
+  if (!m_History.GetCount(m_Tier)) {
+    m_MaxPress = 0;
+    m_MinPress = 1200;
+    return;
+  }
+  m_MaxPress = m_History.GetMax(BH_PRESS, m_Tier);
+  m_MinPress = m_History.GetMin(BH_PRESS, m_Tier);
 }
 
 wxSize DashboardInstrument_BaroHistory::GetSize(int orient, wxSize hint) {
@@ -103,34 +158,16 @@ void DashboardInstrument_BaroHistory::SetData(DASH_CAP st, double data,
       // smoothed curves
       if (m_SpdRecCnt > 5) {
         m_IsRunning = true;
-        m_SampleCount = m_SampleCount < BARO_RECORD_COUNT ? m_SampleCount + 1
-          : BARO_RECORD_COUNT;
-        m_MaxPress = 0;
-        ;
-        // data shifting
-        for (int idx = 1; idx < BARO_RECORD_COUNT; idx++) {
-          if (BARO_RECORD_COUNT - m_SampleCount <= idx)
-            m_MaxPress = wxMax(m_ArrayPressHistory[idx - 1], m_MaxPress);
-          m_MinPress = wxMin(m_ArrayPressHistory[idx - 1], m_MinPress);
-          m_ArrayPressHistory[idx - 1] = m_ArrayPressHistory[idx];
-          m_ExpSmoothArrayPressure[idx - 1] = m_ExpSmoothArrayPressure[idx];
-          m_ArrayRecTime[idx - 1] = m_ArrayRecTime[idx];
-        }
-        m_ArrayPressHistory[BARO_RECORD_COUNT - 1] = m_Press;
-        if (m_SampleCount < 2) {
-          m_ArrayPressHistory[BARO_RECORD_COUNT - 2] = m_Press;
-          m_ExpSmoothArrayPressure[BARO_RECORD_COUNT - 2] = m_Press;
-        }
-        m_ExpSmoothArrayPressure[BARO_RECORD_COUNT - 1] =
-          alpha * m_ArrayPressHistory[BARO_RECORD_COUNT - 2] +
-          (1 - alpha) * m_ExpSmoothArrayPressure[BARO_RECORD_COUNT - 2];
-        m_ArrayRecTime[BARO_RECORD_COUNT - 1] = wxDateTime::Now().GetTm();
-        m_MaxPress = wxMax(m_Press, m_MaxPress);
-
-        m_MinPress = wxMin(m_MinPress, m_Press);
-        if (wxMin(m_Press, m_MinPress) == -1) {
-          m_MinPress = wxMin(m_Press, 1200);  // to make a OK inital value
-        }
+        // smooth on from the previous sample, or start at this one
+        int n = m_History.GetCount();
+        double last = n ? m_History.GetValue(BH_PRESS, n - 1) : m_Press;
+        double lastSmooth =
+            n ? m_History.GetValue(BH_SMOOTH_PRESS, n - 1) : m_Press;
+        double sample[BH_COUNT];
+        sample[BH_PRESS] = m_Press;
+        sample[BH_SMOOTH_PRESS] = alpha * last + (1 - alpha) * lastSmooth;
+        m_History.Add(wxDateTime::Now().GetTicks(), sample);
+        UpdateMinMax();
         // get the overall max min pressure
         m_TotalMaxPress = wxMax(m_Press, m_TotalMaxPress);
         m_TotalMinPress = wxMin(m_Press, m_TotalMinPress);
@@ -293,14 +330,14 @@ void DashboardInstrument_BaroHistory::DrawForeground(wxGCDC* dc) {
   int labelw, labelh;
   dc->GetTextExtent(WindSpeed, &labelw, &labelh, 0, 0, g_pFontLabel);
   // determine the time range of the available data (=oldest data value)
-  int i = 0;
-  while (m_ArrayRecTime[i].year == 999 && i < BARO_RECORD_COUNT - 1) i++;
-  if (i == BARO_RECORD_COUNT - 1) {
+  int count = m_History.GetCount(m_Tier);
+  int first = BARO_RECORD_COUNT - count;
+  if (count < 2) {
     min = 0;
     hour = 0;
 
   } else {
-    wxDateTime localTime(m_ArrayRecTime[i]);
+    wxDateTime localTime(m_History.GetTime(0, m_Tier));
     min = localTime.GetMinute();
     hour = localTime.GetHour();
   }
@@ -321,21 +358,19 @@ void DashboardInstrument_BaroHistory::DrawForeground(wxGCDC* dc) {
   wxPoint pointsSpd[BARO_RECORD_COUNT + 2];
   wxPoint bdDraw[BARO_RECORD_COUNT + 2];
   int ls = 0;
-  bdDraw[ls].x = 1 * m_ratioW + 3 + m_LeftLegend;
-  bdDraw[ls].y = m_TopLineHeight + m_DrawAreaRect.height -
-    ((m_ArrayPressHistory[1] - (double)m_TotalMinPress + 18) * ratioH);
 
   //---------------------------------------------------------------------------------
-  // live pressure data
+  // live pressure data, right aligned
   //---------------------------------------------------------------------------------
 
-  for (int idx = 1; idx < BARO_RECORD_COUNT; idx++) {
+  for (int idx = wxMax(first, 1); idx < BARO_RECORD_COUNT; idx++) {
     pointsSpd[idx].x = idx * m_ratioW + 3 + m_LeftLegend;
     // Print the smoothed value to avoid jumps in the single line.
-    pointsSpd[idx].y = m_TopLineHeight + m_DrawAreaRect.height -
-        ((m_ExpSmoothArrayPressure[idx] - m_TotalMinPress + 18.0) * ratioH);
-    if (BARO_RECORD_COUNT - m_SampleCount <= idx &&
-      pointsSpd[idx].y > m_TopLineHeight &&
+    pointsSpd[idx].y =
+        m_TopLineHeight + m_DrawAreaRect.height -
+        ((m_History.GetValue(BH_SMOOTH_PRESS, idx - first, m_Tier) -
+          m_TotalMinPress + 18.0) * ratioH);
+    if (pointsSpd[idx].y > m_TopLineHeight &&
       pointsSpd[idx].y <= m_TopLineHeight + m_DrawAreaRect.height) {
       bdDraw[ls] = pointsSpd[idx];
       ls++;
@@ -369,7 +404,8 @@ void DashboardInstrument_BaroHistory::DrawForeground(wxGCDC* dc) {
 
   */
   //---------------------------------------------------------------------------------
-  // Draw vertical timelines every 15 minutes
+  // Draw vertical timelines every 15 minutes, less often for the longer
+  // spans
   //---------------------------------------------------------------------------------
   GetGlobalColor("DASHL", &col);
   pen.SetColour(col);
@@ -377,23 +413,28 @@ void DashboardInstrument_BaroHistory::DrawForeground(wxGCDC* dc) {
   dc->SetPen(pen);
   dc->SetTextForeground(col);
   dc->SetFont(*g_pFontSmall);
+  int interval = kTimeLineMinutes[wxMin(m_Tier, 2)];
   int done = -1;
   wxPoint pointTime;
-  for (int idx = 0; idx < BARO_RECORD_COUNT; idx++) {
-    if (m_ArrayRecTime[idx].year != 999) {
-      wxDateTime localTime(m_ArrayRecTime[idx]);
-      hour = localTime.GetHour();
-      min = localTime.GetMinute();
-      if ((hour * 100 + min) != done && (min == 0 || min % 15 == 0)) {
-        pointTime.x = idx * m_ratioW + 3 + m_LeftLegend;
-        dc->DrawLine(pointTime.x, m_TopLineHeight + 1, pointTime.x,
-                     (m_TopLineHeight + m_DrawAreaRect.height + 1));
-        label.Printf(_T("%02d:%02d"), hour, min);
-        dc->GetTextExtent(label, &width, &height, 0, 0, g_pFontSmall);
-        dc->DrawText(label, pointTime.x - width / 2,
-                     m_WindowRect.height - height);
-        done = hour * 100 + min;
-      }
+  for (int idx = first; idx < BARO_RECORD_COUNT; idx++) {
+    wxDateTime localTime(m_History.GetTime(idx - first, m_Tier));
+    hour = localTime.GetHour();
+    min = localTime.GetMinute();
+    int line = (localTime.GetDay() * 1440 + hour * 60 + min) / interval;
+    if (done != -1 && line != done) {
+      pointTime.x = idx * m_ratioW + 3 + m_LeftLegend;
+      dc->DrawLine(pointTime.x, m_TopLineHeight + 1, pointTime.x,
+                   (m_TopLineHeight + m_DrawAreaRect.height + 1));
+      int minutes = line * interval % 1440;
+      if (interval < 1440)
+        label.Printf(_T("%02d:%02d"), minutes / 60, minutes % 60);
+      else
+        label = wxDateTime::GetWeekDayName(localTime.GetWeekDay(),
+                                           wxDateTime::Name_Abbr);
+      dc->GetTextExtent(label, &width, &height, 0, 0, g_pFontSmall);
+      dc->DrawText(label, pointTime.x - width / 2,
+                   m_WindowRect.height - height);
     }
+    done = line;
   }
 }
@@ -46,13 +46,18 @@
 
 #include "instrument.h"
 #include "dial.h"
+#include "history_buffer.h"
 
 class DashboardInstrument_BaroHistory : public DashboardInstrument {
 public:
+  /** key tells the instances apart, to keep their histories across runs. */
   DashboardInstrument_BaroHistory(wxWindow* parent, wxWindowID id,
-                                  wxString title);
+                                  wxString title, wxString key);
 
-  ~DashboardInstrument_BaroHistory(void) {}
+  ~DashboardInstrument_BaroHistory(void);
+
+  /** The dashboard was renamed: keep the history under the new key. */
+  void SetHistoryKey(const wxString& key);
 
   void SetData(DASH_CAP, double, wxString);
   wxSize GetSize(int orient, wxSize hint);
@@ -65,11 +70,11 @@ private:
 
 protected:
   double alpha;
-  double m_ArrayBaroHistory[BARO_RECORD_COUNT];
-  double m_ArrayPressHistory[BARO_RECORD_COUNT];
-  double m_ExpSmoothArrayPressure[BARO_RECORD_COUNT];
-
-  wxDateTime::Tm m_ArrayRecTime[BARO_RECORD_COUNT];
+  // pressure and its smoothed value; the longer tiers are shown by double
+  // clicking
+  HistoryBuffer m_History;
+  int m_Tier;  // of m_History shown
+  wxString m_HistoryPath;
 
   double m_MaxPress;       //...in array
   double m_MinPress;       //...in array
@@ -80,7 +85,6 @@ protected:
   double m_ratioW;
 
   bool m_IsRunning;
-  int m_SampleCount;
   int m_SetNewData;
   wxRect m_WindowRect;
   wxRect m_DrawAreaRect;  // the coordinates of the real darwing area
@@ -94,6 +98,8 @@ protected:
   void DrawBackground(wxGCDC* dc);
   void DrawForeground(wxGCDC* dc);
   void SetMinMaxWindScale();
+  void UpdateMinMax();
+  void OnMouseDClick(wxMouseEvent& event);
 
   void DrawWindSpeedScale(wxGCDC* dc);
   // wxString GetWindDirStr(wxString WindDir);
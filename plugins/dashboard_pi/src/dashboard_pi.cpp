@@ -4874,6 +4874,7 @@ void DashboardWindow::ChangePaneOrientation(int orient, bool updateAUImgr) {
   wxSize sz = GetMinSize();
   // We must change Name to reset AUI perpective
   m_Container->m_sName = MakeName();
+  UpdateHistoryKeys();
   m_pauimgr->AddPane(this, wxAuiPaneInfo()
                                .Name(m_Container->m_sName)
                                .Caption(m_Container->m_sCaption)
@@ -4897,6 +4898,25 @@ void DashboardWindow::ChangePaneOrientation(int orient, bool updateAUImgr) {
   if (updateAUImgr) m_pauimgr->Update();
 }
 
+//  The history instruments keep their histories by the name of the
+//  dashboard and their rank among those of their kind in it.
+wxString DashboardWindow::GetHistoryKey(int ordinal) {
+  return m_Container->m_sName + wxString::Format(_T("_%d"), ordinal);
+}
+
+void DashboardWindow::UpdateHistoryKeys() {
+  int n_wdh = 0, n_bph = 0;
+  for (size_t i = 0; i < m_ArrayOfInstrument.GetCount(); i++) {
+    DashboardInstrumentContainer *cont = m_ArrayOfInstrument.Item(i);
+    if (cont->m_ID == ID_DBP_D_WDH)
+      ((DashboardInstrument_WindDirHistory *)cont->m_pInstrument)
+          ->SetHistoryKey(GetHistoryKey(n_wdh++));
+    else if (cont->m_ID == ID_DBP_D_BPH)
+      ((DashboardInstrument_BaroHistory *)cont->m_pInstrument)
+          ->SetHistoryKey(GetHistoryKey(n_bph++));
+  }
+}
+
 void DashboardWindow::SetSizerOrientation(int orient) {
   itemBoxSizer->SetOrientation(orient);
   /* We must reset all MinSize to ensure we start with new default */
@@ -4942,6 +4962,7 @@ void DashboardWindow::SetInstrumentList(wxArrayInt list) {
    */
   m_ArrayOfInstrument.Clear();
   itemBoxSizer->Clear(true);
+  int n_wdh = 0, n_bph = 0;
   for (size_t i = 0; i < list.GetCount(); i++) {
     int id = list.Item(i);
     DashboardInstrument *instrument = NULL;
@@ -5206,11 +5227,11 @@ void DashboardWindow::SetInstrumentList(wxArrayInt list) {
         break;
       case ID_DBP_D_WDH:
         instrument = new DashboardInstrument_WindDirHistory(
-            this, wxID_ANY, getInstrumentCaption(id));
+            this, wxID_ANY, getInstrumentCaption(id), GetHistoryKey(n_wdh++));
         break;
       case ID_DBP_D_BPH:
         instrument = new DashboardInstrument_BaroHistory(
-            this, wxID_ANY, getInstrumentCaption(id));
+            this, wxID_ANY, getInstrumentCaption(id), GetHistoryKey(n_bph++));
         break;
       case ID_DBP_I_FOS:
         instrument = new DashboardInstrument_FromOwnship(
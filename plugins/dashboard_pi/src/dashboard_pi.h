@@ -386,6 +386,7 @@ public:
                                    SAT_INFO sats[4]);
   void SendUtcTimeToAllInstruments(wxDateTime value);
   void ChangePaneOrientation(int orient, bool updateAUImgr);
+  void UpdateHistoryKeys();
   /*TODO: OnKeyPress pass event to main window or disable focus*/
 
   DashboardWindowContainer *m_Container;
@@ -399,6 +400,8 @@ public:
   bool m_binResize2;
 
 private:
+  wxString GetHistoryKey(int ordinal);
+
   wxAuiManager *m_pauimgr;
   dashboard_pi *m_plugin;
 
@@ -0,0 +1,227 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Dashboard Plugin
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************
+ */
+
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+#include <wx/wx.h>
+#endif  // precompiled headers
+
+#include <wx/file.h>
+#include <wx/filefn.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "history_buffer.h"
+
+// File layout: header, then per tier the samples in the averaging, then
+// the samples oldest first.  Numbers are stored in the machine's own
+// byte order.
+static const char kMagic[4] = {'O', 'H', 'I', 'S'};
+static const int kVersion = 1;
+
+HistoryBuffer::HistoryBuffer(int channels, int size, int tiers, int factor)
+    : m_channels(channels), m_size(size), m_factor(factor) {
+  m_tiers.resize(tiers);
+  for (Tier &t : m_tiers) {
+    t.times.resize(size);
+    t.values.resize((size_t)size * channels);
+    t.minq.resize(channels);
+    t.maxq.resize(channels);
+    t.sums.resize(channels);
+    t.sumn.resize(channels);
+  }
+  m_mean.resize(channels);
+  Clear();
+}
+
+void HistoryBuffer::Clear() {
+  for (Tier &t : m_tiers) {
+    t.added = 0;
+    t.count = 0;
+    t.pending = 0;
+    for (int c = 0; c < m_channels; c++) {
+      t.minq[c].clear();
+      t.maxq[c].clear();
+      t.sums[c] = 0;
+      t.sumn[c] = 0;
+    }
+  }
+}
+
+void HistoryBuffer::Add(time_t time, const double *values) {
+  const double *v = values;
+  for (size_t i = 0; i < m_tiers.size(); i++) {
+    AddToTier(i, time, v);
+    if (i + 1 == m_tiers.size()) break;
+
+    Tier &t = m_tiers[i];
+    for (int c = 0; c < m_channels; c++) {
+      if (std::isnan(v[c])) continue;
+      t.sums[c] += v[c];
+      t.sumn[c]++;
+    }
+    if (++t.pending < m_factor) break;
+
+    for (int c = 0; c < m_channels; c++) {
+      m_mean[c] = t.sumn[c] ? t.sums[c] / t.sumn[c] : NAN;
+      t.sums[c] = 0;
+      t.sumn[c] = 0;
+    }
+    t.pending = 0;
+    v = &m_mean[0];
+  }
+}
+
+void HistoryBuffer::AddToTier(int tier, time_t time, const double *values) {
+  Tier &t = m_tiers[tier];
+  long long seq = t.added;
+  if (t.count == m_size) {
+    long long dropped = seq - m_size;
+    for (int c = 0; c < m_channels; c++) {
+      if (!t.minq[c].empty() && t.minq[c].front() == dropped)
+        t.minq[c].pop_front();
+      if (!t.maxq[c].empty() && t.maxq[c].front() == dropped)
+        t.maxq[c].pop_front();
+    }
+  } else
+    t.count++;
+
+  int slot = seq % m_size;
+  t.times[slot] = time;
+  for (int c = 0; c < m_channels; c++)
+    t.values[(size_t)slot * m_channels + c] = values[c];
+  t.added++;
+
+  for (int c = 0; c < m_channels; c++) {
+    double v = values[c];
+    if (std::isnan(v)) continue;
+    std::deque<long long> &minq = t.minq[c];
+    while (!minq.empty() && Value(t, minq.back(), c) >= v) minq.pop_back();
+    minq.push_back(seq);
+    std::deque<long long> &maxq = t.maxq[c];
+    while (!maxq.empty() && Value(t, maxq.back(), c) <= v) maxq.pop_back();
+    maxq.push_back(seq);
+  }
+}
+
+int HistoryBuffer::GetCount(int tier) const { return m_tiers[tier].count; }
+
+double HistoryBuffer::GetValue(int channel, int idx, int tier) const {
+  const Tier &t = m_tiers[tier];
+  return Value(t, t.added - t.count + idx, channel);
+}
+
+time_t HistoryBuffer::GetTime(int idx, int tier) const {
+  const Tier &t = m_tiers[tier];
+  return t.times[(t.added - t.count + idx) % m_size];
+}
+
+double HistoryBuffer::GetMin(int channel, int tier) const {
+  const Tier &t = m_tiers[tier];
+  if (t.minq[channel].empty()) return NAN;
+  return Value(t, t.minq[channel].front(), channel);
+}
+
+double HistoryBuffer::GetMax(int channel, int tier) const {
+  const Tier &t = m_tiers[tier];
+  if (t.maxq[channel].empty()) return NAN;
+  return Value(t, t.maxq[channel].front(), channel);
+}
+
+bool HistoryBuffer::Save(const wxString &path) const {
+  //  Write aside and rename, so a crash never leaves half a history
+  wxString tmp = path + _T(".tmp");
+  wxFile file;
+  if (!file.Create(tmp, true)) return false;
+
+  bool ok = true;
+  auto put = [&file, &ok](const void *data, size_t len) {
+    if (ok) ok = file.Write(data, len) == len;
+  };
+  int header[5] = {kVersion, m_channels, m_size, (int)m_tiers.size(),
+                   m_factor};
+  put(kMagic, sizeof(kMagic));
+  put(header, sizeof(header));
+  for (const Tier &t : m_tiers) {
+    put(&t.count, sizeof(t.count));
+    put(&t.pending, sizeof(t.pending));
+    put(&t.sums[0], m_channels * sizeof(double));
+    put(&t.sumn[0], m_channels * sizeof(int));
+    for (int idx = 0; idx < t.count; idx++) {
+      long long seq = t.added - t.count + idx;
+      long long time = t.times[seq % m_size];
+      put(&time, sizeof(time));
+      put(&t.values[(seq % m_size) * m_channels], m_channels * sizeof(double));
+    }
+  }
+  ok = file.Close() && ok;
+  if (!ok) {
+    wxRemoveFile(tmp);
+    return false;
+  }
+  return wxRenameFile(tmp, path, true);
+}
+
+bool HistoryBuffer::Load(const wxString &path) {
+  if (!wxFileExists(path)) return false;
+  wxFile file;
+  if (!file.Open(path)) return false;
+
+  auto get = [&file](void *data, size_t len) {
+    return file.Read(data, len) == (ssize_t)len;
+  };
+  char magic[sizeof(kMagic)];
+  int header[5];
+  if (!get(magic, sizeof(magic)) || memcmp(magic, kMagic, sizeof(kMagic)) ||
+      !get(header, sizeof(header)) || header[0] != kVersion ||
+      header[1] != m_channels || header[2] != m_size ||
+      header[3] != (int)m_tiers.size() || header[4] != m_factor)
+    return false;
+
+  Clear();
+  for (size_t i = 0; i < m_tiers.size(); i++) {
+    Tier &t = m_tiers[i];
+    int count;
+    bool ok = get(&count, sizeof(count)) &&
+              get(&t.pending, sizeof(t.pending)) &&
+              get(&t.sums[0], m_channels * sizeof(double)) &&
+              get(&t.sumn[0], m_channels * sizeof(int)) && count >= 0 &&
+              count <= m_size && t.pending >= 0 && t.pending < m_factor;
+    for (int idx = 0; ok && idx < count; idx++) {
+      long long time;
+      ok = get(&time, sizeof(time)) &&
+           get(&m_mean[0], m_channels * sizeof(double));
+      if (ok) AddToTier(i, (time_t)time, &m_mean[0]);
+    }
+    if (!ok) {
+      Clear();
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Dashboard Plugin
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************
+ */
+
+#ifndef __HISTORY_BUFFER_H__
+#define __HISTORY_BUFFER_H__
+
+#include <time.h>
+#include <deque>
+#include <vector>
+
+#include <wx/string.h>
+
+/**
+ * The history of a few values sampled together, for the history
+ * instruments.  Each tier is a ring of fixed size: adding a sample costs the
+ * same however much history is kept, and the min and max of each value over
+ * a tier are kept up to date as samples come and go.
+ *
+ * Tier 0 holds the latest samples.  Each further tier holds the means of
+ * factor samples of the tier before, stamped with the time of the last of
+ * them, so it covers factor times as long.
+ */
+class HistoryBuffer {
+public:
+  HistoryBuffer(int channels, int size, int tiers = 3, int factor = 10);
+
+  /** Add a sample of all channels.  NaN values are kept but not averaged. */
+  void Add(time_t time, const double *values);
+  void Clear();
+
+  int GetTierCount() const { return m_tiers.size(); }
+  int GetSize() const { return m_size; }
+  /** Samples in tier, up to GetSize(). */
+  int GetCount(int tier = 0) const;
+  /** Sample idx of tier, 0 being the oldest. */
+  double GetValue(int channel, int idx, int tier = 0) const;
+  time_t GetTime(int idx, int tier = 0) const;
+  /** Min and max of channel over tier, NaN if it has no values. */
+  double GetMin(int channel, int tier = 0) const;
+  double GetMax(int channel, int tier = 0) const;
+
+  /** Restore a history saved with the same layout. */
+  bool Load(const wxString &path);
+  bool Save(const wxString &path) const;
+
+private:
+  struct Tier {
+    std::vector<time_t> times;
+    std::vector<double> values;  // channels per sample
+    long long added;             // samples ever added
+    int count;
+    // Samples which may still be the min or max, oldest first, with
+    // increasing (decreasing) values
+    std::vector<std::deque<long long> > minq, maxq;
+    // Samples being averaged into the next tier
+    int pending;
+    std::vector<double> sums;
+    std::vector<int> sumn;
+  };
+
+  void AddToTier(int tier, time_t time, const double *values);
+  double Value(const Tier &t, long long seq, int channel) const {
+    return t.values[(seq % m_size) * m_channels + channel];
+  }
+
+  int m_channels;
+  int m_size;
+  int m_factor;
+  std::vector<Tier> m_tiers;
+  std::vector<double> m_mean;  // the sample passed on to the next tier
+};
+
+#endif  // __HISTORY_BUFFER_H__
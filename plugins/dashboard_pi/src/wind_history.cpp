@@ -32,6 +32,8 @@
 #include <wx/wx.h>
 #endif  // precompiled headers
 
+#include <wx/filename.h>
+
 #include "wind_history.h"
 #include "wx28compat.h"
 
@@ -39,13 +41,27 @@
 #pragma hdrstop
 #endif
 
+// Channels of m_History
+enum { WH_DIR, WH_SPD, WH_SMOOTH_SPD, WH_SMOOTH_DIR, WH_COUNT };
+
+// Minutes between the time lines of each tier
+static const int kTimeLineMinutes[] = {10, 120, 1440};
+
+static wxString GetHistoryPath(const wxString& key) {
+  wxFileName fn;
+  fn.SetPath(*GetpPrivateApplicationDataLocation());
+  fn.SetFullName(_T("dashboard_wind_history_") + key + _T(".dat"));
+  return fn.GetFullPath();
+}
+
 //************************************************************************************************************************
 // History of wind direction
 //************************************************************************************************************************
 
 DashboardInstrument_WindDirHistory::DashboardInstrument_WindDirHistory(
-    wxWindow* parent, wxWindowID id, wxString title)
-    : DashboardInstrument(parent, id, title, OCPN_DBP_STC_TWD) {
+    wxWindow* parent, wxWindowID id, wxString title, wxString key)
+    : DashboardInstrument(parent, id, title, OCPN_DBP_STC_TWD),
+      m_History(WH_COUNT, WIND_RECORD_COUNT) {
   m_cap_flag.set(OCPN_DBP_STC_TWS);
   SetDrawSoloInPane(true);
   m_MaxWindDir = -1;
@@ -66,22 +82,40 @@ DashboardInstrument_WindDirHistory::DashboardInstrument_WindDirHistory(
   m_DirStartVal = -1;
   m_IsRunning = false;
   m_SetNewData = 0;
-  m_SampleCount = 0;
   m_LeftLegend = 3;
   m_RightLegend = 3;
-  for (int idx = 0; idx < WIND_RECORD_COUNT; idx++) {
-    m_ArrayWindDirHistory[idx] = -1;
-    m_ArrayWindSpdHistory[idx] = -1;
-    m_ExpSmoothArrayWindSpd[idx] = -1;
-    m_ExpSmoothArrayWindDir[idx] = -1;
-    m_ArrayRecTime[idx] = wxDateTime::Now().GetTm();
-    m_ArrayRecTime[idx].year = 999;
-  }
+  m_Tier = 0;
+  // carry on the history of the last run
+  m_HistoryPath = GetHistoryPath(key);
+  m_History.Load(m_HistoryPath);
+  UpdateMinMax();
   alpha = 0.01;  // smoothing constant
   m_WindowRect = GetClientRect();
   m_DrawAreaRect = GetClientRect();
   m_DrawAreaRect.SetHeight(m_WindowRect.height - m_TopLineHeight -
                            m_TitleHeight);
+  Connect(wxEVT_LEFT_DCLICK,
+          wxMouseEventHandler(DashboardInstrument_WindDirHistory::OnMouseDClick),
+          NULL, this);
+}
+
+DashboardInstrument_WindDirHistory::~DashboardInstrument_WindDirHistory(void) {
+  if (m_History.GetCount()) m_History.Save(m_HistoryPath);
+}
+
+void DashboardInstrument_WindDirHistory::SetHistoryKey(const wxString& key) {
+  wxString path = GetHistoryPath(key);
+  if (path == m_HistoryPath) return;
+  //  Saved under the new key when closed, the old file is stale
+  if (wxFileExists(m_HistoryPath)) wxRemoveFile(m_HistoryPath);
+  m_HistoryPath = path;
+}
+
+//  Show the next longer span of history, back to the shortest
+void DashboardInstrument_WindDirHistory::OnMouseDClick(wxMouseEvent& event) {
+  m_Tier = (m_Tier + 1) % m_History.GetTierCount();
+  UpdateMinMax();
+  Refresh();
 }
 
 wxSize DashboardInstrument_WindDirHistory::GetSize(int orient, wxSize hint) {
@@ -129,30 +163,15 @@ void DashboardInstrument_WindDirHistory::SetData(DASH_CAP st, double data,
       if (m_SpdRecCnt == 5 && m_DirRecCnt == 5) {
         m_WindSpd = m_SpdStartVal / 5;
         m_WindDir = m_DirStartVal / 5;
-        m_oldDirVal = m_WindDir;  // make sure we don't get a diff > or <180 in
-        // the initial run
+        // make sure we don't get a diff > or <180 in the initial run
+        int n = m_History.GetCount();
+        m_oldDirVal =
+            n ? m_History.GetValue(WH_SMOOTH_DIR, n - 1) : m_WindDir;
       }
       // start working after we collected 5 records each, as start values for the
       // smoothed curves
       if (m_SpdRecCnt > 5 && m_DirRecCnt > 5) {
         m_IsRunning = true;
-        m_SampleCount = m_SampleCount < WIND_RECORD_COUNT ? m_SampleCount + 1
-          : WIND_RECORD_COUNT;
-        m_MaxWindDir = 0;
-        m_MinWindDir = 360;
-        m_MaxWindSpd = 0;
-        // data shifting
-        for (int idx = 1; idx < WIND_RECORD_COUNT; idx++) {
-          if (WIND_RECORD_COUNT - m_SampleCount <= idx)
-            m_MinWindDir = wxMin(m_ArrayWindDirHistory[idx], m_MinWindDir);
-          m_MaxWindDir = wxMax(m_ArrayWindDirHistory[idx - 1], m_MaxWindDir);
-          m_MaxWindSpd = wxMax(m_ArrayWindSpdHistory[idx - 1], m_MaxWindSpd);
-          m_ArrayWindDirHistory[idx - 1] = m_ArrayWindDirHistory[idx];
-          m_ArrayWindSpdHistory[idx - 1] = m_ArrayWindSpdHistory[idx];
-          m_ExpSmoothArrayWindSpd[idx - 1] = m_ExpSmoothArrayWindSpd[idx];
-          m_ExpSmoothArrayWindDir[idx - 1] = m_ExpSmoothArrayWindDir[idx];
-          m_ArrayRecTime[idx - 1] = m_ArrayRecTime[idx];
-        }
         double diff = m_WindDir - m_oldDirVal;
         if (diff < -270) {
           m_WindDir += 360;
@@ -160,32 +179,25 @@ void DashboardInstrument_WindDirHistory::SetData(DASH_CAP st, double data,
         else if (diff > 270) {
           m_WindDir -= 360;
         }
-        m_ArrayWindDirHistory[WIND_RECORD_COUNT - 1] = m_WindDir;
-        m_ArrayWindSpdHistory[WIND_RECORD_COUNT - 1] = m_WindSpd;
-        if (m_SampleCount < 2) {
-          m_ArrayWindSpdHistory[WIND_RECORD_COUNT - 2] = m_WindSpd;
-          m_ExpSmoothArrayWindSpd[WIND_RECORD_COUNT - 2] = m_WindSpd;
-          m_ArrayWindDirHistory[WIND_RECORD_COUNT - 2] = m_WindDir;
-          m_ExpSmoothArrayWindDir[WIND_RECORD_COUNT - 2] = m_WindDir;
-        }
-        m_ExpSmoothArrayWindSpd[WIND_RECORD_COUNT - 1] =
-          alpha * m_ArrayWindSpdHistory[WIND_RECORD_COUNT - 2] +
-          (1 - alpha) * m_ExpSmoothArrayWindSpd[WIND_RECORD_COUNT - 2];
-        m_ExpSmoothArrayWindDir[WIND_RECORD_COUNT - 1] =
-          alpha * m_ArrayWindDirHistory[WIND_RECORD_COUNT - 2] +
-          (1 - alpha) * m_ExpSmoothArrayWindDir[WIND_RECORD_COUNT - 2];
-        m_ArrayRecTime[WIND_RECORD_COUNT - 1] = wxDateTime::Now().GetTm();
-        m_oldDirVal = m_ExpSmoothArrayWindDir[WIND_RECORD_COUNT - 1];
-        // include the new/latest value in the max/min value test too
-        m_MaxWindDir = wxMax(m_WindDir, m_MaxWindDir);
-        m_MinWindDir = wxMin(m_WindDir, m_MinWindDir);
-        m_MaxWindSpd = wxMax(m_WindSpd, m_MaxWindSpd);
+        // smooth on from the previous sample, or start at this one
+        int n = m_History.GetCount();
+        double lastDir = n ? m_History.GetValue(WH_DIR, n - 1) : m_WindDir;
+        double lastSpd = n ? m_History.GetValue(WH_SPD, n - 1) : m_WindSpd;
+        double lastSmoothDir =
+            n ? m_History.GetValue(WH_SMOOTH_DIR, n - 1) : m_WindDir;
+        double lastSmoothSpd =
+            n ? m_History.GetValue(WH_SMOOTH_SPD, n - 1) : m_WindSpd;
+        double sample[WH_COUNT];
+        sample[WH_DIR] = m_WindDir;
+        sample[WH_SPD] = m_WindSpd;
+        sample[WH_SMOOTH_SPD] = alpha * lastSpd + (1 - alpha) * lastSmoothSpd;
+        sample[WH_SMOOTH_DIR] = alpha * lastDir + (1 - alpha) * lastSmoothDir;
+        m_History.Add(wxDateTime::Now().GetTicks(), sample);
+        m_oldDirVal = sample[WH_SMOOTH_DIR];
         // get the overall max Wind Speed
         m_TotalMaxWindSpd = wxMax(m_WindSpd, m_TotalMaxWindSpd);
 
-        // set wind angle scale to full +/- 90 degr depending on the real max/min
-        // value recorded
-        SetMinMaxWindScale();
+        UpdateMinMax();
         // Wait two times until new data.
         m_SetNewData = 2;
       }
@@ -207,17 +219,9 @@ void DashboardInstrument_WindDirHistory::ResetData() {
   m_DirStartVal = -1;
   m_IsRunning = false;
   m_SetNewData = 0;
-  m_SampleCount = 0;
   m_LeftLegend = 3;
   m_RightLegend = 3;
-  for (int idx = 0; idx < WIND_RECORD_COUNT; idx++) {
-    m_ArrayWindDirHistory[idx] = -1;
-    m_ArrayWindSpdHistory[idx] = -1;
-    m_ExpSmoothArrayWindSpd[idx] = -1;
-    m_ExpSmoothArrayWindDir[idx] = -1;
-    m_ArrayRecTime[idx] = wxDateTime::Now().GetTm();
-    m_ArrayRecTime[idx].year = 999;
-  }
+  m_History.Clear();
 }
 
 void DashboardInstrument_WindDirHistory::Draw(wxGCDC* dc) {
@@ -230,6 +234,26 @@ void DashboardInstrument_WindDirHistory::Draw(wxGCDC* dc) {
   DrawForeground(dc);
 }
 
+//*********************************************************************************
+// min and max values of the history shown, kept by m_History
+//*********************************************************************************
+void DashboardInstrument_WindDirHistory::UpdateMinMax() {
+  if (!m_History.GetCount(m_Tier)) {
+    m_MaxWindDir = -1;
+    m_MinWindDir = 0;
+    m_WindDirRange = 90;
+    m_MaxWindSpd = 0;
+    return;
+  }
+  m_MaxWindDir = m_History.GetMax(WH_DIR, m_Tier);
+  m_MinWindDir = m_History.GetMin(WH_DIR, m_Tier);
+  m_MaxWindSpd = m_History.GetMax(WH_SPD, m_Tier);
+  if (std::isnan(m_MaxWindSpd)) m_MaxWindSpd = 0;
+  // set wind angle scale to full +/- 90 degr depending on the real max/min
+  // value recorded
+  SetMinMaxWindScale();
+}
+
 //*********************************************************************************
 // determine and set  min and max values for the direction
 //*********************************************************************************
@@ -562,19 +586,19 @@ void DashboardInstrument_WindDirHistory::DrawForeground(wxGCDC* dc) {
   //---------------------------------------------------------------------------------
   // live direction data
   //---------------------------------------------------------------------------------
+  // the samples are drawn right aligned, the latest at the right edge
+  int count = m_History.GetCount(m_Tier);
+  int first = WIND_RECORD_COUNT - count;
   wxPoint points[WIND_RECORD_COUNT + 2];
   wxPoint wdDraw[WIND_RECORD_COUNT + 2];
   int ld = 0;
-  wdDraw[ld].x = m_ratioW + 3 + m_LeftLegend;
-  wdDraw[ld].y = m_TopLineHeight + m_DrawAreaRect.height -
-    (m_ArrayWindDirHistory[1] - m_MinWindDir) * ratioH;
 
-  for (int idx = 1; idx < WIND_RECORD_COUNT; idx++) {
+  for (int idx = wxMax(first, 1); idx < WIND_RECORD_COUNT; idx++) {
     points[idx].x = idx * m_ratioW + 3 + m_LeftLegend;
     points[idx].y = m_TopLineHeight + m_DrawAreaRect.height -
-                    (m_ArrayWindDirHistory[idx] - m_MinWindDir) * ratioH;
-    if (WIND_RECORD_COUNT - m_SampleCount <= idx &&
-                 points[idx].y > m_TopLineHeight &&
+                    (m_History.GetValue(WH_DIR, idx - first, m_Tier) -
+                     m_MinWindDir) * ratioH;
+    if (points[idx].y > m_TopLineHeight &&
                  points[idx].y <= m_TopLineHeight + m_DrawAreaRect.height) {
       wdDraw[ld] = points[idx];
       ld++;
@@ -592,16 +616,12 @@ void DashboardInstrument_WindDirHistory::DrawForeground(wxGCDC* dc) {
   dc->SetPen(pen);
 
   ld = 0;
-  wdDraw[ld].x = m_ratioW + 3 + m_LeftLegend;
-  wdDraw[ld].y = m_TopLineHeight + m_DrawAreaRect.height -
-    (m_ExpSmoothArrayWindDir[ld] - m_MinWindDir) * ratioH;
-
-  for (int idx = 1; idx < WIND_RECORD_COUNT; idx++) {
+  for (int idx = wxMax(first, 1); idx < WIND_RECORD_COUNT; idx++) {
     points[idx].x = idx * m_ratioW + 3 + m_LeftLegend;
     points[idx].y = m_TopLineHeight + m_DrawAreaRect.height -
-                    (m_ExpSmoothArrayWindDir[idx] - m_MinWindDir) * ratioH;
-    if (WIND_RECORD_COUNT - m_SampleCount <= idx &&
-      points[idx].y > m_TopLineHeight &&
+                    (m_History.GetValue(WH_SMOOTH_DIR, idx - first, m_Tier) -
+                     m_MinWindDir) * ratioH;
+    if (points[idx].y > m_TopLineHeight &&
       points[idx].y <= m_TopLineHeight + m_DrawAreaRect.height) {
       wdDraw[ld] = points[idx];
       ld++;
@@ -628,13 +648,11 @@ void DashboardInstrument_WindDirHistory::DrawForeground(wxGCDC* dc) {
   int labelw, labelh;
   dc->GetTextExtent(WindSpeed, &labelw, &labelh, 0, 0, g_pFontLabel);
   // determine the time range of the available data (=oldest data value)
-  int i = 0;
-  while (m_ArrayRecTime[i].year == 999 && i < WIND_RECORD_COUNT - 1) i++;
-  if (i == WIND_RECORD_COUNT - 1) {
+  if (count < 2) {
     min = 0;
     hour = 0;
   } else {
-    wxDateTime localTime(m_ArrayRecTime[i]);
+    wxDateTime localTime(m_History.GetTime(0, m_Tier));
     min = localTime.GetMinute();
     hour = localTime.GetHour();
   }
@@ -656,16 +674,12 @@ void DashboardInstrument_WindDirHistory::DrawForeground(wxGCDC* dc) {
   //---------------------------------------------------------------------------------
 
   int ls = 0;
-  spdDraw[ls].x = 1 * m_ratioW + 3 + m_LeftLegend;
-  spdDraw[ls].y = m_TopLineHeight + m_DrawAreaRect.height -
-                      m_ArrayWindSpdHistory[1] * ratioH;
-
-  for (int idx = 1; idx < WIND_RECORD_COUNT; idx++) {
+  for (int idx = wxMax(first, 1); idx < WIND_RECORD_COUNT; idx++) {
     pointsSpd[idx].x = idx * m_ratioW + 3 + m_LeftLegend;
-    pointsSpd[idx].y = m_TopLineHeight + m_DrawAreaRect.height -
-                       m_ArrayWindSpdHistory[idx] * ratioH;
-    if (WIND_RECORD_COUNT - m_SampleCount <= idx &&
-      pointsSpd[idx].y > m_TopLineHeight &&
+    pointsSpd[idx].y =
+        m_TopLineHeight + m_DrawAreaRect.height -
+        m_History.GetValue(WH_SPD, idx - first, m_Tier) * ratioH;
+    if (pointsSpd[idx].y > m_TopLineHeight &&
       pointsSpd[idx].y <= m_TopLineHeight + m_DrawAreaRect.height) {
       spdDraw[ls] = pointsSpd[idx];
       ls++;
@@ -682,16 +696,12 @@ void DashboardInstrument_WindDirHistory::DrawForeground(wxGCDC* dc) {
   pen.SetWidth(2);
   dc->SetPen(pen);
   ls = 0;
-  spdDraw[ls].x = 1 * m_ratioW + 3 + m_LeftLegend;
-  spdDraw[ls].y = m_TopLineHeight + m_DrawAreaRect.height -
-                 m_ExpSmoothArrayWindSpd[1] * ratioH;
-
-  for (int idx = 1; idx < WIND_RECORD_COUNT; idx++) {
+  for (int idx = wxMax(first, 1); idx < WIND_RECORD_COUNT; idx++) {
     pointsSpd[idx].x = idx * m_ratioW + 3 + m_LeftLegend;
-    pointsSpd[idx].y = m_TopLineHeight + m_DrawAreaRect.height -
-                       m_ExpSmoothArrayWindSpd[idx] * ratioH;
-    if (WIND_RECORD_COUNT - m_SampleCount <= idx &&
-      pointsSpd[idx].y > m_TopLineHeight &&
+    pointsSpd[idx].y =
+        m_TopLineHeight + m_DrawAreaRect.height -
+        m_History.GetValue(WH_SMOOTH_SPD, idx - first, m_Tier) * ratioH;
+    if (pointsSpd[idx].y > m_TopLineHeight &&
       pointsSpd[idx].y <= m_TopLineHeight + m_DrawAreaRect.height) {
       spdDraw[ls] = pointsSpd[idx];
       ls++;
@@ -701,7 +711,8 @@ void DashboardInstrument_WindDirHistory::DrawForeground(wxGCDC* dc) {
     dc->DrawLines(ls, spdDraw);
 
   //---------------------------------------------------------------------------------
-  // draw vertical timelines every 10 minutes
+  // draw vertical timelines every 10 minutes, less often for the longer
+  // spans
   //---------------------------------------------------------------------------------
   GetGlobalColor(_T("DASHL"), &col);
   pen.SetColour(col);
@@ -709,23 +720,28 @@ void DashboardInstrument_WindDirHistory::DrawForeground(wxGCDC* dc) {
   dc->SetPen(pen);
   dc->SetTextForeground(col);
   dc->SetFont(*g_pFontSmall);
+  int interval = kTimeLineMinutes[wxMin(m_Tier, 2)];
   int done = -1;
   wxPoint pointTime;
-  for (int idx = 0; idx < WIND_RECORD_COUNT; idx++) {
-    if (m_ArrayRecTime[idx].year != 999) {
-      wxDateTime localTime(m_ArrayRecTime[idx]);
-      hour = localTime.GetHour();
-      min = localTime.GetMinute();
-      if ((hour * 100 + min) != done && (min % 10 == 0)) {
-        pointTime.x = idx * m_ratioW + 3 + m_LeftLegend;
-        dc->DrawLine(pointTime.x, m_TopLineHeight + 1, pointTime.x,
-                     (m_TopLineHeight + m_DrawAreaRect.height + 1));
-        label.Printf(_T("%02d:%02d"), hour, min);
-        dc->GetTextExtent(label, &width, &height, 0, 0, g_pFontSmall);
-        dc->DrawText(label, pointTime.x - width / 2,
-                     m_WindowRect.height - height);
-        done = hour * 100 + min;
-      }
+  for (int idx = first; idx < WIND_RECORD_COUNT; idx++) {
+    wxDateTime localTime(m_History.GetTime(idx - first, m_Tier));
+    hour = localTime.GetHour();
+    min = localTime.GetMinute();
+    int line = (localTime.GetDay() * 1440 + hour * 60 + min) / interval;
+    if (done != -1 && line != done) {
+      pointTime.x = idx * m_ratioW + 3 + m_LeftLegend;
+      dc->DrawLine(pointTime.x, m_TopLineHeight + 1, pointTime.x,
+                   (m_TopLineHeight + m_DrawAreaRect.height + 1));
+      int minutes = line * interval % 1440;
+      if (interval < 1440)
+        label.Printf(_T("%02d:%02d"), minutes / 60, minutes % 60);
+      else
+        label = wxDateTime::GetWeekDayName(localTime.GetWeekDay(),
+                                           wxDateTime::Name_Abbr);
+      dc->GetTextExtent(label, &width, &height, 0, 0, g_pFontSmall);
+      dc->DrawText(label, pointTime.x - width / 2,
+                   m_WindowRect.height - height);
     }
+    done = line;
   }
 }
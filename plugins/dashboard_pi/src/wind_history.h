@@ -46,12 +46,17 @@
 
 #include "instrument.h"
 #include "dial.h"
+#include "history_buffer.h"
 
 class DashboardInstrument_WindDirHistory : public DashboardInstrument {
 public:
+  /** key tells the instances apart, to keep their histories across runs. */
   DashboardInstrument_WindDirHistory(wxWindow* parent, wxWindowID id,
-                                     wxString title);
-  ~DashboardInstrument_WindDirHistory(void) {}
+                                     wxString title, wxString key);
+  ~DashboardInstrument_WindDirHistory(void);
+
+  /** The dashboard was renamed: keep the history under the new key. */
+  void SetHistoryKey(const wxString& key);
   void SetData(DASH_CAP, double, wxString);
   wxSize GetSize(int orient, wxSize hint);
 
@@ -63,11 +68,11 @@ private:
 
 protected:
   double alpha;
-  double m_ArrayWindDirHistory[WIND_RECORD_COUNT];
-  double m_ArrayWindSpdHistory[WIND_RECORD_COUNT];
-  double m_ExpSmoothArrayWindSpd[WIND_RECORD_COUNT];
-  double m_ExpSmoothArrayWindDir[WIND_RECORD_COUNT];
-  wxDateTime::Tm m_ArrayRecTime[WIND_RECORD_COUNT];
+  // direction, speed and their smoothed values; the longer tiers are shown
+  // by double clicking
+  HistoryBuffer m_History;
+  int m_Tier;  // of m_History shown
+  wxString m_HistoryPath;
 
   double m_MaxWindDir;
   double m_MinWindDir;
@@ -80,7 +85,6 @@ protected:
   double m_ratioW;
   double m_oldDirVal;
   bool m_IsRunning;
-  int m_SampleCount;
   wxString m_WindSpeedUnit;
   int m_SetNewData;        // No need for data every second
 
@@ -96,6 +100,8 @@ protected:
   void DrawBackground(wxGCDC* dc);
   void DrawForeground(wxGCDC* dc);
   void SetMinMaxWindScale();
+  void UpdateMinMax();
+  void OnMouseDClick(wxMouseEvent& event);
   void DrawWindDirScale(wxGCDC* dc);
   void DrawWindSpeedScale(wxGCDC* dc);
   void ResetData();
@@ -93,6 +93,20 @@ static bool PointInLLBox(PlugIn_ViewPort *vp, double x, double y) {
   return TRUE;
 }
 
+//  Positions of the points of the screen column x, from y0 to below y1
+//  every step, so the grib is interpolated at all of them at once.
+static void GetColumnLL(PlugIn_ViewPort *vp, int x, int y0, int y1, int step,
+                        std::vector<double> &lat, std::vector<double> &lon) {
+  lat.clear();
+  lon.clear();
+  for (int y = y0; y < y1; y += step) {
+    double plat, plon;
+    GetCanvasLLPix(vp, wxPoint(x, y), &plat, &plon);
+    lat.push_back(plat);
+    lon.push_back(plon);
+  }
+}
+
 #if 0
 static wxString MToString( int DataCenterModel )
 {
@@ -886,17 +900,19 @@ wxImage GRIBOverlayFactory::CreateGribImage(int settings, GribRecord *pGR,
   wxImage gr_image(width, height);
   gr_image.InitAlpha();
 
-  wxPoint p;
+  GribGridSampler sampler(pGR);
+  std::vector<double> lat, lon, values;
   for (int ipix = 0; ipix < (width - grib_pixel_size + 1);
        ipix += grib_pixel_size) {
-    for (int jpix = 0; jpix < (height - grib_pixel_size + 1);
-         jpix += grib_pixel_size) {
-      double lat, lon;
-      p.x = ipix + porg.x;
-      p.y = jpix + porg.y;
-      GetCanvasLLPix(vp, p, &lat, &lon);
-
-      double v = pGR->getInterpolatedValue(lon, lat);
+    GetColumnLL(vp, ipix + porg.x, porg.y,
+                porg.y + height - grib_pixel_size + 1, grib_pixel_size, lat,
+                lon);
+    values.resize(lat.size());
+    sampler.getValues(lat.size(), lon.data(), lat.data(), values.data());
+
+    for (int k = 0, jpix = 0; k < (int)values.size();
+         k++, jpix += grib_pixel_size) {
+      double v = values[k];
       if (v != GRIB_NOTDEF) {
         v = m_Settings.CalibrateValue(settings, v);
         wxColour c = GetGraphicColor(settings, v);
@@ -1255,17 +1271,21 @@ void GRIBOverlayFactory::RenderGribBarbedArrows(int settings, GribRecord **pGR,
 
     int arrowSize = 16;
 
+    GribGridSampler sampler(pGRX, pGRY);
+    std::vector<double> lat, lon, vkn, ang;
     for (int i = 0; i < m_ParentSize.GetWidth(); i += (space + arrowSize)) {
-      for (int j = 0; j < m_ParentSize.GetHeight(); j += (space + arrowSize)) {
-        double lat, lon;
-        GetCanvasLLPix(vp, wxPoint(i, j), &lat, &lon);
-
-        double vkn, ang;
-        if (GribRecord::getInterpolatedValues(vkn, ang, pGRX, pGRY, lon, lat))
-          drawWindArrowWithBarbs(settings, i, j, vkn * 3.6 / 1.852,
-                                 (ang - 90) * M_PI / 180, (lat < 0.), colour,
-                                 vp->rotation);
-      }
+      GetColumnLL(vp, i, 0, m_ParentSize.GetHeight(), space + arrowSize, lat,
+                  lon);
+      vkn.resize(lat.size());
+      ang.resize(lat.size());
+      sampler.getVectors(lat.size(), lon.data(), lat.data(), vkn.data(),
+                         ang.data());
+
+      for (int k = 0, j = 0; k < (int)lat.size(); k++, j += space + arrowSize)
+        if (vkn[k] != GRIB_NOTDEF)
+          drawWindArrowWithBarbs(settings, i, j, vkn[k] * 3.6 / 1.852,
+                                 (ang[k] - 90) * M_PI / 180, (lat[k] < 0.),
+                                 colour, vp->rotation);
     }
   } else {
     // set minimum spacing between arrows
@@ -1424,6 +1444,9 @@ void GRIBOverlayFactory::RenderGribIsobar(int settings, GribRecord **pGR,
 }
 
 void GRIBOverlayFactory::FillGrid(GribRecord *pGR) {
+  //    The record may be one of the file, read by the timeline prefetch
+  std::unique_lock<std::shared_timed_mutex> lock(GribRecord::dataMutex);
+
   //    Get the the grid
   int imax = pGR->getNi();  // Longitude
   int jmax = pGR->getNj();  // Latitude
@@ -1524,23 +1547,29 @@ void GRIBOverlayFactory::RenderGribDirectionArrows(int settings,
     // Set spacing between arrows
     int space = adjustSpacing(m_Settings.Settings[settings].m_iDirArrSpacing);
 
+    GribGridSampler sampler(pGRX, pGRY), xsampler(pGRX), ysampler(pGRY);
+    std::vector<double> lat, lon, shs, dirs;
     for (int i = 0; i < m_ParentSize.GetWidth(); i += (space + arrowSize)) {
-      for (int j = 0; j < m_ParentSize.GetHeight(); j += (space + arrowSize)) {
-        double lat, lon, sh, dir;
+      GetColumnLL(vp, i, 0, m_ParentSize.GetHeight(), space + arrowSize, lat,
+                  lon);
+      shs.resize(lat.size());
+      dirs.resize(lat.size());
+      if (polar) {  // wave arrows
+        xsampler.getValues(lat.size(), lon.data(), lat.data(), shs.data(),
+                           true);
+        ysampler.getValues(lat.size(), lon.data(), lat.data(), dirs.data(),
+                           true, true);
+      } else  // current arrows
+        sampler.getVectors(lat.size(), lon.data(), lat.data(), shs.data(),
+                           dirs.data());
+
+      for (int k = 0, j = 0; k < (int)lat.size(); k++, j += space + arrowSize) {
+        double sh = shs[k], dir = dirs[k];
         double scale = 1.0;
-        GetCanvasLLPix(vp, wxPoint(i, j), &lat, &lon);
 
-        if (polar) {  // wave arrows
-          sh = pGRX->getInterpolatedValue(lon, lat, true);
-          dir = pGRY->getInterpolatedValue(lon, lat, true, true);
+        if (dir == GRIB_NOTDEF || sh == GRIB_NOTDEF) continue;
 
-          if (dir == GRIB_NOTDEF || sh == GRIB_NOTDEF) continue;
-
-        } else {  // current arrows
-          if (!GribRecord::getInterpolatedValues(sh, dir, pGRX, pGRY, lon, lat))
-            continue;
-          scale = wxMax(1.0, sh);  // Size depends on magnitude.
-        }
+        if (!polar) scale = wxMax(1.0, sh);  // Size depends on magnitude.
 
         dir = (dir - 90) * M_PI / 180.;
 
@@ -1804,13 +1833,18 @@ void GRIBOverlayFactory::RenderGribNumbers(int settings, GribRecord **pGR,
       pbr.x = m_ParentSize.GetWidth();
     }
 
+    GribGridSampler sampler(pGRA);
+    std::vector<double> lat, lon, vals;
+    int j0 = wxMax(ptl.y, 0);
     for (int i = wxMax(ptl.x, 0); i < wxMin(pbr.x, m_ParentSize.GetWidth());
          i += (space + wstring)) {
-      for (int j = wxMax(ptl.y, 0); j < wxMin(pbr.y, m_ParentSize.GetHeight());
-           j += (space + wstring)) {
-        double lat, lon, val;
-        GetCanvasLLPix(vp, wxPoint(i, j), &lat, &lon);
-        val = pGRA->getInterpolatedValue(lon, lat, true);
+      GetColumnLL(vp, i, j0, wxMin(pbr.y, m_ParentSize.GetHeight()),
+                  space + wstring, lat, lon);
+      vals.resize(lat.size());
+      sampler.getValues(lat.size(), lon.data(), lat.data(), vals.data(), true);
+
+      for (int k = 0, j = j0; k < (int)lat.size(); k++, j += space + wstring) {
+        double val = vals[k];
         if (val != GRIB_NOTDEF) {
           double value = m_Settings.CalibrateValue(settings, val);
           wxColour back_color = GetGraphicColor(settings, value);
@@ -2058,8 +2092,14 @@ void GRIBOverlayFactory::RenderGribParticles(int settings, GribRecord **pGR,
 
   double ptime = 0;
 
+  GribGridSampler sampler(pGRX, pGRY);
+
   // update particle map
   if (m_bUpdateParticles) {
+    // first move the particles along their history, and gather the
+    // positions to advance from, to interpolate them all at once
+    std::vector<unsigned int> moved;
+    std::vector<double> lon, lat;
     for (unsigned int i = 0; i < particles.size(); i++) {
       Particle &it = particles[i];
 
@@ -2084,14 +2124,29 @@ void GRIBOverlayFactory::RenderGribParticles(int settings, GribRecord **pGR,
 
       if (++it.m_HistoryPos >= history_size) it.m_HistoryPos = 0;
 
+      if (it.m_Duration < max_duration - history_size) {
+        // particles are only ever moved down from the end, which is not
+        // reached yet, so the index stays valid
+        moved.push_back(i);
+        lon.push_back(pp[0]);
+        lat.push_back(pp[1]);
+      } else
+        it.m_History[it.m_HistoryPos].m_Pos[0] = -10000;
+    }
+
+    std::vector<double> vkns(moved.size()), angs(moved.size());
+    sampler.getVectors(moved.size(), lon.data(), lat.data(), vkns.data(),
+                       angs.data());
+
+    for (unsigned int k = 0; k < moved.size(); k++) {
+      Particle &it = particles[moved[k]];
+      double pp[2] = {lon[k], lat[k]};
+
       Particle::ParticleNode &n = it.m_History[it.m_HistoryPos];
       float(&p)[2] = n.m_Pos;
-      double vkn = 0, ang;
+      double vkn = vkns[k], ang = angs[k];
 
-      if (it.m_Duration < max_duration - history_size &&
-          GribRecord::getInterpolatedValues(vkn, ang, pGRX, pGRY, pp[0],
-                                            pp[1]) &&
-          vkn > 0 && vkn < 100) {
+      if (vkn != GRIB_NOTDEF && vkn > 0 && vkn < 100) {
         vkn = m_Settings.CalibrateValue(settings, vkn);
         double d;
         if (settings == GribOverlaySettings::CURRENT)
@@ -2166,8 +2221,7 @@ void GRIBOverlayFactory::RenderGribParticles(int settings, GribRecord **pGR,
           (float)rand() / RAND_MAX * (pGRX->getLatMax() - pGRX->getLatMin()) +
           pGRX->getLatMin();
 
-      if (GribRecord::getInterpolatedValues(vkn, ang, pGRX, pGRY, p[0], p[1]) &&
-          vkn > 0 && vkn < 100)
+      if (sampler.getVector(vkn, ang, p[0], p[1]) && vkn > 0 && vkn < 100)
         vkn = m_Settings.CalibrateValue(settings, vkn);
       else
         continue;  // try again
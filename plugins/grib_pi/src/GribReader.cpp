@@ -22,10 +22,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "wx/wx.h"
 #endif  // precompiled headers
 
+#include <wx/filename.h>
+
 #include "GribReader.h"
 #include "GribV1Record.h"
 #include "GribV2Record.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <thread>
 
 //-------------------------------------------------------------------------------
 GribReader::GribReader() {
@@ -281,6 +286,41 @@ void GribReader::readAllGribRecords() {
   delete prevDataSet;
 }
 
+//---------------------------------------------------------------------------------
+// Records are read with their data still packed, so that the many records
+// not stored above are dropped without unpacking them.  Unpack the stored
+// ones now, on all cores, and drop those which fail.
+void GribReader::decodeAllGribRecords() {
+  std::vector<GribRecord *> records;
+  std::map<std::string, std::vector<GribRecord *> *>::iterator it;
+  for (it = mapGribRecords.begin(); it != mapGribRecords.end(); it++)
+    records.insert(records.end(), it->second->begin(), it->second->end());
+  if (records.empty()) return;
+
+  std::atomic<size_t> next(0);
+  auto decode = [&records, &next]() {
+    for (size_t i = next++; i < records.size(); i = next++)
+      records[i]->decodeData();
+  };
+  size_t n_threads = std::max(1u, std::thread::hardware_concurrency());
+  n_threads = std::min(n_threads, records.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < n_threads; i++) threads.emplace_back(decode);
+  decode();
+  for (auto &t : threads) t.join();
+
+  for (it = mapGribRecords.begin(); it != mapGribRecords.end(); it++) {
+    std::vector<GribRecord *> *ls = it->second;
+    ls->erase(std::remove_if(ls->begin(), ls->end(),
+                             [](GribRecord *rec) {
+                               if (rec->isOk()) return false;
+                               delete rec;
+                               return true;
+                             }),
+              ls->end());
+  }
+}
+
 //---------------------------------------------------------------------------------
 void GribReader::copyFirstCumulativeRecord(int dataType, int levelType,
                                            int levelValue) {
@@ -416,10 +456,64 @@ void GribReader::copyMissingWaveRecords() {
   copyMissingWaveRecords(GRB_PER, LV_GND_SURF, 0);
 }
 
+//---------------------------------------------------------------------------------
+// Seeking back in a compressed file decompresses it again from the start,
+// and reading seeks back whenever a record is tried as the wrong GRIB
+// edition.  Decompress such files once, to a temporary file which is read
+// instead.
+static ZUFILE *openUncompressedCopy(ZUFILE *file, wxString &tmpName) {
+  tmpName = wxFileName::CreateTempFileName(_T("grib"));
+  if (tmpName.IsEmpty()) return NULL;
+
+  FILE *out = fopen((const char *)tmpName.mb_str(), "wb");
+  bool ok = out != NULL;
+  long total = 0;
+  if (ok) {
+    std::vector<char> buf(ZU_BUFREADSIZE);
+    int nb;
+    while ((nb = zu_read(file, buf.data(), buf.size())) > 0) {
+      if (fwrite(buf.data(), 1, nb, out) != (size_t)nb) {
+        ok = false;
+        break;
+      }
+      total += nb;
+    }
+    if (fclose(out) != 0) ok = false;
+  }
+
+  ZUFILE *copy = NULL;
+  if (ok && total > 0)
+    copy = zu_open((const char *)tmpName.mb_str(), "rb", ZU_COMPRESS_NONE);
+  if (copy == NULL) {
+    wxRemoveFile(tmpName);
+    tmpName.Clear();
+  }
+  return copy;
+}
+
 //---------------------------------------------------------------------------------
 void GribReader::readGribFileContent() {
   fileSize = zu_filesize(file);
+
+  wxString tmpName;
+  if (file->type != ZU_COMPRESS_NONE) {
+    ZUFILE *copy = openUncompressedCopy(file, tmpName);
+    if (copy != NULL) {
+      zu_close(file);
+      file = copy;
+    } else {
+      zu_rewind(file);
+    }
+  }
+
   readAllGribRecords();
+  decodeAllGribRecords();
+
+  if (!tmpName.IsEmpty()) {
+    zu_close(file);
+    file = NULL;
+    wxRemoveFile(tmpName);
+  }
 
   createListDates();
   //    hoursBetweenRecords = computeHoursBeetweenGribRecords();
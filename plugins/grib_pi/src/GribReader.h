@@ -113,6 +113,7 @@ private:
 
   void readGribFileContent();
   void readAllGribRecords();
+  void decodeAllGribRecords();
   void createListDates();
   double computeHoursBeetweenGribRecords();
   std::set<time_t> setAllDates;
@@ -25,6 +25,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //#include "cutil.h"
 #include <stdlib.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 //#include <QDateTime>
 
 #include "GribRecord.h"
@@ -41,6 +49,110 @@ static double interp_angle(double a0, double a1, double d, double p) {
   return a;
 }
 
+// The threads splitting large grids, started once and kept.
+class GribRowPool {
+public:
+  static GribRowPool &Get() {
+    static GribRowPool pool;
+    return pool;
+  }
+
+  // Threads available, counting the caller.
+  long Size() const { return (long)m_threads.size() + 1; }
+
+  // Call part(1) ... part(n - 1) on the pool and part(0) on this thread,
+  // and wait for all of them.
+  void Run(long n, const std::function<void(long)> &part);
+
+private:
+  struct Batch {
+    const std::function<void(long)> *part;
+    long pending;
+  };
+
+  GribRowPool();
+  ~GribRowPool();
+  void Worker();
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond, m_done;
+  std::deque<std::pair<Batch *, long> > m_jobs;
+  std::vector<std::thread> m_threads;
+  bool m_stop;
+};
+
+GribRowPool::GribRowPool() : m_stop(false) {
+  long n = std::max(1u, std::thread::hardware_concurrency());
+  for (long i = 1; i < n; i++)
+    m_threads.emplace_back(&GribRowPool::Worker, this);
+}
+
+GribRowPool::~GribRowPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cond.notify_all();
+  for (auto &thread : m_threads) thread.join();
+}
+
+void GribRowPool::Run(long n, const std::function<void(long)> &part) {
+  Batch batch = {&part, n - 1};
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (long i = 1; i < n; i++) m_jobs.emplace_back(&batch, i);
+  }
+  m_cond.notify_all();
+  part(0);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [&batch] { return batch.pending == 0; });
+}
+
+void GribRowPool::Worker() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cond.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+    if (m_stop) return;
+
+    std::pair<Batch *, long> job = m_jobs.front();
+    m_jobs.pop_front();
+
+    lock.unlock();
+    (*job.first->part)(job.second);
+    lock.lock();
+    if (--job.first->pending == 0) m_done.notify_all();
+  }
+}
+
+// Call rows(j0, j1) for the rows of an Ni x Nj grid, split over the row
+// pool when the grid is large enough for the threads to pay.
+template <typename F>
+static void ForEachRows(int Ni, int Nj, F rows) {
+  const long kMinPoints = 1 << 16;  // per thread
+  long n = std::min((long)Ni * Nj / kMinPoints, (long)Nj);
+  if (n > 1) n = std::min(n, GribRowPool::Get().Size());
+  if (n <= 1) {
+    rows(0, Nj);
+    return;
+  }
+  GribRowPool::Get().Run(
+      n, [&](long t) { rows((int)(Nj * t / n), (int)(Nj * (t + 1) / n)); });
+}
+
+// One row of a time interpolation, over contiguous points so that the
+// compiler can vectorize it.
+static void InterpolateRow(double *out, const double *r1, const double *r2,
+                           int n, double d) {
+  for (int i = 0; i < n; i++) {
+    double a = r1[i], b = r2[i];
+    out[i] = (a == GRIB_NOTDEF || b == GRIB_NOTDEF) ? GRIB_NOTDEF
+                                                    : (1 - d) * a + d * b;
+  }
+}
+
+std::shared_timed_mutex GribRecord::dataMutex;
+
 //-------------------------------------------------------------------------------
 void GribRecord::print() {
   printf(
@@ -173,30 +285,39 @@ GribRecord *GribRecord::InterpolatedRecord(const GribRecord &rec1,
   if (rec1.BMSbits != NULL && rec2.BMSbits != NULL)
     BMSbits = new zuchar[(Ni * Nj - 1) / 8 + 1]();
 
-  for (int i = 0; i < Ni; i++)
-    for (int j = 0; j < Nj; j++) {
-      int in = j * Ni + i;
-      int i1 = (j * jm1 + rec1offj) * rec1.Ni + i * im1 + rec1offi;
-      int i2 = (j * jm2 + rec2offj) * rec2.Ni + i * im2 + rec2offi;
-      double data1 = rec1.data[i1], data2 = rec2.data[i2];
-      if (data1 == GRIB_NOTDEF || data2 == GRIB_NOTDEF)
-        data[in] = GRIB_NOTDEF;
-      else {
-        if (!dir)
-          data[in] = (1 - d) * data1 + d * data2;
+  ForEachRows(Ni, Nj, [&](int j0, int j1) {
+    for (int j = j0; j < j1; j++) {
+      const double *r1 = rec1.data + (j * jm1 + rec1offj) * rec1.Ni + rec1offi;
+      const double *r2 = rec2.data + (j * jm2 + rec2offj) * rec2.Ni + rec2offi;
+      double *out = data + j * Ni;
+      if (!dir && im1 == 1 && im2 == 1) {
+        InterpolateRow(out, r1, r2, Ni, d);
+        continue;
+      }
+      for (int i = 0; i < Ni; i++) {
+        double data1 = r1[i * im1], data2 = r2[i * im2];
+        if (data1 == GRIB_NOTDEF || data2 == GRIB_NOTDEF)
+          out[i] = GRIB_NOTDEF;
+        else if (!dir)
+          out[i] = (1 - d) * data1 + d * data2;
         else
-          data[in] = interp_angle(data1, data2, d, 180.);
+          out[i] = interp_angle(data1, data2, d, 180.);
       }
+    }
+  });
 
-      if (BMSbits) {
+  // Rows share the bytes at their ends, so the bits are done in one go
+  if (BMSbits) {
+    for (int j = 0; j < Nj; j++)
+      for (int i = 0; i < Ni; i++) {
+        int in = j * Ni + i;
+        int i1 = (j * jm1 + rec1offj) * rec1.Ni + i * im1 + rec1offi;
+        int i2 = (j * jm2 + rec2offj) * rec2.Ni + i * im2 + rec2offi;
         int b1 = rec1.BMSbits[i1 >> 3] & 1 << (i1 & 7);
         int b2 = rec2.BMSbits[i2 >> 3] & 1 << (i2 & 7);
-        if (b1 && b2)
-          BMSbits[in >> 3] |= 1 << (in & 7);
-        else
-          BMSbits[in >> 3] &= ~(1 << (in & 7));
+        if (b1 && b2) BMSbits[in >> 3] |= 1 << (in & 7);
       }
-    }
+  }
 
   /* should maybe update strCurDate ? */
 
@@ -249,20 +370,24 @@ GribRecord *GribRecord::Interpolated2DRecord(
   // recopie les champs de bits
   int size = Ni * Nj;
   double *datax = new double[size], *datay = new double[size];
-  for (int i = 0; i < Ni; i++) {
-    for (int j = 0; j < Nj; j++) {
-      int in = j * Ni + i;
-      int i1 = (j * jm1 + rec1offj) * rec1x.Ni + i * im1 + rec1offi;
-      int i2 = (j * jm2 + rec2offj) * rec2x.Ni + i * im2 + rec2offi;
-      double data1x = rec1x.data[i1], data1y = rec1y.data[i1];
-      double data2x = rec2x.data[i2], data2y = rec2y.data[i2];
-      if (data1x == GRIB_NOTDEF || data1y == GRIB_NOTDEF ||
-          data2x == GRIB_NOTDEF || data2y == GRIB_NOTDEF) {
-        datax[in] = GRIB_NOTDEF;
-        datay[in] = GRIB_NOTDEF;
-      } else {
-        double data1m = sqrt(pow(data1x, 2) + pow(data1y, 2));
-        double data2m = sqrt(pow(data2x, 2) + pow(data2y, 2));
+  ForEachRows(Ni, Nj, [&](int j0, int j1) {
+    for (int j = j0; j < j1; j++) {
+      int row1 = (j * jm1 + rec1offj) * rec1x.Ni + rec1offi;
+      int row2 = (j * jm2 + rec2offj) * rec2x.Ni + rec2offi;
+      const double *r1x = rec1x.data + row1, *r1y = rec1y.data + row1;
+      const double *r2x = rec2x.data + row2, *r2y = rec2y.data + row2;
+      double *outx = datax + j * Ni, *outy = datay + j * Ni;
+      for (int i = 0; i < Ni; i++) {
+        double data1x = r1x[i * im1], data1y = r1y[i * im1];
+        double data2x = r2x[i * im2], data2y = r2y[i * im2];
+        if (data1x == GRIB_NOTDEF || data1y == GRIB_NOTDEF ||
+            data2x == GRIB_NOTDEF || data2y == GRIB_NOTDEF) {
+          outx[i] = GRIB_NOTDEF;
+          outy[i] = GRIB_NOTDEF;
+          continue;
+        }
+        double data1m = sqrt(data1x * data1x + data1y * data1y);
+        double data2m = sqrt(data2x * data2x + data2y * data2y);
         double datam = (1 - d) * data1m + d * data2m;
 
         double data1a = atan2(data1y, data1x);
@@ -273,11 +398,11 @@ GribRecord *GribRecord::Interpolated2DRecord(
           data2a -= 2 * M_PI;
         double dataa = (1 - d) * data1a + d * data2a;
 
-        datax[in] = datam * cos(dataa);
-        datay[in] = datam * sin(dataa);
+        outx[i] = datam * cos(dataa);
+        outy[i] = datam * sin(dataa);
       }
     }
-  }
+  });
 
   /* should maybe update strCurDate ? */
 
@@ -452,7 +577,12 @@ GribRecord::~GribRecord() {
 
 //-------------------------------------------------------------------------------
 void GribRecord::multiplyAllData(double k) {
-  if (data == 0 || !isOk()) return;
+  if (!isOk()) return;
+  if (data == 0) {
+    // Still packed, translateDataType() runs before decodeData()
+    pendingScale *= k;
+    return;
+  }
 
   for (zuint j = 0; j < Nj; j++) {
     for (zuint i = 0; i < Ni; i++) {
@@ -463,6 +593,13 @@ void GribRecord::multiplyAllData(double k) {
   }
 }
 
+void GribRecord::applyPendingScale() {
+  if (pendingScale == 1.0) return;
+  double k = pendingScale;
+  pendingScale = 1.0;
+  multiplyAllData(k);
+}
+
 //----------------------------------------------
 void GribRecord::setRecordCurrentDate(time_t t) {
   curDate = t;
@@ -517,21 +654,138 @@ time_t GribRecord::makeDate(zuint year, zuint month, zuint day, zuint hour,
 double GribRecord::getInterpolatedValue(double px, double py,
                                         bool numericalInterpolation,
                                         bool dir) const {
-  if (!ok || Di == 0 || Dj == 0) return GRIB_NOTDEF;
+  return GribGridSampler(this).getValue(px, py, numericalInterpolation, dir);
+}
+
+bool GribRecord::getInterpolatedValues(double &M, double &A,
+                                       const GribRecord *GRX,
+                                       const GribRecord *GRY, double px,
+                                       double py, bool numericalInterpolation) {
+  if (!GRX || !GRY) return false;
 
-  if (!isPointInMap(px, py)) {
+  return GribGridSampler(GRX, GRY).getVector(M, A, px, py,
+                                             numericalInterpolation);
+}
+
+//===============================================================================================
+
+GribGridSampler::GribGridSampler(const GribRecord *rec)
+    : ok(rec->ok && rec->Di != 0 && rec->Dj != 0),
+      datax(rec->data),
+      datay(NULL),
+      Ni(rec->Ni),
+      Nj(rec->Nj),
+      Niy(0),
+      Lo1(rec->Lo1),
+      La1(rec->La1),
+      Di(rec->Di),
+      Dj(rec->Dj) {
+  // same extent as GribRecord::isXInMap() and isYInMap()
+  double maxLo = Di > 0 ? rec->Lo2 : rec->Lo1;
+  if (rec->Lo2 + Di >= 360) /* grib that covers the whole world */
+    maxLo += Di;
+  xMin = Di > 0 ? rec->Lo1 : rec->Lo2;
+  xMax = maxLo;
+  yMin = Dj < 0 ? rec->La2 : rec->La1;
+  yMax = Dj < 0 ? rec->La1 : rec->La2;
+}
+
+GribGridSampler::GribGridSampler(const GribRecord *recx, const GribRecord *recy)
+    : GribGridSampler(recx) {
+  GribGridSampler sy(recy);
+  ok = recx->ok && recy->ok && Di != 0 && Dj != 0;
+  datay = sy.datax;
+  Niy = sy.Ni;
+  // a point must be in both grids
+  xMin = wxMax(xMin, sy.xMin);
+  xMax = wxMin(xMax, sy.xMax);
+  yMin = wxMax(yMin, sy.yMin);
+  yMax = wxMin(yMax, sy.yMax);
+}
+
+//  Grid coordinates of a point, trying it again around the world on
+//  both sides, false if it is outside the grid.
+inline bool GribGridSampler::locate(double px, double py, double &pi,
+                                    double &pj) const {
+  if (!isYInMap(py)) return false;
+  if (!isXInMap(px)) {
     px += 360.0;  // tour du monde à droite ?
-    if (!isPointInMap(px, py)) {
+    if (!isXInMap(px)) {
       px -= 2 * 360.0;  // tour du monde à gauche ?
-      if (!isPointInMap(px, py)) {
-        return GRIB_NOTDEF;
-      }
+      if (!isXInMap(px)) return false;
     }
   }
-  double pi, pj;  // coord. in grid unit
   pi = (px - Lo1) / Di;
   pj = (py - La1) / Dj;
+  // past the last column of a grid around the world, the first ones again
+  if (pi >= Ni) pi = wxMax(0.0, pi - 360.0 / Di);
+  return true;
+}
+
+//  The same as locate() for n points, in a loop without branches the
+//  compiler can vectorize.
+void GribGridSampler::locate(int n, const double *px, const double *py,
+                             double *pi, double *pj, bool *in) const {
+  for (int k = 0; k < n; k++) {
+    double x = px[k], xr = x + 360.0, xl = xr - 2 * 360.0;
+    bool h = isXInMap(x), hr = isXInMap(xr), hl = isXInMap(xl);
+    in[k] = isYInMap(py[k]) && (h || hr || hl);
+    double i = ((h ? x : hr ? xr : xl) - Lo1) / Di;
+    pi[k] = i >= Ni ? wxMax(0.0, i - 360.0 / Di) : i;
+    pj[k] = (py[k] - La1) / Dj;
+  }
+}
 
+double GribGridSampler::getValue(double px, double py,
+                                 bool numericalInterpolation, bool dir) const {
+  double pi, pj;  // coord. in grid unit
+  if (!ok || !locate(px, py, pi, pj)) return GRIB_NOTDEF;
+  return valueAt(pi, pj, numericalInterpolation, dir);
+}
+
+bool GribGridSampler::getVector(double &M, double &A, double px, double py,
+                                bool numericalInterpolation) const {
+  double pi, pj;  // coord. in grid unit
+  if (!ok || !datay || !locate(px, py, pi, pj)) return false;
+  return vectorAt(M, A, pi, pj, numericalInterpolation);
+}
+
+//  Points are taken by blocks: the whole block is located on the grid
+//  first, then the grid is read for each point.
+static const int kSampleBlock = 256;
+
+void GribGridSampler::getValues(int n, const double *px, const double *py,
+                                double *values, bool numericalInterpolation,
+                                bool dir) const {
+  double pi[kSampleBlock], pj[kSampleBlock];
+  bool in[kSampleBlock];
+  for (int b = 0; b < n; b += kSampleBlock) {
+    int nb = wxMin(kSampleBlock, n - b);
+    locate(nb, px + b, py + b, pi, pj, in);
+    for (int k = 0; k < nb; k++)
+      values[b + k] = ok && in[k]
+                          ? valueAt(pi[k], pj[k], numericalInterpolation, dir)
+                          : GRIB_NOTDEF;
+  }
+}
+
+void GribGridSampler::getVectors(int n, const double *px, const double *py,
+                                 double *M, double *A,
+                                 bool numericalInterpolation) const {
+  double pi[kSampleBlock], pj[kSampleBlock];
+  bool in[kSampleBlock];
+  for (int b = 0; b < n; b += kSampleBlock) {
+    int nb = wxMin(kSampleBlock, n - b);
+    locate(nb, px + b, py + b, pi, pj, in);
+    for (int k = 0; k < nb; k++)
+      if (!ok || !datay || !in[k] ||
+          !vectorAt(M[b + k], A[b + k], pi[k], pj[k], numericalInterpolation))
+        M[b + k] = A[b + k] = GRIB_NOTDEF;
+  }
+}
+
+double GribGridSampler::valueAt(double pi, double pj,
+                                bool numericalInterpolation, bool dir) const {
   // 00 10      point is in a square
   // 01 11
   int i0 = (int)pi;  // point 00
@@ -551,7 +805,7 @@ double GribRecord::getInterpolatedValue(double px, double py,
     if (dx >= 0.5) i0 = i1;
     if (dy >= 0.5) j0 = j1;
 
-    return getValue(i0, j0);
+    return valx(i0, j0);
   }
 
   //     bool h00,h01,h10,h11;
@@ -566,10 +820,10 @@ double GribRecord::getInterpolatedValue(double px, double py,
   //         nbval ++;
 
   int nbval = 0;  // how many values in grid ?
-  if (getValue(i0, j0) != GRIB_NOTDEF) nbval++;
-  if (getValue(i1, j0) != GRIB_NOTDEF) nbval++;
-  if (getValue(i0, j1) != GRIB_NOTDEF) nbval++;
-  if (getValue(i1, j1) != GRIB_NOTDEF) nbval++;
+  if (valx(i0, j0) != GRIB_NOTDEF) nbval++;
+  if (valx(i1, j0) != GRIB_NOTDEF) nbval++;
+  if (valx(i0, j1) != GRIB_NOTDEF) nbval++;
+  if (valx(i1, j1) != GRIB_NOTDEF) nbval++;
 
   if (nbval < 3) return GRIB_NOTDEF;
 
@@ -583,10 +837,10 @@ double GribRecord::getInterpolatedValue(double px, double py,
   // kx = distance(xa,x)
   // ky = distance(xa,y)
   if (nbval == 4) {
-    double x00 = getValue(i0, j0);
-    double x01 = getValue(i0, j1);
-    double x10 = getValue(i1, j0);
-    double x11 = getValue(i1, j1);
+    double x00 = valx(i0, j0);
+    double x01 = valx(i0, j1);
+    double x10 = valx(i1, j0);
+    double x11 = valx(i1, j1);
     if (!dir) {
       double x1 = (1.0 - dx) * x00 + dx * x10;
       double x2 = (1.0 - dx) * x01 + dx * x11;
@@ -602,32 +856,32 @@ double GribRecord::getInterpolatedValue(double px, double py,
   if (dir) return GRIB_NOTDEF;
 
   // here nbval==3, check the corner without data
-  if (getValue(i0, j0) == GRIB_NOTDEF) {
+  if (valx(i0, j0) == GRIB_NOTDEF) {
     // printf("! h00  %f %f\n", dx,dy);
-    xa = getValue(i1, j1);  // A = point 11
-    xb = getValue(i0, j1);  // B = point 01
-    xc = getValue(i1, j0);  // C = point 10
+    xa = valx(i1, j1);  // A = point 11
+    xb = valx(i0, j1);  // B = point 01
+    xc = valx(i1, j0);  // C = point 10
     kx = 1 - dx;
     ky = 1 - dy;
-  } else if (getValue(i0, j1) == GRIB_NOTDEF) {
+  } else if (valx(i0, j1) == GRIB_NOTDEF) {
     // printf("! h01  %f %f\n", dx,dy);
-    xa = getValue(i1, j0);  // A = point 10
-    xb = getValue(i1, j1);  // B = point 11
-    xc = getValue(i0, j0);  // C = point 00
+    xa = valx(i1, j0);  // A = point 10
+    xb = valx(i1, j1);  // B = point 11
+    xc = valx(i0, j0);  // C = point 00
     kx = dy;
     ky = 1 - dx;
-  } else if (getValue(i1, j0) == GRIB_NOTDEF) {
+  } else if (valx(i1, j0) == GRIB_NOTDEF) {
     // printf("! h10  %f %f\n", dx,dy);
-    xa = getValue(i0, j1);  // A = point 01
-    xb = getValue(i0, j0);  // B = point 00
-    xc = getValue(i1, j1);  // C = point 11
+    xa = valx(i0, j1);  // A = point 01
+    xb = valx(i0, j0);  // B = point 00
+    xc = valx(i1, j1);  // C = point 11
     kx = 1 - dy;
     ky = dx;
   } else {
     // printf("! h11  %f %f\n", dx,dy);
-    xa = getValue(i0, j0);  // A = point 00
-    xb = getValue(i1, j0);  // B = point 10
-    xc = getValue(i0, j1);  // C = point 01
+    xa = valx(i0, j0);  // A = point 00
+    xb = valx(i1, j0);  // B = point 10
+    xc = valx(i0, j1);  // C = point 01
     kx = dx;
     ky = dy;
   }
@@ -645,36 +899,17 @@ double GribRecord::getInterpolatedValue(double px, double py,
   return k2 * vx + (1 - k2) * vy;
 }
 
-bool GribRecord::getInterpolatedValues(double &M, double &A,
-                                       const GribRecord *GRX,
-                                       const GribRecord *GRY, double px,
-                                       double py, bool numericalInterpolation) {
-  if (!GRX || !GRY) return false;
-
-  if (!GRX->ok || !GRY->ok || GRX->Di == 0 || GRX->Dj == 0) return false;
-
-  if (!GRX->isPointInMap(px, py) || !GRY->isPointInMap(px, py)) {
-    px += 360.0;  // tour du monde à droite ?
-    if (!GRX->isPointInMap(px, py) || !GRY->isPointInMap(px, py)) {
-      px -= 2 * 360.0;  // tour du monde à gauche ?
-      if (!GRX->isPointInMap(px, py) || !GRY->isPointInMap(px, py)) {
-        return false;
-      }
-    }
-  }
-  double pi, pj;  // coord. in grid unit
-  pi = (px - GRX->Lo1) / GRX->Di;
-  pj = (py - GRX->La1) / GRX->Dj;
-
+bool GribGridSampler::vectorAt(double &M, double &A, double pi, double pj,
+                               bool numericalInterpolation) const {
   // 00 10      point is in a square
   // 01 11
   int i0 = (int)pi;  // point 00
   int j0 = (int)pj;
 
   unsigned int i1 = pi + 1, j1 = pj + 1;
-  if (i1 >= GRX->Ni) i1 = i0;
+  if (i1 >= Ni) i1 = i0;
 
-  if (j1 >= GRX->Nj) j1 = j0;
+  if (j1 >= Nj) j1 = j0;
 
   // distances to 00
   double dx = pi - i0;
@@ -685,8 +920,8 @@ bool GribRecord::getInterpolatedValues(double &M, double &A,
     if (dx >= 0.5) i0 = i1;
     if (dy >= 0.5) j0 = j1;
 
-    vx = GRX->getValue(i0, j0);
-    vy = GRY->getValue(i0, j0);
+    vx = valx(i0, j0);
+    vy = valy(i0, j0);
     if (vx == GRIB_NOTDEF || vy == GRIB_NOTDEF) return false;
 
     M = sqrt(vx * vx + vy * vy);
@@ -706,18 +941,18 @@ bool GribRecord::getInterpolatedValues(double &M, double &A,
   //         nbval ++;
 
   int nbval = 0;  // how many values in grid ?
-  if (GRY->getValue(i0, j0) != GRIB_NOTDEF) nbval++;
-  if (GRY->getValue(i1, j0) != GRIB_NOTDEF) nbval++;
-  if (GRY->getValue(i0, j1) != GRIB_NOTDEF) nbval++;
-  if (GRY->getValue(i1, j1) != GRIB_NOTDEF) nbval++;
+  if (valy(i0, j0) != GRIB_NOTDEF) nbval++;
+  if (valy(i1, j0) != GRIB_NOTDEF) nbval++;
+  if (valy(i0, j1) != GRIB_NOTDEF) nbval++;
+  if (valy(i1, j1) != GRIB_NOTDEF) nbval++;
 
   if (nbval <= 3) return false;
 
   nbval = 0;  // how many values in grid ?
-  if (GRX->getValue(i0, j0) != GRIB_NOTDEF) nbval++;
-  if (GRX->getValue(i1, j0) != GRIB_NOTDEF) nbval++;
-  if (GRX->getValue(i0, j1) != GRIB_NOTDEF) nbval++;
-  if (GRX->getValue(i1, j1) != GRIB_NOTDEF) nbval++;
+  if (valx(i0, j0) != GRIB_NOTDEF) nbval++;
+  if (valx(i1, j0) != GRIB_NOTDEF) nbval++;
+  if (valx(i0, j1) != GRIB_NOTDEF) nbval++;
+  if (valx(i1, j1) != GRIB_NOTDEF) nbval++;
 
   if (nbval <= 3) return false;
 
@@ -730,16 +965,16 @@ bool GribRecord::getInterpolatedValues(double &M, double &A,
   // kx = distance(xa,x)
   // ky = distance(xa,y)
   if (nbval == 4) {
-    double x00x = GRX->getValue(i0, j0), x00y = GRY->getValue(i0, j0);
+    double x00x = valx(i0, j0), x00y = valy(i0, j0);
     double x00m = sqrt(x00x * x00x + x00y * x00y), x00a = atan2(x00x, x00y);
 
-    double x01x = GRX->getValue(i0, j1), x01y = GRY->getValue(i0, j1);
+    double x01x = valx(i0, j1), x01y = valy(i0, j1);
     double x01m = sqrt(x01x * x01x + x01y * x01y), x01a = atan2(x01x, x01y);
 
-    double x10x = GRX->getValue(i1, j0), x10y = GRY->getValue(i1, j0);
+    double x10x = valx(i1, j0), x10y = valy(i1, j0);
     double x10m = sqrt(x10x * x10x + x10y * x10y), x10a = atan2(x10x, x10y);
 
-    double x11x = GRX->getValue(i1, j1), x11y = GRY->getValue(i1, j1);
+    double x11x = valx(i1, j1), x11y = valy(i1, j1);
     double x11m = sqrt(x11x * x11x + x11y * x11y), x11a = atan2(x11x, x11y);
 
     double x0m = (1 - dx) * x00m + dx * x10m,
@@ -762,33 +997,33 @@ bool GribRecord::getInterpolatedValues(double &M, double &A,
         // here nbval==3, check the corner without data
         if (!h00) {
             //printf("! h00  %f %f\n", dx,dy);
-            xa = getValue(i1, j1);   // A = point 11
-            xb = getValue(i0, j1);   // B = point 01
-            xc = getValue(i1, j0);   // C = point 10
+            xa = valx(i1, j1);   // A = point 11
+            xb = valx(i0, j1);   // B = point 01
+            xc = valx(i1, j0);   // C = point 10
             kx = 1-dx;
             ky = 1-dy;
         }
         else if (!h01) {
             //printf("! h01  %f %f\n", dx,dy);
-            xa = getValue(i1, j0);     // A = point 10
-            xb = getValue(i1, j1);   // B = point 11
-            xc = getValue(i0, j0);     // C = point 00
+            xa = valx(i1, j0);     // A = point 10
+            xb = valx(i1, j1);   // B = point 11
+            xc = valx(i0, j0);     // C = point 00
             kx = dy;
             ky = 1-dx;
         }
         else if (!h10) {
             //printf("! h10  %f %f\n", dx,dy);
-            xa = getValue(i0, j1);     // A = point 01
-            xb = getValue(i0, j0);       // B = point 00
-            xc = getValue(i1, j1);     // C = point 11
+            xa = valx(i0, j1);     // A = point 01
+            xb = valx(i0, j0);       // B = point 00
+            xc = valx(i1, j1);     // C = point 11
             kx = 1-dy;
             ky = dx;
         }
         else {
             //printf("! h11  %f %f\n", dx,dy);
-            xa = getValue(i0, j0);  // A = point 00
-            xb = getValue(i1, j0);  // B = point 10
-            xc = getValue(i0, j1);  // C = point 01
+            xa = valx(i0, j0);  // A = point 00
+            xb = valx(i1, j0);  // B = point 10
+            xc = valx(i0, j1);  // C = point 01
             kx = dx;
             ky = dy;
         }
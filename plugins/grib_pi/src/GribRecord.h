@@ -25,6 +25,7 @@ Elément de base d'un fichier GRIB
 
 #include <iostream>
 #include <cmath>
+#include <shared_mutex>
 
 #define DEBUG_INFO false
 #define DEBUG_ERROR true
@@ -152,10 +153,15 @@ public:
 class GribRecord {
 public:
   GribRecord(const GribRecord &rec);
-  GribRecord() { m_bfilled = false; }
+  GribRecord() : m_bfilled(false), pendingScale(1.0) {}
 
   virtual ~GribRecord();
 
+  // Records read from a file keep their packed data until it is needed,
+  // so records which are not kept are never unpacked.  Unpack it now,
+  // false if this fails.
+  virtual bool decodeData() { return ok; }
+
   static GribRecord *InterpolatedRecord(const GribRecord &rec1,
                                         const GribRecord &rec2, double d,
                                         bool dir = false);
@@ -256,7 +262,14 @@ public:
   bool isFilled() { return m_bfilled; }
   void setFilled(bool val = true) { m_bfilled = val; }
 
+  // Held shared while the records of a file are read off the GUI thread,
+  // and exclusively while one is changed in place, see
+  // GRIBOverlayFactory::FillGrid()
+  static std::shared_timed_mutex dataMutex;
+
 private:
+  friend class GribGridSampler;
+
   // Is a point within the extent of the grid?
   inline bool isPointInMap(double x, double y) const;
   inline bool isXInMap(double x) const;
@@ -283,6 +296,10 @@ protected:
   char strCurDate[32];
   int dataCenterModel;
   bool m_bfilled;
+  // Unit conversion asked for before the data was unpacked, applied by
+  // applyPendingScale() at the end of decodeData()
+  double pendingScale;
+  void applyPendingScale();
 
   //---------------------------------------------
   // SECTION 0: THE INDICATOR SECTION (IS)
@@ -332,6 +349,54 @@ protected:
   //        void   print();
 };
 
+//----------------------------------------------
+// Interpolates a record, or a vector given by the records of its two
+// components on the same grid, at many points.  The extent of the grid
+// and the wrap around the world are worked out once for all the points,
+// and a batch of points is located on the grid in one pass before the
+// values are read.  Gives the same values as getInterpolatedValue() and
+// getInterpolatedValues().  The records must outlive the sampler.
+class GribGridSampler {
+public:
+  explicit GribGridSampler(const GribRecord *rec);
+  GribGridSampler(const GribRecord *recx, const GribRecord *recy);
+
+  bool isOk() const { return ok; }
+
+  // Value at one point, GRIB_NOTDEF if none
+  double getValue(double px, double py, bool numericalInterpolation = true,
+                  bool dir = false) const;
+  // Magnitude and direction of the vector at one point, false if none
+  bool getVector(double &M, double &A, double px, double py,
+                 bool numericalInterpolation = true) const;
+
+  // Values at n points, GRIB_NOTDEF where there is none
+  void getValues(int n, const double *px, const double *py, double *values,
+                 bool numericalInterpolation = true, bool dir = false) const;
+  // Vectors at n points, M and A GRIB_NOTDEF where there is none
+  void getVectors(int n, const double *px, const double *py, double *M,
+                  double *A, bool numericalInterpolation = true) const;
+
+private:
+  inline bool isXInMap(double x) const { return x >= xMin && x <= xMax; }
+  inline bool isYInMap(double y) const { return y >= yMin && y <= yMax; }
+  inline bool locate(double px, double py, double &pi, double &pj) const;
+  void locate(int n, const double *px, const double *py, double *pi,
+              double *pj, bool *in) const;
+  double valx(int i, int j) const { return datax[j * Ni + i]; }
+  double valy(int i, int j) const { return datay[j * Niy + i]; }
+  double valueAt(double pi, double pj, bool numericalInterpolation,
+                 bool dir) const;
+  bool vectorAt(double &M, double &A, double pi, double pj,
+                bool numericalInterpolation) const;
+
+  bool ok;
+  const double *datax, *datay;
+  zuint Ni, Nj, Niy;
+  double Lo1, La1, Di, Dj;
+  double xMin, xMax, yMin, yMax;  // extent, common to both records
+};
+
 //==========================================================================
 inline bool GribRecord::hasValue(int i, int j) const {
   // is data present in BMS ?
@@ -24,6 +24,9 @@
  ***************************************************************************
  */
 
+#ifndef __GRIBRECORDSET_H__
+#define __GRIBRECORDSET_H__
+
 #include "GribRecord.h"
 
 // These are indexes into the array
@@ -107,3 +110,5 @@ private:
   // interpolated grib are not, keep track of them
   bool m_GribRecordUnref[Idx_COUNT];
 };
+
+#endif
@@ -0,0 +1,218 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  GRIB Plugin timeline interpolation
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef WX_PRECOMP
+#include "wx/wx.h"
+#endif  // precompiled headers
+
+#include <algorithm>
+
+#include "GribTimeline.h"
+
+GribTimelineCache::GribTimelineCache(const std::vector<GribRecordSet *> &sets,
+                                     size_t max_bytes)
+    : m_sets(sets), m_max_bytes(max_bytes), m_bytes(0), m_stop(false) {}
+
+GribTimelineCache::~GribTimelineCache() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+    m_queue.clear();
+  }
+  m_cond.notify_all();
+  if (m_thread.joinable()) m_thread.join();
+}
+
+void GribTimelineCache::Prefetch(const std::vector<time_t> &times) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_queue.assign(times.begin(), times.end());
+  if (!m_thread.joinable() && !m_queue.empty())
+    m_thread = std::thread(&GribTimelineCache::Worker, this);
+  m_cond.notify_all();
+}
+
+std::vector<time_t> GribTimelineCache::GetKeptTimes() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<time_t> times;
+  for (auto &step : m_steps) times.push_back(step->time);
+  return times;
+}
+
+std::shared_ptr<GribTimelineStep> GribTimelineCache::GetStep(time_t time) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    std::shared_ptr<GribTimelineStep> step = FindStep(time);
+    if (step) return step;
+    if (!m_running.count(time)) break;
+    m_cond.wait(lock);
+  }
+
+  m_running.insert(time);
+  lock.unlock();
+  std::shared_ptr<GribTimelineStep> step = ComputeStep(time);
+  lock.lock();
+  m_running.erase(time);
+  AddStep(step);
+  m_cond.notify_all();
+  return step;
+}
+
+//  A kept step, made the latest.  Call with the mutex locked.
+std::shared_ptr<GribTimelineStep> GribTimelineCache::FindStep(time_t time) {
+  for (auto it = m_steps.begin(); it != m_steps.end(); ++it) {
+    if ((*it)->time != time) continue;
+    std::shared_ptr<GribTimelineStep> step = *it;
+    m_steps.erase(it);
+    m_steps.push_front(step);
+    return step;
+  }
+  return NULL;
+}
+
+//  Keep a step, dropping the least recently used ones over the memory
+//  limit.  Sets still using them keep them alive.  Call with the mutex
+//  locked.
+void GribTimelineCache::AddStep(const std::shared_ptr<GribTimelineStep> &step) {
+  m_steps.push_front(step);
+  m_bytes += step->bytes;
+  while (m_steps.size() > 1 && m_bytes > m_max_bytes) {
+    m_bytes -= m_steps.back()->bytes;
+    m_steps.pop_back();
+  }
+}
+
+void GribTimelineCache::Worker() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cond.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+    if (m_stop) return;
+
+    time_t time = m_queue.front();
+    m_queue.pop_front();
+    bool kept = false;
+    for (auto it = m_steps.begin(); it != m_steps.end() && !kept; ++it)
+      kept = (*it)->time == time;
+    if (kept || m_running.count(time)) continue;
+
+    m_running.insert(time);
+    lock.unlock();
+    std::shared_ptr<GribTimelineStep> step = ComputeStep(time);
+    lock.lock();
+    m_running.erase(time);
+    AddStep(step);
+    m_cond.notify_all();
+  }
+}
+
+//  For each parameter, the records of the nearest times before and after,
+//  interpolated.  The records of the file are only read, under a shared
+//  GribRecord::dataMutex, so this runs on any thread.
+std::shared_ptr<GribTimelineStep> GribTimelineCache::ComputeStep(
+    time_t time) const {
+  std::shared_lock<std::shared_timed_mutex> data_lock(GribRecord::dataMutex);
+
+  std::shared_ptr<GribTimelineStep> step =
+      std::make_shared<GribTimelineStep>();
+  step->time = time;
+  step->bytes = sizeof(GribTimelineStep);
+  for (int i = 0; i < Idx_COUNT; i++) step->records[i] = NULL;
+
+  time_t mintime = m_sets[0]->m_Reference_Time;
+  double nminute = (time - mintime) / 60;
+
+  //  The first set at or after time
+  size_t after = std::lower_bound(m_sets.begin(), m_sets.end(), time,
+                                  [](const GribRecordSet *set, time_t t) {
+                                    return set->m_Reference_Time < t;
+                                  }) -
+                 m_sets.begin();
+
+  auto set_record = [&step](int i, GribRecord *rec) {
+    if (rec) {
+      step->records[i] = rec;
+      step->interpolated.emplace_back(rec);
+      step->bytes += sizeof(GribRecord) +
+                     (size_t)rec->getNi() * rec->getNj() * sizeof(double);
+    }
+  };
+
+  for (int i = 0; i < Idx_COUNT; i++) {
+    // already computed using polar interpolation from first axis
+    if (step->records[i]) continue;
+
+    GribRecordSet *GRS1 = NULL, *GRS2 = NULL;
+    GribRecord *GR1 = NULL, *GR2 = NULL;
+    for (size_t j = after; j < m_sets.size() && !GR2; j++)
+      if ((GR2 = m_sets[j]->m_GribRecordPtrArray[i])) GRS2 = m_sets[j];
+    size_t before = after;
+    if (before < m_sets.size() && m_sets[before]->m_Reference_Time == time)
+      before++;
+    for (size_t j = before; j > 0 && !GR1; j--)
+      if ((GR1 = m_sets[j - 1]->m_GribRecordPtrArray[i])) GRS1 = m_sets[j - 1];
+
+    if (!GR1 || !GR2) continue;
+
+    double minute2 = (GRS2->m_Reference_Time - mintime) / 60;
+    double minute1 = (GRS1->m_Reference_Time - mintime) / 60;
+
+    if (minute2 < minute1 || nminute < minute1 || nminute > minute2) continue;
+
+    double interp_const;
+    if (minute1 == minute2) {
+      // with big grib a copy is slow use a reference.
+      step->records[i] = GR1;
+      continue;
+    } else
+      interp_const = (nminute - minute1) / (minute2 - minute1);
+
+    /* if this is a vector interpolation use the 2d method */
+    int iy = -1;
+    if (i < Idx_WIND_VY)
+      iy = i + Idx_WIND_VY;
+    else if (i <= Idx_WIND_VY300 || i == Idx_SEACURRENT_VY)
+      continue;
+    else if (i == Idx_SEACURRENT_VX)
+      iy = Idx_SEACURRENT_VY;
+
+    if (iy >= 0) {
+      GribRecord *GR1y = GRS1->m_GribRecordPtrArray[iy];
+      GribRecord *GR2y = GRS2->m_GribRecordPtrArray[iy];
+      if (GR1y && GR2y) {
+        GribRecord *Ry;
+        set_record(i, GribRecord::Interpolated2DRecord(Ry, *GR1, *GR1y, *GR2,
+                                                       *GR2y, interp_const));
+        set_record(iy, Ry);
+        continue;
+      }
+    }
+
+    set_record(i, GribRecord::InterpolatedRecord(*GR1, *GR2, interp_const,
+                                                 i == Idx_WVDIR));
+  }
+
+  return step;
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  GRIB Plugin timeline interpolation
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef __GRIBTIMELINE_H__
+#define __GRIBTIMELINE_H__
+
+#include <time.h>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "GribRecordSet.h"
+
+/** The records of a GRIB file at one time, interpolated where needed. */
+struct GribTimelineStep {
+  time_t time;
+  GribRecord *records[Idx_COUNT];
+  std::vector<std::unique_ptr<GribRecord> > interpolated;  // owned
+  size_t bytes;
+};
+
+/**
+ * The timeline of one GRIB file.  The steps last asked for are kept, up to
+ * a memory limit, and shared with the record sets handed out, so going
+ * back and forth on the timeline does not interpolate again.  Steps
+ * expected next are computed ahead on a background thread.
+ */
+class GribTimelineCache {
+public:
+  /** Memory for the kept steps.  The latest one is kept whatever its size. */
+  static const size_t kDefaultMaxBytes = 256 * 1024 * 1024;
+
+  /** sets are the record sets of the file, in time order, not empty. */
+  GribTimelineCache(const std::vector<GribRecordSet *> &sets,
+                    size_t max_bytes = kDefaultMaxBytes);
+  ~GribTimelineCache();
+
+  /**
+   * The step for time: kept, being computed in the background, or
+   * computed now on this thread.
+   */
+  std::shared_ptr<GribTimelineStep> GetStep(time_t time);
+
+  /** Compute these times in the background, replacing earlier requests. */
+  void Prefetch(const std::vector<time_t> &times);
+
+  /** The times of the kept steps, latest first. */
+  std::vector<time_t> GetKeptTimes();
+
+private:
+  std::shared_ptr<GribTimelineStep> FindStep(time_t time);
+  void AddStep(const std::shared_ptr<GribTimelineStep> &step);
+  std::shared_ptr<GribTimelineStep> ComputeStep(time_t time) const;
+  void Worker();
+
+  std::vector<GribRecordSet *> m_sets;
+  size_t m_max_bytes;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::list<std::shared_ptr<GribTimelineStep> > m_steps;  // latest first
+  size_t m_bytes;
+  std::set<time_t> m_running;  // steps being computed
+  std::deque<time_t> m_queue;  // steps to compute ahead
+  std::thread m_thread;
+  bool m_stop;
+};
+
+#endif
@@ -1319,6 +1319,24 @@ void GRIBUICtrlBar::TimelineChanged() {
   wxDateTime time = TimelineTime();
   SetGribTimelineRecordSet(GetTimeLineRecordSet(time));
 
+  //  Interpolate the next steps while this one is shown, those ahead first
+  //  when playing
+  if (m_InterpolateMode && m_TimeLineHours) {
+    int value = m_sTimeline->GetValue();
+    int stepmin =
+        m_OverlaySettings.GetMinFromIndex(m_OverlaySettings.m_SlicesPerUpdate);
+    std::vector<time_t> times;
+    int steps[] = {1, -1, 2};
+    for (int k = 0; k < (m_tPlayStop.IsRunning() ? 3 : 2); k++) {
+      int v = value + steps[k];
+      if (v < 0 || v > m_sTimeline->GetMax()) continue;
+      times.push_back(
+          (MinTime() + wxTimeSpan(v * stepmin / 60, (v * stepmin) % 60))
+              .GetTicks());
+    }
+    m_bGRIBActiveFile->PrefetchTimeline(times);
+  }
+
   if (!m_InterpolateMode) {
     /* get closest value to update timeline */
     ArrayOfGribRecordSets *rsa = m_bGRIBActiveFile->GetRecordSetArrayPtr();
@@ -1430,87 +1448,7 @@ wxDateTime GRIBUICtrlBar::MinTime() {
 
 GribTimelineRecordSet *GRIBUICtrlBar::GetTimeLineRecordSet(wxDateTime time) {
   if (m_bGRIBActiveFile == NULL) return NULL;
-  ArrayOfGribRecordSets *rsa = m_bGRIBActiveFile->GetRecordSetArrayPtr();
-
-  if (rsa->GetCount() == 0) return NULL;
-
-  GribTimelineRecordSet *set =
-      new GribTimelineRecordSet(m_bGRIBActiveFile->GetCounter());
-  for (int i = 0; i < Idx_COUNT; i++) {
-    GribRecordSet *GRS1 = NULL, *GRS2 = NULL;
-    GribRecord *GR1 = NULL, *GR2 = NULL;
-    wxDateTime GR1time, GR2time;
-
-    // already computed using polar interpolation from first axis
-    if (set->m_GribRecordPtrArray[i]) continue;
-
-    unsigned int j;
-    for (j = 0; j < rsa->GetCount(); j++) {
-      GribRecordSet *GRS = &rsa->Item(j);
-      GribRecord *GR = GRS->m_GribRecordPtrArray[i];
-      if (!GR) continue;
-
-      wxDateTime curtime = GRS->m_Reference_Time;
-      if (curtime <= time) GR1time = curtime, GRS1 = GRS, GR1 = GR;
-
-      if (curtime >= time) {
-        GR2time = curtime, GRS2 = GRS, GR2 = GR;
-        break;
-      }
-    }
-
-    if (!GR1 || !GR2) continue;
-
-    wxDateTime mintime = MinTime();
-    double minute2 = (GR2time - mintime).GetMinutes();
-    double minute1 = (GR1time - mintime).GetMinutes();
-    double nminute = (time - mintime).GetMinutes();
-
-    if (minute2 < minute1 || nminute < minute1 || nminute > minute2) continue;
-
-    double interp_const;
-    if (minute1 == minute2) {
-      // with big grib a copy is slow use a reference.
-      set->m_GribRecordPtrArray[i] = GR1;
-      continue;
-    } else
-      interp_const = (nminute - minute1) / (minute2 - minute1);
-
-    /* if this is a vector interpolation use the 2d method */
-    if (i < Idx_WIND_VY) {
-      GribRecord *GR1y = GRS1->m_GribRecordPtrArray[i + Idx_WIND_VY];
-      GribRecord *GR2y = GRS2->m_GribRecordPtrArray[i + Idx_WIND_VY];
-      if (GR1y && GR2y) {
-        GribRecord *Ry;
-        set->SetUnRefGribRecord(
-            i, GribRecord::Interpolated2DRecord(Ry, *GR1, *GR1y, *GR2, *GR2y,
-                                                interp_const));
-        set->SetUnRefGribRecord(i + Idx_WIND_VY, Ry);
-        continue;
-      }
-    } else if (i <= Idx_WIND_VY300)
-      continue;
-    else if (i == Idx_SEACURRENT_VX) {
-      GribRecord *GR1y = GRS1->m_GribRecordPtrArray[Idx_SEACURRENT_VY];
-      GribRecord *GR2y = GRS2->m_GribRecordPtrArray[Idx_SEACURRENT_VY];
-      if (GR1y && GR2y) {
-        GribRecord *Ry;
-        set->SetUnRefGribRecord(
-            i, GribRecord::Interpolated2DRecord(Ry, *GR1, *GR1y, *GR2, *GR2y,
-                                                interp_const));
-        set->SetUnRefGribRecord(Idx_SEACURRENT_VY, Ry);
-        continue;
-      }
-    } else if (i == Idx_SEACURRENT_VY)
-      continue;
-
-    set->SetUnRefGribRecord(i, GribRecord::InterpolatedRecord(
-                                   *GR1, *GR2, interp_const, i == Idx_WVDIR));
-  }
-
-  set->m_Reference_Time = time.GetTicks();
-  //(1-interp_const)*GRS1.m_Reference_Time + interp_const*GRS2.m_Reference_Time;
-  return set;
+  return m_bGRIBActiveFile->GetTimelineRecordSet(time.GetTicks());
 }
 
 double GRIBUICtrlBar::getTimeInterpolatedValue(int idx, double lon, double lat,
@@ -1950,6 +1888,7 @@ GRIBFile::GRIBFile(const wxArrayString &file_names, bool CumRec, bool WaveRec,
     : m_counter(++ID) {
   m_bOK = false;  // Assume ok until proven otherwise
   m_pGribReader = NULL;
+  m_pTimelineCache = NULL;
   m_last_message = wxEmptyString;
   for (unsigned int i = 0; i < file_names.GetCount(); i++) {
     wxString file_name = file_names[i];
@@ -2318,7 +2257,34 @@ GRIBFile::GRIBFile(const wxArrayString &file_names, bool CumRec, bool WaveRec,
         pRec->getRecordRefDate();  // to ovoid crash with some bad files
 }
 
-GRIBFile::~GRIBFile() { delete m_pGribReader; }
+GRIBFile::~GRIBFile() {
+  delete m_pTimelineCache;  // stops it before the records go
+  delete m_pGribReader;
+}
+
+//  The records at any time, interpolated between those of the file
+GribTimelineRecordSet *GRIBFile::GetTimelineRecordSet(time_t time) {
+  if (m_GribRecordSetArray.GetCount() == 0) return NULL;
+  if (!m_pTimelineCache) {
+    std::vector<GribRecordSet *> sets;
+    for (unsigned int i = 0; i < m_GribRecordSetArray.GetCount(); i++)
+      sets.push_back(&m_GribRecordSetArray.Item(i));
+    m_pTimelineCache = new GribTimelineCache(sets);
+  }
+  std::shared_ptr<GribTimelineStep> step = m_pTimelineCache->GetStep(time);
+
+  GribTimelineRecordSet *set = new GribTimelineRecordSet(m_counter);
+  for (int i = 0; i < Idx_COUNT; i++)
+    set->m_GribRecordPtrArray[i] = step->records[i];
+  set->m_Step = step;  // keeps the interpolated records
+  set->m_Reference_Time = time;
+  return set;
+}
+
+void GRIBFile::PrefetchTimeline(const std::vector<time_t> &times) {
+  if (!m_pTimelineCache) return;  // nothing shown yet
+  m_pTimelineCache->Prefetch(times);
+}
 
 //---------------------------------------------------------------------------------------
 //               GRIB Cursor Data Ctrl & Display implementation
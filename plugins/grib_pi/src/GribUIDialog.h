@@ -35,12 +35,16 @@
 #include <wx/fileconf.h>
 #include <wx/glcanvas.h>
 
+#include <memory>
+#include <vector>
+
 #include "GribUIDialogBase.h"
 #include "CursorData.h"
 #include "GribSettingsDialog.h"
 #include "GribRequestDialog.h"
 #include "GribReader.h"
 #include "GribRecordSet.h"
+#include "GribTimeline.h"
 #include "IsoLine.h"
 #include "GrabberWin.h"
 
@@ -84,6 +88,9 @@ public:
 
   /* cache isobars here to speed up rendering */
   wxArrayPtrVoid *m_IsobarArray[Idx_COUNT];
+
+  /* the interpolated records, shared with the timeline cache */
+  std::shared_ptr<GribTimelineStep> m_Step;
 };
 
 //----------------------------------------------------------------------------------------------------------
@@ -236,6 +243,9 @@ public:
 
   const unsigned int GetCounter() { return m_counter; }
 
+  GribTimelineRecordSet *GetTimelineRecordSet(time_t time);
+  void PrefetchTimeline(const std::vector<time_t> &times);
+
   WX_DEFINE_ARRAY_INT(int, GribIdxArray);
   GribIdxArray m_GribIdxArray;
 
@@ -251,6 +261,7 @@ private:
 
   //    An array of GribRecordSets found in this GRIB file
   ArrayOfGribRecordSets m_GribRecordSetArray;
+  GribTimelineCache *m_pTimelineCache;
 
   int m_nGribRecords;
 };
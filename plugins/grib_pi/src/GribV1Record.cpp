@@ -320,6 +320,7 @@ GribV1Record::GribV1Record(ZUFILE* file, int id_) {
   //   seekStart = zu_tell(file);           // moved to section 0 read
   data = NULL;
   BMSbits = NULL;
+  packedData = NULL;
   eof = false;
   knownData = true;
   IsDuplicated = false;
@@ -413,7 +414,7 @@ GribV1Record::GribV1Record(const GribRecord& rec) : GribRecord(rec) {
 #pragma warning(default : 4717)
 }
 
-GribV1Record::~GribV1Record() {}
+GribV1Record::~GribV1Record() { delete[] packedData; }
 
 //----------------------------------------------
 static zuint readPackedBits(zuchar* buf, zuint first, zuint nbBits) {
@@ -698,7 +699,6 @@ bool GribV1Record::readGribSection4_BDS(ZUFILE* file) {
     ok = false;
     return ok;
   }
-  zuint startbit = 0;
   int datasize = sectionSize4 - 11;
   zuchar* buf =
       new zuchar[datasize +
@@ -714,6 +714,18 @@ bool GribV1Record::readGribSection4_BDS(ZUFILE* file) {
     return ok;
   }
 
+  // Unpacked by decodeData(), if the record is kept
+  packedData = buf;
+  return ok;
+}
+
+//----------------------------------------------
+bool GribV1Record::decodeData() {
+  if (packedData == NULL || !ok) return ok;
+
+  zuchar* buf = packedData;
+  zuint startbit = 0;
+
   // Allocate memory for the data
   data = new double[Ni * Nj];
 
@@ -773,6 +785,8 @@ bool GribV1Record::readGribSection4_BDS(ZUFILE* file) {
   }
 
   delete[] buf;
+  packedData = NULL;
+  applyPendingScale();
   return ok;
 }
 
@@ -34,10 +34,12 @@ class GribV1Record : public GribRecord {
 public:
   GribV1Record(ZUFILE* file, int id_);
   GribV1Record(const GribRecord& rec);
-  GribV1Record() {}
+  GribV1Record() : packedData(NULL) {}
 
   ~GribV1Record();
 
+  bool decodeData();
+
 protected:
 private:
   zuint periodSeconds(zuchar unit, zuchar P1, zuchar P2, zuchar range);
@@ -77,6 +79,7 @@ private:
   double scaleFactorEpow2;
   double refValue;
   zuint nbBitsInPack;
+  zuchar* packedData;  // BDS data until decodeData()
   // SECTION 5: END SECTION (ES)
 
   //---------------------------------------------
@@ -42,7 +42,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "GribV2Record.h"
 
 #ifdef JASPER
+#include <mutex>
+
 #include <jasper/jasper.h>
+
+static std::mutex jasperMutex;
 #endif
 
 const double GRIB_MISSING_VALUE = GRIB_NOTDEF;
@@ -981,9 +985,12 @@ static bool unpackDS(GRIBMessage *grib_msg) {
       len = len - 5;
       jvals = new int[npoints];
       grib_msg->grids.gridpoints = new double[npoints];
-      if (len > 0)
+      if (len > 0) {
+        // records are unpacked on several threads, jasper is not reentrant
+        std::lock_guard<std::mutex> lock(jasperMutex);
         dec_jpeg2000((char *)&grib_msg->buffer[grib_msg->offset / 8 + 5], len,
                      jvals);
+      }
       cnt = 0;
       for (l = 0; l < npoints; l++) {
         if (grib_msg->md.bitmap == NULL || grib_msg->md.bitmap[l] == 1) {
@@ -1002,6 +1009,27 @@ static bool unpackDS(GRIBMessage *grib_msg) {
   return true;
 }
 
+// A message holding a copy of the current data section and of the metadata
+// unpackDS() needs, so the data can be unpacked after grib_msg moved on.
+static GRIBMessage *copyDataSection(const GRIBMessage *grib_msg, int len) {
+  GRIBMessage *copy = new GRIBMessage();
+  // +4 for the look ahead of getBits() at the end of the section
+  copy->buffer = new unsigned char[len + 4]();
+  memcpy(copy->buffer, grib_msg->buffer + grib_msg->offset / 8, len);
+  copy->offset = 0;
+
+  copy->md = grib_msg->md;
+  copy->md.stat_proc.t = 0;
+  copy->md.bms = 0;
+  copy->md.bitmap = 0;
+  if (grib_msg->md.bitmap != NULL) {
+    size_t size = grib_msg->md.bmssize * 8;
+    copy->md.bitmap = new unsigned char[size];
+    memcpy(copy->md.bitmap, grib_msg->md.bitmap, size);
+  }
+  return copy;
+}
+
 static zuchar GRBV2_TO_DATA(int productDiscipline, int dataCat, int dataNum) {
   zuchar ret = 255;
   // printf("search %d %d %d\n", productDiscipline, dataCat,  dataNum);
@@ -1537,6 +1565,8 @@ void GribV2Record::readDataSet(ZUFILE *file) {
   int len, sec_num;
 
   data = NULL;
+  packedData = 0;
+  pendingScale = 1.0;
   BMSbits = NULL;
   hasBMS = false;
   knownData = false;
@@ -1657,13 +1687,7 @@ void GribV2Record::readDataSet(ZUFILE *file) {
         }
         break;
       case 7:  // Section 7: Data Section
-        if (skip == false) {
-          ok = unpackDS(grib_msg);
-          if (ok) {
-            data = grib_msg->grids.gridpoints;
-            grib_msg->grids.gridpoints = 0;
-          }
-        }
+        if (skip == false) packedData = copyDataSection(grib_msg, len);
         if (grib_msg->num_grids != 1) DS = true;
         break;
     }
@@ -1703,6 +1727,7 @@ GribV2Record::GribV2Record(ZUFILE *file, int id_) {
   id = id_;
   seekStart = zu_tell(file);  // moved to section 0 read
   data = NULL;
+  packedData = 0;
   BMSsize = 0;
   BMSbits = NULL;
   hasBMS = false;
@@ -1799,7 +1824,25 @@ GribV2Record::GribV2Record(const GribRecord &rec) : GribRecord(rec) {
 #pragma warning(default : 4717)
 }
 
-GribV2Record::~GribV2Record() { delete grib_msg; }
+GribV2Record::~GribV2Record() {
+  delete grib_msg;
+  delete packedData;
+}
+
+// ---------------------------------------
+bool GribV2Record::decodeData() {
+  if (packedData == 0 || !ok) return ok;
+
+  ok = unpackDS(packedData);
+  if (ok) {
+    data = packedData->grids.gridpoints;
+    packedData->grids.gridpoints = 0;
+  }
+  delete packedData;
+  packedData = 0;
+  if (ok) applyPendingScale();
+  return ok;
+}
 
 //==============================================================
 // Lecture des données
@@ -36,10 +36,15 @@ class GribV2Record : public GribRecord {
 public:
   GribV2Record(ZUFILE* file, int id_);
   GribV2Record(const GribRecord& rec);
-  GribV2Record() { grib_msg = 0; }
+  GribV2Record() {
+    grib_msg = 0;
+    packedData = 0;
+  }
 
   ~GribV2Record();
 
+  bool decodeData();
+
   // return a new record for next data set
   GribV2Record* GribV2NextDataSet(ZUFILE* file, int id_);
   bool hasMoreDataSet() const;
@@ -48,6 +53,7 @@ private:
   zuint periodSeconds(zuchar unit, zuint P1, zuint P2, zuchar range);
   void readDataSet(ZUFILE* file);
   class GRIBMessage* grib_msg;
+  class GRIBMessage* packedData;  // data section until decodeData()
 
   //-----------------------------------------
   void translateDataType();  // adapte les codes des différents centres météo
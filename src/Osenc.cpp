@@ -34,8 +34,18 @@
 
 #include <wx/wfstream.h>
 #include <wx/filename.h>
+#include <wx/ffile.h>
 #include <wx/progdlg.h>
 
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "Osenc.h"
 #include "s52s57.h"
 #include "s57chart.h"  // for one static method
@@ -45,11 +55,14 @@
 #include "ogr_s57.h"
 #include "gdal/cpl_string.h"
 #include "LOD_reduce.h"
+#include "ChartArena.h"
 
 #include "mygeom.h"
 #include "georef.h"
 #include "gui_lib.h"
+#include <atomic>
 #include <mutex>
+#include <thread>
 
 extern s57RegistrarMgr *m_pRegistrarMan;
 extern wxString g_csv_locn;
@@ -139,6 +152,128 @@ void Osenc_instreamFile::Init() {
   m_ok = false;
 }
 
+//--------------------------------------------------------------------------
+//      Osenc_instreamMapped implementation
+//--------------------------------------------------------------------------
+Osenc_instreamMapped::Osenc_instreamMapped() { Init(); }
+
+Osenc_instreamMapped::~Osenc_instreamMapped() { Close(); }
+
+bool Osenc_instreamMapped::Open(const wxString &senc_file_name) {
+  Close();
+
+#ifdef __WXMSW__
+  HANDLE hFile = ::CreateFileW(senc_file_name.wc_str(), GENERIC_READ,
+                               FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (hFile != INVALID_HANDLE_VALUE) {
+    LARGE_INTEGER size;
+    if (::GetFileSizeEx(hFile, &size) && size.QuadPart > 0) {
+      HANDLE hMapping =
+          ::CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+      if (hMapping) {
+        void *view = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        if (view) {
+          m_data = (const unsigned char *)view;
+          m_size = (size_t)size.QuadPart;
+          m_hMapping = hMapping;
+          m_mapped = true;
+        } else
+          ::CloseHandle(hMapping);
+      }
+    }
+    ::CloseHandle(hFile);  // the mapping keeps its own reference
+  }
+#else
+  int fd = open(senc_file_name.fn_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void *view = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (view != MAP_FAILED) {
+        madvise(view, st.st_size, MADV_SEQUENTIAL);
+        m_data = (const unsigned char *)view;
+        m_size = st.st_size;
+        m_mapped = true;
+      }
+    }
+    close(fd);  // the mapping stays valid
+  }
+#endif
+
+  //  No mapping, e.g. on some network file systems: read it all at once
+  if (!m_mapped) {
+    wxFFile file(senc_file_name, _T("rb"));
+    if (!file.IsOpened()) return false;
+
+    wxFileOffset length = file.Length();
+    if (length <= 0) return false;
+
+    unsigned char *data = (unsigned char *)malloc(length);
+    if (!data) return false;
+    if (file.Read(data, length) != (size_t)length) {
+      free(data);
+      return false;
+    }
+    m_data = data;
+    m_size = length;
+  }
+
+  m_pos = 0;
+  m_ok = true;
+  return true;
+}
+
+void Osenc_instreamMapped::Close() {
+  if (m_data) {
+    if (m_mapped) {
+#ifdef __WXMSW__
+      ::UnmapViewOfFile(m_data);
+      ::CloseHandle((HANDLE)m_hMapping);
+#else
+      munmap((void *)m_data, m_size);
+#endif
+    } else
+      free((void *)m_data);
+  }
+  Init();
+}
+
+Osenc_instream &Osenc_instreamMapped::Read(void *buffer, size_t size) {
+  const unsigned char *p = Consume(size);
+  if (p) memcpy(buffer, p, size);
+
+  return *this;
+}
+
+const unsigned char *Osenc_instreamMapped::Consume(size_t size) {
+  if (!m_ok || (size > m_size - m_pos)) {
+    m_ok = false;
+    return NULL;
+  }
+
+  const unsigned char *p = m_data + m_pos;
+  m_pos += size;
+  return p;
+}
+
+bool Osenc_instreamMapped::IsOk() { return m_ok; }
+
+bool Osenc_instreamMapped::isAvailable() { return true; }
+
+void Osenc_instreamMapped::Shutdown() {}
+
+void Osenc_instreamMapped::Init() {
+  m_data = NULL;
+  m_size = 0;
+  m_pos = 0;
+  m_mapped = false;
+#ifdef __WXMSW__
+  m_hMapping = NULL;
+#endif
+  m_ok = false;
+}
+
 //--------------------------------------------------------------------------
 //      Osenc_outstreamFile implementation
 //      A simple file stream implementation based on wxFFileOutStream
@@ -218,6 +353,8 @@ Osenc::~Osenc() {
 
 void Osenc::init(void) {
   m_LOD_meters = 0;
+  m_tess_threads = 1;
+  m_pretess = NULL;
   m_poRegistrar = NULL;
   m_bPrivateRegistrar = false;
   m_senc_file_read_version = 0;
@@ -238,6 +375,7 @@ void Osenc::init(void) {
 
   m_pauxOutstream = NULL;
   m_pauxInstream = NULL;
+  m_arena = NULL;
   m_pOutstream = NULL;
   m_pInstream = NULL;
   m_UpFiles = nullptr;
@@ -537,7 +675,8 @@ int Osenc::ingest200(const wxString &senc_file_name,
   //     wxBufferedInputStream fpx( fpx_u );
 
   //    Sanity check for existence of file
-  Osenc_instreamFile fpx;
+  //    The file is mapped, and record payloads are parsed in place
+  Osenc_instreamMapped fpx;
   fpx.Open(senc_file_name);
   if (!fpx.IsOk()) return ERROR_SENCFILE_NOT_FOUND;
 
@@ -558,51 +697,31 @@ int Osenc::ingest200(const wxString &senc_file_name,
       break;
     }
 
+    //  Every record, known or not, is followed by its payload
+    unsigned char *buf =
+        getRecordPayload(fpx, record.record_length - sizeof(OSENC_Record_Base));
+    if (!buf) {
+      dun = 1;
+      break;
+    }
+
     // Process Records
     switch (record.record_type) {
       case HEADER_SENC_VERSION: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
         uint16_t *pint = (uint16_t *)buf;
         m_senc_file_read_version = *pint;
         break;
       }
       case HEADER_CELL_NAME: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
         m_Name = wxString(buf, wxConvUTF8);
         break;
       }
       case HEADER_CELL_PUBLISHDATE: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
         m_sdate000 = wxString(buf, wxConvUTF8);
         break;
       }
 
       case HEADER_CELL_EDITION: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
         uint16_t *pint = (uint16_t *)buf;
         m_read_base_edtn.Printf(_T("%d"), *pint);
 
@@ -610,25 +729,11 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case HEADER_CELL_UPDATEDATE: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
         m_LastUpdateDate = wxString(buf, wxConvUTF8);
         break;
       }
 
       case HEADER_CELL_UPDATE: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
         uint16_t *pint = (uint16_t *)buf;
         m_read_last_applied_update = *pint;
 
@@ -636,37 +741,16 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case HEADER_CELL_NATIVESCALE: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
         uint32_t *pint = (uint32_t *)buf;
         m_Chart_Scale = *pint;
         break;
       }
 
       case HEADER_CELL_SENCCREATEDATE: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
         break;
       }
 
       case CELL_EXTENT_RECORD: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
         _OSENC_EXTENT_Record_Payload *pPayload =
             (_OSENC_EXTENT_Record_Payload *)buf;
         m_extent.NLAT = pPayload->extent_nw_lat;
@@ -683,38 +767,14 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case CELL_COVR_RECORD: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         break;
       }
 
       case CELL_NOCOVR_RECORD: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         break;
       }
 
       case FEATURE_ID_RECORD: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         // Starting definition of a new feature
         _OSENC_Feature_Identification_Record_Payload *pPayload =
             (_OSENC_Feature_Identification_Record_Payload *)buf;
@@ -737,7 +797,7 @@ int Osenc::ingest200(const wxString &senc_file_name,
         //                     int yyp = 4;
 
         if (acronym.length()) {
-          obj = new S57Obj(acronym.c_str());
+          obj = S57Obj::Create(acronym.c_str(), m_arena);
           obj->Index = featureID;
 
           pObjectVector->push_back(obj);
@@ -747,14 +807,6 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case FEATURE_ATTRIBUTE_RECORD: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         // Get the payload
         OSENC_Attribute_Record_Payload *pPayload =
             (OSENC_Attribute_Record_Payload *)buf;
@@ -823,14 +875,6 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case FEATURE_GEOMETRY_RECORD_POINT: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         // Get the payload
         _OSENC_PointGeometry_Record_Payload *pPayload =
             (_OSENC_PointGeometry_Record_Payload *)buf;
@@ -844,14 +888,6 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case FEATURE_GEOMETRY_RECORD_AREA: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         // Get the payload
         _OSENC_AreaGeometry_Record_Payload *pPayload =
             (_OSENC_AreaGeometry_Record_Payload *)buf;
@@ -875,8 +911,8 @@ int Osenc::ingest200(const wxString &senc_file_name,
 
           // Copy the line index table, which in this case is offset in the
           // payload
-          Descriptor.indexTable =
-              (int *)malloc(pPayload->edgeVector_count * 3 * sizeof(int));
+          Descriptor.indexTable = (int *)allocIndexTable(
+              pPayload->edgeVector_count * 3 * sizeof(int));
           memcpy(Descriptor.indexTable, next_byte,
                  pPayload->edgeVector_count * 3 * sizeof(int));
 
@@ -887,14 +923,6 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case FEATURE_GEOMETRY_RECORD_LINE: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         // Get the payload & parse it
         _OSENC_LineGeometry_Record_Payload *pPayload =
             (_OSENC_LineGeometry_Record_Payload *)buf;
@@ -909,8 +937,8 @@ int Osenc::ingest200(const wxString &senc_file_name,
         lD.indexCount = pPayload->edgeVector_count;
 
         // Copy the payload tables
-        lD.indexTable =
-            (int *)malloc(pPayload->edgeVector_count * 3 * sizeof(int));
+        lD.indexTable = (int *)allocIndexTable(pPayload->edgeVector_count * 3 *
+                                               sizeof(int));
         memcpy(lD.indexTable, &pPayload->payLoad,
                pPayload->edgeVector_count * 3 * sizeof(int));
 
@@ -920,14 +948,6 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case FEATURE_GEOMETRY_RECORD_MULTIPOINT: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         // Get the payload & parse it
         OSENC_MultipointGeometry_Record_Payload *pPayload =
             (OSENC_MultipointGeometry_Record_Payload *)buf;
@@ -950,14 +970,6 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case VECTOR_EDGE_NODE_TABLE_RECORD: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         //  Parse the buffer
         uint8_t *pRun = (uint8_t *)buf;
 
@@ -993,14 +1005,6 @@ int Osenc::ingest200(const wxString &senc_file_name,
       }
 
       case VECTOR_CONNECTED_NODE_TABLE_RECORD: {
-        unsigned char *buf =
-            getBuffer(record.record_length - sizeof(OSENC_Record_Base));
-        if (!fpx.Read(buf, record.record_length - sizeof(OSENC_Record_Base))
-                 .IsOk()) {
-          dun = 1;
-          break;
-        }
-
         //  Parse the buffer
         uint8_t *pRun = (uint8_t *)buf;
 
@@ -1698,6 +1702,11 @@ int Osenc::createSenc200(const wxString &FullPath000,
 
   int iObj = 0;
 
+  //  With several tessellation threads, features are collected in batches
+  //  so that the areas of each batch can be tessellated concurrently
+  std::vector<OGRFeature *> batch;
+  size_t batch_size = m_tess_threads > 1 ? 64 * m_tess_threads : 0;
+
   while (bcont) {
     objectDef = poReader->ReadNextFeature();
 
@@ -1724,6 +1733,13 @@ int Osenc::createSenc200(const wxString &FullPath000,
       }
 #endif
 
+      if (batch_size) {
+        batch.push_back(objectDef);
+        if (batch.size() >= batch_size)
+          CreateSENCRecordBatch200(batch, stream, poReader);
+        continue;
+      }
+
       OGRwkbGeometryType geoType = wkbUnknown;
       //      This test should not be necessary for real (i.e not C_AGGR)
       //      features However... some update files contain errors, and have
@@ -1745,6 +1761,10 @@ int Osenc::createSenc200(const wxString &FullPath000,
       break;
   }
 
+  //  Write the last partial batch, or drop it if cancelled
+  if (bcont) CreateSENCRecordBatch200(batch, stream, poReader);
+  for (size_t i = 0; i < batch.size(); i++) delete batch[i];
+
   if (bcont) {
     //      Create and write the Vector Edge Table
     CreateSENCVectorEdgeTableRecord200(stream, poReader);
@@ -2239,6 +2259,63 @@ bool Osenc::CreateLineFeatureGeometryRecord200(S57Reader *poReader,
   return true;
 }
 
+bool Osenc::CreateSENCRecordBatch200(std::vector<OGRFeature *> &batch,
+                                     Osenc_outstream *stream,
+                                     S57Reader *poReader) {
+  //  Tessellate all the areas of the batch first
+  std::vector<OGRFeature *> areas;
+  for (size_t i = 0; i < batch.size(); i++) {
+    OGRGeometry *pGeo = batch[i]->GetGeometryRef();
+    if (pGeo && (pGeo->getGeometryType() == wkbPolygon) &&
+        ((OGRPolygon *)pGeo)->getExteriorRing())
+      areas.push_back(batch[i]);
+  }
+  std::vector<PolyTessGeo *> tess(areas.size(), (PolyTessGeo *)NULL);
+
+  if (areas.size()) {
+    std::atomic<size_t> next(0);
+    auto tessellate = [&]() {
+      for (size_t i = next++; i < areas.size(); i = next++) {
+        OGRPolygon *poly = (OGRPolygon *)areas[i]->GetGeometryRef();
+        tess[i] =
+            new PolyTessGeo(poly, true, m_ref_lat, m_ref_lon, m_LOD_meters);
+      }
+    };
+
+    //  As for a single area, other SENC builds may proceed meanwhile
+    lockCR.unlock();
+    size_t n_threads = wxMin((size_t)m_tess_threads, areas.size());
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < n_threads; i++) helpers.emplace_back(tessellate);
+    tessellate();
+    for (size_t i = 0; i < helpers.size(); i++) helpers[i].join();
+    lockCR.lock();
+  }
+
+  //  Then write the records in reader order
+  bool ret = true;
+  size_t iarea = 0;
+  for (size_t i = 0; i < batch.size(); i++) {
+    OGRFeature *objectDef = batch[i];
+    if ((iarea < areas.size()) && (areas[iarea] == objectDef))
+      m_pretess = tess[iarea++];
+
+    OGRGeometry *pGeo = objectDef->GetGeometryRef();
+    if (pGeo && (pGeo->getGeometryType() != wkbUnknown)) {
+      if (!CreateSENCRecord200(objectDef, stream, 1, poReader)) ret = false;
+    }
+
+    //  Left over if the record failed before reaching its geometry
+    delete m_pretess;
+    m_pretess = NULL;
+
+    delete objectDef;
+  }
+  batch.clear();
+
+  return ret;
+}
+
 bool Osenc::CreateAreaFeatureGeometryRecord200(S57Reader *poReader,
                                                OGRFeature *pFeature,
                                                Osenc_outstream *stream) {
@@ -2251,9 +2328,14 @@ bool Osenc::CreateAreaFeatureGeometryRecord200(S57Reader *poReader,
 
   if (!poly->getExteriorRing()) return false;
 
-  lockCR.unlock();
-  ppg = new PolyTessGeo(poly, true, m_ref_lat, m_ref_lon, m_LOD_meters);
-  lockCR.lock();
+  if (m_pretess) {
+    ppg = m_pretess;
+    m_pretess = NULL;
+  } else {
+    lockCR.unlock();
+    ppg = new PolyTessGeo(poly, true, m_ref_lat, m_ref_lon, m_LOD_meters);
+    lockCR.lock();
+  }
 
   error_code = ppg->ErrorCode;
 
@@ -3705,6 +3787,28 @@ void Osenc::InitializePersistentBuffer(void) {
   bufferSize = 1024;
 }
 
+//  Payloads are used in place in the mapped file. Some ARM targets fault
+//  on unaligned multi-byte loads, so copy to the aligned buffer there.
+//  Line index tables become owned by their S57Obj
+void *Osenc::allocIndexTable(size_t size) {
+  if (m_arena) return m_arena->Alloc(size);
+  return malloc(size);
+}
+
+unsigned char *Osenc::getRecordPayload(Osenc_instreamMapped &stream,
+                                       size_t length) {
+  const unsigned char *payload = stream.Consume(length);
+  if (!payload) return NULL;
+
+#ifdef __ARM_ARCH
+  unsigned char *buf = getBuffer(length);
+  memcpy(buf, payload, length);
+  return buf;
+#else
+  return (unsigned char *)payload;
+#endif
+}
+
 unsigned char *Osenc::getBuffer(size_t length) {
   if (length > bufferSize) {
     pBuffer = (unsigned char *)realloc(pBuffer, length * 2);
@@ -249,6 +249,8 @@ Quilt::Quilt(ChartCanvas *parent) {
   m_bquiltskew = g_bopengl;
   //  Quilting of different projections is allowed for OpenGL only
   m_bquiltanyproj = g_bopengl;
+
+  m_index_db = NULL;
 }
 
 Quilt::~Quilt() {
@@ -466,9 +468,10 @@ ChartBase *Quilt::GetLargestScaleChart() {
   return pret;
 }
 
-LLRegion Quilt::GetChartQuiltRegion(const ChartTableEntry &cte, ViewPort &vp) {
+LLRegion Quilt::GetChartQuiltRegion(const ChartTableEntry &cte,
+                                    const LLBBox &box) {
   LLRegion chart_region;
-  LLRegion screen_region(vp.GetBBox());
+  LLRegion screen_region(box);
 
   // Special case for charts which extend around the world, or near to it
   //  Mostly this means cm93....
@@ -490,8 +493,7 @@ LLRegion Quilt::GetChartQuiltRegion(const ChartTableEntry &cte, ViewPort &vp) {
             OCPNRegion t_region = vp.GetVPRegionIntersect( screen_region, 4,
        &ply[0], cte.GetScale() ); return t_region;
     */
-    return LLRegion(-80, vp.GetBBox().GetMinLon(), 80,
-                    vp.GetBBox().GetMaxLon());
+    return LLRegion(-80, box.GetMinLon(), 80, box.GetMaxLon());
   }
 
   //    If the chart has an aux ply table, use it for finer region precision
@@ -1334,49 +1336,23 @@ bool Quilt::BuildExtendedChartStackAndCandidateArray(int ref_db_index,
   //    which intersect the ViewPort in any way
   //    .AND. other requirements.
   //    Again, skipping cm93 for now
-  int n_all_charts = ChartData->GetChartTableEntries();
-
+  //    The charts passing the tests which do not depend on where the
+  //    ViewPort is are kept in an index, so only those near it are visited
   LLBBox viewbox = vp_local.GetBBox();
   int sure_index = -1;
   int sure_index_scale = 0;
   int sure_index_type = -1;
 
-  for (int i = 0; i < n_all_charts; i++) {
-    //    We can eliminate some charts immediately
-    //    Try to make these tests in some sensible order....
-
-    int groupIndex = m_parent->m_groupIndex;
-    if ((groupIndex > 0) && (!ChartData->IsChartInGroup(i, groupIndex)))
-      continue;
+  BuildChartIndex(reference_family, quilt_proj);
+  SearchChartIndex(viewbox, m_chart_ids);
 
+  for (unsigned int ic = 0; ic < m_chart_ids.size(); ic++) {
+    int i = m_chart_ids[ic];
     const ChartTableEntry &cte = ChartData->GetChartTableEntry(i);
 
-    //  On android, SDK > 29, we require that the directory of charts be "writable"
-    //  as determined by Android Java file system
-#ifdef __OCPN__ANDROID__
-    wxFileName fn(cte.GetFullSystemPath());
-    if (!androidIsDirWritable( fn.GetPath()))
-      continue;
-#endif
-
-    if (reference_family != cte.GetChartFamily()) {
-      if (cte.GetChartType() != CHART_TYPE_MBTILES)
-        continue;
-    }
-
-    if (cte.GetChartType() == CHART_TYPE_CM93COMP) continue;
-
     const LLBBox &chart_box = cte.GetBBox();
     if ((viewbox.IntersectOut(chart_box))) continue;
 
-    if (!m_bquiltanyproj && quilt_proj != cte.GetChartProjectionType())
-      continue;
-
-    double skew_norm = cte.GetChartSkew();
-    if (skew_norm > 180.) skew_norm -= 360.;
-
-    if (!m_bquiltskew && fabs(skew_norm) > 1.0) continue;
-
     //    Special case for S57 ENC
     //    Add the chart only if the chart's fractional area exceeds n%
     if( CHART_TYPE_S57 == cte.GetChartType() ) {
@@ -1422,12 +1398,10 @@ bool Quilt::BuildExtendedChartStackAndCandidateArray(int ref_db_index,
 
     if ((cte.Scale_ge(ref_scale_test) && (zoom_factor > zoom_test_val)) || (zoom_factor > zoom_factor_test_extra)) {
 
-      LLRegion cell_region = GetChartQuiltRegion(cte, vp_local);
-
       // this is false if the chart has no actual overlap on screen
       // or lots of NoCovr regions.  US3EC04.000 is a good example
       // i.e the full bboxes overlap, but the actual vp intersect is null.
-      if (!cell_region.Empty()) {
+      if (IsChartRegionInBox(i, viewbox)) {
         // Check to see if this chart is already in the stack array
         // by virtue of being under the Viewport center point....
         bool b_exists = false;
@@ -1516,6 +1490,126 @@ bool Quilt::BuildExtendedChartStackAndCandidateArray(int ref_db_index,
   return true;
 }
 
+void Quilt::InvalidateCache() {
+  m_index_db = NULL;
+  m_region_extent.Invalidate();
+  m_chart_regions.clear();
+  m_patch_key.clear();
+  m_patch_regions.clear();
+}
+
+//  Index the charts which may join a quilt of the reference family and
+//  projection, by the tests which do not depend on the ViewPort.
+void Quilt::BuildChartIndex(int reference_family, int quilt_proj) {
+  int groupIndex = m_parent->m_groupIndex;
+  int n_all_charts = ChartData->GetChartTableEntries();
+
+  if (m_index_db == ChartData && m_index_entries == n_all_charts &&
+      m_index_group == groupIndex && m_index_family == reference_family &&
+      m_index_proj == quilt_proj && m_index_anyproj == m_bquiltanyproj &&
+      m_index_skew == m_bquiltskew)
+    return;
+
+  m_chart_index.Clear();
+  for (int i = 0; i < n_all_charts; i++) {
+    //    We can eliminate some charts immediately
+    //    Try to make these tests in some sensible order....
+    if ((groupIndex > 0) && (!ChartData->IsChartInGroup(i, groupIndex)))
+      continue;
+
+    const ChartTableEntry &cte = ChartData->GetChartTableEntry(i);
+
+    //  On android, SDK > 29, we require that the directory of charts be "writable"
+    //  as determined by Android Java file system
+#ifdef __OCPN__ANDROID__
+    wxFileName fn(cte.GetFullSystemPath());
+    if (!androidIsDirWritable( fn.GetPath()))
+      continue;
+#endif
+
+    if (reference_family != cte.GetChartFamily()) {
+      if (cte.GetChartType() != CHART_TYPE_MBTILES)
+        continue;
+    }
+
+    if (cte.GetChartType() == CHART_TYPE_CM93COMP) continue;
+
+    if (!m_bquiltanyproj && quilt_proj != cte.GetChartProjectionType())
+      continue;
+
+    double skew_norm = cte.GetChartSkew();
+    if (skew_norm > 180.) skew_norm -= 360.;
+
+    if (!m_bquiltskew && fabs(skew_norm) > 1.0) continue;
+
+    const LLBBox &chart_box = cte.GetBBox();
+    if (!chart_box.GetValid()) continue;
+    m_chart_index.Insert(chart_box.GetMinLat(), chart_box.GetMinLon(),
+                         chart_box.GetMaxLat(), chart_box.GetMaxLon(), i);
+  }
+  m_chart_index.Build();
+
+  m_index_db = ChartData;
+  m_index_entries = n_all_charts;
+  m_index_group = groupIndex;
+  m_index_family = reference_family;
+  m_index_proj = quilt_proj;
+  m_index_anyproj = m_bquiltanyproj;
+  m_index_skew = m_bquiltskew;
+}
+
+//  The indexed charts whose boxes may meet box, in database order
+void Quilt::SearchChartIndex(const LLBBox &box, std::vector<int> &ids) {
+  ids.clear();
+
+  //  A little more than the margin of LLBBox::IntersectOut(), and the box
+  //  again a turn of the globe either way for the date line
+  const double marge = 1e-5;
+  for (int turn = -1; turn <= 1; turn++)
+    m_chart_index.Search(box.GetMinLat() - marge,
+                         box.GetMinLon() + 360. * turn - marge,
+                         box.GetMaxLat() + marge,
+                         box.GetMaxLon() + 360. * turn + marge, ids);
+
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+//  Does the quilt region of the chart reach into box?  The regions are
+//  worked out for a larger box around it and kept while the ViewPort
+//  stays inside that, so panning only computes them for charts coming
+//  into view.
+bool Quilt::IsChartRegionInBox(int db_index, const LLBBox &box) {
+  if (!m_region_extent.GetValid() || !m_region_extent.IntersectIn(box)) {
+    double lat_marge = box.GetLatRange() / 2;
+    double lon_marge = box.GetLonRange() / 2;
+    m_region_extent.Set(wxMax(box.GetMinLat() - lat_marge, -90.),
+                        box.GetMinLon() - lon_marge,
+                        wxMin(box.GetMaxLat() + lat_marge, 90.),
+                        box.GetMaxLon() + lon_marge);
+    m_chart_regions.clear();
+  }
+
+  //  Charts going around the world always have a region on screen
+  const ChartTableEntry &cte = ChartData->GetChartTableEntry(db_index);
+  if (fabs(cte.GetLonMax() - cte.GetLonMin()) > 180.) return true;
+
+  std::map<int, LLRegion>::iterator it = m_chart_regions.find(db_index);
+  if (it == m_chart_regions.end()) {
+    it = m_chart_regions
+             .insert(std::make_pair(db_index,
+                                    GetChartQuiltRegion(cte, m_region_extent)))
+             .first;
+  }
+
+  const LLRegion &chart_region = it->second;
+  if (chart_region.Empty() || chart_region.IntersectOut(box)) return false;
+
+  LLRegion box_region(box);
+  box_region.Intersect(chart_region);
+  return !box_region.Empty();
+}
+
 int Quilt::AdjustRefSelection(const ViewPort &vp_in) {
   //  Starting from the currently selected Ref chart,
   //  choose a ref chart that meets the required under/overzoom limits
@@ -2145,10 +2239,25 @@ bool Quilt::Compose(const ViewPort &vp_in) {
 
   //    Generate the final render regions for the patches, one by one
 
-  m_covered_region.Clear();
 #if 1  // this does the same as before with a lot less operations if there are
        // many charts
 
+  //  Before clipping to the ViewPort the patch regions depend only on the
+  //  patches, so they are kept while panning over the same ones
+  std::vector<int> patch_key;
+  patch_key.push_back(m_reference_type == CHART_TYPE_CM93COMP);
+  patch_key.push_back(b_has_overlays);
+  for (unsigned int i = 0; i < m_PatchList.GetCount(); i++) {
+    QuiltPatch *piqp = m_PatchList.Item(i)->GetData();
+    patch_key.push_back(piqp->b_Valid ? piqp->dbIndex : -1 - piqp->dbIndex);
+  }
+  bool b_patches_same = patch_key == m_patch_key;
+  if (!b_patches_same) {
+    m_patch_key.swap(patch_key);
+    m_patch_regions.assign(m_PatchList.GetCount(), LLRegion());
+    m_covered_region.Clear();
+  }
+
   //  If the reference chart is cm93, we need to render it first.
   bool b_skipCM93 = false;
   if (m_reference_type == CHART_TYPE_CM93COMP) {
@@ -2163,12 +2272,15 @@ bool Quilt::Compose(const ViewPort &vp_in) {
 
       if (m.GetChartType() == CHART_TYPE_CM93COMP) {
         //    Start with the chart's full region coverage.
-        piqp->ActiveRegion = piqp->quilt_region;
-        piqp->ActiveRegion.Intersect(cvp_region);
+        if (!b_patches_same) {
+          m_patch_regions[i] = piqp->quilt_region;
 
-        //    Update the next pass full region to remove the region just
-        //    allocated
-        m_covered_region.Union(piqp->quilt_region);
+          //    Update the next pass full region to remove the region just
+          //    allocated
+          m_covered_region.Union(piqp->quilt_region);
+        }
+        piqp->ActiveRegion = m_patch_regions[i];
+        piqp->ActiveRegion.Intersect(cvp_region);
 
         b_skipCM93 = true;  // did this already...
         break;
@@ -2190,31 +2302,35 @@ bool Quilt::Compose(const ViewPort &vp_in) {
       if (cte.GetChartType() == CHART_TYPE_CM93COMP) continue;
     }
 
-    //    Start with the chart's full region coverage.
-    piqp->ActiveRegion = piqp->quilt_region;
+    piqp->b_overlay = false;
+    if (cte.GetChartFamily() == CHART_FAMILY_VECTOR) {
+      piqp->b_overlay = s57chart::IsCellOverlayType(cte.GetFullSystemPath());
+    }
 
-    // this operation becomes expensive with lots of charts
-    if (!b_has_overlays && m_PatchList.GetCount() < 25)
-      piqp->ActiveRegion.Subtract(m_covered_region);
+    if (!b_patches_same) {
+      //    Start with the chart's full region coverage.
+      m_patch_regions[i] = piqp->quilt_region;
 
+      // this operation becomes expensive with lots of charts
+      if (!b_has_overlays && m_PatchList.GetCount() < 25)
+        m_patch_regions[i].Subtract(m_covered_region);
+
+      //    Maintain the present full quilt coverage region
+      if (!piqp->b_overlay) m_covered_region.Union(piqp->quilt_region);
+    }
+
+    piqp->ActiveRegion = m_patch_regions[i];
     piqp->ActiveRegion.Intersect(cvp_region);
 
     //    Could happen that a larger scale chart covers completely a smaller
     //    scale chart
     if (piqp->ActiveRegion.Empty() && (piqp->dbIndex != m_refchart_dbIndex))
       piqp->b_eclipsed = true;
-
-    //    Maintain the present full quilt coverage region
-    piqp->b_overlay = false;
-    if (cte.GetChartFamily() == CHART_FAMILY_VECTOR) {
-      piqp->b_overlay = s57chart::IsCellOverlayType(cte.GetFullSystemPath());
-    }
-
-    if (!piqp->b_overlay) m_covered_region.Union(piqp->quilt_region);
   }
 #else
   // this is the old algorithm does the same thing in n^2/2 operations instead
   // of 2*n-1
+  m_covered_region.Clear();
   for (unsigned int i = 0; i < m_PatchList.GetCount(); i++) {
     wxPatchListNode *pcinode = m_PatchList.Item(i);
     QuiltPatch *piqp = pcinode->GetData();
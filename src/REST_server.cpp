@@ -23,6 +23,7 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
  **************************************************************************/
 
+#include <algorithm>
 #include <mutex>
 #include <vector>
 #include <memory>
@@ -50,6 +51,7 @@
 #include "track.h"
 #include "routeman.h"
 #include "nav_object_database.h"
+#include "nav_history.h"
 #ifndef CLIAPP
 #include "routemanagerdialog.h"
 #endif
@@ -221,6 +223,7 @@ bool RESTServer::LoadConfig( void )
       wxString client_name = s1.BeforeFirst(':');
       wxString client_key = s1.AfterFirst(':');
 
+      std::lock_guard<std::mutex> lock(m_key_mutex);
       m_key_map[client_name.ToStdString()] = client_key.ToStdString();
     }
     TheBaseConfig()->Read("ServerOverwriteDuplicates", &m_b_overwrite, 0 );
@@ -328,7 +331,10 @@ void RESTServer::HandleServerMessage(RESTServerEvent& event) {
     std::string new_api_key = PINtoRandomKeyString(m_dPIN);
 
     //  Add new PIN to map
-    m_key_map[event.m_source_peer] = new_api_key;
+    {
+      std::lock_guard<std::mutex> lock(m_key_mutex);
+      m_key_map[event.m_source_peer] = new_api_key;
+    }
 
     // And persist it
     SaveConfig();
@@ -554,6 +560,66 @@ void RESTServer::HandleServerMessage(RESTServerEvent& event) {
 
 
 
+bool RESTServer::IsApiKeyValid(const std::string& source,
+                               const std::string& key) {
+  std::lock_guard<std::mutex> lock(m_key_mutex);
+  auto it = m_key_map.find(source);
+  return it != m_key_map.end() && key.size() && it->second == key;
+}
+
+//  Query variable name, URL decoded, or "" when absent or badly encoded
+static std::string GetQueryVar(struct mg_http_message *hm, const char* name) {
+  struct mg_str parm = mg_http_var(hm->query, mg_str(name));
+  if (!parm.len || !parm.ptr) return "";
+  std::string value(parm.len + 1, '\0');
+  int n = mg_url_decode(parm.ptr, parm.len, &value[0], value.size(), 1);
+  if (n < 0) return "";
+  value.resize(n);
+  return value;
+}
+
+//  Reply to /api/history?source=&apikey=&series=&from=&to=&step= with the
+//  samples as [time, value] pairs.  Answered here in the server thread, the
+//  history database has its own connection for queries.
+static void ReplyNavHistory(struct mg_connection *c,
+                            struct mg_http_message *hm, RESTServer *parent) {
+  std::string source = GetQueryVar(hm, "source");
+  std::string api_key = GetQueryVar(hm, "apikey");
+  std::string series = GetQueryVar(hm, "series");
+  std::vector<std::string> names = NavHistory::GetSeriesNames();
+  if (!parent || !parent->IsApiKeyValid(source, api_key) ||
+      std::find(names.begin(), names.end(), series) == names.end()) {
+    mg_http_reply(c, 200, "", "{\"result\": %d}\n",
+                  RESTServerResult::RESULT_GENERIC_ERROR);
+    return;
+  }
+
+  time_t to = time(0);
+  std::string s = GetQueryVar(hm, "to");
+  if (s.size()) to = strtoll(s.c_str(), NULL, 10);
+  time_t from = to - 3600;
+  s = GetQueryVar(hm, "from");
+  if (s.size()) from = strtoll(s.c_str(), NULL, 10);
+  int step = atoi(GetQueryVar(hm, "step").c_str());
+
+  std::string reply = "{\"result\": 0, \"series\": \"" + series +
+                      "\", \"samples\": [";
+  //  The values as stored, positions to 1e-6 degrees
+  int decimals = NavHistory::GetSeriesDecimals(series);
+  char item[64];
+  bool first = true;
+  for (const NavHistorySample& sample :
+       NavHistory::GetInstance().Query(series, from, to, step)) {
+    snprintf(item, sizeof(item), "%s[%lld, %.*f]", first ? "" : ", ",
+             (long long)sample.time, decimals, sample.value);
+    reply += item;
+    first = false;
+  }
+  reply += "]}\n";
+  mg_http_reply(c, 200, "Content-Type: application/json\r\n", "%s",
+                reply.c_str());
+}
+
 // We use the same event handler function for HTTP and HTTPS connections
 // fn_data is NULL for plain HTTP, and non-NULL for HTTPS
 static void fn(struct mg_connection *c, int ev, void *ev_data, void *fn_data) {
@@ -605,6 +671,8 @@ static void fn(struct mg_connection *c, int ev, void *ev_data, void *fn_data) {
         lock.unlock();
       }
       mg_http_reply(c, 200, "", "{\"result\": %d}\n", return_status);
+    } else if (mg_http_match_uri(hm, "/api/history")) {
+      ReplyNavHistory(c, hm, parent);
     } else if (mg_http_match_uri(hm, "/api/rx_object")) {
       int MID = ORS_CHUNK_N;
 
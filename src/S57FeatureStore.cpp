@@ -0,0 +1,163 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  S57 Chart render culling index
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include <wx/math.h>
+
+#include "S57FeatureStore.h"
+#include "s52plib.h"
+#include "bbox.h"
+
+extern s52plib *ps52plib;
+
+//  Objects further than this off the view can still show symbols or text
+//  inside it, s52plib grows their boxes as they are rendered.
+static const double kCullMarginPixels = 128.;
+
+//  The largest SCAMIN allowance of the chart zoom modifier in s52plib
+static const double kMaxScaminModifier = 8.;
+
+//  Floats rounded away from the value, so the stored box always contains
+//  the double precision one
+static float FloatBelow(double v) {
+  float f = (float)v;
+  return (double)f > v ? std::nextafter(f, -FLT_MAX) : f;
+}
+
+static float FloatAbove(double v) {
+  float f = (float)v;
+  return (double)f < v ? std::nextafter(f, FLT_MAX) : f;
+}
+
+S57FeatureStore::S57FeatureStore() : m_valid(false) {}
+
+void S57FeatureStore::Build(ObjRazRules *const rules[PRIO_NUM][LUPNAME_NUM]) {
+  Clear();
+  for (int i = 0; i < PRIO_NUM; ++i) {
+    for (int j = 0; j < LUPNAME_NUM; j++) {
+      for (ObjRazRules *top = rules[i][j]; top != NULL; top = top->next) {
+        S57Obj *obj = top->obj;
+        const LLBBox &box = obj->BBObj;
+
+        S57FeatureInfo info;
+        info.has_box = box.GetValid();
+        info.lat_min = info.has_box ? box.GetMinLat() : 0.;
+        info.lat_max = info.has_box ? box.GetMaxLat() : 0.;
+        info.lon_min = info.has_box ? box.GetMinLon() : 0.;
+        info.lon_max = info.has_box ? box.GetMaxLon() : 0.;
+        info.scamin = obj->Scamin;
+        info.category = obj->m_DisplayCat;
+        info.category_mutable = obj->m_bcategory_mutable;
+        Add(i, j, top, info);
+      }
+    }
+  }
+  m_valid = true;
+}
+
+void S57FeatureStore::Clear() {
+  for (int i = 0; i < PRIO_NUM; ++i) {
+    for (int j = 0; j < LUPNAME_NUM; j++) {
+      FeatureList &list = m_lists[i][j];
+      list.has_box = (j >= 2);  // lines and areas
+      list.lat_min.clear();
+      list.lat_max.clear();
+      list.lon_min.clear();
+      list.lon_max.clear();
+      list.scamin_limit.clear();
+      list.category.clear();
+      list.rules.clear();
+    }
+  }
+  m_valid = false;
+}
+
+void S57FeatureStore::Add(int prio, int lup_type, ObjRazRules *rules,
+                          const S57FeatureInfo &info) {
+  FeatureList &list = m_lists[prio][lup_type];
+  LUPrec *LUP = rules->LUP;
+
+  if (info.has_box) {
+    list.lat_min.push_back(FloatBelow(info.lat_min));
+    list.lat_max.push_back(FloatAbove(info.lat_max));
+    list.lon_min.push_back(FloatBelow(info.lon_min));
+    list.lon_max.push_back(FloatAbove(info.lon_max));
+  } else {
+    list.lat_min.push_back(-1000.f);
+    list.lat_max.push_back(1000.f);
+    list.lon_min.push_back(-1000.f);
+    list.lon_max.push_back(1000.f);
+  }
+
+  //  Same exemptions as s52plib::ObjectRenderCheckCat().  Objects whose
+  //  category a CS procedure may change are left to s52plib.
+  float scamin_limit = 0.f;
+  if (LUP && LUP->DISC != DISPLAYBASE && LUP->DPRI != PRIO_GROUP1 &&
+      !info.category_mutable && info.scamin > 0)
+    scamin_limit = FloatAbove(info.scamin * kMaxScaminModifier);
+  list.scamin_limit.push_back(scamin_limit);
+
+  char category = 0;
+  if (LUP && !info.category_mutable && strncmp(LUP->OBCL, "SOUNDG", 6))
+    category = (char)info.category;
+  list.category.push_back(category);
+
+  list.rules.push_back(rules);
+}
+
+S57CullParms S57FeatureStore::MakeCullParms(const LLBBox &vp_box,
+                                            double view_scale_ppm,
+                                            double chart_scale) {
+  S57CullParms cull;
+
+  cull.use_box = vp_box.GetValid() && view_scale_ppm > 0 &&
+                 vp_box.GetLonRange() < 360.;
+  if (cull.use_box) {
+    double margin = kCullMarginPixels / view_scale_ppm / 111120.;
+    double clat = (vp_box.GetMinLat() + vp_box.GetMaxLat()) / 2.;
+    double margin_lon = margin / wxMax(cos(clat * M_PI / 180.), 0.05);
+    cull.lat_min = FloatBelow(vp_box.GetMinLat() - margin);
+    cull.lat_max = FloatAbove(vp_box.GetMaxLat() + margin);
+    cull.lon_min = FloatBelow(vp_box.GetMinLon() - margin_lon);
+    cull.lon_max = FloatAbove(vp_box.GetMaxLon() + margin_lon);
+  } else {
+    cull.lat_min = cull.lat_max = cull.lon_min = cull.lon_max = 0.f;
+  }
+
+  cull.chart_scale = 0.;
+  if (ps52plib && ps52plib->m_bUseSCAMIN) cull.chart_scale = chart_scale;
+
+  cull.display_category = 0;
+  if (ps52plib) {
+    DisCat cat = ps52plib->GetDisplayCategory();
+    if (cat == DISPLAYBASE || cat == STANDARD)
+      cull.display_category = (char)cat;
+  }
+
+  return cull;
+}
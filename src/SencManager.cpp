@@ -30,6 +30,11 @@
 #include "wx/wx.h"
 #endif  // precompiled headers
 
+#include <chrono>
+#include <cmath>
+
+#include <wx/math.h>
+
 #include "s57chart.h"
 #include "Osenc.h"
 #include "chcanv.h"
@@ -45,6 +50,8 @@ extern S57ClassRegistrar *g_poRegistrar;
 SENCJobTicket::SENCJobTicket() {
   m_SENCResult = SENC_BUILD_INACTIVE;
   m_status = THREAD_INACTIVE;
+  m_thread = NULL;
+  m_native_scale = 0;
 }
 
 const wxEventType wxEVT_OCPN_BUILDSENCTHREAD = wxNewEventType();
@@ -84,6 +91,10 @@ SENCThreadManager::SENCThreadManager() {
   m_max_jobs = wxMax(nCPU - 1, 1);
   // m_max_jobs = 1;
 
+  m_nworkers = 0;
+  m_nidle = 0;
+  m_view_scale = 0;
+
   //    if(bthread_debug)
   printf(" SENC: nCPU: %d    m_max_jobs :%d\n", nCPU, m_max_jobs);
 
@@ -102,14 +113,19 @@ SENCThreadManager::~SENCThreadManager() {
 }
 
 SENCThreadStatus SENCThreadManager::ScheduleJob(SENCJobTicket *ticket) {
-  //  Do not add a job if there is already a job pending for this chart, by name
-  for (size_t i = 0; i < ticket_list.size(); i++) {
-    if (ticket_list[i]->m_FullPath000 == ticket->m_FullPath000)
-      return THREAD_PENDING;
-  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
 
-  ticket->m_status = THREAD_PENDING;
-  ticket_list.push_back(ticket);
+    //  Do not add a job if there is already a job pending for this chart, by
+    //  name
+    for (size_t i = 0; i < ticket_list.size(); i++) {
+      if (ticket_list[i]->m_FullPath000 == ticket->m_FullPath000)
+        return THREAD_PENDING;
+    }
+
+    ticket->m_status = THREAD_PENDING;
+    ticket_list.push_back(ticket);
+  }
 
   // printf("Scheduling job:  %s\n", (const
   // char*)ticket->m_FullPath000.mb_str()); printf("Job count:  %d\n",
@@ -119,41 +135,37 @@ SENCThreadStatus SENCThreadManager::ScheduleJob(SENCJobTicket *ticket) {
 }
 
 void SENCThreadManager::StartTopJob() {
-  SENCJobTicket *startCandidate;
-  // Get the running job count
   int nRunning = 0;
-  for (size_t i = 0; i < ticket_list.size(); i++) {
-    if (ticket_list[i]->m_status == THREAD_STARTED) nRunning++;
-  }
+  size_t nJobs;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
 
-  // OK to start one?
-  if (nRunning < m_max_jobs) {
-    // Find the first eligible
-    startCandidate = NULL;
+    // Get the running and waiting job counts
+    int nPending = 0;
     for (size_t i = 0; i < ticket_list.size(); i++) {
-      if (ticket_list[i]->m_status == THREAD_PENDING) {
-        startCandidate = ticket_list[i];
-        break;
-      }
+      if (ticket_list[i]->m_status == THREAD_STARTED) nRunning++;
+      if (ticket_list[i]->m_status == THREAD_PENDING) nPending++;
     }
+    nJobs = ticket_list.size();
 
-    // Found one?
-    if (startCandidate) {
-      // printf("Starting job:  %s\n", (const
-      // char*)startCandidate->m_FullPath000.mb_str());
-
-      SENCBuildThread *thread = new SENCBuildThread(startCandidate, this);
-      startCandidate->m_thread = thread;
-      startCandidate->m_status = THREAD_STARTED;
+    // Grow the pool if no idle worker is left to take the waiting jobs
+    if ((nPending > m_nidle) && (m_nworkers < m_max_jobs)) {
+      SENCBuildThread *thread = new SENCBuildThread(this);
       thread->SetPriority(20);
       thread->Run();
+      m_nworkers++;
+    }
+
+    // The workers pick the best job for the current view themselves
+    if (nPending) {
+      m_job_cond.notify_all();
       nRunning++;
     }
   }
 
   if (nRunning) {
     wxString count;
-    count.Printf(_T("  %ld"), ticket_list.size());
+    count.Printf(_T("  %ld"), nJobs);
     if (gFrame->GetPrimaryCanvas())
       gFrame->GetPrimaryCanvas()->SetAlertString(_("Preparing vector chart  ") +
                                                  count);
@@ -164,28 +176,29 @@ void SENCThreadManager::FinishJob(SENCJobTicket *ticket) {
   // printf("Finishing job:  %s\n", (const
   // char*)ticket->m_FullPath000.mb_str());
 
-  // Find and remove the ticket from the list
-  for (size_t i = 0; i < ticket_list.size(); i++) {
-    if (ticket_list[i] == ticket) {
-      // printf("   Removing job:  %s\n", (const
-      // char*)ticket->m_FullPath000.mb_str());
+  int nRunning = 0;
+  size_t nJobs;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
 
-      ticket_list.erase(ticket_list.begin() + i);
-      // printf("Job count:  %d\n", ticket_list.size());
+    // Find and remove the ticket from the list
+    for (size_t i = 0; i < ticket_list.size(); i++) {
+      if (ticket_list[i] == ticket) {
+        ticket_list.erase(ticket_list.begin() + i);
+        break;
+      }
+    }
 
-      break;
+    for (size_t i = 0; i < ticket_list.size(); i++) {
+      if (ticket_list[i]->m_status == THREAD_STARTED) nRunning++;
     }
+    nJobs = ticket_list.size();
   }
 
 #if 1
-  int nRunning = 0;
-  for (size_t i = 0; i < ticket_list.size(); i++) {
-    if (ticket_list[i]->m_status == THREAD_STARTED) nRunning++;
-  }
-
   if (nRunning) {
     wxString count;
-    count.Printf(_T("  %ld"), ticket_list.size());
+    count.Printf(_T("  %ld"), nJobs);
     if (gFrame->GetPrimaryCanvas())
       gFrame->GetPrimaryCanvas()->SetAlertString(_("Preparing vector chart  ") +
                                                  count);
@@ -196,9 +209,13 @@ void SENCThreadManager::FinishJob(SENCJobTicket *ticket) {
 #endif
 }
 
-int SENCThreadManager::GetJobCount() { return ticket_list.size(); }
+int SENCThreadManager::GetJobCount() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return ticket_list.size();
+}
 
 bool SENCThreadManager::IsChartInTicketlist(s57chart *chart) {
+  std::lock_guard<std::mutex> lock(m_mutex);
   for (size_t i = 0; i < ticket_list.size(); i++) {
     if (ticket_list[i]->m_chart == chart) return true;
   }
@@ -206,16 +223,120 @@ bool SENCThreadManager::IsChartInTicketlist(s57chart *chart) {
 }
 
 bool SENCThreadManager::SetChartPointer(s57chart *chart, void *new_ptr) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
   // Find the ticket
   for (size_t i = 0; i < ticket_list.size(); i++) {
-    if (ticket_list[i]->m_chart == chart) {
-      ticket_list[i]->m_chart = (s57chart *)new_ptr;
+    SENCJobTicket *ticket = ticket_list[i];
+    if (ticket->m_chart == chart) {
+      //  The chart is gone, typically purged from the cache after the view
+      //  moved on, so drop its job if not yet started.  It is scheduled
+      //  again whenever the chart is reloaded.
+      if (!new_ptr && (ticket->m_status == THREAD_PENDING)) {
+        ticket_list.erase(ticket_list.begin() + i);
+        delete ticket;
+        return true;
+      }
+      ticket->m_chart = (s57chart *)new_ptr;
       return true;
     }
   }
   return false;
 }
 
+void SENCThreadManager::SetViewPriority(const LLBBox &box, double chart_scale) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_view_box = box;
+  m_view_scale = chart_scale;
+}
+
+//  Lower is more urgent.  Cells in view score 0 for distance, others 1 plus
+//  their distance from the view center in view sizes.  Each decade between
+//  the cell's compilation scale and the view scale adds 1, so cells of the
+//  displayed scale band go first.
+double SENCThreadManager::JobScore(SENCJobTicket *ticket) {
+  // Without a view yet, first come first served
+  if (!m_view_box.GetValid()) return 0;
+
+  double score = 0;
+
+  if (ticket->m_box.GetValid() && m_view_box.IntersectOut(ticket->m_box)) {
+    double vlat = (m_view_box.GetMinLat() + m_view_box.GetMaxLat()) / 2.;
+    double vlon = (m_view_box.GetMinLon() + m_view_box.GetMaxLon()) / 2.;
+    double coslat = cos(wxDegToRad(vlat));
+
+    double dlat = (ticket->m_box.GetMinLat() + ticket->m_box.GetMaxLat()) / 2. -
+                  vlat;
+    double dlon = (ticket->m_box.GetMinLon() + ticket->m_box.GetMaxLon()) / 2. -
+                  vlon;
+    if (dlon > 180.) dlon -= 360.;
+    if (dlon < -180.) dlon += 360.;
+    dlon *= coslat;
+
+    double size =
+        wxMax(m_view_box.GetMaxLat() - m_view_box.GetMinLat(),
+              (m_view_box.GetMaxLon() - m_view_box.GetMinLon()) * coslat);
+    size = wxMax(size, 1e-6);
+
+    score += 1. + sqrt(dlat * dlat + dlon * dlon) / size;
+  }
+
+  if ((ticket->m_native_scale > 0) && (m_view_scale > 0))
+    score += fabs(log10(ticket->m_native_scale / m_view_scale));
+
+  return score;
+}
+
+//  Called with m_mutex held
+SENCJobTicket *SENCThreadManager::PickJob() {
+  SENCJobTicket *best = NULL;
+  double best_score = 0;
+  for (size_t i = 0; i < ticket_list.size(); i++) {
+    if (ticket_list[i]->m_status != THREAD_PENDING) continue;
+    double score = JobScore(ticket_list[i]);
+    if (!best || (score < best_score)) {
+      best = ticket_list[i];
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+SENCJobTicket *SENCThreadManager::WaitForJob(SENCBuildThread *thread) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  SENCJobTicket *ticket = PickJob();
+  if (!ticket) {
+    //  Wait a bounded time, so the worker can notice when wxWidgets wants
+    //  it gone at exit
+    m_nidle++;
+    m_job_cond.wait_for(lock, std::chrono::milliseconds(500));
+    m_nidle--;
+    ticket = PickJob();
+  }
+
+  if (ticket) {
+    ticket->m_status = THREAD_STARTED;
+    ticket->m_thread = thread;
+  }
+  return ticket;
+}
+
+//  Cores not busy with other cells help tessellate this one
+int SENCThreadManager::GetTessThreads() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  int nRunning = 0;
+  for (size_t i = 0; i < ticket_list.size(); i++) {
+    if (ticket_list[i]->m_status == THREAD_STARTED) nRunning++;
+  }
+  return wxMax(1, m_max_jobs / wxMax(nRunning, 1));
+}
+
+void SENCThreadManager::WorkerExit() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_nworkers--;
+}
+
 #define NBAR_LENGTH 40
 
 void SENCThreadManager::OnEvtThread(OCPN_BUILDSENC_ThreadEvent &event) {
@@ -254,17 +375,25 @@ void SENCThreadManager::OnEvtThread(OCPN_BUILDSENC_ThreadEvent &event) {
 //      SENCBuildThread Implementation
 //----------------------------------------------------------------------------------
 
-SENCBuildThread::SENCBuildThread(SENCJobTicket *ticket,
-                                 SENCThreadManager *manager) {
-  m_FullPath000 = ticket->m_FullPath000;
-  m_SENCFileName = ticket->m_SENCFileName;
+SENCBuildThread::SENCBuildThread(SENCThreadManager *manager) {
   m_manager = manager;
-  m_ticket = ticket;
 
   Create();
 }
 
 void *SENCBuildThread::Entry() {
+  //  A pool worker, building one SENC after another until the application
+  //  exits
+  while (!TestDestroy()) {
+    SENCJobTicket *ticket = m_manager->WaitForJob(this);
+    if (ticket) BuildJob(ticket);
+  }
+
+  m_manager->WorkerExit();
+  return 0;
+}
+
+void SENCBuildThread::BuildJob(SENCJobTicket *ticket) {
   //#ifdef __MSVC__
   //  _set_se_translator(my_translate);
 
@@ -280,51 +409,41 @@ void *SENCBuildThread::Entry() {
     Osenc senc;
 
     senc.setRegistrar(g_poRegistrar);
-    senc.setRefLocn(m_ticket->ref_lat, m_ticket->ref_lon);
-    senc.SetLODMeters(m_ticket->m_LOD_meters);
+    senc.setRefLocn(ticket->ref_lat, ticket->ref_lon);
+    senc.SetLODMeters(ticket->m_LOD_meters);
+    senc.SetTessThreads(m_manager->GetTessThreads());
     senc.setNoErrDialog(true);
 
-    m_ticket->m_SENCResult = SENC_BUILD_STARTED;
+    ticket->m_SENCResult = SENC_BUILD_STARTED;
     OCPN_BUILDSENC_ThreadEvent Sevent(wxEVT_OCPN_BUILDSENCTHREAD, 0);
     Sevent.stat = 0;
     Sevent.type = SENC_BUILD_STARTED;
-    Sevent.m_ticket = m_ticket;
-    if (m_manager) m_manager->QueueEvent(Sevent.Clone());
+    Sevent.m_ticket = ticket;
+    m_manager->QueueEvent(Sevent.Clone());
 
-    int ret = senc.createSenc200(m_FullPath000, m_SENCFileName, false);
+    int ret = senc.createSenc200(ticket->m_FullPath000, ticket->m_SENCFileName,
+                                 false);
 
     OCPN_BUILDSENC_ThreadEvent Nevent(wxEVT_OCPN_BUILDSENCTHREAD, 0);
     Nevent.stat = ret;
-    Nevent.m_ticket = m_ticket;
+    Nevent.m_ticket = ticket;
     if (ret == ERROR_INGESTING000)
       Nevent.type = SENC_BUILD_DONE_ERROR;
     else
       Nevent.type = SENC_BUILD_DONE_NOERROR;
 
-    m_ticket->m_SENCResult = Sevent.type;
-    if (m_manager) m_manager->QueueEvent(Nevent.Clone());
+    ticket->m_SENCResult = Sevent.type;
+    m_manager->QueueEvent(Nevent.Clone());
 
     // if(ret == ERROR_INGESTING000)
     //  return BUILD_SENC_NOK_PERMANENT;
     // else
     //  return ret;
-
-    return 0;
   }  // try
 
   //#ifdef __MSVC__
   catch (const std::exception &e /*SE_Exception e*/) {
     const char *msg = e.what();
-    if (m_manager) {
-      //             OCPN_CompressionThreadEvent
-      //             Nevent(wxEVT_OCPN_COMPRESSIONTHREAD, 0);
-      //             m_ticket->b_isaborted = true;
-      //             Nevent.SetTicket(m_ticket);
-      //             Nevent.type = 0;
-      //             m_manager->QueueEvent(Nevent.Clone());
-    }
-
-    return 0;
   }
   //#endif
 }
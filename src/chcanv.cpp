@@ -3998,8 +3998,8 @@ void ChartCanvas::OnRolloverPopupTimerEvent(wxTimerEvent &event) {
           double tlenght = pt->Length();
           s << _T("\n") << _("Total Track: ")
             << FormatDistanceAdaptive(tlenght);
-          if (pt->GetLastPoint()->GetTimeString() &&
-              pt->GetPoint(0)->GetTimeString()) {
+          if (pt->GetLastPoint()->HasValidTimestamp() &&
+              pt->GetPoint(0)->HasValidTimestamp()) {
             wxDateTime lastPointTime = pt->GetLastPoint()->GetCreateTime();
             wxDateTime zeroPointTime = pt->GetPoint(0)->GetCreateTime();
             if (lastPointTime.IsValid() && zeroPointTime.IsValid()){
@@ -4012,9 +4012,9 @@ void ChartCanvas::OnRolloverPopupTimerEvent(wxTimerEvent &event) {
             }
           }
 
-          if (g_bShowTrackPointTime && strlen(segShow_point_b->GetTimeString()))
+          if (g_bShowTrackPointTime && segShow_point_b->HasValidTimestamp())
             s << _T("\n") << _("Segment Created: ")
-              << segShow_point_b->GetTimeString();
+              << segShow_point_b->GetTimeString().c_str();
 
           s << _T("\n");
           if (g_bShowTrue)
@@ -4034,8 +4034,8 @@ void ChartCanvas::OnRolloverPopupTimerEvent(wxTimerEvent &event) {
 
           s << FormatDistanceAdaptive(dist);
 
-          if (segShow_point_a->GetTimeString() &&
-              segShow_point_b->GetTimeString()) {
+          if (segShow_point_a->HasValidTimestamp() &&
+              segShow_point_b->HasValidTimestamp()) {
             wxDateTime apoint = segShow_point_a->GetCreateTime();
             wxDateTime bpoint = segShow_point_b->GetCreateTime();
             if (apoint.IsValid() && bpoint.IsValid()){
@@ -5474,6 +5474,10 @@ bool ChartCanvas::SetViewPoint(double lat, double lon, double scale_ppm,
     }
   }
 
+  //  Let background SENC builds favour the cells in view
+  if (g_SencThreadManager && g_SencThreadManager->GetJobCount())
+    g_SencThreadManager->SetViewPriority(VPoint.GetBBox(), VPoint.chart_scale);
+
   //  Maintain member vLat/vLon
   m_vLat = VPoint.clat;
   m_vLon = VPoint.clon;
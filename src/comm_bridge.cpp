@@ -43,6 +43,7 @@
 #include "comm_vars.h"
 #include "config_vars.h"
 #include "idents.h"
+#include "nav_history.h"
 #include "OCPNPlatform.h"
 #include "ocpn_types.h"
 #include "own_ship.h"
@@ -54,6 +55,8 @@ wxDEFINE_EVENT(EVT_N2K_129025, ObservedEvt);
 wxDEFINE_EVENT(EVT_N2K_129026, ObservedEvt);
 wxDEFINE_EVENT(EVT_N2K_127250, ObservedEvt);
 wxDEFINE_EVENT(EVT_N2K_129540, ObservedEvt);
+wxDEFINE_EVENT(EVT_N2K_128267, ObservedEvt);
+wxDEFINE_EVENT(EVT_N2K_130306, ObservedEvt);
 
 wxDEFINE_EVENT(EVT_N0183_RMC, ObservedEvt);
 wxDEFINE_EVENT(EVT_N0183_HDT, ObservedEvt);
@@ -64,6 +67,9 @@ wxDEFINE_EVENT(EVT_N0183_GSV, ObservedEvt);
 wxDEFINE_EVENT(EVT_N0183_GGA, ObservedEvt);
 wxDEFINE_EVENT(EVT_N0183_GLL, ObservedEvt);
 wxDEFINE_EVENT(EVT_N0183_AIVDO, ObservedEvt);
+wxDEFINE_EVENT(EVT_N0183_DPT, ObservedEvt);
+wxDEFINE_EVENT(EVT_N0183_DBT, ObservedEvt);
+wxDEFINE_EVENT(EVT_N0183_MWV, ObservedEvt);
 
 wxDEFINE_EVENT(EVT_DRIVER_CHANGE, wxCommandEvent);
 
@@ -85,16 +91,40 @@ void ClearNavData(NavData &d){
   d.SID = 0;
 }
 
+/**
+* Queue the updated own ship data for the nav history database
+*/
+static void RecordNavHistory(int vflag, time_t time) {
+  NavHistory& history = NavHistory::GetInstance();
+  if (!history.IsRunning()) return;
+
+  if (vflag & POS_UPDATE) {
+    history.Add(NavHistory::Series::Lat, time, gLat);
+    history.Add(NavHistory::Series::Lon, time, gLon);
+  }
+  if (vflag & SOG_UPDATE) history.Add(NavHistory::Series::Sog, time, gSog);
+  if (vflag & COG_UPDATE) history.Add(NavHistory::Series::Cog, time, gCog);
+  if (vflag & HDT_UPDATE) history.Add(NavHistory::Series::Hdt, time, gHdt);
+}
+
 /**
 * Send BasicNavDataMsg based on global state in gLat, gLon, etc
 * on appmsg_bus
 */
 static void SendBasicNavdata(int vflag) {
+  time_t now = wxDateTime::Now().GetTicks();
+  RecordNavHistory(vflag, now);
   auto msg = std::make_shared<BasicNavDataMsg>(
-      gLat, gLon, gSog, gCog, gVar, gHdt, vflag, wxDateTime::Now().GetTicks());
+      gLat, gLon, gSog, gCog, gVar, gHdt, vflag, now);
   AppMsgBus::GetInstance().Notify(std::move(msg));
 }
 
+static void RecordNavHistory(NavHistory::Series series, double value) {
+  NavHistory& history = NavHistory::GetInstance();
+  if (history.IsRunning())
+    history.Add(series, wxDateTime::Now().GetTicks(), value);
+}
+
 
 static inline double GeodesicRadToDeg(double rads) {
   return rads * 180.0 / M_PI;
@@ -320,6 +350,22 @@ void CommBridge::InitCommListeners() {
     HandleN2K_129540(UnpackEvtPointer<Nmea2000Msg>(ev));
   });
 
+  // Water Depth   PGN 128267
+  //-----------------------------
+  Nmea2000Msg n2k_msg_128267(static_cast<uint64_t>(128267));
+  listener_N2K_128267.Listen(n2k_msg_128267, this, EVT_N2K_128267);
+  Bind(EVT_N2K_128267, [&](ObservedEvt ev) {
+    HandleN2K_128267(UnpackEvtPointer<Nmea2000Msg>(ev));
+  });
+
+  // Wind Data   PGN 130306
+  //-----------------------------
+  Nmea2000Msg n2k_msg_130306(static_cast<uint64_t>(130306));
+  listener_N2K_130306.Listen(n2k_msg_130306, this, EVT_N2K_130306);
+  Bind(EVT_N2K_130306, [&](ObservedEvt ev) {
+    HandleN2K_130306(UnpackEvtPointer<Nmea2000Msg>(ev));
+  });
+
 
   // NMEA0183
   // RMC
@@ -394,6 +440,30 @@ void CommBridge::InitCommListeners() {
     HandleN0183_AIVDO(UnpackEvtPointer<Nmea0183Msg>(ev));
   });
 
+  // DPT
+  Nmea0183Msg n0183_msg_DPT("DPT");
+  listener_N0183_DPT.Listen(n0183_msg_DPT, this, EVT_N0183_DPT);
+
+  Bind(EVT_N0183_DPT, [&](ObservedEvt ev) {
+    HandleN0183_DPT(UnpackEvtPointer<Nmea0183Msg>(ev));
+  });
+
+  // DBT
+  Nmea0183Msg n0183_msg_DBT("DBT");
+  listener_N0183_DBT.Listen(n0183_msg_DBT, this, EVT_N0183_DBT);
+
+  Bind(EVT_N0183_DBT, [&](ObservedEvt ev) {
+    HandleN0183_DBT(UnpackEvtPointer<Nmea0183Msg>(ev));
+  });
+
+  // MWV
+  Nmea0183Msg n0183_msg_MWV("MWV");
+  listener_N0183_MWV.Listen(n0183_msg_MWV, this, EVT_N0183_MWV);
+
+  Bind(EVT_N0183_MWV, [&](ObservedEvt ev) {
+    HandleN0183_MWV(UnpackEvtPointer<Nmea0183Msg>(ev));
+  });
+
   // SignalK
   SignalkMsg sk_msg;
   listener_SignalK.Listen(sk_msg, this, EVT_SIGNALK);
@@ -681,6 +751,35 @@ bool CommBridge::HandleN2K_129540(std::shared_ptr<const Nmea2000Msg> n2k_msg) {
   return true;
 }
 
+//  Depth and wind are only recorded, so no priorities are kept for them.
+
+bool CommBridge::HandleN2K_128267(std::shared_ptr<const Nmea2000Msg> n2k_msg) {
+  double depth;
+  if (!m_decoder.DecodePGN128267(n2k_msg->payload, depth))
+    return false;
+
+  RecordNavHistory(NavHistory::Series::Depth, depth);
+  return true;
+}
+
+bool CommBridge::HandleN2K_130306(std::shared_ptr<const Nmea2000Msg> n2k_msg) {
+  double angle, speed;
+  bool is_true;
+  if (!m_decoder.DecodePGN130306(n2k_msg->payload, angle, speed, is_true))
+    return false;
+
+  angle = GeodesicRadToDeg(angle);
+  speed = MS2KNOTS(speed);
+  if (is_true) {
+    RecordNavHistory(NavHistory::Series::Twa, angle);
+    RecordNavHistory(NavHistory::Series::Tws, speed);
+  } else {
+    RecordNavHistory(NavHistory::Series::Awa, angle);
+    RecordNavHistory(NavHistory::Series::Aws, speed);
+  }
+  return true;
+}
+
 bool CommBridge::HandleN0183_RMC(std::shared_ptr<const Nmea0183Msg> n0183_msg) {
   std::string str = n0183_msg->payload;
 
@@ -931,6 +1030,38 @@ bool CommBridge::HandleN0183_AIVDO(
   return true;
 }
 
+bool CommBridge::HandleN0183_DPT(std::shared_ptr<const Nmea0183Msg> n0183_msg) {
+  double depth;
+  if (!m_decoder.DecodeDPT(n0183_msg->payload, depth)) return false;
+
+  RecordNavHistory(NavHistory::Series::Depth, depth);
+  return true;
+}
+
+bool CommBridge::HandleN0183_DBT(std::shared_ptr<const Nmea0183Msg> n0183_msg) {
+  double depth;
+  if (!m_decoder.DecodeDBT(n0183_msg->payload, depth)) return false;
+
+  RecordNavHistory(NavHistory::Series::Depth, depth);
+  return true;
+}
+
+bool CommBridge::HandleN0183_MWV(std::shared_ptr<const Nmea0183Msg> n0183_msg) {
+  double angle, speed;
+  bool is_true;
+  if (!m_decoder.DecodeMWV(n0183_msg->payload, angle, speed, is_true))
+    return false;
+
+  if (is_true) {
+    RecordNavHistory(NavHistory::Series::Twa, angle);
+    RecordNavHistory(NavHistory::Series::Tws, speed);
+  } else {
+    RecordNavHistory(NavHistory::Series::Awa, angle);
+    RecordNavHistory(NavHistory::Series::Aws, speed);
+  }
+  return true;
+}
+
 bool CommBridge::HandleSignalK(std::shared_ptr<const SignalkMsg> sK_msg){
   std::string str = sK_msg->raw_message;
 
@@ -212,6 +212,64 @@ bool CommDecoder::DecodeGLL(std::string s, NavData& temp_data) {
   return true;
 }
 
+//  DPT and DBT are not parsed by the NMEA0183 library, so read the fields
+//  here.
+static bool SplitSentence(std::string s, SENTENCE& sentence) {
+  wxString str(s.c_str());
+  sentence.Sentence = ProcessNMEA4Tags(str);
+  sentence.Sentence.Trim();
+  return sentence.IsChecksumBad(sentence.GetNumberOfDataFields() + 1) != NTrue;
+}
+
+bool CommDecoder::DecodeDPT(std::string s, double& depth) {
+  SENTENCE sentence;
+  if (!SplitSentence(s, sentence)) return false;
+
+  //  Depth below the transducer, and the offset of the transducer from the
+  //  surface (positive) or the keel (negative)
+  depth = sentence.Double(1);
+  if (std::isnan(depth)) return false;
+  double offset = sentence.Double(2);
+  if (!std::isnan(offset) && offset > 0) depth += offset;
+  return true;
+}
+
+bool CommDecoder::DecodeDBT(std::string s, double& depth) {
+  SENTENCE sentence;
+  if (!SplitSentence(s, sentence)) return false;
+
+  depth = sentence.Double(3);  // meters
+  return !std::isnan(depth);
+}
+
+bool CommDecoder::DecodeMWV(std::string s, double& angle, double& speed,
+                            bool& is_true) {
+  wxString sentence(s.c_str());
+  wxString sentence3 = ProcessNMEA4Tags(sentence);
+  m_NMEA0183 << sentence3;
+
+  if (!m_NMEA0183.PreParse()) return false;
+  if (!m_NMEA0183.Parse()) return false;
+  if (m_NMEA0183.Mwv.IsDataValid != NTrue) return false;
+
+  angle = m_NMEA0183.Mwv.WindAngle;
+  speed = m_NMEA0183.Mwv.WindSpeed;
+  is_true = m_NMEA0183.Mwv.Reference == _T("T");
+  if (std::isnan(angle) || std::isnan(speed)) return false;
+
+  wxString units = m_NMEA0183.Mwv.WindSpeedUnits;
+  if (units == _T("K"))
+    speed /= 1.852;
+  else if (units == _T("M"))
+    speed *= 1.9438444924406;
+  else if (units == _T("S"))
+    speed *= 0.868976;
+  else if (units != _T("N"))
+    return false;
+
+  return true;
+}
+
 bool CommDecoder::DecodeGSV(std::string s, NavData& temp_data) {
   wxString sentence(s.c_str());
   wxString sentence3 = ProcessNMEA4Tags(sentence);
@@ -364,6 +422,39 @@ bool CommDecoder::DecodePGN129540(std::vector<unsigned char> v,  NavData& temp_d
   return false;
 }
 
+bool CommDecoder::DecodePGN128267(std::vector<unsigned char> v,
+                                  double& depth) {
+  unsigned char SID;
+  double DepthBelowTransducer, Offset, Range;
+
+  if (!ParseN2kPGN128267(v, SID, DepthBelowTransducer, Offset, Range))
+    return false;
+  if (N2kIsNA(DepthBelowTransducer)) return false;
+
+  depth = DepthBelowTransducer;
+  if (!N2kIsNA(Offset) && Offset > 0) depth += Offset;
+  return true;
+}
+
+//  Angle in radians and speed in m/s, as sent.
+bool CommDecoder::DecodePGN130306(std::vector<unsigned char> v, double& angle,
+                                  double& speed, bool& is_true) {
+  unsigned char SID;
+  tN2kWindReference ref;
+
+  if (!ParseN2kPGN130306(v, SID, speed, angle, ref)) return false;
+  if (N2kIsNA(speed) || N2kIsNA(angle)) return false;
+
+  if (ref == tN2kWindReference::N2kWind_Apparent)
+    is_true = false;
+  else if (ref == tN2kWindReference::N2kWind_True_boat)
+    is_true = true;
+  else
+    return false;
+
+  return true;
+}
+
 bool CommDecoder::DecodeSignalK(std::string s, NavData& temp_data){
   rapidjson::Document root;
 
@@ -22,15 +22,21 @@
  *   Free Software Foundation, Inc.,                                       *
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
  **************************************************************************/
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <vector>
 
 #include <wx/event.h>
+#include <wx/jsonreader.h>
+#include <wx/jsonval.h>
 
 #include "ocpn_plugin.h"
 #include "comm_navmsg_bus.h"
 #include "comm_appmsg.h"
+#include "nav_history.h"
 
 using namespace std;
 
@@ -49,6 +55,76 @@ std::string GetN0183Payload(NMEA0183Id id, ObservedEvt ev) {
   return msg->payload;
 }
 
+/**
+ * What was parsed from the last few messages.  The listeners of a message
+ * get it one after another, so the message is parsed by the first one only
+ * and the others share the result.
+ */
+template <typename T>
+class ParsedMsgCache {
+public:
+  shared_ptr<const T> Get(const shared_ptr<const void>& msg,
+                          std::function<shared_ptr<const T>()> parse) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& entry : m_entries) {
+      // A weak pointer keeps its control block, so this never matches a
+      // new message at the address of an old one.
+      if (!entry.first.owner_before(msg) && !msg.owner_before(entry.first))
+        return entry.second;
+    }
+    auto parsed = parse();
+    m_entries.emplace_front(msg, parsed);
+    if (m_entries.size() > kSize) m_entries.pop_back();
+    return parsed;
+  }
+
+private:
+  // A n0183 message is notified once for its type and once for "ALL"
+  static const size_t kSize = 4;
+
+  std::mutex m_mutex;
+  std::deque<std::pair<weak_ptr<const void>, shared_ptr<const T>>> m_entries;
+};
+
+shared_ptr<const vector<string>> GetN0183Fields(NMEA0183Id id,
+                                                ObservedEvt ev) {
+  static ParsedMsgCache<vector<string>> cache;
+  auto msg = UnpackEvtPointer<Nmea0183Msg>(ev);
+  return cache.Get(ev.GetSharedPtr(), [&msg] {
+    auto fields = make_shared<vector<string>>();
+    const string& s = msg->payload;
+    size_t start = s.size() > 0 && (s[0] == '$' || s[0] == '!') ? 1 : 0;
+    size_t end = s.find_first_of("*\r\n", start);
+    if (end == string::npos) end = s.size();
+    while (true) {
+      size_t comma = s.find(',', start);
+      if (comma == string::npos || comma > end) break;
+      fields->push_back(s.substr(start, comma - start));
+      start = comma + 1;
+    }
+    fields->push_back(s.substr(start, end - start));
+    return shared_ptr<const vector<string>>(fields);
+  });
+}
+
+shared_ptr<const vector<uint8_t>> GetN2000PayloadPtr(NMEA2000Id id,
+                                                     ObservedEvt ev) {
+  auto msg = UnpackEvtPointer<Nmea2000Msg>(ev);
+  return shared_ptr<const vector<uint8_t>>(msg, &msg->payload);
+}
+
+shared_ptr<const wxJSONValue> GetSignalkDocument(SignalkId id,
+                                                 ObservedEvt ev) {
+  static ParsedMsgCache<wxJSONValue> cache;
+  auto msg = UnpackEvtPointer<SignalkMsg>(ev);
+  return cache.Get(ev.GetSharedPtr(), [&msg] {
+    auto root = make_shared<wxJSONValue>();
+    wxJSONReader reader;
+    if (reader.Parse(msg->raw_message, root.get()) != 0) root.reset();
+    return shared_ptr<const wxJSONValue>(root);
+  });
+}
+
 shared_ptr<ObservableListener> GetListener(NMEA2000Id id, wxEventType et,
                                            wxEvtHandler* eh) {
   return make_shared<ObservableListener>(Nmea2000Msg(id.id), eh,
@@ -83,3 +159,14 @@ PluginNavdata GetEventNavdata(ObservedEvt ev) {
   data.time = msg->time;
   return data;
 }
+
+vector<string> GetNavHistorySeries() { return NavHistory::GetSeriesNames(); }
+
+vector<PluginNavHistorySample> GetNavHistory(const string& series, time_t from,
+                                             time_t to, int step) {
+  vector<PluginNavHistorySample> samples;
+  for (const NavHistorySample& s :
+       NavHistory::GetInstance().Query(series, from, to, step))
+    samples.push_back({s.time, s.value});
+  return samples;
+}
@@ -26,6 +26,7 @@
 
 bool g_bGarminHostUpload;
 bool g_bWplUsePosition;
+bool g_bNavHistory = true;
 
 double g_UserVar = 0.0;
 
@@ -3096,6 +3096,8 @@ void glChartCanvas::RenderRasterChartRegionGL(ChartBase *chart, ViewPort &vp,
 #endif
 
   LLBBox box = region.GetBox();
+  pTexFact->PrefetchTiles(vp, box, base_level, global_color_scheme);
+
   int numtiles;
   int mem_used = 0;
   if (g_memCacheLimit > 0) {
@@ -30,6 +30,22 @@
 #include <wx/wx.h>
 
 #include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "dychart.h"
 
@@ -117,6 +133,26 @@ extern bool GetMemoryStatus(int *mem_total, int *mem_used);
 extern wxString CompressedCachePath(wxString path);
 extern glTextureManager *g_glTextureManager;
 
+//  CRC-32 of the cache tiles and catalog entries
+static uint32_t CacheChecksum(const unsigned char *data, size_t size) {
+  static const struct CrcTable {
+    uint32_t t[256];
+    CrcTable() {
+      for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+          c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+        t[i] = c;
+      }
+    }
+  } table;
+
+  uint32_t crc = 0xffffffff;
+  for (size_t i = 0; i < size; i++)
+    crc = table.t[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return crc ^ 0xffffffff;
+}
+
 //      CatalogEntry implementation
 CatalogEntry::CatalogEntry() {}
 
@@ -140,9 +176,12 @@ void CatalogEntry::Serialize(unsigned char *t) {
   *p++ = k.tcolorscheme;
   *p++ = v.texture_offset;
   *p++ = v.compressed_size;
+  *p++ = v.checksum;
+  *p++ = CacheChecksum(t, CATALOG_ENTRY_SERIAL_SIZE - sizeof(uint32_t));
 }
 
-void CatalogEntry::DeSerialize(unsigned char *t) {
+//  False if the entry was not completely written
+bool CatalogEntry::DeSerialize(unsigned char *t) {
   uint32_t *p = (uint32_t *)t;
 
   k.mip_level = *p++;
@@ -151,15 +190,299 @@ void CatalogEntry::DeSerialize(unsigned char *t) {
   k.tcolorscheme = (ColorScheme)*p++;
   v.texture_offset = *p++;
   v.compressed_size = *p++;
+  v.checksum = *p++;
+  return *p == CacheChecksum(t, CATALOG_ENTRY_SERIAL_SIZE - sizeof(uint32_t));
+}
+
+//      glTexCacheMap implementation
+//  A read only mapping of a whole cache file.  The decoders share it, so it
+//  stays valid for jobs still running after the factory has mapped the
+//  grown file again, or has gone away.
+class glTexCacheMap {
+public:
+  glTexCacheMap();
+  ~glTexCacheMap();
+
+  bool Open(const wxString &path);
+  const unsigned char *GetData(size_t offset, size_t size) const {
+    if (offset > m_size || size > m_size - offset) return NULL;
+    return m_data + offset;
+  }
+
+private:
+  unsigned char *m_data;
+  size_t m_size;
+#ifdef __WXMSW__
+  HANDLE m_hMapping;
+#endif
+};
+
+glTexCacheMap::glTexCacheMap() : m_data(NULL), m_size(0) {
+#ifdef __WXMSW__
+  m_hMapping = NULL;
+#endif
+}
+
+glTexCacheMap::~glTexCacheMap() {
+  if (!m_data) return;
+#ifdef __WXMSW__
+  ::UnmapViewOfFile(m_data);
+  ::CloseHandle(m_hMapping);
+#else
+  munmap(m_data, m_size);
+#endif
+}
+
+bool glTexCacheMap::Open(const wxString &path) {
+#ifdef __WXMSW__
+  //  The factory keeps the file open for writing meanwhile
+  HANDLE hFile = ::CreateFileW(path.wc_str(), GENERIC_READ,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                               OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+  if (hFile == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER size;
+  if (::GetFileSizeEx(hFile, &size) && size.QuadPart > 0) {
+    m_hMapping = ::CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_hMapping) {
+      void *view = ::MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+      if (view) {
+        m_data = (unsigned char *)view;
+        m_size = (size_t)size.QuadPart;
+      } else {
+        ::CloseHandle(m_hMapping);
+        m_hMapping = NULL;
+      }
+    }
+  }
+  ::CloseHandle(hFile);  // the mapping keeps its own reference
+#else
+  int fd = open(path.fn_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void *view = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (view != MAP_FAILED) {
+      m_data = (unsigned char *)view;
+      m_size = st.st_size;
+    }
+  }
+  close(fd);  // the mapping stays valid
+#endif
+
+  return m_data != NULL;
+}
+
+//      glTexPrefetch implementation
+//  The tiles of one factory being decompressed ahead of use.  A tile is
+//  PENDING until a pool thread starts on it, then RUNNING, then DONE with
+//  its buffer until GetTextureLevel() takes it.
+struct glTexDecodeJob {
+  std::shared_ptr<glTexPrefetch> owner;
+  std::shared_ptr<glTexCacheMap> map;  // keeps src valid
+  uint64_t key;
+  const unsigned char *src;
+  int src_size;
+  uint32_t checksum;
+  int size;
+};
+
+class glTexPrefetch {
+public:
+  glTexPrefetch() : m_closed(false) {}
+
+  static uint64_t Key(int index, int level, ColorScheme color_scheme) {
+    return ((uint64_t)index << 16) | ((uint64_t)color_scheme << 8) | level;
+  }
+
+  void Update(std::vector<glTexDecodeJob> &jobs);
+  bool Take(uint64_t key, unsigned char *&data);
+  void Close();
+  void Run(const glTexDecodeJob &job);
+
+private:
+  enum TileState { PENDING, RUNNING, DONE };
+  struct Tile {
+    TileState state;
+    unsigned char *data;
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_done;
+  std::map<uint64_t, Tile> m_tiles;
+  bool m_closed;
+};
+
+//  The threads decompressing tiles for all factories
+class glTexDecodePool {
+public:
+  static void Submit(std::vector<glTexDecodeJob> &jobs);
+
+private:
+  glTexDecodePool();
+  ~glTexDecodePool();
+  void Worker();
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::deque<glTexDecodeJob> m_jobs;
+  std::vector<std::thread> m_threads;
+  bool m_stop;
+};
+
+glTexDecodePool::glTexDecodePool() : m_stop(false) {
+  //  Leave most cores to the render thread and texture compression
+  int n = wxMin(wxMax(1, wxThread::GetCPUCount() / 2), 4);
+  for (int i = 0; i < n; i++)
+    m_threads.emplace_back(&glTexDecodePool::Worker, this);
+}
+
+glTexDecodePool::~glTexDecodePool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+    m_jobs.clear();
+  }
+  m_cond.notify_all();
+  for (size_t i = 0; i < m_threads.size(); i++) m_threads[i].join();
+}
+
+void glTexDecodePool::Submit(std::vector<glTexDecodeJob> &jobs) {
+  if (jobs.empty()) return;
+
+  static glTexDecodePool pool;
+  {
+    std::lock_guard<std::mutex> lock(pool.m_mutex);
+    for (size_t i = 0; i < jobs.size(); i++) pool.m_jobs.push_back(jobs[i]);
+  }
+  pool.m_cond.notify_all();
+}
+
+void glTexDecodePool::Worker() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cond.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+    if (m_stop) return;
+
+    glTexDecodeJob job = m_jobs.front();
+    m_jobs.pop_front();
+
+    lock.unlock();
+    job.owner->Run(job);
+    job = glTexDecodeJob();  // release the map outside the lock
+    lock.lock();
+  }
+}
+
+//  Replace the wanted tiles: start the new ones, and drop the buffers of
+//  those no longer wanted.  Running ones finish and are dropped next time.
+void glTexPrefetch::Update(std::vector<glTexDecodeJob> &jobs) {
+  std::vector<glTexDecodeJob> start;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::set<uint64_t> wanted;
+    for (size_t i = 0; i < jobs.size(); i++) wanted.insert(jobs[i].key);
+
+    for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+      if (it->second.state != RUNNING && !wanted.count(it->first)) {
+        FreeCompTile(it->second.data);
+        it = m_tiles.erase(it);
+      } else
+        ++it;
+    }
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+      Tile tile = {PENDING, NULL};
+      if (m_tiles.insert(std::make_pair(jobs[i].key, tile)).second)
+        start.push_back(jobs[i]);
+    }
+  }
+  glTexDecodePool::Submit(start);
+}
+
+//  The decompressed tile, waiting for it if it is being decompressed.  False
+//  if it was not asked for or not started, for the caller to do it now.
+bool glTexPrefetch::Take(uint64_t key, unsigned char *&data) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto it = m_tiles.find(key);
+  if (it == m_tiles.end()) return false;
+
+  if (it->second.state == PENDING) {
+    m_tiles.erase(it);
+    return false;
+  }
+
+  while (it->second.state == RUNNING) {
+    m_done.wait(lock);
+    it = m_tiles.find(key);  // still there, only Take() erases running tiles
+  }
+
+  data = it->second.data;
+  m_tiles.erase(it);
+  return data != NULL;
+}
+
+//  The factory is going away.  Tiles still running are freed by Run().
+void glTexPrefetch::Close() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_closed = true;
+  for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+    if (it->second.state != RUNNING) {
+      FreeCompTile(it->second.data);
+      it = m_tiles.erase(it);
+    } else
+      ++it;
+  }
+}
+
+void glTexPrefetch::Run(const glTexDecodeJob &job) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_tiles.find(job.key);
+    if (m_closed || it == m_tiles.end() || it->second.state != PENDING)
+      return;  // no longer wanted, or taken over by the render thread
+    it->second.state = RUNNING;
+  }
+
+  unsigned char *data = NULL;
+  if (CacheChecksum(job.src, job.src_size) == job.checksum) {
+    data = AllocCompTile(job.size);
+    if (data && LZ4_decompress_safe((const char *)job.src, (char *)data,
+                                    job.src_size, job.size) != job.size) {
+      FreeCompTile(data);
+      data = NULL;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_tiles.find(job.key);
+    if (m_closed) {
+      FreeCompTile(data);
+      m_tiles.erase(it);
+    } else {
+      it->second.state = DONE;
+      it->second.data = data;
+    }
+  }
+  m_done.notify_all();
 }
 
 //      glTexFactory Implementation
 enum TextureDataType { COMPRESSED_BUFFER_OK, MAP_BUFFER_OK };
 
+//  Frames ahead of the view to prefetch tiles for, while panning or zooming
+static const double kPrefetchFrames = 4;
+
+//  At most this many tile levels decompressed ahead of use, per chart
+static const size_t kMaxPrefetch = 128;
+
 glTexFactory::glTexFactory(ChartBase *chart, int raster_format) {
   //    m_pchart = chart;
   n_catalog_entries = 0;
-  m_catalog_offset = sizeof(CompressedCacheHeader);
+  m_data_end = sizeof(CompressedCacheHeader);
+  m_serial = 0;
   wxDateTime ed = chart->GetEditionDate();
   m_chart_date_binary = (uint32_t)ed.IsValid() ? ed.GetTicks() : 0;
   m_chartfile_date_binary = ::wxFileModificationTime(chart->GetFullPath());
@@ -168,6 +491,7 @@ glTexFactory::glTexFactory(ChartBase *chart, int raster_format) {
   m_ChartPath = chart->GetFullPath();
 
   m_CompressedCacheFilePath = CompressedCachePath(chart->GetFullPath());
+  m_IndexFilePath = m_CompressedCacheFilePath + _T(".idx");
   m_hdrOK = false;
   m_catalogOK = false;
   m_newCatalog = true;
@@ -175,6 +499,10 @@ glTexFactory::glTexFactory(ChartBase *chart, int raster_format) {
   m_catalogCorrupted = false;
 
   m_fs = 0;
+  m_index_fs = 0;
+  m_map_failed = false;
+  m_prefetch = std::make_shared<glTexPrefetch>();
+  m_prefetch_lat = m_prefetch_lon = m_prefetch_ppm = 0;
   m_LRUtime = 0;
   m_ntex = 0;
   m_tiles = NULL;
@@ -205,20 +533,16 @@ glTexFactory::glTexFactory(ChartBase *chart, int raster_format) {
 }
 
 glTexFactory::~glTexFactory() {
+  m_prefetch->Close();
+  AppendIndex();
   delete m_fs;
+  delete m_index_fs;
 
   PurgeBackgroundCompressionPool();
   DeleteAllTextures();
   DeleteAllDescriptors();
 
-  for (int i = 0; i < N_COLOR_SCHEMES; i++) {
-    for (int j = 0; j < MAX_TEX_LEVEL; j++) {
-      CatalogEntryValue *v = m_cache[i][j];
-      if (v) {
-        free(v);
-      }
-    }
-  }
+  ClearCatalog();
 
   free(m_td_array);  // array is empty
 
@@ -888,7 +1212,7 @@ bool glTexFactory::UpdateCacheLevel(const wxRect &rect, int level,
   //      This texture is already done
   if (v != 0) return false;
 
-  return UpdateCachePrecomp(data, size, rect, level, color_scheme);
+  return UpdateCachePrecomp(data, size, rect, level, color_scheme, false);
 }
 
 bool glTexFactory::UpdateCacheAllLevels(const wxRect &rect,
@@ -903,7 +1227,7 @@ bool glTexFactory::UpdateCacheAllLevels(const wxRect &rect,
     work |= UpdateCacheLevel(rect, level, color_scheme, compcomp_array[level],
                              compcomp_size[level]);
   if (work) {
-    WriteCatalogAndHeader();
+    AppendIndex();
   }
 
   return work;
@@ -917,7 +1241,7 @@ int glTexFactory::GetTextureLevel(glTextureDescriptor *ptd, const wxRect &rect,
     if (ptd->compcomp_array[level]) {
       // If we have the compcomp bits in ram decompress them
       int size = TextureTileSize(level, true);
-      unsigned char *cb = (unsigned char *)malloc(size);
+      unsigned char *cb = AllocCompTile(size);
       LZ4_decompress_fast((char *)ptd->compcomp_array[level], (char *)cb, size);
       ptd->comp_array[level] = cb;
       return COMPRESSED_BUFFER_OK;
@@ -932,19 +1256,31 @@ int glTexFactory::GetTextureLevel(glTextureDescriptor *ptd, const wxRect &rect,
       //      so go load it
       if (p != 0) {
         int size = TextureTileSize(level, true);
+        unsigned char *cb = NULL;
+
+        //  Normally decompressed in the background by PrefetchTiles()
+        uint64_t key =
+            glTexPrefetch::Key(ArrayIndex(rect.x, rect.y), level, color_scheme);
+        if (!m_prefetch->Take(key, cb)) {
+          std::vector<unsigned char> buf;
+          const unsigned char *src = GetCheckedCacheData(p, buf);
+          if (src) {
+            cb = AllocCompTile(size);
+            if (LZ4_decompress_safe((const char *)src, (char *)cb,
+                                    p->compressed_size, size) != size) {
+              FreeCompTile(cb);
+              cb = NULL;
+            }
+          }
+        }
 
-        if (m_fs->IsOpened()) {
-          m_fs->Seek(p->texture_offset);
-          ptd->comp_array[level] = (unsigned char *)malloc(size);
-          int max_compressed_size = LZ4_COMPRESSBOUND(g_tile_size);
-          char *compressed_data = (char *)malloc(p->compressed_size);
-          m_fs->Read(compressed_data, p->compressed_size);
-          LZ4_decompress_fast(compressed_data, (char *)ptd->comp_array[level],
-                              size);
-          free(compressed_data);
+        if (cb) {
+          ptd->comp_array[level] = cb;
+          return COMPRESSED_BUFFER_OK;
         }
 
-        return COMPRESSED_BUFFER_OK;
+        //  The cache is damaged, build the texture again
+        DropCacheEntry(p);
       }
     }
   }
@@ -956,71 +1292,239 @@ int glTexFactory::GetTextureLevel(glTextureDescriptor *ptd, const wxRect &rect,
   return MAP_BUFFER_OK;
 }
 
+//  The compressed data of a cache entry, read through a mapping of the file.
+//  NULL if the file cannot be mapped, or is shorter than the catalog says.
+const unsigned char *glTexFactory::GetCacheData(const CatalogEntryValue *p) {
+  if (m_map_failed) return NULL;
+
+  const unsigned char *data =
+      m_map ? m_map->GetData(p->texture_offset, p->compressed_size) : NULL;
+  if (!data) {
+    //  Not mapped yet, or written to since: map the file as it is now
+    if (m_fs && m_fs->IsOpened()) m_fs->Flush();
+
+    std::shared_ptr<glTexCacheMap> map = std::make_shared<glTexCacheMap>();
+    if (!map->Open(m_CompressedCacheFilePath)) {
+      m_map_failed = true;  // read the file instead
+      m_map.reset();
+      return NULL;
+    }
+    m_map = map;
+    data = m_map->GetData(p->texture_offset, p->compressed_size);
+  }
+  return data;
+}
+
+//  As GetCacheData(), reading into buf if the file cannot be mapped, and
+//  NULL unless the data matches its checksum.
+const unsigned char *glTexFactory::GetCheckedCacheData(
+    const CatalogEntryValue *p, std::vector<unsigned char> &buf) {
+  const unsigned char *data = GetCacheData(p);
+  if (!data && m_map_failed && m_fs && m_fs->IsOpened()) {
+    buf.resize(p->compressed_size);
+    if (m_fs->Seek(p->texture_offset) &&
+        m_fs->Read(buf.data(), buf.size()) == buf.size())
+      data = buf.data();
+    m_fs->SeekEnd();
+  }
+  if (data && CacheChecksum(data, p->compressed_size) != p->checksum)
+    data = NULL;
+  return data;
+}
+
+//  Forget a damaged tile.  It is built again, and appended to the cache.
+void glTexFactory::DropCacheEntry(CatalogEntryValue *p) {
+  if (!m_catalogCorrupted) {
+    wxLogMessage(_T("Bad cache tile %s %s"), m_ChartPath.c_str(),
+                 m_CompressedCacheFilePath.c_str());
+    m_catalogCorrupted = true;
+  }
+  p->compressed_size = 0;
+  n_catalog_entries--;
+}
+
+//  Queue the cached levels of a tile that BuildTexture() would upload from
+//  level on, and which are not in memory yet.
+void glTexFactory::WantPrefetch(int index, int level, ColorScheme color_scheme,
+                                std::vector<glTexDecodeJob> &jobs) {
+  if (level < 0 || level > g_mipmap_max_level) return;
+
+  glTextureDescriptor *ptd = m_td_array[index];
+  int level_min = ptd ? ptd->level_min : g_mipmap_max_level + 1;
+#ifdef ocpnUSE_GLES
+  int level_end = wxMin(level + 1, level_min);
+#else
+  int level_end = level_min;
+#endif
+
+  wxRect rect;
+  ArrayXY(&rect, index);
+
+  for (int l = level; l < level_end && jobs.size() < kMaxPrefetch; l++) {
+    if (ptd && (ptd->comp_array[l] || ptd->compcomp_array[l])) continue;
+
+    CatalogEntryValue *p = GetCacheEntryValue(l, rect.x, rect.y, color_scheme);
+    if (!p) break;  // built from the chart instead
+    const unsigned char *src = GetCacheData(p);
+    if (!src) break;
+
+    glTexDecodeJob job;
+    job.owner = m_prefetch;
+    job.map = m_map;
+    job.key = glTexPrefetch::Key(index, l, color_scheme);
+    job.src = src;
+    job.src_size = p->compressed_size;
+    job.checksum = p->checksum;
+    job.size = TextureTileSize(l, true);
+    jobs.push_back(job);
+  }
+}
+
+void glTexFactory::PrefetchTiles(const ViewPort &vp, const LLBBox &box,
+                                 int base_level, ColorScheme color_scheme) {
+  if (!g_GLOptions.m_bTextureCompression ||
+      !g_GLOptions.m_bTextureCompressionCaching)
+    return;
+  if (!m_tiles || !box.GetValid() || m_map_failed) return;
+
+  //  Where the view is heading: a few frames further along the last move,
+  //  grown when zooming out, and with the next mipmap level while zooming
+  LLBBox ahead;
+  int zoom_level = -1;
+  if (m_prefetch_ppm > 0) {
+    double dlat = vp.clat - m_prefetch_lat;
+    double dlon = vp.clon - m_prefetch_lon;
+    if (dlon > 180)
+      dlon -= 360;
+    else if (dlon < -180)
+      dlon += 360;
+
+    double grow = 0;
+    if (vp.view_scale_ppm < m_prefetch_ppm * .99) {
+      grow = wxMin((m_prefetch_ppm / vp.view_scale_ppm - 1) * kPrefetchFrames,
+                   1.);
+      zoom_level = base_level + 1;
+    } else if (vp.view_scale_ppm > m_prefetch_ppm * 1.01)
+      zoom_level = base_level - 1;
+
+    double glat = grow * box.GetLatRange() / 2;
+    double glon = grow * box.GetLonRange() / 2;
+    dlat *= kPrefetchFrames;
+    dlon *= kPrefetchFrames;
+    if (dlat || dlon || grow)
+      ahead.Set(box.GetMinLat() + wxMin(dlat, 0.) - glat,
+                box.GetMinLon() + wxMin(dlon, 0.) - glon,
+                box.GetMaxLat() + wxMax(dlat, 0.) + glat,
+                box.GetMaxLon() + wxMax(dlon, 0.) + glon);
+  }
+  m_prefetch_lat = vp.clat;
+  m_prefetch_lon = vp.clon;
+  m_prefetch_ppm = vp.view_scale_ppm;
+
+  //  In order of need: the view, then ahead of it, then the next level
+  std::vector<glTexDecodeJob> jobs;
+  for (int pass = 0; pass < 3; pass++) {
+    for (int i = 0; i < m_ntex && jobs.size() < kMaxPrefetch; i++) {
+      const LLBBox &tile_box = m_tiles[i]->box;
+      bool in_view = !tile_box.IntersectOut(box);
+      bool in_ahead = ahead.GetValid() && !tile_box.IntersectOut(ahead);
+
+      if (pass == 0 && in_view)
+        WantPrefetch(i, base_level, color_scheme, jobs);
+      else if (pass == 1 && in_ahead && !in_view)
+        WantPrefetch(i, base_level, color_scheme, jobs);
+      else if (pass == 2 && zoom_level >= 0 &&
+               (in_view || (zoom_level > base_level && in_ahead)))
+        WantPrefetch(i, zoom_level, color_scheme, jobs);
+    }
+  }
+
+  m_prefetch->Update(jobs);
+}
+
+void glTexFactory::MakeHeader(CompressedCacheHeader &hdr,
+                              uint32_t serial) const {
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.magic = COMPRESSED_CACHE_MAGIC;
+  hdr.format = g_raster_format;
+  hdr.chartdate = m_chart_date_binary;
+  hdr.chartfile_date = m_chartfile_date_binary;
+  hdr.chartfile_size = m_chartfile_size;
+  hdr.serial = serial;
+}
+
 // return not used
 // false? never
 // true
 bool glTexFactory::LoadHeader(void) {
   if (m_hdrOK) return true;
 
-  bool need_new = false;
+  bool need_new = true;
 
-  if (wxFileName::FileExists(m_CompressedCacheFilePath)) {
+  if (wxFileName::FileExists(m_CompressedCacheFilePath) &&
+      wxFileName::FileExists(m_IndexFilePath)) {
     m_fs = new wxFFile(m_CompressedCacheFilePath, _T("rb+"));
-    if (m_fs->IsOpened()) {
-      CompressedCacheHeader hdr;
-
-      //  Header is located at the end of the file
-      wxFileOffset hdr_offset = m_fs->Length() - sizeof(hdr);
-      hdr_offset = m_fs->Seek(hdr_offset);
-
-      if (sizeof(hdr) == m_fs->Read(&hdr, sizeof(hdr))) {
-        if (hdr.magic != COMPRESSED_CACHE_MAGIC ||
-            hdr.chartdate != m_chart_date_binary ||
-            hdr.chartfile_date != m_chartfile_date_binary ||
-            hdr.chartfile_size != m_chartfile_size ||
-            hdr.format != g_raster_format) {
-          //  Bad header signature
-          delete m_fs;
-          need_new = true;
-        } else {  // good header
-          n_catalog_entries = hdr.m_nentries;
-          m_catalog_offset = hdr.catalog_offset;
+    m_index_fs = new wxFFile(m_IndexFilePath, _T("rb+"));
+    if (m_fs->IsOpened() && m_index_fs->IsOpened()) {
+      CompressedCacheHeader hdr, index_hdr, want;
+
+      //  Both files must belong to this chart, and to each other
+      if (sizeof(hdr) == m_fs->Read(&hdr, sizeof(hdr)) &&
+          sizeof(index_hdr) ==
+              m_index_fs->Read(&index_hdr, sizeof(index_hdr))) {
+        MakeHeader(want, hdr.serial);
+        if (!memcmp(&hdr, &want, sizeof(hdr)) &&
+            !memcmp(&index_hdr, &want, sizeof(hdr))) {
+          m_serial = hdr.serial;
+          m_data_end = m_fs->Length();
+          need_new = false;
         }
-      } else {  // file exists, and is empty
-        n_catalog_entries = 0;
-        m_catalog_offset = 0;
-        WriteCatalogAndHeader();
       }
     }  // is open
 
-    else {  // some problem opening file, probably permissions on Win7
+    if (need_new) {  // bad header signature, or some problem opening files,
+                     // probably permissions on Win7
       delete m_fs;
-      need_new = true;
-      wxRemoveFile(m_CompressedCacheFilePath);
+      delete m_index_fs;
+      m_fs = m_index_fs = 0;
     }
-
   }  // exists
 
   else {  // File does not exist
     wxFileName fn(m_CompressedCacheFilePath);
     if (!fn.DirExists()) fn.Mkdir();
-    need_new = true;
   }
 
-  if (need_new) {
-    //  Create new file, with empty catalog, and correct header
-    m_fs = new wxFFile(m_CompressedCacheFilePath, _T("wb"));
-    n_catalog_entries = 0;
-    m_catalog_offset = 0;
-    WriteCatalogAndHeader();
-    delete m_fs;
+  if (need_new) CreateCache();
 
-    m_fs = new wxFFile(m_CompressedCacheFilePath, _T("rb+"));
-  }
   m_hdrOK = true;
   return true;
 }
 
+//  Start an empty cache, with a new serial so that neither file can be
+//  taken for part of an earlier cache.
+bool glTexFactory::CreateCache() {
+  CompressedCacheHeader hdr;
+  MakeHeader(hdr, (uint32_t)wxDateTime::Now().GetTicks());
+
+  m_fs = new wxFFile(m_CompressedCacheFilePath, _T("w+b"));
+  m_index_fs = new wxFFile(m_IndexFilePath, _T("w+b"));
+  if (!m_fs->IsOpened() || !m_index_fs->IsOpened()) {
+    wxRemoveFile(m_CompressedCacheFilePath);
+    wxRemoveFile(m_IndexFilePath);
+    return false;
+  }
+
+  m_fs->Write(&hdr, sizeof(hdr));
+  m_fs->Flush();
+  m_index_fs->Write(&hdr, sizeof(hdr));
+  m_index_fs->Flush();
+
+  m_serial = hdr.serial;
+  m_data_end = sizeof(hdr);
+  return true;
+}
+
 bool glTexFactory::AddCacheEntryValue(const CatalogEntry &p) {
   if ((int)p.k.tcolorscheme < 0 || p.k.tcolorscheme >= N_COLOR_SCHEMES)
     return false;
@@ -1036,95 +1540,142 @@ bool glTexFactory::AddCacheEntryValue(const CatalogEntry &p) {
 
   CatalogEntryValue *v = m_cache[p.k.tcolorscheme][p.k.mip_level];
   CatalogEntryValue *r = &v[array_index];
+  if (r->compressed_size == 0) n_catalog_entries++;
   *r = p.v;
   return true;
 }
 
+void glTexFactory::ClearCatalog() {
+  for (int i = 0; i < N_COLOR_SCHEMES; i++) {
+    for (int j = 0; j < MAX_TEX_LEVEL; j++) {
+      free(m_cache[i][j]);
+      m_cache[i][j] = NULL;
+    }
+  }
+  n_catalog_entries = 0;
+}
+
+//  Read the whole index at once.  The entries are in the order the tiles
+//  were written, so a later entry replaces an earlier one for the same tile.
 bool glTexFactory::LoadCatalog(void) {
   m_newCatalog = false;
   if (m_catalogOK) return true;
 
   if (!LoadHeader()) return false;
 
-  if (n_catalog_entries == 0) {
-    // new empty header
-    m_catalogOK = true;
+  m_catalogOK = true;
+  if (!m_index_fs || !m_index_fs->IsOpened()) {
     m_newCatalog = true;
     return true;
   }
 
-  m_fs->Seek(m_catalog_offset);
-
-  CatalogEntry ps;
-  int buf_size = ps.GetSerialSize();
-  unsigned char *buf = (unsigned char *)malloc(buf_size);
-
   CatalogEntry p;
-  bool bad = false;
-  for (int i = 0; i < n_catalog_entries; i++) {
-    m_fs->Read(buf, buf_size);
-    p.DeSerialize(buf);
-    if (!AddCacheEntryValue(p)) bad = true;
+  size_t entry_size = p.GetSerialSize();
+  wxFileOffset length = m_index_fs->Length() - sizeof(CompressedCacheHeader);
+  std::vector<unsigned char> buf(length > 0 ? length : 0);
+  if (!buf.empty()) {
+    m_index_fs->Seek(sizeof(CompressedCacheHeader));
+    buf.resize(m_index_fs->Read(buf.data(), buf.size()));
+  }
+  m_index_fs->SeekEnd();
+
+  //  After a crash the last entries may be cut short, or point at tiles
+  //  that never reached the disk
+  bool bad = buf.size() % entry_size != 0;
+  for (size_t i = 0; i + entry_size <= buf.size(); i += entry_size) {
+    if (!p.DeSerialize(&buf[i])) {
+      bad = true;
+      break;  // nothing after this can be trusted
+    }
+    if (p.v.texture_offset < (int)sizeof(CompressedCacheHeader) ||
+        p.v.texture_offset + (wxFileOffset)p.v.compressed_size > m_data_end ||
+        !AddCacheEntryValue(p))
+      bad = true;
   }
 
-  free(buf);
-  if (bad && !m_catalogCorrupted) {
-    wxLogMessage(_T("Bad cache catalog %s %s"), m_ChartPath.c_str(),
-                 m_CompressedCacheFilePath.c_str());
-    m_catalogCorrupted = true;
+  if (bad) {
+    if (!m_catalogCorrupted) {
+      wxLogMessage(_T("Bad cache catalog %s %s"), m_ChartPath.c_str(),
+                   m_CompressedCacheFilePath.c_str());
+      m_catalogCorrupted = true;
+    }
+    RewriteIndex();  // drop the damaged entries, so new ones can follow
+  }
+
+  if (n_catalog_entries == 0) {
+    // new empty catalog
+    m_newCatalog = true;
   }
-  m_catalogOK = true;
   return true;
 }
 
-bool glTexFactory::WriteCatalogAndHeader() {
-  if (m_fs && m_fs->IsOpened()) {
-    m_fs->Seek(m_catalog_offset);
+//  Write a header and all the catalog entries to a file.
+bool glTexFactory::WriteIndex(wxFFile &file, const CompressedCacheHeader &hdr) {
+  std::vector<unsigned char> buf(sizeof(hdr));
+  memcpy(buf.data(), &hdr, sizeof(hdr));
 
-    CatalogEntry ps;
-    int buf_size = ps.GetSerialSize();
-    unsigned char buf[CATALOG_ENTRY_SERIAL_SIZE];  // MSVC requires constant
-                                                   // stack array size...
-    int new_n_catalog_entries = 0;
-    CatalogEntry p;
-    wxRect rect;
-    for (int i = 0; i < N_COLOR_SCHEMES; i++) {
-      p.k.tcolorscheme = (ColorScheme)i;
-      for (int j = 0; j < MAX_TEX_LEVEL; j++) {
-        CatalogEntryValue *v = m_cache[i][j];
-        if (!v) continue;
-        p.k.mip_level = j;
-        for (int k = 0; k < m_ntex; k++) {
-          ArrayXY(&rect, k);
-          p.k.y = rect.y;
-          p.k.x = rect.x;
-          CatalogEntryValue *r = &v[k];
-          if (r->compressed_size == 0) continue;
-          p.v = *r;
-          new_n_catalog_entries++;
-          p.Serialize(buf);
-          m_fs->Write(buf, buf_size);
-        }
+  CatalogEntry p;
+  wxRect rect;
+  for (int i = 0; i < N_COLOR_SCHEMES; i++) {
+    p.k.tcolorscheme = (ColorScheme)i;
+    for (int j = 0; j < MAX_TEX_LEVEL; j++) {
+      CatalogEntryValue *v = m_cache[i][j];
+      if (!v) continue;
+      p.k.mip_level = j;
+      for (int k = 0; k < m_ntex; k++) {
+        if (v[k].compressed_size == 0) continue;
+        ArrayXY(&rect, k);
+        p.k.y = rect.y;
+        p.k.x = rect.x;
+        p.v = v[k];
+        size_t pos = buf.size();
+        buf.resize(pos + p.GetSerialSize());
+        p.Serialize(&buf[pos]);
       }
     }
+  }
+
+  return file.Write(buf.data(), buf.size()) == buf.size() && file.Flush();
+}
 
-    n_catalog_entries = new_n_catalog_entries;
-    //   Write header at file end
-    CompressedCacheHeader hdr;
-    hdr.magic = COMPRESSED_CACHE_MAGIC;
-    hdr.format = g_raster_format;
-    hdr.m_nentries = n_catalog_entries;
-    hdr.catalog_offset = m_catalog_offset;
-    hdr.chartdate = m_chart_date_binary;
-    hdr.chartfile_date = m_chartfile_date_binary;
-    hdr.chartfile_size = m_chartfile_size;
+//  Replace the index by one of the entries in use.  A crash meanwhile
+//  leaves the old index, or the new one.
+bool glTexFactory::RewriteIndex() {
+  wxString tmp_path = m_IndexFilePath + _T(".tmp");
+  CompressedCacheHeader hdr;
+  MakeHeader(hdr, m_serial);
+
+  m_index_pending.clear();  // all in the new index
+  bool ok;
+  {
+    wxFFile tmp(tmp_path, _T("wb"));
+    ok = tmp.IsOpened() && WriteIndex(tmp, hdr);
+  }
 
-    m_fs->Write(&hdr, sizeof(hdr));
-    m_fs->Flush();
+  delete m_index_fs;  // MSW cannot replace an open file
+  m_index_fs = 0;
+  if (ok) ok = wxRenameFile(tmp_path, m_IndexFilePath, true);
+  if (!ok && wxFileName::FileExists(tmp_path)) wxRemoveFile(tmp_path);
 
-    return true;
-  } else
+  m_index_fs = new wxFFile(m_IndexFilePath, _T("rb+"));
+  if (m_index_fs->IsOpened()) m_index_fs->SeekEnd();
+  return ok;
+}
+
+//  Write the entries of the tiles added since the last call.  The tiles are
+//  flushed first, and the checksums catch what a power loss makes of the
+//  order in which the disk got them.
+bool glTexFactory::AppendIndex() {
+  if (m_index_pending.empty()) return true;
+  if (!m_fs || !m_fs->IsOpened() || !m_index_fs || !m_index_fs->IsOpened())
     return false;
+
+  m_fs->Flush();
+  bool ok = m_index_fs->Write(m_index_pending.data(), m_index_pending.size()) ==
+            m_index_pending.size();
+  m_index_fs->Flush();
+  m_index_pending.clear();
+  return ok;
 }
 
 bool glTexFactory::UpdateCachePrecomp(unsigned char *data, int data_size,
@@ -1140,27 +1691,114 @@ bool glTexFactory::UpdateCachePrecomp(unsigned char *data, int data_size,
   // Make sure the file exists
   wxASSERT(m_fs != 0);
 
-  if (!m_fs->IsOpened()) return false;
+  if (!m_fs || !m_fs->IsOpened()) return false;
 
   //      Create a new catalog entry
   CatalogEntry p(level, rect.x, rect.y, color_scheme);
-
-  //      Write the compressed data to disk
-  p.v.texture_offset = m_catalog_offset;
-
+  p.v.texture_offset = m_data_end;
   p.v.compressed_size = data_size;
-  AddCacheEntryValue(p);
-  n_catalog_entries++;
+  p.v.checksum = CacheChecksum(data, data_size);
 
-  //      We write the new data at the current catalog offset, overwriting the
-  //      old catalog
-  m_fs->Seek(m_catalog_offset);
-  m_fs->Write(data, data_size);
+  //      Append the compressed data to the tile file.  Tiles are never
+  //      moved or overwritten, so the mappings of the file stay valid.
+  m_fs->Seek(m_data_end);
+  if (m_fs->Write(data, data_size) != (size_t)data_size) {
+    m_fs->Seek(m_data_end);  // the next tile goes over the partial one
+    return false;
+  }
+  m_data_end += data_size;
+  if (!AddCacheEntryValue(p)) return false;
 
-  //      Write the catalog and Header (which follows the catalog at the end of
-  //      the file
-  m_catalog_offset += data_size;
-  if (write_catalog) WriteCatalogAndHeader();
+  //      And its entry to the index
+  size_t pos = m_index_pending.size();
+  m_index_pending.resize(pos + p.GetSerialSize());
+  p.Serialize(&m_index_pending[pos]);
+  if (write_catalog) AppendIndex();
 
   return true;
 }
+
+bool glTexFactory::CompactCache() {
+  if (!LoadCatalog() || !m_fs || !m_fs->IsOpened()) return false;
+  AppendIndex();
+
+  //  Only worth it if a good part of the file is not in use
+  wxFileOffset used = sizeof(CompressedCacheHeader);
+  for (int i = 0; i < N_COLOR_SCHEMES; i++)
+    for (int j = 0; j < MAX_TEX_LEVEL; j++)
+      if (m_cache[i][j])
+        for (int k = 0; k < m_ntex; k++)
+          used += m_cache[i][j][k].compressed_size;
+  if (m_data_end - used < m_data_end / 4) return false;
+
+  wxLogMessage(_T("Compacting cache %s %s"), m_ChartPath.c_str(),
+               m_CompressedCacheFilePath.c_str());
+
+  //  Copy the tiles in use, checked, to a new tile file
+  CompressedCacheHeader hdr;
+  MakeHeader(hdr, m_serial + 1);
+  wxString tmp_path = m_CompressedCacheFilePath + _T(".tmp");
+  wxString index_tmp_path = m_IndexFilePath + _T(".tmp");
+
+  std::vector<CatalogEntry> entries;
+  bool ok;
+  {
+    wxFFile tmp(tmp_path, _T("wb"));
+    ok = tmp.IsOpened() && tmp.Write(&hdr, sizeof(hdr)) == sizeof(hdr);
+    wxFileOffset offset = sizeof(hdr);
+
+    wxRect rect;
+    std::vector<unsigned char> buf;
+    for (int i = 0; i < N_COLOR_SCHEMES && ok; i++) {
+      for (int j = 0; j < MAX_TEX_LEVEL && ok; j++) {
+        CatalogEntryValue *v = m_cache[i][j];
+        if (!v) continue;
+        for (int k = 0; k < m_ntex && ok; k++) {
+          if (v[k].compressed_size == 0) continue;
+          const unsigned char *src = GetCheckedCacheData(&v[k], buf);
+          if (!src) continue;  // damaged, built again when needed
+
+          ArrayXY(&rect, k);
+          CatalogEntry p(j, rect.x, rect.y, (ColorScheme)i);
+          p.v = v[k];
+          p.v.texture_offset = offset;
+          ok = tmp.Write(src, p.v.compressed_size) == p.v.compressed_size;
+          offset += p.v.compressed_size;
+          entries.push_back(p);
+        }
+      }
+    }
+    ok = ok && tmp.Flush();
+  }
+
+  //  Let go of the old files: MSW cannot replace them while open or mapped
+  m_prefetch->Close();
+  m_prefetch = std::make_shared<glTexPrefetch>();
+  m_map.reset();
+  delete m_fs;
+  delete m_index_fs;
+  m_fs = m_index_fs = 0;
+
+  //  The index of the new tiles.  The serials tell whether the files were
+  //  both replaced, should the second rename not happen.
+  if (ok) {
+    ClearCatalog();
+    for (size_t i = 0; i < entries.size(); i++) AddCacheEntryValue(entries[i]);
+    {
+      wxFFile tmp(index_tmp_path, _T("wb"));
+      ok = tmp.IsOpened() && WriteIndex(tmp, hdr);
+    }
+    ok = ok && wxRenameFile(tmp_path, m_CompressedCacheFilePath, true) &&
+         wxRenameFile(index_tmp_path, m_IndexFilePath, true);
+  }
+  if (wxFileName::FileExists(tmp_path)) wxRemoveFile(tmp_path);
+  if (wxFileName::FileExists(index_tmp_path)) wxRemoveFile(index_tmp_path);
+
+  //  Open whichever cache is there now
+  ClearCatalog();
+  m_hdrOK = false;
+  m_catalogOK = false;
+  m_map_failed = false;
+  LoadCatalog();
+  return ok;
+}
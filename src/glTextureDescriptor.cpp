@@ -25,6 +25,10 @@
 #include "glTextureDescriptor.h"
 #include <wx/thread.h>
 
+#include <map>
+#include <mutex>
+#include <vector>
+
 #if defined(__OCPN__ANDROID__)
 #include <GLES2/gl2.h>
 #elif defined(__WXQT__) || defined(__WXGTK__)
@@ -33,6 +37,60 @@
 
 wxCriticalSection gs_critSect;
 
+//  Free tile buffers kept for reuse, by size, up to this many bytes in all
+static const size_t kTilePoolLimit = 32 * 1024 * 1024;
+
+//  Each buffer carries its size ahead of the tile data
+static const size_t kTileHeader = 16;
+
+struct TilePool {
+  ~TilePool() {
+    for (auto it = free_lists.begin(); it != free_lists.end(); ++it)
+      for (size_t i = 0; i < it->second.size(); i++) free(it->second[i]);
+  }
+  std::map<size_t, std::vector<unsigned char *> > free_lists;
+};
+
+static std::mutex s_tile_pool_mutex;
+static TilePool s_tile_pool;
+static size_t s_tile_pool_bytes;
+
+unsigned char *AllocCompTile(size_t size) {
+  unsigned char *block = NULL;
+  {
+    std::lock_guard<std::mutex> lock(s_tile_pool_mutex);
+    std::vector<unsigned char *> &free_list = s_tile_pool.free_lists[size];
+    if (free_list.size()) {
+      block = free_list.back();
+      free_list.pop_back();
+      s_tile_pool_bytes -= size;
+    }
+  }
+
+  if (!block) {
+    block = (unsigned char *)malloc(kTileHeader + size);
+    if (!block) return NULL;
+    *(size_t *)block = size;
+  }
+  return block + kTileHeader;
+}
+
+void FreeCompTile(unsigned char *tile) {
+  if (!tile) return;
+
+  unsigned char *block = tile - kTileHeader;
+  size_t size = *(size_t *)block;
+  {
+    std::lock_guard<std::mutex> lock(s_tile_pool_mutex);
+    if (s_tile_pool_bytes + size <= kTilePoolLimit) {
+      s_tile_pool.free_lists[size].push_back(block);
+      s_tile_pool_bytes += size;
+      return;
+    }
+  }
+  free(block);
+}
+
 glTextureDescriptor::glTextureDescriptor() {
   for (int i = 0; i < 10; i++) {
     map_array[i] = NULL;
@@ -64,7 +122,7 @@ void glTextureDescriptor::FreeMap() {
 
 void glTextureDescriptor::FreeComp() {
   for (int i = 0; i < 10; i++) {
-    free(comp_array[i]);
+    FreeCompTile(comp_array[i]);
     comp_array[i] = NULL;
   }
 }
@@ -408,7 +408,7 @@ bool JobTicket::DoJob() {
                                   compcomp_bits_array, compcomp_size_array);
 
       for (int i = 0; i < g_mipmap_max_level + 1; i++) {
-        free(comp_bits_array[i]), comp_bits_array[i] = 0;
+        FreeCompTile(comp_bits_array[i]), comp_bits_array[i] = 0;
         free(compcomp_bits_array[i]), compcomp_bits_array[i] = 0;
       }
 
@@ -506,7 +506,7 @@ bool JobTicket::DoJob(const wxRect &rect) {
   for (int level = level_min_request; level < g_mipmap_max_level + 1; level++) {
     int dim = TextureDim(level);
     int size = TextureTileSize(level, true);
-    unsigned char *tex_data = (unsigned char *)malloc(size);
+    unsigned char *tex_data = AllocCompTile(size);
     if (g_raster_format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) {
       // color range fit is worse quality but twice as fast
       int flags = squish::kDxt1 | squish::kColourRangeFit;
@@ -840,7 +840,7 @@ void glTextureManager::OnEvtThread(OCPN_CompressionThreadEvent &event) {
 
   if (ticket->b_isaborted || ticket->b_abort) {
     for (int i = 0; i < g_mipmap_max_level + 1; i++) {
-      free(ticket->comp_bits_array[i]);
+      FreeCompTile(ticket->comp_bits_array[i]);
       free(ticket->compcomp_bits_array[i]);
     }
 
@@ -1509,6 +1509,9 @@ void glTextureManager::BuildCompressedCache() {
       break;
     }
 
+    //  Drop what earlier crashes or rebuilt tiles left in the cache
+    tex_fact->CompactCache();
+
     int size_X = pBSBChart->GetSize_X();
     int size_Y = pBSBChart->GetSize_Y();
 
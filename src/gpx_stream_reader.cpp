@@ -0,0 +1,247 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Split GPX files into objects without loading the document
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "gpx_stream_reader.h"
+
+//  Bytes read from the file at a time
+static const size_t kReadSize = 1 << 20;
+
+static const char kSegmentOpen[] = "<trkseg>";
+static const char kSegmentClose[] = "</trkseg>";
+
+GpxStreamReader::GpxStreamReader(const Handler &handler, size_t batch_size)
+    : m_handler(handler),
+      m_batch_size(batch_size ? batch_size : 1),
+      m_depth(0),
+      m_error(false),
+      m_done(false),
+      m_in_track(false),
+      m_in_segment(false),
+      m_segment(0),
+      m_n_points(0),
+      m_segment_sent(false) {}
+
+//  Text and markup inside the element being collected
+void GpxStreamReader::Append(const char *data, size_t size) {
+  if (m_in_segment) {
+    if (m_depth >= 4) m_points.append(data, size);  // inside a trkpt
+  } else if (m_in_track) {
+    m_header.append(data, size);
+  } else if (m_depth >= 2) {
+    m_object.append(data, size);
+  }
+}
+
+void GpxStreamReader::FlushPoints() {
+  m_points.append(kSegmentClose);
+  if (m_handler.on_points) m_handler.on_points(m_points, m_segment);
+  m_points = kSegmentOpen;
+  m_n_points = 0;
+  m_segment_sent = true;
+}
+
+static std::string TagName(const char *tag, size_t size) {
+  size_t i = (size > 1 && tag[1] == '/') ? 2 : 1;
+  size_t start = i;
+  while (i < size && !isspace((unsigned char)tag[i]) && tag[i] != '/' &&
+         tag[i] != '>')
+    i++;
+  return std::string(tag + start, i - start);
+}
+
+bool GpxStreamReader::ProcessTag(const char *tag, size_t size) {
+  bool is_end = tag[1] == '/';
+  bool is_empty = !is_end && size >= 2 && tag[size - 2] == '/';
+
+  if (is_end) {
+    if (m_depth == 0) return false;
+
+    if (m_depth == 1) {  // the root
+      m_done = true;
+    } else if (m_depth == 2 && m_in_track) {
+      m_header.append(tag, size);
+      if (m_handler.on_track_end) m_handler.on_track_end(m_header, m_segment);
+      m_header.clear();
+      m_in_track = false;
+    } else if (m_depth == 2) {
+      m_object.append(tag, size);
+      if (m_handler.on_object) m_handler.on_object(m_object);
+      m_object.clear();
+    } else if (m_depth == 3 && m_in_segment) {
+      if (m_n_points || !m_segment_sent) FlushPoints();
+      m_in_segment = false;
+    } else if (m_depth == 4 && m_in_segment) {
+      m_points.append(tag, size);
+      if (++m_n_points >= m_batch_size) FlushPoints();
+    } else {
+      Append(tag, size);
+    }
+    m_depth--;
+    return true;
+  }
+
+  if (m_depth == 0) {
+    std::string root(tag, size);
+    if (!is_empty) root += "</" + TagName(tag, size) + ">";
+    if (m_handler.on_root) m_handler.on_root(root);
+    if (is_empty) m_done = true;
+  } else if (m_depth == 1) {
+    if (TagName(tag, size) == "trk") {
+      m_in_track = true;
+      m_segment = 0;
+      m_header.assign(tag, size);
+      if (m_handler.on_track_begin) m_handler.on_track_begin();
+      if (is_empty) {
+        if (m_handler.on_track_end) m_handler.on_track_end(m_header, 0);
+        m_header.clear();
+        m_in_track = false;
+      }
+    } else {
+      m_object.assign(tag, size);
+      if (is_empty) {
+        if (m_handler.on_object) m_handler.on_object(m_object);
+        m_object.clear();
+      }
+    }
+  } else if (m_depth == 2 && m_in_track && TagName(tag, size) == "trkseg") {
+    m_segment++;
+    m_points = kSegmentOpen;
+    m_n_points = 0;
+    m_segment_sent = false;
+    if (is_empty)
+      FlushPoints();
+    else
+      m_in_segment = true;
+  } else if (m_depth == 3 && m_in_segment) {
+    m_points.append(tag, size);
+    if (is_empty && ++m_n_points >= m_batch_size) FlushPoints();
+  } else {
+    Append(tag, size);
+  }
+
+  if (!is_empty) m_depth++;
+  return true;
+}
+
+bool GpxStreamReader::Feed(const char *data, size_t size) {
+  if (m_error) return false;
+  m_pending.append(data, size);
+
+  const char *buf = m_pending.data();
+  const size_t n = m_pending.size();
+  size_t pos = 0;
+
+  while (pos < n && !m_done) {
+    const char *lt = (const char *)memchr(buf + pos, '<', n - pos);
+    if (!lt) {
+      Append(buf + pos, n - pos);
+      pos = n;
+      break;
+    }
+    size_t start = lt - buf;
+    if (start > pos) Append(buf + pos, start - pos);
+    pos = start;
+
+    //  Find the end of this piece of markup, or wait for more input
+    size_t avail = n - start;
+    size_t end = std::string::npos;
+    if (avail < 2) break;
+    if (lt[1] == '!') {
+      if (avail < 9) break;
+      if (!strncmp(lt, "<!--", 4)) {
+        end = m_pending.find("-->", start + 4);
+        if (end == std::string::npos) break;
+        pos = end + 3;
+      } else if (!strncmp(lt, "<![CDATA[", 9)) {
+        end = m_pending.find("]]>", start + 9);
+        if (end == std::string::npos) break;
+        Append(lt, end + 3 - start);
+        pos = end + 3;
+      } else {  // DOCTYPE, maybe with an internal subset
+        size_t gt = m_pending.find('>', start);
+        size_t bracket = m_pending.find('[', start);
+        if (bracket != std::string::npos && bracket < gt)
+          gt = m_pending.find("]>", bracket);
+        if (gt == std::string::npos) break;
+        pos = m_pending.find('>', gt) + 1;
+      }
+    } else if (lt[1] == '?') {
+      end = m_pending.find("?>", start + 2);
+      if (end == std::string::npos) break;
+      pos = end + 2;
+    } else {
+      char quote = 0;
+      size_t i;
+      for (i = start + 1; i < n; i++) {
+        char c = buf[i];
+        if (quote) {
+          if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+          quote = c;
+        } else if (c == '>') {
+          break;
+        }
+      }
+      if (i == n) break;
+      if (!ProcessTag(lt, i + 1 - start)) {
+        m_error = true;
+        return false;
+      }
+      pos = i + 1;
+    }
+  }
+
+  if (m_done)
+    m_pending.clear();
+  else
+    m_pending.erase(0, pos);
+  return true;
+}
+
+bool GpxStreamReader::Finish() { return !m_error && m_done; }
+
+bool GpxStreamReader::ReadFile(const std::string &path) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  bool ok = Read(f);
+  fclose(f);
+  return ok;
+}
+
+bool GpxStreamReader::Read(FILE *f) {
+  std::vector<char> buffer(kReadSize);
+  bool ok = true;
+  size_t n;
+  while (ok && !m_done && (n = fread(buffer.data(), 1, buffer.size(), f)) > 0)
+    ok = Feed(buffer.data(), n);
+  if (ferror(f)) ok = false;
+
+  return ok && Finish();
+}
@@ -0,0 +1,509 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Own ship and sensor history database
+ * Author:   David Register
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+
+#include <wx/log.h>
+
+#include <SQLiteCpp/SQLiteCpp.h>
+
+#include "nav_history.h"
+
+#ifndef M_PI
+#define M_PI ((2) * (acos(0.0)))
+#endif
+
+//  How the values of a series are averaged
+enum NavHistoryKind {
+  kLinear,
+  kDirection,  // degrees, as directions, from 0 to 360
+  kLongitude   // degrees, as directions, from -180 to 180
+};
+
+//  The series as stored.  The position in the table is the id kept in the
+//  database, so new series go at the end.
+struct NavHistorySeries {
+  const char* name;
+  double resolution;  // values are stored rounded to this
+  NavHistoryKind kind;
+};
+
+static const NavHistorySeries kSeries[] = {
+    {"lat", 1e-6, kLinear},    {"lon", 1e-6, kLongitude},
+    {"sog", 0.01, kLinear},    {"cog", 0.1, kDirection},
+    {"hdt", 0.1, kDirection},  {"depth", 0.01, kLinear},
+    {"aws", 0.01, kLinear},    {"awa", 0.1, kDirection},
+    {"tws", 0.01, kLinear},    {"twa", 0.1, kDirection}};
+
+//  Retention policy: the samples of a tier older than keep seconds are
+//  replaced by their means per step seconds in the next tier.
+struct NavHistoryTier {
+  int step;     // 0 for the samples as recorded
+  time_t keep;  // 0 for forever
+};
+
+static const NavHistoryTier kTiers[] = {
+    {0, 7 * 24 * 3600}, {60, 183 * 24 * 3600}, {900, 0}};
+static const int kTierCount = sizeof(kTiers) / sizeof(kTiers[0]);
+
+static const size_t kChunkSamples = 600;
+static const int kCompactSeconds = 3600;
+
+//  Chunk encoding: the sample count, the times and then the values rounded
+//  to the series resolution, each column as zigzag varint deltas.
+
+static void PutVarint(std::string& out, unsigned long long v) {
+  while (v >= 0x80) {
+    out += (char)(v | 0x80);
+    v >>= 7;
+  }
+  out += (char)v;
+}
+
+static bool GetVarint(const unsigned char*& p, const unsigned char* end,
+                      unsigned long long& v) {
+  v = 0;
+  for (int shift = 0; p < end && shift < 64; shift += 7) {
+    unsigned char c = *p++;
+    v |= (unsigned long long)(c & 0x7f) << shift;
+    if (!(c & 0x80)) return true;
+  }
+  return false;
+}
+
+static unsigned long long ZigZag(long long v) {
+  return ((unsigned long long)v << 1) ^ (unsigned long long)(v >> 63);
+}
+
+static long long UnZigZag(unsigned long long v) {
+  return (long long)(v >> 1) ^ -(long long)(v & 1);
+}
+
+static std::string EncodeChunk(const std::vector<NavHistorySample>& samples,
+                               double resolution) {
+  std::string out;
+  PutVarint(out, samples.size());
+  long long last = 0;
+  for (const NavHistorySample& s : samples) {
+    PutVarint(out, ZigZag((long long)s.time - last));
+    last = s.time;
+  }
+  last = 0;
+  for (const NavHistorySample& s : samples) {
+    long long v = std::llround(s.value / resolution);
+    PutVarint(out, ZigZag(v - last));
+    last = v;
+  }
+  return out;
+}
+
+static bool DecodeChunk(const void* data, int size, double resolution,
+                        std::vector<NavHistorySample>& samples) {
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  const unsigned char* end = p + size;
+  unsigned long long n, v;
+  //  On error nothing is added
+  if (!GetVarint(p, end, n) || n > (unsigned long long)size) return false;
+
+  size_t first = samples.size();
+  samples.resize(first + n);
+  long long last = 0;
+  for (size_t i = first; i < samples.size(); i++) {
+    if (!GetVarint(p, end, v)) {
+      samples.resize(first);
+      return false;
+    }
+    last += UnZigZag(v);
+    samples[i].time = last;
+  }
+  last = 0;
+  for (size_t i = first; i < samples.size(); i++) {
+    if (!GetVarint(p, end, v)) {
+      samples.resize(first);
+      return false;
+    }
+    last += UnZigZag(v);
+    samples[i].value = last * resolution;
+  }
+  return true;
+}
+
+//  Means per step seconds of samples in time order, at the start of each
+//  step.
+static std::vector<NavHistorySample> Average(
+    const std::vector<NavHistorySample>& samples, int step,
+    NavHistoryKind kind) {
+  std::vector<NavHistorySample> means;
+  size_t i = 0;
+  while (i < samples.size()) {
+    time_t start = samples[i].time - samples[i].time % step;
+    double sum = 0, sum_sin = 0, sum_cos = 0;
+    int n = 0;
+    for (; i < samples.size() && samples[i].time < start + step; i++, n++) {
+      double v = samples[i].value;
+      if (kind != kLinear) {
+        sum_sin += sin(v * M_PI / 180.);
+        sum_cos += cos(v * M_PI / 180.);
+      } else
+        sum += v;
+    }
+    double mean;
+    if (kind != kLinear) {
+      mean = atan2(sum_sin, sum_cos) * 180. / M_PI;
+      if (kind == kDirection && mean < 0) mean += 360.;
+    } else
+      mean = sum / n;
+    means.push_back({start, mean});
+  }
+  return means;
+}
+
+static bool SampleBefore(const NavHistorySample& a,
+                         const NavHistorySample& b) {
+  return a.time < b.time;
+}
+
+const int NavHistory::kFlushSeconds;
+
+NavHistory& NavHistory::GetInstance() {
+  static NavHistory instance;
+  return instance;
+}
+
+NavHistory::NavHistory()
+    : m_generation(0),
+      m_last_compact(0),
+      m_running(false),
+      m_stop(false),
+      m_flush_request(0),
+      m_flush_done(0) {}
+
+NavHistory::~NavHistory() { Stop(); }
+
+bool NavHistory::Start(const std::string& path) {
+  Stop();
+  try {
+    m_db.reset(new SQLite::Database(
+        path, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE));
+    //  Readers never wait for the writer, and the other way round
+    m_db->exec("PRAGMA journal_mode = WAL");
+    m_db->exec("PRAGMA synchronous = NORMAL");
+    m_db->exec(
+        "CREATE TABLE IF NOT EXISTS chunks ("
+        "id INTEGER PRIMARY KEY, series INTEGER NOT NULL, "
+        "tier INTEGER NOT NULL, t0 INTEGER NOT NULL, t1 INTEGER NOT NULL, "
+        "n INTEGER NOT NULL, data BLOB NOT NULL)");
+    m_db->exec(
+        "CREATE INDEX IF NOT EXISTS chunks_time ON chunks (series, t0)");
+  } catch (SQLite::Exception& e) {
+    wxLogWarning("Cannot open nav history %s: %s", path.c_str(), e.what());
+    m_db.reset();
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_path = path;
+  m_generation++;
+  m_open.assign((int)Series::Count, OpenChunk{0, {}});
+  m_last_time.assign((int)Series::Count, 0);
+  m_last_compact = 0;
+  m_stop = false;
+  m_running = true;
+  m_thread = std::thread(&NavHistory::Worker, this);
+  return true;
+}
+
+void NavHistory::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) return;
+    m_running = false;
+    m_stop = true;
+  }
+  m_cond.notify_all();
+  m_thread.join();
+  m_db.reset();
+  m_open.clear();
+}
+
+void NavHistory::Add(Series series, time_t time, double value) {
+  if (std::isnan(value)) return;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_running) return;
+  time_t& last = m_last_time[(int)series];
+  if (time == last) return;
+  last = time;
+  m_pending.push_back({series, time, value});
+}
+
+void NavHistory::Flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (!m_running) return;
+  int request = ++m_flush_request;
+  m_cond.notify_all();
+  m_cond.wait(lock, [&] { return m_flush_done >= request || !m_running; });
+}
+
+void NavHistory::Worker() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cond.wait_for(lock, std::chrono::seconds(kFlushSeconds), [this] {
+      return m_stop || m_flush_request != m_flush_done;
+    });
+    std::vector<Pending> pending;
+    pending.swap(m_pending);
+    int request = m_flush_request;
+    bool flush = request != m_flush_done;
+    bool stop = m_stop;
+    lock.unlock();
+
+    try {
+      Write(pending);
+      //  Later samples go to new chunks, which may be compacted
+      if (flush)
+        for (OpenChunk& chunk : m_open) chunk = OpenChunk{0, {}};
+      time_t now = time(0);
+      if (flush || now - m_last_compact >= kCompactSeconds) {
+        Compact(now);
+        m_last_compact = now;
+      }
+    } catch (SQLite::Exception& e) {
+      wxLogWarning("Nav history not written: %s", e.what());
+      for (OpenChunk& chunk : m_open) chunk = OpenChunk{0, {}};
+    }
+
+    lock.lock();
+    m_flush_done = request;
+    m_cond.notify_all();
+    if (stop) return;
+  }
+}
+
+void NavHistory::Write(const std::vector<Pending>& pending) {
+  if (pending.empty()) return;
+
+  std::vector<bool> changed((int)Series::Count, false);
+  SQLite::Transaction transaction(*m_db);
+  for (const Pending& p : pending) {
+    int series = (int)p.series;
+    OpenChunk& chunk = m_open[series];
+    chunk.samples.push_back({p.time, p.value});
+    changed[series] = true;
+    if (chunk.samples.size() >= kChunkSamples) {
+      WriteChunk(series, 0, chunk);
+      chunk = OpenChunk{0, {}};
+      changed[series] = false;
+    }
+  }
+  for (int series = 0; series < (int)Series::Count; series++)
+    if (changed[series]) WriteChunk(series, 0, m_open[series]);
+  transaction.commit();
+}
+
+//  Write chunk, or rewrite it with the samples added since.
+void NavHistory::WriteChunk(int series, int tier, OpenChunk& chunk) {
+  std::string data = EncodeChunk(chunk.samples, kSeries[series].resolution);
+  auto range = std::minmax_element(chunk.samples.begin(), chunk.samples.end(),
+                                   SampleBefore);
+  long long t0 = range.first->time;
+  long long t1 = range.second->time;
+
+  if (chunk.id) {
+    SQLite::Statement update(
+        *m_db, "UPDATE chunks SET t0 = ?, t1 = ?, n = ?, data = ? WHERE id = ?");
+    update.bind(1, t0);
+    update.bind(2, t1);
+    update.bind(3, (int)chunk.samples.size());
+    update.bind(4, data.data(), data.size());
+    update.bind(5, chunk.id);
+    update.exec();
+  } else {
+    SQLite::Statement insert(*m_db,
+                             "INSERT INTO chunks (series, tier, t0, t1, n, "
+                             "data) VALUES (?, ?, ?, ?, ?, ?)");
+    insert.bind(1, series);
+    insert.bind(2, tier);
+    insert.bind(3, t0);
+    insert.bind(4, t1);
+    insert.bind(5, (int)chunk.samples.size());
+    insert.bind(6, data.data(), data.size());
+    insert.exec();
+    chunk.id = m_db->getLastInsertRowid();
+  }
+}
+
+//  Apply the retention policy.  The chunk being filled is left alone, and
+//  so are the samples of a step that is partly in the chunks still kept,
+//  so there is a single mean per step.
+void NavHistory::Compact(time_t now) {
+  for (int tier = 0; tier + 1 < kTierCount; tier++) {
+    if (!kTiers[tier].keep) continue;
+    long long cutoff = now - kTiers[tier].keep;
+    int step = kTiers[tier + 1].step;
+
+    for (int series = 0; series < (int)Series::Count; series++) {
+      long long open = tier == 0 ? m_open[series].id : 0;
+      SQLite::Transaction transaction(*m_db);
+
+      std::vector<long long> ids;
+      std::vector<NavHistorySample> samples;
+      SQLite::Statement select(*m_db,
+                               "SELECT id, data FROM chunks WHERE series = ? "
+                               "AND tier = ? AND t1 < ? AND id != ?");
+      select.bind(1, series);
+      select.bind(2, tier);
+      select.bind(3, cutoff);
+      select.bind(4, open);
+      while (select.executeStep()) {
+        ids.push_back(select.getColumn(0).getInt64());
+        SQLite::Column data = select.getColumn(1);
+        DecodeChunk(data.getBlob(), data.getBytes(),
+                    kSeries[series].resolution, samples);
+      }
+      if (samples.empty()) continue;
+
+      //  The first step with samples in the chunks kept
+      long long limit = LLONG_MAX;
+      SQLite::Statement first(*m_db,
+                              "SELECT MIN(t0) FROM chunks WHERE series = ? "
+                              "AND tier = ? AND (t1 >= ? OR id = ?)");
+      first.bind(1, series);
+      first.bind(2, tier);
+      first.bind(3, cutoff);
+      first.bind(4, open);
+      if (first.executeStep() && !first.getColumn(0).isNull()) {
+        limit = first.getColumn(0).getInt64();
+        limit -= limit % step;
+      }
+
+      SQLite::Statement remove(*m_db, "DELETE FROM chunks WHERE id = ?");
+      for (long long id : ids) {
+        remove.bind(1, id);
+        remove.exec();
+        remove.reset();
+      }
+
+      std::stable_sort(samples.begin(), samples.end(), SampleBefore);
+      auto split = std::lower_bound(samples.begin(), samples.end(),
+                                    NavHistorySample{(time_t)limit, 0},
+                                    SampleBefore);
+      //  Put back the samples of a step not complete yet
+      if (split != samples.end()) {
+        OpenChunk rest{0, std::vector<NavHistorySample>(split, samples.end())};
+        WriteChunk(series, tier, rest);
+        samples.erase(split, samples.end());
+      }
+
+      std::vector<NavHistorySample> means =
+          Average(samples, step, kSeries[series].kind);
+      for (size_t i = 0; i < means.size(); i += kChunkSamples) {
+        OpenChunk chunk{0, {}};
+        chunk.samples.assign(
+            means.begin() + i,
+            means.begin() + std::min(means.size(), i + kChunkSamples));
+        WriteChunk(series, tier + 1, chunk);
+      }
+      transaction.commit();
+    }
+  }
+}
+
+std::vector<std::string> NavHistory::GetSeriesNames() {
+  std::vector<std::string> names;
+  for (const NavHistorySeries& s : kSeries) names.push_back(s.name);
+  return names;
+}
+
+int NavHistory::GetSeriesDecimals(const std::string& name) {
+  for (const NavHistorySeries& s : kSeries) {
+    if (name == s.name) return (int)std::lround(-std::log10(s.resolution));
+  }
+  return -1;
+}
+
+std::vector<NavHistorySample> NavHistory::Query(const std::string& name,
+                                                time_t from, time_t to,
+                                                int step) {
+  std::vector<NavHistorySample> samples;
+  int series = 0;
+  while (series < (int)Series::Count && name != kSeries[series].name)
+    series++;
+  if (series == (int)Series::Count) return samples;
+
+  std::string path;
+  int generation;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    path = m_path;
+    generation = m_generation;
+  }
+  if (path.empty()) return samples;
+
+  //  A connection of our own per thread, so the writer is never waited for.
+  //  It is opened again after Start().
+  struct Reader {
+    std::string path;
+    int generation = 0;
+    std::unique_ptr<SQLite::Database> db;
+  };
+  static thread_local Reader reader;
+  try {
+    if (!reader.db || reader.path != path ||
+        reader.generation != generation) {
+      reader.db.reset();
+      reader.db.reset(new SQLite::Database(path, SQLite::OPEN_READONLY));
+      reader.path = path;
+      reader.generation = generation;
+    }
+    SQLite::Database& db = *reader.db;
+    SQLite::Statement select(db,
+                             "SELECT data FROM chunks WHERE series = ? AND "
+                             "t0 <= ? AND t1 >= ?");
+    select.bind(1, series);
+    select.bind(2, (long long)to);
+    select.bind(3, (long long)from);
+    std::vector<NavHistorySample> chunk;
+    while (select.executeStep()) {
+      SQLite::Column data = select.getColumn(0);
+      chunk.clear();
+      DecodeChunk(data.getBlob(), data.getBytes(), kSeries[series].resolution,
+                  chunk);
+      for (const NavHistorySample& s : chunk)
+        if (s.time >= from && s.time <= to) samples.push_back(s);
+    }
+  } catch (SQLite::Exception& e) {
+    wxLogMessage("Nav history query failed: %s", e.what());
+    reader.db.reset();
+    samples.clear();
+    return samples;
+  }
+
+  std::stable_sort(samples.begin(), samples.end(), SampleBefore);
+  if (step > 0) samples = Average(samples, step, kSeries[series].kind);
+  return samples;
+}
@@ -21,8 +21,15 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
  ***************************************************************************
  */
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <thread>
+
+#include <wx/ffile.h>
 #include <wx/string.h>
 
+#include "gpx_stream_reader.h"
 #include "nav_object_database.h"
 #include "routeman.h"
 #include "navutil_base.h"
@@ -285,20 +292,11 @@ static TrackPoint *GPXLoadTrackPoint1(pugi::xml_node &wpt_node) {
 
   for (pugi::xml_node child = wpt_node.first_child(); child != 0;
        child = child.next_sibling()) {
-    const char *pcn = child.name();
-    if (!strcmp(pcn, "time"))
+    //  Extensions, e.g. opencpn:action in the changes file, carry nothing
+    //  for the point itself
+    if (!strcmp(child.name(), "time"))
       TimeString = wxString::FromUTF8(child.first_child().value());
-
-    //    OpenCPN Extensions....
-    else if (!strcmp(pcn, "extensions")) {
-      for (pugi::xml_node ext_child = child.first_child(); ext_child;
-           ext_child = ext_child.next_sibling()) {
-        wxString ext_name = wxString::FromUTF8(ext_child.name());
-        if (ext_name == _T ( "opencpn:action" )) {
-        }
-      }  // for
-    }    // extensions
-  }      // for
+  }
 
   // Create trackpoint
   return new TrackPoint(rlat, rlon, TimeString);
@@ -833,7 +831,7 @@ static bool GPXCreateTrkpt(pugi::xml_node node, TrackPoint *pt,
 
   if (flags & OUT_TIME && pt->HasValidTimestamp()) {
     child = node.append_child("time");
-    child.append_child(pugi::node_pcdata).set_value(pt->GetTimeString());
+    child.append_child(pugi::node_pcdata).set_value(pt->GetTimeString().c_str());
   }
 
   return true;
@@ -1472,38 +1470,129 @@ bool NavObjectCollection1::LoadAllGPXObjects(bool b_full_viz,
   pugi::xml_node objects = this->child("gpx");
 
   for (pugi::xml_node object = objects.first_child(); object;
-       object = object.next_sibling()) {
-    if (!strcmp(object.name(), "wpt")) {
-      RoutePoint *pWp = ::GPXLoadWaypoint1(object, _T("circle"), _T(""),
-                                           b_full_viz, false, false, 0);
+       object = object.next_sibling())
+    LoadGPXObject(object, b_full_viz, wpt_duplicates, b_compute_bbox);
 
-      pWp->m_bIsolatedMark = true;  // This is an isolated mark
-      RoutePoint *pExisting =
-          WaypointExists(pWp->GetName(), pWp->m_lat, pWp->m_lon);
-      if (!pExisting) {
-        if (NULL != pWayPointMan) pWayPointMan->AddRoutePoint(pWp);
-        pSelect->AddSelectableRoutePoint(pWp->m_lat, pWp->m_lon, pWp);
-        LLBBox wptbox;
-        wptbox.Set(pWp->m_lat, pWp->m_lon, pWp->m_lat, pWp->m_lon);
-        BBox.Expand(wptbox);
-      } else {
-        delete pWp;
-        wpt_duplicates++;
-      }
-    } else if (!strcmp(object.name(), "trk")) {
-      Track *pTrack = GPXLoadTrack1(object, b_full_viz, false, false, 0);
-      if (InsertTrack(pTrack) && b_compute_bbox && pTrack->IsVisible()) {
-        // BBox.Expand(pTrack->GetBBox());
-      }
-    } else if (!strcmp(object.name(), "rte")) {
-      Route *pRoute = GPXLoadRoute1(object, b_full_viz, false, false, 0, false);
-      if (InsertRouteA(pRoute, this) && b_compute_bbox && pRoute->IsVisible()) {
-        BBox.Expand(pRoute->GetBBox());
-      }
+  return true;
+}
+
+void NavObjectCollection1::LoadGPXObject(pugi::xml_node object,
+                                         bool b_full_viz, int &wpt_duplicates,
+                                         bool b_compute_bbox) {
+  if (!strcmp(object.name(), "wpt")) {
+    RoutePoint *pWp = ::GPXLoadWaypoint1(object, _T("circle"), _T(""),
+                                         b_full_viz, false, false, 0);
+
+    pWp->m_bIsolatedMark = true;  // This is an isolated mark
+    RoutePoint *pExisting =
+        WaypointExists(pWp->GetName(), pWp->m_lat, pWp->m_lon);
+    if (!pExisting) {
+      if (NULL != pWayPointMan) pWayPointMan->AddRoutePoint(pWp);
+      pSelect->AddSelectableRoutePoint(pWp->m_lat, pWp->m_lon, pWp);
+      LLBBox wptbox;
+      wptbox.Set(pWp->m_lat, pWp->m_lon, pWp->m_lat, pWp->m_lon);
+      BBox.Expand(wptbox);
+    } else {
+      delete pWp;
+      wpt_duplicates++;
+    }
+  } else if (!strcmp(object.name(), "trk")) {
+    Track *pTrack = GPXLoadTrack1(object, b_full_viz, false, false, 0);
+    if (InsertTrack(pTrack) && b_compute_bbox && pTrack->IsVisible()) {
+      // BBox.Expand(pTrack->GetBBox());
+    }
+  } else if (!strcmp(object.name(), "rte")) {
+    Route *pRoute = GPXLoadRoute1(object, b_full_viz, false, false, 0, false);
+    if (InsertRouteA(pRoute, this) && b_compute_bbox && pRoute->IsVisible()) {
+      BBox.Expand(pRoute->GetBBox());
     }
   }
+}
 
-  return true;
+//  The trkpt elements of one batch from GpxStreamReader, run on a worker
+static std::vector<TrackPoint *> LoadTrackPointBatch(const std::string &xml,
+                                                     int segment) {
+  std::vector<TrackPoint *> points;
+  pugi::xml_document doc;
+  if (!doc.load_buffer(xml.data(), xml.size())) return points;
+
+  for (pugi::xml_node tpchild = doc.first_child().first_child(); tpchild;
+       tpchild = tpchild.next_sibling()) {
+    if (strcmp(tpchild.name(), "trkpt")) continue;
+    TrackPoint *pWp = ::GPXLoadTrackPoint1(tpchild);
+    if (pWp) {
+      pWp->m_GPXTrkSegNo = segment;
+      points.push_back(pWp);
+    }
+  }
+  return points;
+}
+
+bool NavObjectCollection1::LoadGPXStream(const wxString &path,
+                                         int &wpt_duplicates) {
+  wpt_duplicates = 0;
+  bool b_full_viz = true;
+
+  //  Each object is parsed into this small document in turn, the track
+  //  points in batches by workers, at most max_batches in flight
+  pugi::xml_document fragment;
+  std::vector<TrackPoint *> track_points;
+  std::deque<std::future<std::vector<TrackPoint *> > > batches;
+  const size_t max_batches =
+      std::max(2u, std::thread::hardware_concurrency());
+
+  auto collect = [&](size_t keep) {
+    while (batches.size() > keep) {
+      std::vector<TrackPoint *> points = batches.front().get();
+      batches.pop_front();
+      track_points.insert(track_points.end(), points.begin(), points.end());
+    }
+  };
+
+  GpxStreamReader::Handler handler;
+  handler.on_root = [&](const std::string &xml) {
+    if (!fragment.load_buffer(xml.data(), xml.size())) return;
+    pugi::xml_attribute creator = fragment.first_child().attribute("creator");
+    b_full_viz = strcmp(creator.value(), "OpenCPN") != 0;
+  };
+  handler.on_object = [&](const std::string &xml) {
+    if (!fragment.load_buffer(xml.data(), xml.size())) return;
+    LoadGPXObject(fragment.first_child(), b_full_viz, wpt_duplicates, false);
+  };
+  handler.on_track_begin = [&]() { track_points.clear(); };
+  handler.on_points = [&](const std::string &xml, int segment) {
+    collect(max_batches - 1);
+    batches.push_back(
+        std::async(std::launch::async, LoadTrackPointBatch, xml, segment));
+  };
+  handler.on_track_end = [&](const std::string &xml, int n_segments) {
+    collect(0);
+    Track *pTrack = NULL;
+    if (fragment.load_buffer(xml.data(), xml.size())) {
+      pugi::xml_node trk_node = fragment.first_child();
+      pTrack = GPXLoadTrack1(trk_node, b_full_viz, false, false, 0);
+    }
+    if (pTrack) {
+      for (TrackPoint *pWp : track_points) pTrack->AddPoint(pWp);
+      pTrack->SetCurrentTrackSeg(n_segments);
+      InsertTrack(pTrack);
+    } else {
+      for (TrackPoint *pWp : track_points) delete pWp;
+    }
+    track_points.clear();
+  };
+
+  //  wxFFile opens the file by its wide name on Windows
+  wxFFile file(path, "rb");
+  if (!file.IsOpened()) return false;
+  GpxStreamReader reader(handler);
+  bool ok = reader.Read(file.fp());
+
+  //  A file cut off inside a track
+  collect(0);
+  for (TrackPoint *pWp : track_points) delete pWp;
+
+  return ok;
 }
 
 
@@ -1548,9 +1637,9 @@ int NavObjectCollection1::LoadAllGPXObjectsAsLayer(int layer_id,
 
 NavObjectChanges::NavObjectChanges(wxString file_name)
     : NavObjectCollection1() {
-  m_filename = file_name;
-  m_changes_file = fopen(m_filename.mb_str(), "a");
+  m_changes_file = 0;
   m_bdirty = false;
+  Init(file_name);
 }
 
 NavObjectChanges::~NavObjectChanges() {
@@ -1558,6 +1647,58 @@ NavObjectChanges::~NavObjectChanges() {
   if (::wxFileExists(m_filename)) ::wxRemoveFile(m_filename);
 }
 
+void NavObjectChanges::Init(const wxString &path) {
+  Close();
+  m_filename = path;
+  m_changes_file = fopen(m_filename.mb_str(), "a");
+  m_journal_size = 0;
+  if (m_changes_file) {
+    fseek(m_changes_file, 0, SEEK_END);
+    m_journal_size = ftell(m_changes_file);
+  }
+  m_last_flush = time(NULL);
+  m_bpending = false;
+}
+
+void NavObjectChanges::Close() {
+  if (m_changes_file) fclose(m_changes_file);
+  m_changes_file = 0;
+  m_bpending = false;
+}
+
+void NavObjectChanges::Flush() {
+  if (m_changes_file && m_bpending) fflush(m_changes_file);
+  m_last_flush = time(NULL);
+  m_bpending = false;
+}
+
+bool NavObjectChanges::Rotate(const wxString &old_path) {
+  Close();
+  bool ok = true;
+  if (::wxFileExists(m_filename))
+    ok = ::wxRenameFile(m_filename, old_path, false);
+  Init(m_filename);
+  m_bdirty = false;
+  return ok;
+}
+
+//  The change is written out and dropped from the document at once, the
+//  journal file is the only record of it.  Route, track and waypoint edits
+//  are flushed as they come, track points are committed in groups, at
+//  most kJournalFlushSeconds apart.
+void NavObjectChanges::WriteChange(pugi::xml_node object, bool flush_now) {
+  if (m_changes_file) {
+    pugi::xml_writer_file writer(m_changes_file);
+    object.print(writer, " ");
+    m_journal_size = ftell(m_changes_file);
+    m_bdirty = true;
+    m_bpending = true;
+    if (flush_now || time(NULL) - m_last_flush >= kJournalFlushSeconds)
+      Flush();
+  }
+  object.parent().remove_child(object);
+}
+
 void NavObjectChanges::AddRoute(Route *pr, const char *action) {
   SetRootGPXNode();
 
@@ -1569,12 +1710,7 @@ void NavObjectChanges::AddRoute(Route *pr, const char *action) {
   pugi::xml_node child = xchild.append_child("opencpn:action");
   child.append_child(pugi::node_pcdata).set_value(action);
 
-  if (m_changes_file){
-    pugi::xml_writer_file writer(m_changes_file);
-    object.print(writer, " ");
-    fflush(m_changes_file);
-    m_bdirty = true;
-  }
+  WriteChange(object, true);
 }
 
 void NavObjectChanges::AddTrack(Track *pr, const char *action) {
@@ -1587,12 +1723,7 @@ void NavObjectChanges::AddTrack(Track *pr, const char *action) {
   pugi::xml_node child = xchild.append_child("opencpn:action");
   child.append_child(pugi::node_pcdata).set_value(action);
 
-  if (m_changes_file){
-    pugi::xml_writer_file writer(m_changes_file);
-    object.print(writer, " ");
-    fflush(m_changes_file);
-    m_bdirty = true;
-  }
+  WriteChange(object, true);
 }
 
 void NavObjectChanges::AddWP(RoutePoint *pWP, const char *action) {
@@ -1605,12 +1736,7 @@ void NavObjectChanges::AddWP(RoutePoint *pWP, const char *action) {
   pugi::xml_node child = xchild.append_child("opencpn:action");
   child.append_child(pugi::node_pcdata).set_value(action);
 
-  if (m_changes_file){
-    pugi::xml_writer_file writer(m_changes_file);
-    object.print(writer, " ");
-    fflush(m_changes_file);
-    m_bdirty = true;
-  }
+  WriteChange(object, true);
 }
 
 void NavObjectChanges::AddTrackPoint(TrackPoint *pWP, const char *action,
@@ -1628,12 +1754,7 @@ void NavObjectChanges::AddTrackPoint(TrackPoint *pWP, const char *action,
   pugi::xml_node gchild = xchild.append_child("opencpn:track_GUID");
   gchild.append_child(pugi::node_pcdata).set_value(parent_GUID.mb_str());
 
-  if (m_changes_file){
-    pugi::xml_writer_file writer(m_changes_file);
-    object.print(writer, " ");
-    fflush(m_changes_file);
-    m_bdirty = true;
-  }
+  WriteChange(object, false);
 }
 
 bool NavObjectChanges::ApplyChanges(void) {
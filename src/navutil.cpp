@@ -505,13 +505,15 @@ MyConfig::MyConfig(const wxString &LocalFileName)
       config_file.GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR);
   m_sNavObjSetFile += _T ( "navobj.xml" );
   m_sNavObjSetChangesFile = m_sNavObjSetFile + _T ( ".changes" );
+  m_sNavObjSetOldChangesFile = m_sNavObjSetChangesFile + _T ( ".old" );
 
   m_pNavObjectInputSet = NULL;
   m_pNavObjectChangesSet = NULL;
-
+  m_compact_running = false;
 }
 
 MyConfig::~MyConfig() {
+  WaitNavObjCompaction();
   for (size_t i = 0; i < g_canvasConfigArray.GetCount(); i++) {
     delete g_canvasConfigArray.Item(i);
   }
@@ -1494,6 +1496,10 @@ int MyConfig::LoadMyConfigRaw(bool bAsTemplate) {
   g_bEnableZoomToCursor = false;
   Read(_T ( "EnableZoomToCursor" ), &g_bEnableZoomToCursor);
 
+  // Own ship and sensor history database
+  g_bNavHistory = true;
+  Read(_T ( "EnableNavHistory" ), &g_bNavHistory);
+
   val.Clear();
   Read(_T ( "TrackIntervalSeconds" ), &val);
   if (val.Length() > 0) {
@@ -1673,8 +1679,8 @@ static bool ReloadPendingChanges(const wxString& changes_path) {
   // We crashed last time :(
   // That's why this file still exists...
   // Let's reconstruct the unsaved changes
+  //  Only read, so the journal is not opened for appending here
   auto pNavObjectChangesSet = NavObjectChanges::getTempInstance();
-  pNavObjectChangesSet->Init(changes_path);
   pNavObjectChangesSet->load_file(changes_path.fn_str());
 
   //  Remove the file before applying the changes,
@@ -1709,11 +1715,15 @@ void MyConfig::LoadNavObjects() {
 
   m_pNavObjectChangesSet = NavObjectChanges::getInstance();
 
-  if (::wxFileExists(m_sNavObjSetChangesFile)) {
-    if (ReloadPendingChanges(m_sNavObjSetChangesFile)) {
-      UpdateNavObj();
-    }
-  }
+  //  A journal left by a compaction that did not finish is older than the
+  //  current one, so goes first
+  bool b_reloaded = false;
+  if (::wxFileExists(m_sNavObjSetOldChangesFile))
+    b_reloaded |= ReloadPendingChanges(m_sNavObjSetOldChangesFile);
+  if (::wxFileExists(m_sNavObjSetChangesFile))
+    b_reloaded |= ReloadPendingChanges(m_sNavObjSetChangesFile);
+  if (b_reloaded) UpdateNavObj();
+
   m_pNavObjectChangesSet->Init(m_sNavObjSetChangesFile);
 }
 
@@ -2797,6 +2807,7 @@ void MyConfig::UpdateSettings() {
   Write(_T ( "WaypointPreventDragging" ), g_bWayPointPreventDragging);
 
   Write(_T ( "EnableZoomToCursor" ), g_bEnableZoomToCursor);
+  Write(_T ( "EnableNavHistory" ), g_bNavHistory);
 
   Write(_T ( "TrackIntervalSeconds" ), g_TrackIntervalSeconds);
   Write(_T ( "TrackDeltaDistance" ), g_TrackDeltaDistance);
@@ -2822,28 +2833,89 @@ void MyConfig::UpdateSettings() {
   Flush();
 }
 
+//  Write navobj.xml through a temporary file, so a crash while saving
+//  leaves the previous navobj.xml and its journal intact.
+static bool SaveNavObjSet(NavObjectCollection1 *set, const wxString &path) {
+  wxString tmp_path = path + _T(".tmp");
+  if (!set->save_file(tmp_path.fn_str(), "  ")) return false;
+  return ::wxRenameFile(tmp_path, path, true);
+}
+
+void MyConfig::WaitNavObjCompaction() {
+  if (m_compact_thread.joinable()) m_compact_thread.join();
+}
+
+void MyConfig::CheckNavObjJournal() {
+  if (!m_pNavObjectChangesSet) return;
+  m_pNavObjectChangesSet->Flush();
+
+  //  Compact once the journal is past this size, at most one at a time
+  const long kCompactJournalBytes = 4 * 1024 * 1024;
+  if (m_compact_running ||
+      m_pNavObjectChangesSet->GetJournalSize() < kCompactJournalBytes)
+    return;
+  WaitNavObjCompaction();
+
+  //  A journal from a failed compaction is still waiting, start over with
+  //  a full save here
+  if (::wxFileExists(m_sNavObjSetOldChangesFile)) {
+    UpdateNavObj(true);
+    return;
+  }
+
+  //  The objects are collected here, on the GUI thread that owns them:
+  //  routes, tracks and waypoints are edited from the GUI thread without
+  //  any lock, so building the document stays here and only the file
+  //  output goes to the worker.  Changes made from now on go to a new
+  //  journal, the old one is removed once navobj.xml holds everything it
+  //  recorded.
+  NavObjectCollection1 *pNavObjectSet = new NavObjectCollection1();
+  pNavObjectSet->CreateAllGPXObjects();
+  if (!m_pNavObjectChangesSet->Rotate(m_sNavObjSetOldChangesFile)) {
+    delete pNavObjectSet;
+    return;
+  }
+
+  m_compact_running = true;
+  wxString navobj_path = m_sNavObjSetFile;
+  wxString old_changes = m_sNavObjSetOldChangesFile;
+  m_compact_thread = std::thread([this, pNavObjectSet, navobj_path,
+                                  old_changes]() {
+    wxLogNull logNo;
+    if (SaveNavObjSet(pNavObjectSet, navobj_path))
+      ::wxRemoveFile(old_changes);
+    delete pNavObjectSet;
+    m_compact_running = false;
+  });
+}
+
 void MyConfig::UpdateNavObj(bool bRecreate) {
+  WaitNavObjCompaction();
+
   //   Create the NavObjectCollection, and save to specified file
   NavObjectCollection1 *pNavObjectSet = new NavObjectCollection1();
 
   pNavObjectSet->CreateAllGPXObjects();
-  pNavObjectSet->SaveFile(m_sNavObjSetFile);
+  bool b_saved = SaveNavObjSet(pNavObjectSet, m_sNavObjSetFile);
 
   delete pNavObjectSet;
 
-  if (m_pNavObjectChangesSet->m_changes_file)
-    fclose(m_pNavObjectChangesSet->m_changes_file);
+  m_pNavObjectChangesSet->Close();
 
-  if (::wxFileExists(m_sNavObjSetChangesFile)) {
+  if (b_saved) {
     wxLogNull logNo;  // avoid silly log error message.
-    wxRemoveFile(m_sNavObjSetChangesFile);
+    if (::wxFileExists(m_sNavObjSetChangesFile))
+      wxRemoveFile(m_sNavObjSetChangesFile);
+    if (::wxFileExists(m_sNavObjSetOldChangesFile))
+      wxRemoveFile(m_sNavObjSetOldChangesFile);
+    m_pNavObjectChangesSet->m_bdirty = false;
   }
 
   if (bRecreate) {
     m_pNavObjectChangesSet->Init(m_sNavObjSetChangesFile);
 
+    //  The changes set keeps no objects in memory, only the journal file
     m_pNavObjectChangesSet->reset();
-    m_pNavObjectChangesSet->load_file(m_sNavObjSetChangesFile.fn_str());
   }
 }
 
@@ -3143,9 +3215,9 @@ void UI_ImportGPX(wxWindow *parent, bool islayer, wxString dirpath,
 
       if (::wxFileExists(path)) {
         NavObjectCollection1 *pSet = new NavObjectCollection1;
-        pSet->load_file(path.fn_str());
 
         if (islayer) {
+          pSet->load_file(path.fn_str());
           l->m_NoOfItems = pSet->LoadAllGPXObjectsAsLayer(
               l->m_LayerID, l->m_bIsVisibleOnChart, l->m_bHasVisibleNames);
           l->m_LayerType = isPersistent ? _("Persistent") : _("Temporary");
@@ -3176,10 +3248,10 @@ void UI_ImportGPX(wxWindow *parent, bool islayer, wxString dirpath,
             wxLogMessage(msg);
           }
         } else {
+          //  Streamed, imports can be large archives of tracks.  Full
+          //  visibility of names and objects unless from OpenCPN.
           int wpt_dups;
-          pSet->LoadAllGPXObjects(
-              !pSet->IsOpenCPN(),
-              wpt_dups);  // Import with full visibility of names and objects
+          pSet->LoadGPXStream(path, wpt_dups);
           if (wpt_dups > 0) {
             OCPNMessageBox(
                 parent,
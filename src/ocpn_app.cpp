@@ -113,6 +113,7 @@
 #include "mDNS_query.h"
 #include "mDNS_service.h"
 #include "multiplexer.h"
+#include "nav_history.h"
 #include "nav_object_database.h"
 #include "navutil_base.h"
 #include "navutil.h"
@@ -124,6 +125,7 @@
 #include "options.h"
 #include "own_ship.h"
 #include "plugin_handler.h"
+#include "render_bench.h"
 #include "route.h"
 #include "routemanagerdialog.h"
 #include "routeman.h"
@@ -218,6 +220,7 @@ int g_unit_test_2;
 bool g_start_fullscreen;
 bool g_rebuild_gl_cache;
 bool g_parse_all_enc;
+wxString g_render_bench_script;
 
 // Files specified on the command line, if any.
 wxVector<wxString> g_params;
@@ -958,6 +961,8 @@ void MyApp::OnInitCmdLine(wxCmdLineParser &parser) {
                      "or negative <num> specifies no limit."),
                    wxCMD_LINE_VAL_NUMBER);
   parser.AddSwitch(_T("unit_test_2"));
+  parser.AddOption(_T("render_bench"), wxEmptyString,
+                   _T("Run the offscreen S57 render benchmark <script> and exit."));
   parser.AddParam("import GPX files", wxCMD_LINE_VAL_STRING,
                   wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE);
   parser.AddLongSwitch("unit_test_2");
@@ -992,6 +997,7 @@ bool MyApp::OnCmdLineParsed(wxCmdLineParser &parser) {
   g_bdisable_opengl = parser.Found(_T("no_opengl"));
   g_rebuild_gl_cache = parser.Found(_T("rebuild_gl_raster_cache"));
   g_parse_all_enc = parser.Found(_T("parse_all_enc"));
+  parser.Found(_T("render_bench"), &g_render_bench_script);
   if (parser.Found(_T("unit_test_1"), &number)) {
     g_unit_test_1 = static_cast<int>(number);
     if (g_unit_test_1 == 0) g_unit_test_1 = -1;
@@ -1862,6 +1868,12 @@ bool MyApp::OnInit() {
   // move method to frame
   //if (g_parse_all_enc) ParseAllENC(gFrame);
 
+  // Process command line option to run the offscreen render benchmark
+  if (!g_render_bench_script.IsEmpty()) {
+    RenderBench bench(g_render_bench_script);
+    exit(bench.Run() ? 0 : 1);
+  }
+
   //      establish GPS timeout value as multiple of frame timer
   //      This will override any nonsense or unset value from the config file
   if ((gps_watchdog_timeout_ticks > 60) || (gps_watchdog_timeout_ticks <= 0))
@@ -2023,6 +2035,11 @@ bool MyApp::OnInit() {
   // Initialize the CommBridge
   m_comm_bridge.Initialize();
 
+  if (g_bNavHistory) {
+    wxFileName history_file(g_Platform->GetPrivateDataDir(), "nav_history.db");
+    NavHistory::GetInstance().Start(history_file.GetFullPath().ToStdString());
+  }
+
   std::vector<std::string> ipv4_addrs = get_local_ipv4_addresses();
 
   //If network connection is available, start the server and mDNS client
@@ -2085,6 +2102,8 @@ int MyApp::OnExit() {
   wxLogMessage(navmsg);
   g_loglast_time = lognow;
 
+  NavHistory::GetInstance().Stop();
+
   if (ptcmgr) delete ptcmgr;
 
   delete pConfig;
@@ -5769,6 +5769,10 @@ void MyFrame::OnFrameTimer1(wxTimerEvent &event) {
 
 #endif
 
+  //  Commit logged track points, compact the changes journal when large.
+  //  On Android this also bounds the journal between the scheduled saves.
+  if (pConfig) pConfig->CheckNavObjJournal();
+
   // Reset pending next AppMsgBus notification
   m_b_new_data = false;
 
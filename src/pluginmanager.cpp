@@ -169,11 +169,16 @@ struct sigaction sa_all_PIM;
 struct sigaction sa_all_PIM_previous;
 
 sigjmp_buf env_PIM;  // the context saved by sigsetjmp();
+static volatile sig_atomic_t in_plugin_PIM = 0;  // env_PIM is valid
 
 void catch_signals_PIM(int signo) {
   switch (signo) {
     case SIGSEGV:
-      siglongjmp(env_PIM, 1);  // jump back to the setjmp() point
+      if (in_plugin_PIM)
+        siglongjmp(env_PIM, 1);  // jump back to the setjmp() point
+      // Not in a plugin: put back the previous action, which gets the
+      // fault when the instruction is retried.
+      sigaction(SIGSEGV, &sa_all_PIM_previous, NULL);
       break;
 
     default:
@@ -1149,14 +1154,15 @@ void PlugInManager::HandleSignalK(std::shared_ptr<const SignalkMsg> sK_msg) {
 
   g_ownshipMMSI_SK = sK_msg->context_self;
 
-  wxJSONReader jsonReader;
-  wxJSONValue root;
+  if (GetJSONMessageTargetCount() == 0) return;
 
-  std::string msgTerminated = sK_msg->raw_message;
-  ;
-
-  int errors = jsonReader.Parse(msgTerminated, &root);
-  if (errors == 0) SendJSONMessageToAllPlugins(wxT("OCPN_CORE_SIGNALK"), root);
+  // Checked with the document shared with the plugins listening to the
+  // message, then passed on as received rather than written out again.
+  ObservedEvt ev;
+  ev.SetSharedPtr(sK_msg);
+  if (GetSignalkDocument(SignalkId("signalK"), ev))
+    SendMessageToAllPlugins(wxT("OCPN_CORE_SIGNALK"),
+                            wxString::FromUTF8(sK_msg->raw_message.c_str()));
 }
 
 /**
@@ -2179,48 +2185,49 @@ void PlugInManager::SendNMEASentenceToAllPlugIns(const wxString &sentence) {
       sentence);  // decouples 'const wxString &' and 'wxString &' to keep bin
                   // compat for plugins
 #ifndef __WXMSW__
-  // Set up a framework to catch (some) sigsegv faults from plugins.
-  sigaction(SIGSEGV, NULL, &sa_all_PIM_previous);  // save existing
-                                                   // action for this signal
+  // Set up a framework to catch (some) sigsegv faults from plugins.  The
+  // handler stays installed between sentences and only jumps back here
+  // while in_plugin_PIM is set.  It is installed again when it has been
+  // replaced, or has put back the previous action after a fault elsewhere,
+  // so a sentence costs a single sigaction() call.
   struct sigaction temp;
   sigaction(SIGSEGV, NULL, &temp);  // inspect existing action for this signal
-
-  temp.sa_handler = catch_signals_PIM;  // point to my handler
-  sigemptyset(&temp.sa_mask);           // make the blocking set
-                                        // empty, so that all
-                                        // other signals will be
-                                        // unblocked during my handler
-  temp.sa_flags = 0;
-  sigaction(SIGSEGV, &temp, NULL);
+  if (temp.sa_handler != catch_signals_PIM) {
+    sa_all_PIM_previous = temp;  // save existing action for this signal
+
+    temp.sa_handler = catch_signals_PIM;  // point to my handler
+    sigemptyset(&temp.sa_mask);           // make the blocking set
+                                          // empty, so that all
+                                          // other signals will be
+                                          // unblocked during my handler
+    // Not blocked in the handler either, so there is no signal mask to
+    // save in sigsetjmp() and restore after the jump.
+    temp.sa_flags = SA_NODEFER;
+    sigaction(SIGSEGV, &temp, NULL);
+  }
+
+  if (sigsetjmp(env_PIM, 0)) {  //  Something in a plugin faulted.
+    // Probably safest to assume that all variables in this method are
+    // trash.. So, simply return.
+    in_plugin_PIM = 0;
+    return;
+  }
+  in_plugin_PIM = 1;
 #endif
   auto plugin_array = PluginLoader::getInstance()->GetPlugInArray();
   for (unsigned int i = 0; i < plugin_array->GetCount(); i++) {
     PlugInContainer *pic = plugin_array->Item(i);
     if (pic->m_bEnabled && pic->m_bInitState) {
       if (pic->m_cap_flag & WANTS_NMEA_SENTENCES) {
-#ifndef __WXMSW__
-        if (sigsetjmp(env_PIM,
-                      1)) {  //  Something in the "else" code block faulted.
-
-          // Probably safest to assume that all variables in this method are
-          // trash.. So, simply clean up and return.
-          sigaction(SIGSEGV, &sa_all_PIM_previous,
-                    NULL);  // reset signal handler
-          return;
-        } else
-#endif
-        {
-          // volatile int *x = 0;
-          //*x = 0;
-          if (pic->m_pplugin)
-            pic->m_pplugin->SetNMEASentence(decouple_sentence);
-        }
+        // volatile int *x = 0;
+        //*x = 0;
+        if (pic->m_pplugin) pic->m_pplugin->SetNMEASentence(decouple_sentence);
       }
     }
   }
 
 #ifndef __WXMSW__
-  sigaction(SIGSEGV, &sa_all_PIM_previous, NULL);  // reset signal handler
+  in_plugin_PIM = 0;
 #endif
 }
 
@@ -0,0 +1,377 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Offscreen S57/S52 DC rendering benchmark
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <wx/bitmap.h>
+#include <wx/dcmemory.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+#include <wx/math.h>
+#include <wx/stopwatch.h>
+
+#include "render_bench.h"
+#include "LLRegion.h"
+#include "s52plib.h"
+#include "SpanFill.h"
+#include "s57chart.h"
+#include "OCPNRegion.h"
+#include "viewport.h"
+
+extern s52plib* ps52plib;
+
+//  Nominal display resolution used to turn a scale denominator into
+//  pixels per meter, 96 DPI.
+static const double kNominalPixPerMeter = 96. / 0.0254;
+
+RenderBench::RenderBench(const wxString& script)
+    : m_script(script),
+      m_repeat(1),
+      m_compare_spans(false),
+      m_reload(0),
+      m_heap_stats(false),
+      m_compare_store(false),
+      m_compare_bands(false),
+      m_quilt(0) {}
+
+bool RenderBench::Load() {
+  std::ifstream stream(m_script.ToStdString());
+  if (!stream) {
+    m_error = "Cannot open script " + m_script.ToStdString();
+    return false;
+  }
+  wxString script_dir = wxFileName(m_script).GetPath();
+
+  std::string line;
+  int line_nr = 0;
+  while (std::getline(stream, line)) {
+    line_nr++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) line = line.substr(0, hash);
+
+    std::istringstream words(line);
+    std::string keyword;
+    if (!(words >> keyword)) continue;
+
+    bool ok = true;
+    if (keyword == "cell") {
+      std::string path;
+      ok = static_cast<bool>(words >> path);
+      if (ok) {
+        wxFileName fn(path);
+        if (fn.IsRelative()) fn.MakeAbsolute(script_dir);
+        m_cells.push_back(fn.GetFullPath());
+      }
+    } else if (keyword == "view") {
+      View v;
+      v.rotation = 0.;
+      ok = static_cast<bool>(words >> v.lat >> v.lon >> v.scale >> v.width >>
+                             v.height);
+      if (ok) words >> v.rotation;
+      ok = ok && v.scale > 0 && v.width > 0 && v.height > 0;
+      if (ok) m_views.push_back(v);
+    } else if (keyword == "repeat") {
+      ok = static_cast<bool>(words >> m_repeat) && m_repeat > 0;
+    } else if (keyword == "spans") {
+      m_compare_spans = true;
+    } else if (keyword == "reload") {
+      ok = static_cast<bool>(words >> m_reload) && m_reload > 0;
+    } else if (keyword == "heap") {
+      m_heap_stats = true;
+    } else if (keyword == "store") {
+      m_compare_store = true;
+    } else if (keyword == "bands") {
+      m_compare_bands = true;
+    } else if (keyword == "quilt") {
+      ok = static_cast<bool>(words >> m_quilt) && m_quilt > 0;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      std::ostringstream ss;
+      ss << m_script.ToStdString() << ":" << line_nr << ": bad line";
+      m_error = ss.str();
+      return false;
+    }
+  }
+  if (m_cells.empty() || m_views.empty()) {
+    m_error = "Script needs at least one cell and one view";
+    return false;
+  }
+  return true;
+}
+
+static ViewPort MakeViewPort(const RenderBench::View& v) {
+  ViewPort vp;
+  vp.clat = v.lat;
+  vp.clon = v.lon;
+  vp.chart_scale = v.scale;
+  vp.ref_scale = v.scale;
+  vp.view_scale_ppm = kNominalPixPerMeter / v.scale;
+  vp.pix_width = v.width;
+  vp.pix_height = v.height;
+  vp.rotation = wxDegToRad(v.rotation);
+  vp.skew = 0.;
+  vp.tilt = 0.;
+  vp.b_quilt = false;
+  vp.m_projection_type = PROJECTION_MERCATOR;
+  vp.rv_rect = wxRect(0, 0, v.width, v.height);
+  vp.SetBoxes();
+  vp.Validate();
+  return vp;
+}
+
+//  The region work of Quilt::Compose(): pick the charts that show in the
+//  view, largest scale first, until it is covered, then cut each chart's
+//  patch from what the larger scale charts left.  Returns the patch count.
+static size_t ComposeRegions(const LLRegion& cvp_region,
+                             const std::vector<LLRegion>& coverage) {
+  LLRegion vp_region = cvp_region;
+  std::vector<const LLRegion*> candidates;
+  for (auto& chart_region : coverage) {
+    if (vp_region.Empty()) break;
+    LLRegion vpu_region(cvp_region);
+    vpu_region.Intersect(chart_region);
+    if (vpu_region.Empty()) continue;
+    vp_region.Subtract(chart_region);
+    candidates.push_back(&chart_region);
+  }
+
+  LLRegion covered_region;
+  size_t n_patches = 0;
+  for (auto chart_region : candidates) {
+    LLRegion patch_region = *chart_region;
+    patch_region.Subtract(covered_region);
+    covered_region.Union(*chart_region);
+    patch_region.Intersect(cvp_region);
+    if (!patch_region.Empty()) n_patches++;
+  }
+  return n_patches;
+}
+
+static void PrintHeapStats(const char* label) {
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  struct mallinfo2 mi = mallinfo2();
+#elif defined(__GLIBC__)
+  struct mallinfo mi = mallinfo();
+#endif
+#ifdef __GLIBC__
+  //  Free bytes spread over many chunks is what fragmentation looks like
+  printf("heap %-14s in use %9.1f MB  free %9.1f MB in %8lu chunks\n",
+         label, mi.uordblks / 1048576., mi.fordblks / 1048576.,
+         (unsigned long)mi.ordblks);
+#endif
+}
+
+bool RenderBench::Run() {
+  if (!Load()) {
+    fprintf(stderr, "render_bench: %s\n", m_error.c_str());
+    return false;
+  }
+  if (!ps52plib || !ps52plib->m_bOK) {
+    fprintf(stderr, "render_bench: S52 presentation library not loaded\n");
+    return false;
+  }
+
+  if (m_heap_stats) PrintHeapStats("before load");
+
+  std::vector<s57chart*> charts;
+  for (auto& cell : m_cells) {
+    wxStopWatch sw;
+    auto chart = new s57chart();
+    chart->DisableBackgroundSENC();
+    if (chart->Init(cell, FULL_INIT) != INIT_OK) {
+      fprintf(stderr, "render_bench: cannot load %s\n",
+              cell.ToStdString().c_str());
+      delete chart;
+      continue;
+    }
+    chart->SetColorScheme(GLOBAL_COLOR_SCHEME_DAY);
+    printf("load %-40s %9.1f ms\n",
+           wxFileName(cell).GetFullName().ToStdString().c_str(),
+           sw.TimeInMicro().ToDouble() / 1000.);
+    charts.push_back(chart);
+  }
+  if (charts.empty()) return false;
+
+  if (m_heap_stats) {
+    size_t n_alloc = 0, reserved = 0;
+    for (auto chart : charts) {
+      n_alloc += chart->GetArena().GetAllocCount();
+      reserved += chart->GetArena().GetBytesReserved();
+    }
+    PrintHeapStats("after load");
+    printf("arena %lu allocations in %.1f MB\n", (unsigned long)n_alloc,
+           reserved / 1048576.);
+  }
+
+  //  The first load above built any missing SENC, so these time the
+  //  cached SENC path that chart opening and quilting depend on
+  if (m_reload > 0) {
+    printf("\n");
+    for (auto& cell : m_cells) {
+      double total_ms = 0.;
+      int n_ok = 0;
+      for (int i = 0; i < m_reload; i++) {
+        wxStopWatch sw;
+        auto chart = new s57chart();
+        chart->DisableBackgroundSENC();
+        bool ok = chart->Init(cell, FULL_INIT) == INIT_OK;
+        delete chart;
+        if (!ok) break;
+        total_ms += sw.TimeInMicro().ToDouble() / 1000.;
+        n_ok++;
+      }
+      if (n_ok)
+        printf("reload %-38s %9.1f ms\n",
+               wxFileName(cell).GetFullName().ToStdString().c_str(),
+               total_ms / n_ok);
+    }
+  }
+
+  if (m_quilt > 0) {
+    //  Coverage as Quilt builds it from the chart database, by scale
+    std::vector<s57chart*> by_scale(charts);
+    std::sort(by_scale.begin(), by_scale.end(), [](s57chart* a, s57chart* b) {
+      return a->GetNativeScale() < b->GetNativeScale();
+    });
+    std::vector<LLRegion> coverage;
+    for (auto chart : by_scale) {
+      LLRegion chart_region;
+      for (int i = 0; i < chart->GetCOVREntries(); i++)
+        chart_region.Union(LLRegion(chart->GetCOVRTablenPoints(i),
+                                    chart->GetCOVRTableHead(i)));
+      coverage.push_back(chart_region);
+    }
+
+    printf("\n");
+    for (auto& v : m_views) {
+      ViewPort vp = MakeViewPort(v);
+      const LLRegion cvp_region = vp.GetLLRegion(vp.rv_rect);
+      size_t n_patches = 0;
+      wxStopWatch sw;
+      for (int i = 0; i < m_quilt; i++)
+        n_patches = ComposeRegions(cvp_region, coverage);
+      char label[64];
+      snprintf(label, sizeof(label), "%.4f,%.4f 1:%.0f %dx%d", v.lat, v.lon,
+               v.scale, v.width, v.height);
+      printf("quilt %-36s %3lu patches %9.3f ms\n", label,
+             (unsigned long)n_patches,
+             sw.TimeInMicro().ToDouble() / 1000. / m_quilt);
+    }
+  }
+
+  //  With "spans", run everything once with the portable span fill
+  //  routines, with "store" once without the feature store and with
+  //  "bands" with fewer area fill threads, then again with the SIMD
+  //  routines picked for this CPU, the store and all threads
+  struct Pass {
+    bool use_simd;
+    bool use_store;
+    int max_bands;
+  };
+  std::vector<Pass> passes;
+  if (m_compare_spans) passes.push_back({false, true, 8});
+  if (m_compare_store) passes.push_back({true, false, 8});
+  if (m_compare_bands) {
+    for (int n : {1, 2, 4}) passes.push_back({true, true, n});
+  }
+  passes.push_back({true, true, 8});
+
+  S57RenderStats stats;
+  s57chart::SetRenderStats(&stats);
+  for (const Pass& pass : passes) {
+    const char* spans = SpanFill_ResolveRoutines(pass.use_simd);
+    s57chart::SetUseFeatureStore(pass.use_store);
+    s57chart::SetMaxAreaBands(pass.max_bands);
+    printf("\nspan routines: %s, feature store: %s, area bands: %d\n",
+           spans, pass.use_store ? "on" : "off", pass.max_bands);
+    printf("%-36s %8s %8s %8s %8s %8s %8s %9s\n", "view", "rules", "areas",
+           "bound", "lines", "symbols", "text", "total");
+
+    S57RenderStats all;
+    for (auto& v : m_views) {
+      ViewPort vp = MakeViewPort(v);
+      OCPNRegion region(0, 0, v.width, v.height);
+      wxBitmap bitmap(v.width, v.height);
+      stats.Reset();
+
+      for (int i = 0; i < m_repeat; i++) {
+        for (auto chart : charts) {
+          //  Force a rules rebuild and a complete repaint.  The render
+          //  path times the rebuild, so each phase is counted once.
+          chart->InvalidateRules();
+          chart->InvalidateCache();
+          wxMemoryDC dc;
+          chart->RenderRegionViewOnDCNoText(dc, vp, region);
+          dc.SelectObject(wxNullBitmap);
+
+          wxMemoryDC text_dc(bitmap);
+          ps52plib->ClearTextList();
+          chart->RenderRegionViewOnDCTextOnly(text_dc, vp, region);
+          text_dc.SelectObject(wxNullBitmap);
+        }
+      }
+
+      double n = m_repeat;
+      char label[64];
+      snprintf(label, sizeof(label), "%.4f,%.4f 1:%.0f %dx%d", v.lat, v.lon,
+               v.scale, v.width, v.height);
+      printf("%-36s %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %9.2f\n", label,
+             stats.rules_ms / n, stats.areas_ms / n, stats.boundaries_ms / n,
+             stats.lines_ms / n, stats.symbols_ms / n, stats.text_ms / n,
+             stats.Total() / n);
+
+      all.rules_ms += stats.rules_ms / n;
+      all.areas_ms += stats.areas_ms / n;
+      all.boundaries_ms += stats.boundaries_ms / n;
+      all.lines_ms += stats.lines_ms / n;
+      all.symbols_ms += stats.symbols_ms / n;
+      all.text_ms += stats.text_ms / n;
+    }
+
+    printf("%-36s %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %9.2f\n", "all views",
+           all.rules_ms, all.areas_ms, all.boundaries_ms, all.lines_ms,
+           all.symbols_ms, all.text_ms, all.Total());
+  }
+  s57chart::SetRenderStats(NULL);
+  s57chart::SetUseFeatureStore(true);
+  s57chart::SetMaxAreaBands(8);
+  fflush(stdout);
+
+  for (auto chart : charts) delete chart;
+  if (m_heap_stats) {
+    PrintHeapStats("after unload");
+    fflush(stdout);
+  }
+  return true;
+}
@@ -35,6 +35,7 @@
 #include <wx/arrstr.h>
 #include <wx/datetime.h>
 #include <wx/gdicmn.h>
+#include <wx/hashmap.h>
 #include <wx/log.h>
 #include <wx/pen.h>
 #include <wx/string.h>
@@ -709,3 +710,17 @@ bool Route::IsEqualTo(Route *ptargetroute) {
 
   return true;  // success, they are the same
 }
+
+wxColour GetGpxxColor(const wxString &name) {
+  WX_DECLARE_STRING_HASH_MAP(int, GpxxColorHash);
+  static GpxxColorHash hash;
+  if (hash.empty()) {
+    for (unsigned int i = 0; i < sizeof(::GpxxColorNames) / sizeof(wxString);
+         i++)
+      hash[::GpxxColorNames[i]] = i;
+  }
+
+  GpxxColorHash::const_iterator it = hash.find(name);
+  if (it == hash.end()) return wxColour();
+  return ::GpxxColors[it->second];
+}
@@ -1,4 +1,6 @@
 
+#include <vector>
+
 #include <wx/colour.h>
 #include <wx/gdicmn.h>
 #include <wx/pen.h>
@@ -75,13 +77,7 @@ void RouteGui::Draw(ocpnDC &dc, ChartCanvas *canvas, const LLBBox &box) {
     if (m_route.m_Colour == wxEmptyString) {
       col = g_pRouteMan->GetRoutePen()->GetColour();
     } else {
-      for (unsigned int i = 0; i < sizeof(::GpxxColorNames) / sizeof(wxString);
-           i++) {
-        if (m_route.m_Colour == ::GpxxColorNames[i]) {
-          col = ::GpxxColors[i];
-          break;
-        }
-      }
+      col = GetGpxxColor(m_route.m_Colour);
     }
     dc.SetPen(*wxThePenList->FindOrCreatePen(col, width, style));
     dc.SetBrush(*wxTheBrushList->FindOrCreateBrush(col, wxBRUSHSTYLE_SOLID));
@@ -387,13 +383,7 @@ void RouteGui::DrawGLRouteLines(ViewPort &vp, ChartCanvas *canvas, ocpnDC &dc) {
     if (m_route.m_Colour == wxEmptyString) {
       col = g_pRouteMan->GetRoutePen()->GetColour();
     } else {
-      for (unsigned int i = 0; i < sizeof(::GpxxColorNames) / sizeof(wxString);
-           i++) {
-        if (m_route.m_Colour == ::GpxxColorNames[i]) {
-          col = ::GpxxColors[i];
-          break;
-        }
-      }
+      col = GetGpxxColor(m_route.m_Colour);
     }
   }
 
@@ -428,6 +418,13 @@ void RouteGui::DrawGLRouteLines(ViewPort &vp, ChartCanvas *canvas, ocpnDC &dc) {
 #endif
 }
 
+#ifdef ocpnUSE_GL
+static void FlushGLStrip(ocpnDC *dc, std::vector<wxPoint> &strip) {
+  if (strip.size() > 1) dc->DrawLines((int)strip.size(), &strip[0]);
+  strip.clear();
+}
+#endif
+
 void RouteGui::DrawGLLines(ViewPort &vp, ocpnDC *dc, ChartCanvas *canvas) {
 #ifdef ocpnUSE_GL
   float pix_full_circle =
@@ -453,6 +450,13 @@ void RouteGui::DrawGLLines(ViewPort &vp, ocpnDC *dc, ChartCanvas *canvas) {
 
   // dc is passed for thicker highlighted lines (performance not very important)
 
+  //  Solid lines are joined into strips drawn with one DrawLines() call
+  //  each.  Dashed pens are drawn segment by segment, since only
+  //  DrawLine() does the dashing.
+  static std::vector<wxPoint> strip;
+  strip.clear();
+  bool b_strip = dc && dc->GetPen().GetStyle() == wxPENSTYLE_SOLID;
+
   for (node = node->GetNext(); node; node = node->GetNext()) {
     RoutePoint *prp1 = prp2;
     prp2 = node->GetData();
@@ -464,6 +468,7 @@ void RouteGui::DrawGLLines(ViewPort &vp, ocpnDC *dc, ChartCanvas *canvas) {
       canvas->GetDoubleCanvasPointPix(prp2->m_lat, prp2->m_lon, &r2);
       if (std::isnan(r2.m_x)) {
         r1valid = false;
+        FlushGLStrip(dc, strip);
         continue;
       }
 
@@ -479,6 +484,7 @@ void RouteGui::DrawGLLines(ViewPort &vp, ocpnDC *dc, ChartCanvas *canvas) {
       if ((lat1l && lat2l) || (lat1r && lat2r)) {
         r1valid = false;
         prp1->m_pos_on_screen = false;
+        FlushGLStrip(dc, strip);
         continue;
       }
 
@@ -490,6 +496,7 @@ void RouteGui::DrawGLLines(ViewPort &vp, ocpnDC *dc, ChartCanvas *canvas) {
       if ((lon1l && lon2l) || (lon1r && lon2r)) {
         r1valid = false;
         prp1->m_pos_on_screen = false;
+        FlushGLStrip(dc, strip);
         continue;
       }
 
@@ -525,10 +532,15 @@ void RouteGui::DrawGLLines(ViewPort &vp, ocpnDC *dc, ChartCanvas *canvas) {
 
       if (dc)
         if (adder) {
+          FlushGLStrip(dc, strip);
           float adderc = cos(vp.rotation) * adder,
                 adders = sin(vp.rotation) * adder;
           dc->DrawLine(r1.m_x, r1.m_y, r2.m_x + adderc, r2.m_y + adders);
           dc->DrawLine(r1.m_x - adderc, r1.m_y - adders, r2.m_x, r2.m_y);
+        } else if (b_strip) {
+          if (strip.empty())
+            strip.push_back(wxPoint((int)r1.m_x, (int)r1.m_y));
+          strip.push_back(wxPoint((int)r2.m_x, (int)r2.m_y));
         } else
           dc->DrawLine(r1.m_x, r1.m_y, r2.m_x, r2.m_y);
       else {
@@ -538,7 +550,7 @@ void RouteGui::DrawGLLines(ViewPort &vp, ocpnDC *dc, ChartCanvas *canvas) {
       r1valid = true;
     }
   }
-
+  FlushGLStrip(dc, strip);
 
 #endif
 }
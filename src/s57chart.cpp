@@ -83,7 +83,14 @@
 #endif
 
 #include <algorithm>  // for std::sort
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "ssl/sha1.h"
 #include "shaders.h"
@@ -133,6 +140,14 @@ static int s_bInS57;  // Exclusion flag to prvent recursion in this class init
                       // wxProgressDialog callback....
 int s_cnt;
 
+S57RenderStats *s57chart::s_render_stats = NULL;
+bool s57chart::s_use_feature_store = true;
+int s57chart::s_max_area_bands = 8;
+
+static inline double StopWatchMs(wxStopWatch &sw) {
+  return sw.TimeInMicro().ToDouble() / 1000.;
+}
+
 static uint64_t hash_fast64(const void *buf, size_t len, uint64_t seed) {
   const uint64_t m = 0x880355f21e6d1965ULL;
   const uint64_t *pos = (const uint64_t *)buf;
@@ -199,6 +214,84 @@ render_canvas_parms::render_canvas_parms() { pix_buff = NULL; }
 
 render_canvas_parms::~render_canvas_parms(void) {}
 
+//----------------------------------------------------------------------------------
+//      The threads filling area bands for DCRenderRect(), started once
+//----------------------------------------------------------------------------------
+class S57AreaBandPool {
+public:
+  static S57AreaBandPool &Get() {
+    static S57AreaBandPool pool;
+    return pool;
+  }
+
+  //  Threads available, counting the caller
+  int Size() const { return (int)m_threads.size() + 1; }
+
+  //  Call band(1) ... band(n - 1) on the pool and band(0) on this thread,
+  //  and wait for all of them
+  void Run(int n, const std::function<void(int)> &band);
+
+private:
+  struct Batch {
+    const std::function<void(int)> *band;
+    int pending;
+  };
+
+  S57AreaBandPool();
+  ~S57AreaBandPool();
+  void Worker();
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond, m_done;
+  std::deque<std::pair<Batch *, int>> m_jobs;
+  std::vector<std::thread> m_threads;
+  bool m_stop;
+};
+
+S57AreaBandPool::S57AreaBandPool() : m_stop(false) {
+  int n = wxMin((int)std::thread::hardware_concurrency(), 8);
+  for (int i = 1; i < n; i++)
+    m_threads.emplace_back(&S57AreaBandPool::Worker, this);
+}
+
+S57AreaBandPool::~S57AreaBandPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cond.notify_all();
+  for (size_t i = 0; i < m_threads.size(); i++) m_threads[i].join();
+}
+
+void S57AreaBandPool::Run(int n, const std::function<void(int)> &band) {
+  Batch batch = {&band, n - 1};
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int i = 1; i < n; i++) m_jobs.push_back(std::make_pair(&batch, i));
+  }
+  m_cond.notify_all();
+  band(0);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [&batch] { return batch.pending == 0; });
+}
+
+void S57AreaBandPool::Worker() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cond.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+    if (m_stop) return;
+
+    std::pair<Batch *, int> job = m_jobs.front();
+    m_jobs.pop_front();
+
+    lock.unlock();
+    (*job.first->band)(job.second);
+    lock.lock();
+    if (--job.first->pending == 0) m_done.notify_all();
+  }
+}
+
 static void PrepareForRender(ViewPort *pvp, s52plib *plib) {
  if(!plib)
    return;
@@ -230,6 +323,7 @@ s57chart::s57chart() {
 
   for (int i = 0; i < PRIO_NUM; i++)
     for (int j = 0; j < LUPNAME_NUM; j++) razRules[i][j] = NULL;
+  m_pick_index_valid = false;
 
   m_Chart_Scale = 1;  // Will be fetched during Init()
   m_Chart_Skew = 0.0;
@@ -485,7 +579,7 @@ void s57chart::FreeObjectsAndRules() {
       top = razRules[i][j];
       while (top != NULL) {
         top->obj->nRef--;
-        if (0 == top->obj->nRef) delete top->obj;
+        if (0 == top->obj->nRef) S57Obj::Destroy(top->obj);
 
         if (top->child) {
           ObjRazRules *ctop = top->child;
@@ -503,11 +597,34 @@ void s57chart::FreeObjectsAndRules() {
         free_mps(top->mps);
 
         nxx = top->next;
-        free(top);
         top = nxx;
       }
     }
   }
+
+  //  The objects' attributes and geometry indices, and the rules themselves
+  m_arena.Release();
+  m_feature_store.Invalidate();
+  m_pick_index_valid = false;
+}
+
+const S57FeatureStore &s57chart::GetFeatureStore() {
+  if (!m_feature_store.IsValid()) m_feature_store.Build(razRules);
+  return m_feature_store;
+}
+
+S57CullParms s57chart::GetCullParms(const ViewPort &vp) {
+  if (!s_use_feature_store) {
+    S57CullParms cull;
+    cull.use_box = false;
+    cull.lat_min = cull.lat_max = cull.lon_min = cull.lon_max = 0.f;
+    cull.chart_scale = 0.;
+    cull.display_category = 0;
+    return cull;
+  }
+  //  The box s52plib itself tests against, set up by SetVPointCompat()
+  return S57FeatureStore::MakeCullParms(ps52plib->GetBBox(),
+                                        vp.view_scale_ppm, vp.chart_scale);
 }
 
 void s57chart::ClearRenderedTextCache() {
@@ -992,6 +1109,12 @@ typedef struct segment_pair {
   float e0, n0, e1, n1;
 } _segment_pair;
 
+//  Segment lists live as long as their object, so in the same storage
+static line_segment_element *NewLineSegment(S57Obj *obj) {
+  if (obj->m_arena) return obj->m_arena->New<line_segment_element>();
+  return new line_segment_element;
+}
+
 void s57chart::AssembleLineGeometry(void) {
   // Walk the hash tables to get the required buffer size
 
@@ -1116,7 +1239,7 @@ void s57chart::AssembleLineGeometry(void) {
                 } else
                   pcs = csit->second;
 
-                line_segment_element *pls = new line_segment_element;
+                line_segment_element *pls = NewLineSegment(obj);
                 pls->next = 0;
                 //                            pls->n_points = 2;
                 pls->priority = 0;
@@ -1129,7 +1252,7 @@ void s57chart::AssembleLineGeometry(void) {
             }
 
             if (pedge && pedge->nCount) {
-              line_segment_element *pls = new line_segment_element;
+              line_segment_element *pls = NewLineSegment(obj);
               pls->next = 0;
               //                        pls->n_points = pedge->nCount;
               pls->priority = 0;
@@ -1187,7 +1310,7 @@ void s57chart::AssembleLineGeometry(void) {
                   } else
                     pcs = csit->second;
 
-                  line_segment_element *pls = new line_segment_element;
+                  line_segment_element *pls = NewLineSegment(obj);
                   pls->next = 0;
                   pls->priority = 0;
                   pls->pcs = pcs;
@@ -1233,7 +1356,7 @@ void s57chart::AssembleLineGeometry(void) {
                   } else
                     pcs = csit->second;
 
-                  line_segment_element *pls = new line_segment_element;
+                  line_segment_element *pls = NewLineSegment(obj);
                   pls->next = 0;
                   pls->priority = 0;
                   pls->pcs = pcs;
@@ -1258,7 +1381,7 @@ void s57chart::AssembleLineGeometry(void) {
           }
 
           // we are all finished with the line segment index array, per object
-          free(obj->m_lsindex_array);
+          if (!obj->m_arena) free(obj->m_lsindex_array);
           obj->m_lsindex_array = NULL;
         }
 
@@ -1721,27 +1844,35 @@ bool s57chart::DoRenderOnGL(const wxGLContext &glc, const ViewPort &VPoint) {
 #ifdef ocpnUSE_GL
 
   int i;
-  ObjRazRules *top;
-  ObjRazRules *crnt;
   ViewPort tvp = VPoint;  // undo const  TODO fix this in PLIB
 
+  const S57FeatureStore &store = GetFeatureStore();
+  S57CullParms cull = GetCullParms(VPoint);
+  auto render = [&](ObjRazRules *crnt) {
+    crnt->sm_transform_parms = &vp_transform;
+    ps52plib->RenderObjectToGL(glc, crnt);
+  };
+
+  int area_type, point_type;
+  if (ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES)
+    area_type = 4;  // Area Symbolized Boundaries
+  else
+    area_type = 3;  // Area Plain Boundaries
+  if (ps52plib->m_nSymbolStyle == SIMPLIFIED)
+    point_type = 0;  // SIMPLIFIED Points
+  else
+    point_type = 1;  // Paper Chart Points Points
+
 #if 1
 
   //      Render the areas quickly
   // bind VBO in order to use
 
   for (i = 0; i < PRIO_NUM; ++i) {
-    if (ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES)
-      top = razRules[i][4];  // Area Symbolized Boundaries
-    else
-      top = razRules[i][3];  // Area Plain Boundaries
-
-    while (top != NULL) {
-      crnt = top;
-      top = top->next;  // next object
+    store.ForEach(i, area_type, cull, [&](ObjRazRules *crnt) {
       crnt->sm_transform_parms = &vp_transform;
       ps52plib->RenderAreaToGL(glc, crnt);
-    }
+    });
   }
 
 #else
@@ -1773,45 +1904,14 @@ bool s57chart::DoRenderOnGL(const wxGLContext &glc, const ViewPort &VPoint) {
   // qDebug() << "Done areas" << sw.GetTime();
 
   //    Render the lines and points
-  for (i = 0; i < PRIO_NUM; ++i) {
-    if (ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES)
-      top = razRules[i][4];  // Area Symbolized Boundaries
-    else
-      top = razRules[i][3];  // Area Plain Boundaries
-    while (top != NULL) {
-      crnt = top;
-      top = top->next;  // next object
-      crnt->sm_transform_parms = &vp_transform;
-      ps52plib->RenderObjectToGL(glc, crnt);
-    }
-  }
+  for (i = 0; i < PRIO_NUM; ++i) store.ForEach(i, area_type, cull, render);
   // qDebug() << "Done Boundaries" << sw.GetTime();
 
-  for (i = 0; i < PRIO_NUM; ++i) {
-    top = razRules[i][2];  // LINES
-    while (top != NULL) {
-      crnt = top;
-      top = top->next;
-      crnt->sm_transform_parms = &vp_transform;
-      ps52plib->RenderObjectToGL(glc, crnt);
-    }
-  }
+  for (i = 0; i < PRIO_NUM; ++i) store.ForEach(i, 2, cull, render);  // LINES
 
   // qDebug() << "Done Lines" << sw.GetTime();
 
-  for (i = 0; i < PRIO_NUM; ++i) {
-    if (ps52plib->m_nSymbolStyle == SIMPLIFIED)
-      top = razRules[i][0];  // SIMPLIFIED Points
-    else
-      top = razRules[i][1];  // Paper Chart Points Points
-
-    while (top != NULL) {
-      crnt = top;
-      top = top->next;
-      crnt->sm_transform_parms = &vp_transform;
-      ps52plib->RenderObjectToGL(glc, crnt);
-    }
-  }
+  for (i = 0; i < PRIO_NUM; ++i) store.ForEach(i, point_type, cull, render);
   // qDebug() << "Done Points" << sw.GetTime();
 
 #endif  //#ifdef ocpnUSE_GL
@@ -1971,12 +2071,14 @@ bool s57chart::DoRenderRegionViewOnDC(wxMemoryDC &dc, const ViewPort &VPoint,
   PrepareForRender((ViewPort *)&VPoint, ps52plib);
 
   if (m_plib_state_hash != ps52plib->GetStateHash()) {
+    wxStopWatch sw;
     m_bLinePrioritySet = false;  // need to reset line priorities
     UpdateLUPs(this);            // and update the LUPs
     ClearRenderedTextCache();    // and reset the text renderer,
                                // for the case where depth(height) units change
     ResetPointBBoxes(m_last_vp, VPoint);
     SetSafetyContour();
+    if (s_render_stats) s_render_stats->rules_ms += StopWatchMs(sw);
   }
 
   if (VPoint.view_scale_ppm != m_last_vp.view_scale_ppm) {
@@ -2053,10 +2155,12 @@ bool s57chart::RenderViewOnDC(wxMemoryDC &dc, const ViewPort &VPoint) {
   PrepareForRender((ViewPort *)&VPoint, ps52plib);
 
   if (m_plib_state_hash != ps52plib->GetStateHash()) {
+    wxStopWatch sw;
     m_bLinePrioritySet = false;  // need to reset line priorities
     UpdateLUPs(this);            // and update the LUPs
     ClearRenderedTextCache();    // and reset the text renderer
     SetSafetyContour();
+    if (s_render_stats) s_render_stats->rules_ms += StopWatchMs(sw);
   }
 
   SetLinePriorities();
@@ -2295,8 +2399,6 @@ bool s57chart::DoRenderViewOnDC(wxMemoryDC &dc, const ViewPort &VPoint,
 int s57chart::DCRenderRect(wxMemoryDC &dcinput, const ViewPort &vp,
                            wxRect *rect) {
   int i;
-  ObjRazRules *top;
-  ObjRazRules *crnt;
 
   wxASSERT(rect);
   ViewPort tvp = vp;  // undo const  TODO fix this in PLIB
@@ -2354,19 +2456,61 @@ int s57chart::DCRenderRect(wxMemoryDC &dcinput, const ViewPort &vp,
   }
 
   //      Render the areas quickly
-  for (i = 0; i < PRIO_NUM; ++i) {
-    if (ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES)
-      top = razRules[i][4];  // Area Symbolized Boundaries
-    else
-      top = razRules[i][3];  // Area Plain Boundaries
+  wxStopWatch sw_areas;
+
+  //      Large rectangles are filled by several threads, each owning a
+  //      horizontal band of the canvas. Objects are prepared and projected
+  //      once, serially, so the band workers only rasterize the triangles.
+  //      At very small scales, RenderToBufferAC() also draws objects across
+  //      the antimeridian, so stay serial there.
+  int n_bands = 1;
+  if (vp.chart_scale <= 5e7) {
+    n_bands = wxMin(S57AreaBandPool::Get().Size(), pb_spec.height / 64);
+    n_bands = wxMin(n_bands, s_max_area_bands);
+  }
+
+  const S57FeatureStore &store = GetFeatureStore();
+  S57CullParms cull = GetCullParms(vp);
+  int area_type;
+  if (ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES)
+    area_type = 4;  // Area Symbolized Boundaries
+  else
+    area_type = 3;  // Area Plain Boundaries
+
+  if (n_bands > 1) {
+    AreaBufferList areas;
+    for (i = 0; i < PRIO_NUM; ++i) {
+      store.ForEach(i, area_type, cull, [&](ObjRazRules *crnt) {
+        crnt->sm_transform_parms = &vp_transform;
+        int prep = ps52plib->PrepareAreaToBuffer(crnt);
+        if (prep) ps52plib->ProjectAreaToBuffer(crnt, prep, areas);
+      });
+    }
 
-    while (top != NULL) {
-      crnt = top;
-      top = top->next;  // next object
-      crnt->sm_transform_parms = &vp_transform;
-      ps52plib->RenderAreaToDC(&dcinput, crnt, &pb_spec);
+    std::vector<render_canvas_parms> bands(n_bands, pb_spec);
+    int row = 0;
+    for (int ib = 0; ib < n_bands; ib++) {
+      int rows = (pb_spec.height - row) / (n_bands - ib);
+      bands[ib].pix_buff = pb_spec.pix_buff + row * pb_spec.pb_pitch;
+      bands[ib].y = pb_spec.y + row;
+      bands[ib].height = rows;
+      row += rows;
+    }
+    S57AreaBandPool::Get().Run(n_bands, [&](int ib) {
+      ps52plib->RasterAreaToBuffer(areas, &bands[ib]);
+    });
+  } else {
+    for (i = 0; i < PRIO_NUM; ++i) {
+      store.ForEach(i, area_type, cull, [&](ObjRazRules *crnt) {
+        crnt->sm_transform_parms = &vp_transform;
+        ps52plib->RenderAreaToDC(&dcinput, crnt, &pb_spec);
+      });
     }
   }
+  if (s_render_stats) {
+    s_render_stats->areas_ms += StopWatchMs(sw_areas);
+    s_render_stats->n_rects++;
+  }
 
 //      Convert the Private render canvas into a bitmap
 #ifdef ocpnUSE_ocpnBitmap
@@ -2408,10 +2552,30 @@ int s57chart::DCRenderRect(wxMemoryDC &dcinput, const ViewPort &vp,
 bool s57chart::DCRenderLPB(wxMemoryDC &dcinput, const ViewPort &vp,
                            wxRect *rect) {
   int i;
-  ObjRazRules *top;
-  ObjRazRules *crnt;
   ViewPort tvp = vp;  // undo const  TODO fix this in PLIB
 
+  //  Phase timers, only reported if render stats are being collected
+  wxStopWatch sw_bound, sw_lines, sw_points;
+  sw_lines.Pause();
+  sw_points.Pause();
+
+  const S57FeatureStore &store = GetFeatureStore();
+  S57CullParms cull = GetCullParms(vp);
+  auto render = [&](ObjRazRules *crnt) {
+    crnt->sm_transform_parms = &vp_transform;
+    ps52plib->RenderObjectToDC(&dcinput, crnt);
+  };
+
+  int area_type, point_type;
+  if (ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES)
+    area_type = 4;  // Area Symbolized Boundaries
+  else
+    area_type = 3;  // Area Plain Boundaries
+  if (ps52plib->m_nSymbolStyle == SIMPLIFIED)
+    point_type = 0;  // SIMPLIFIED Points
+  else
+    point_type = 1;  // Paper Chart Points Points
+
   for (i = 0; i < PRIO_NUM; ++i) {
     //      Set up a Clipper for Lines
     wxDCClipper *pdcc = NULL;
@@ -2420,48 +2584,28 @@ bool s57chart::DCRenderLPB(wxMemoryDC &dcinput, const ViewPort &vp,
     //         pdcc = new wxDCClipper(dcinput, nr);
     //      }
 
-    if (ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES)
-      top = razRules[i][4];  // Area Symbolized Boundaries
-    else
-      top = razRules[i][3];  // Area Plain Boundaries
-    while (top != NULL) {
-      crnt = top;
-      top = top->next;  // next object
-      crnt->sm_transform_parms = &vp_transform;
-      ps52plib->RenderObjectToDC(&dcinput, crnt);
-    }
+    store.ForEach(i, area_type, cull, render);
+    sw_bound.Pause();
 
-    top = razRules[i][2];  // LINES
-    while (top != NULL) {
-      crnt = top;
-      top = top->next;
-      crnt->sm_transform_parms = &vp_transform;
-      ps52plib->RenderObjectToDC(&dcinput, crnt);
-    }
+    sw_lines.Resume();
+    store.ForEach(i, 2, cull, render);  // LINES
+    sw_lines.Pause();
 
-    if (ps52plib->m_nSymbolStyle == SIMPLIFIED)
-      top = razRules[i][0];  // SIMPLIFIED Points
-    else
-      top = razRules[i][1];  // Paper Chart Points Points
-
-    while (top != NULL) {
-      crnt = top;
-      top = top->next;
-      crnt->sm_transform_parms = &vp_transform;
-      ps52plib->RenderObjectToDC(&dcinput, crnt);
-    }
+    sw_points.Resume();
+    store.ForEach(i, point_type, cull, render);
+    sw_points.Pause();
 
     //      Destroy Clipper
     if (pdcc) delete pdcc;
+
+    sw_bound.Resume();
   }
 
-  /*
-   printf("Render Lines                  %ldms\n", stlines.Time());
-   printf("Render Simple Points          %ldms\n", stsim_pt.Time());
-   printf("Render Paper Points           %ldms\n", stpap_pt.Time());
-   printf("Render Symbolized Boundaries  %ldms\n", stasb.Time());
-   printf("Render Plain Boundaries       %ldms\n\n", stapb.Time());
-   */
+  if (s_render_stats) {
+    s_render_stats->boundaries_ms += StopWatchMs(sw_bound);
+    s_render_stats->lines_ms += StopWatchMs(sw_lines);
+    s_render_stats->symbols_ms += StopWatchMs(sw_points);
+  }
   return true;
 }
 
@@ -2471,6 +2615,7 @@ bool s57chart::DCRenderText(wxMemoryDC &dcinput, const ViewPort &vp) {
   ObjRazRules *crnt;
   ViewPort tvp = vp;  // undo const  TODO fix this in PLIB
 
+  wxStopWatch sw;
   for (i = 0; i < PRIO_NUM; ++i) {
     if (ps52plib->m_nBoundaryStyle == SYMBOLIZED_BOUNDARIES)
       top = razRules[i][4];  // Area Symbolized Boundaries
@@ -2504,6 +2649,7 @@ bool s57chart::DCRenderText(wxMemoryDC &dcinput, const ViewPort &vp) {
       ps52plib->RenderObjectToDCText(&dcinput, crnt);
     }
   }
+  if (s_render_stats) s_render_stats->text_ms += StopWatchMs(sw);
 
   return true;
 }
@@ -2883,6 +3029,7 @@ InitReturn s57chart::PostInit(ChartInitFlag flags, ColorScheme cs) {
 
   CreateChartContext();
   PopulateObjectsWithContext();
+  BuildPickIndex();
 
   m_RAZBuilt = true;
   bReadyToRender = true;
@@ -4075,6 +4222,9 @@ int s57chart::BuildSENCFile(const wxString &FullPath000,
       ticket->m_FullPath000 = FullPath000;
       ticket->m_SENCFileName = SENCFileName;
       ticket->m_chart = this;
+      ticket->m_box.Set(m_FullExtent.SLAT, m_FullExtent.WLON,
+                        m_FullExtent.NLAT, m_FullExtent.ELON);
+      ticket->m_native_scale = m_native_scale;
 
       m_SENCthreadStatus = g_SencThreadManager->ScheduleJob(ticket);
       bReadyToRender = true;
@@ -4115,6 +4265,7 @@ int s57chart::BuildRAZFromSENCFile(const wxString &FullPath) {
   VC_ElementVector VCs;
 
   sencfile.setRefLocn(ref_lat, ref_lon);
+  sencfile.setArena(&m_arena);
 
   int srv = sencfile.ingest200(FullPath, &Objects, &VEs, &VCs);
 
@@ -4243,7 +4394,7 @@ int s57chart::BuildRAZFromSENCFile(const wxString &FullPath) {
         msg.Prepend(_T("   Could not find LUP for "));
         LogMessageOnce(msg);
       }
-      delete obj;
+      S57Obj::Destroy(obj);
       obj = NULL;
       Objects[i] = NULL;
     } else {
@@ -4404,7 +4555,9 @@ int s57chart::_insertRules(S57Obj *obj, LUPrec *LUP, s57chart *pOwner) {
   }
 
   // insert rules
-  rzRules = (ObjRazRules *)malloc(sizeof(ObjRazRules));
+  m_feature_store.Invalidate();
+  m_pick_index_valid = false;
+  rzRules = m_arena.New<ObjRazRules>();
   rzRules->obj = obj;
   obj->nRef++;  // Increment reference counter for delete check;
   rzRules->LUP = LUP;
@@ -4627,106 +4780,142 @@ void s57chart::UpdateLUPs(s57chart *pOwner) {
   // charts
   // TODO really should make the dynamic LUPs belong to the chart class that
   // created them
+
+  //  Rules may have been added and display categories were reset above
+  m_feature_store.Build(razRules);
+  BuildPickIndex();
 }
 
-ListOfObjRazRules *s57chart::GetLightsObjRuleListVisibleAtLatLon(
-    float lat, float lon, ViewPort *VPoint) {
-  ListOfObjRazRules *ret_ptr = new ListOfObjRazRules;
-  std::vector<ObjRazRules *> selected_rules;
+//  The attribute part of the sector light test, which does not change
+//  while the chart is loaded
+static bool GetSectorLightRange(S57Obj *obj, double *range) {
+  char *curr_att = obj->att_array;
+  int n_attr = obj->n_attr;
+  wxArrayOfS57attVal *attValArray = obj->attVal;
 
-  //    Iterate thru the razRules array, by object/rule type
+  if (!curr_att) return false;
 
-  ObjRazRules *top;
-  char *curr_att = NULL;
-  int n_attr = 0;
-  wxArrayOfS57attVal *attValArray = NULL;
-  bool bleading_attribute = false;
+  bool bviz = true;
+  double valnmr = -1;
+  for (int attrCounter = 0; attrCounter < n_attr; attrCounter++) {
+    wxString curAttrName = wxString(curr_att, wxConvUTF8, 6);
 
-  for (int i = 0; i < PRIO_NUM; ++i) {
-    {
-      // Points by type, array indices [0..1]
+    S57attVal *pAttrVal = NULL;
+    if (attValArray) pAttrVal = attValArray->Item(attrCounter);
+    wxString value = s57chart::GetAttributeValueAsString(pAttrVal, curAttrName);
 
-      int point_type = (ps52plib->m_nSymbolStyle == SIMPLIFIED) ? 0 : 1;
-      top = razRules[i][point_type];
+    if (curAttrName == _T("LITVIS")) {
+      if (value.StartsWith(_T("obsc"))) bviz = false;
+    } else if (curAttrName == _T("VALNMR"))
+      value.ToDouble(&valnmr);
 
-      while (top != NULL) {
-        if (top->obj->npt == 1) {
-          if (!strncmp(top->obj->FeatureName, "LIGHTS", 6)) {
-            double sectrTest;
-            bool hasSectors = GetDoubleAttr(top->obj, "SECTR1", sectrTest);
-            if (hasSectors) {
-              if (ps52plib->ObjectRenderCheckCat(top)) {
-                int attrCounter;
-                double valnmr = -1;
-                wxString curAttrName;
-                curr_att = top->obj->att_array;
-                n_attr = top->obj->n_attr;
-                attValArray = top->obj->attVal;
-
-                if (curr_att) {
-                  bool bviz = true;
-
-                  attrCounter = 0;
-                  int noAttr = 0;
-
-                  bleading_attribute = false;
-
-                  while (attrCounter < n_attr) {
-                    curAttrName = wxString(curr_att, wxConvUTF8, 6);
-                    noAttr++;
-
-                    S57attVal *pAttrVal = NULL;
-                    if (attValArray) {
-                      // if(Chs57)
-                      pAttrVal = attValArray->Item(attrCounter);
-                      // else if( target_plugin_chart )
-                      // pAttrVal = attValArray->Item(attrCounter);
-                    }
-                    wxString value = s57chart::GetAttributeValueAsString(
-                        pAttrVal, curAttrName);
+    curr_att += 6;
+  }
 
-                    if (curAttrName == _T("LITVIS")) {
-                      if (value.StartsWith(_T("obsc"))) bviz = false;
-                    } else if (curAttrName == _T("VALNMR"))
-                      value.ToDouble(&valnmr);
+  *range = valnmr;
+  return bviz && (valnmr > 0.1);
+}
 
-                    attrCounter++;
-                    curr_att += 6;
-                  }
+void s57chart::BuildPickIndex() {
+  m_pick_tree.Clear();
+  m_pick_entries.clear();
+  m_pick_unindexed.clear();
+  m_light_tree.Clear();
+  m_light_entries.clear();
 
-                  if (bviz && (valnmr > 0.1)) {
-                    // As a quick check, compare the mercator-manhattan distance
-                    double olon, olat;
-                    fromSM(
-                        (top->obj->x * top->obj->x_rate) + top->obj->x_origin,
-                        (top->obj->y * top->obj->y_rate) + top->obj->y_origin,
-                        ref_lat, ref_lon, &olat, &olon);
-
-                    double dlat = lat - olat;
-                    double dy = dlat * 60 / cos(olat * PI / 180.);
-                    double dlon = lon - olon;
-                    double dx = dlon * 60;
-                    double manhat = abs(dy) + abs(dx);
-                    if (1 /*(abs(dy) + abs(dx)) < valnmr*/) {
-                      // close...Check precisely
-                      double br, dd;
-                      DistanceBearingMercator(lat, lon, olat, olon, &br, &dd);
-                      if (dd < valnmr) {
-                        selected_rules.push_back(top);
-                      }
-                    }
-                  }
-                }
-              }
-            }
-          }
-        }
+  //  Entries are numbered in the order GetObjRuleListAtLatLon() visits the
+  //  lists, so sorting search results restores that order
+  static const int pick_types[] = {3, 4, 2};  // Area boundaries, Lines
+  for (int i = 0; i < PRIO_NUM; ++i) {
+    for (int j : pick_types) {
+      for (ObjRazRules *top = razRules[i][j]; top; top = top->next) {
+        PickEntry e = {top, i, j, 0., 0., 0.};
+        int id = (int)m_pick_entries.size();
+        m_pick_entries.push_back(e);
+
+        //  The hit tests in DoesLatLonSelectObject() stay within the
+        //  object geometry, which the box at load time already covers.
+        //  Boxes only grow afterwards, as symbols and text are rendered.
+        S57Obj *obj = top->obj;
+        const LLBBox &box = obj->BBObj;
+        if ((obj->Primitive_type == GEO_AREA ||
+             obj->Primitive_type == GEO_LINE) &&
+            box.GetValid())
+          m_pick_tree.Insert(box.GetMinLat(), box.GetMinLon(),
+                             box.GetMaxLat(), box.GetMaxLon(), id);
+        else
+          m_pick_unindexed.push_back(id);
+      }
+    }
 
-        top = top->next;
+    for (int j = 0; j < 2; j++) {  // Points
+      for (ObjRazRules *top = razRules[i][j]; top; top = top->next) {
+        S57Obj *obj = top->obj;
+        if (obj->npt != 1 || strncmp(obj->FeatureName, "LIGHTS", 6)) continue;
+        double sectrTest;
+        if (!GetDoubleAttr(obj, "SECTR1", sectrTest)) continue;
+
+        double valnmr;
+        if (!GetSectorLightRange(obj, &valnmr)) continue;
+
+        double olon, olat;
+        fromSM((obj->x * obj->x_rate) + obj->x_origin,
+               (obj->y * obj->y_rate) + obj->y_origin, ref_lat, ref_lon,
+               &olat, &olon);
+
+        //  Mercator distance is at least the latitude difference, and the
+        //  longitude difference scaled by the cosine of the highest
+        //  latitude passed.  Pad a little for rounding.
+        double dlat = valnmr / 60. * 1.01 + 1e-6;
+        double coslat = cos(wxMin(fabs(olat) + dlat, 89.) * PI / 180.);
+        double dlon = wxMin(dlat / coslat, 360.);
+
+        PickEntry e = {top, i, j, olat, olon, valnmr};
+        m_light_tree.Insert(olat - dlat, olon - dlon, olat + dlat, olon + dlon,
+                            (int)m_light_entries.size());
+        m_light_entries.push_back(e);
       }
     }
   }
 
+  m_pick_tree.Build();
+  m_light_tree.Build();
+  m_pick_index_valid = true;
+}
+
+//  Ids of the boxes within margin of lat/lon, in entry order.  Boxes may
+//  lie either side of the date line, like LLBBox::ContainsMarge() allows.
+void s57chart::SearchPickIndex(const LLRTree &tree, double lat, double lon,
+                               double margin, std::vector<int> &ids) {
+  for (double shift = -360.; shift <= 360.; shift += 360.)
+    tree.Search(lat - margin, lon + shift - margin, lat + margin,
+                lon + shift + margin, ids);
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+ListOfObjRazRules *s57chart::GetLightsObjRuleListVisibleAtLatLon(
+    float lat, float lon, ViewPort *VPoint) {
+  ListOfObjRazRules *ret_ptr = new ListOfObjRazRules;
+  std::vector<ObjRazRules *> selected_rules;
+
+  if (!m_pick_index_valid) BuildPickIndex();
+
+  //  Only sector lights whose nominal range may reach lat/lon
+  std::vector<int> candidates;
+  SearchPickIndex(m_light_tree, lat, lon, 0., candidates);
+
+  int point_type = (ps52plib->m_nSymbolStyle == SIMPLIFIED) ? 0 : 1;
+  for (int id : candidates) {
+    const PickEntry &e = m_light_entries[id];
+    if (e.lup_type != point_type) continue;
+    if (!ps52plib->ObjectRenderCheckCat(e.rules)) continue;
+
+    double br, dd;
+    DistanceBearingMercator(lat, lon, e.lat, e.lon, &br, &dd);
+    if (dd < e.range) selected_rules.push_back(e.rules);
+  }
+
   // Copy the rules in order into a wxList so the function returns the correct type
   for(std::size_t i = 0; i < selected_rules.size(); ++i) {
     ret_ptr->Append(selected_rules[i]);
@@ -4743,6 +4932,17 @@ ListOfObjRazRules *s57chart::GetObjRuleListAtLatLon(float lat, float lon,
   ListOfObjRazRules *ret_ptr = new ListOfObjRazRules;
   std::vector<ObjRazRules *> selected_rules;
 
+  if (!m_pick_index_valid) BuildPickIndex();
+
+  //  Lines and areas near lat/lon, plus those without a usable box
+  std::vector<int> candidates = m_pick_unindexed;
+  if (selection_mask & (MASK_AREA | MASK_LINE))
+    SearchPickIndex(m_pick_tree, lat, lon, select_radius, candidates);
+  size_t next_candidate = 0;
+
+  int area_boundary_type =
+      (ps52plib->m_nBoundaryStyle == PLAIN_BOUNDARIES) ? 3 : 4;
+
   //    Iterate thru the razRules array, by object/rule type
 
   ObjRazRules *top;
@@ -4785,33 +4985,22 @@ ListOfObjRazRules *s57chart::GetObjRuleListAtLatLon(float lat, float lon,
       }
     }
 
-    if (selection_mask & MASK_AREA) {
-      // Areas by boundary type, array indices [3..4]
-
-      int area_boundary_type =
-          (ps52plib->m_nBoundaryStyle == PLAIN_BOUNDARIES) ? 3 : 4;
-      top = razRules[i][area_boundary_type];  // Area nnn Boundaries
-      while (top != NULL) {
-        if (ps52plib->ObjectRenderCheck(top)) {
-          if (DoesLatLonSelectObject(lat, lon, select_radius, top->obj))
-            selected_rules.push_back(top);
-        }
-
-        top = top->next;
-      }  // while
-    }
-
-    if (selection_mask & MASK_LINE) {
-      // Finally, lines
-      top = razRules[i][2];  // Lines
-
-      while (top != NULL) {
-        if (ps52plib->ObjectRenderCheck(top)) {
-          if (DoesLatLonSelectObject(lat, lon, select_radius, top->obj))
-            selected_rules.push_back(top);
-        }
+    //  Areas by boundary type, array indices [3..4], then lines, from the
+    //  candidates of this priority
+    while (next_candidate < candidates.size()) {
+      const PickEntry &e = m_pick_entries[candidates[next_candidate]];
+      if (e.prio != i) break;
+      next_candidate++;
+
+      if (e.lup_type == 2) {
+        if (!(selection_mask & MASK_LINE)) continue;
+      } else if (!(selection_mask & MASK_AREA) ||
+                 e.lup_type != area_boundary_type)
+        continue;
 
-        top = top->next;
+      if (ps52plib->ObjectRenderCheck(e.rules)) {
+        if (DoesLatLonSelectObject(lat, lon, select_radius, e.rules->obj))
+          selected_rules.push_back(e.rules);
       }
     }
   }
@@ -59,6 +59,7 @@
 #include "pluginmanager.h"  // for S57 lights overlay
 
 #include "Osenc.h"
+#include "ChartArena.h"
 
 #ifdef __MSVC__
 #define _CRTDBG_MAP_ALLOC
@@ -96,15 +97,18 @@ S57Obj::~S57Obj() {
   //  Don't delete any allocated records of simple copy clones
   if (!bIsClone) {
     if (attVal) {
-      for (unsigned int iv = 0; iv < attVal->GetCount(); iv++) {
-        S57attVal *vv = attVal->Item(iv);
-        void *v2 = vv->value;
-        free(v2);
-        delete vv;
+      //  Arena storage goes with the chart
+      if (!m_arena) {
+        for (unsigned int iv = 0; iv < attVal->GetCount(); iv++) {
+          S57attVal *vv = attVal->Item(iv);
+          void *v2 = vv->value;
+          free(v2);
+          delete vv;
+        }
       }
       delete attVal;
     }
-    free(att_array);
+    if (!m_arena) free(att_array);
 
     if (pPolyTessGeo) {
 #ifdef ocpnUSE_GL
@@ -121,22 +125,57 @@ S57Obj::~S57Obj() {
     if (FText) delete FText;
 
     if (geoPt) free(geoPt);
-    if (geoPtz) free(geoPtz);
-    if (geoPtMulti) free(geoPtMulti);
 
-    if (m_lsindex_array) free(m_lsindex_array);
+    if (!m_arena) {
+      if (geoPtz) free(geoPtz);
+      if (geoPtMulti) free(geoPtMulti);
 
-    if (m_ls_list) {
-      line_segment_element *element = m_ls_list;
-      while (element) {
-        line_segment_element *next = element->next;
-        delete element;
-        element = next;
+      if (m_lsindex_array) free(m_lsindex_array);
+
+      if (m_ls_list) {
+        line_segment_element *element = m_ls_list;
+        while (element) {
+          line_segment_element *next = element->next;
+          delete element;
+          element = next;
+        }
       }
     }
   }
 }
 
+S57Obj *S57Obj::Create(const char *featureName, ChartArena *arena) {
+  if (!arena) return new S57Obj(featureName);
+  return arena->New<S57Obj>(featureName, arena);
+}
+
+void S57Obj::Destroy(S57Obj *obj) {
+  if (obj->m_arena)
+    obj->~S57Obj();
+  else
+    delete obj;
+}
+
+void *S57Obj::ObjAlloc(size_t size) {
+  if (m_arena) return m_arena->Alloc(size);
+  return malloc(size);
+}
+
+void S57Obj::AddAttAcronym(const char *acronym) {
+  if (m_arena) {
+    //  Grow by doubling, abandoning the old array to the arena
+    if ((n_attr & (n_attr - 1)) == 0) {
+      char *new_array = (char *)m_arena->Alloc(6 * wxMax(2 * n_attr, 4));
+      if (n_attr) memcpy(new_array, att_array, 6 * n_attr);
+      att_array = new_array;
+    }
+  } else
+    att_array = (char *)realloc(att_array, 6 * (n_attr + 1));
+
+  strncpy(att_array + (6 * sizeof(char) * n_attr), acronym, 6);
+  n_attr++;
+}
+
 void S57Obj::Init() {
   att_array = NULL;
   attVal = NULL;
@@ -177,13 +216,16 @@ void S57Obj::Init() {
   auxParm1 = 0;
   auxParm2 = 0;
   auxParm3 = 0;
+
+  m_arena = NULL;
 }
 
 //----------------------------------------------------------------------------------
 //      S57Obj CTOR from FeatureName
 //----------------------------------------------------------------------------------
-S57Obj::S57Obj(const char *featureName) {
+S57Obj::S57Obj(const char *featureName, ChartArena *arena) {
   Init();
+  m_arena = arena;
 
   attVal = new wxArrayOfS57attVal();
 
@@ -195,17 +237,16 @@ S57Obj::S57Obj(const char *featureName) {
 }
 
 bool S57Obj::AddIntegerAttribute(const char *acronym, int val) {
-  S57attVal *pattValTmp = new S57attVal;
+  S57attVal *pattValTmp =
+      m_arena ? m_arena->New<S57attVal>() : new S57attVal;
 
-  int *pAVI = (int *)malloc(sizeof(int));  // new int;
+  int *pAVI = (int *)ObjAlloc(sizeof(int));  // new int;
   *pAVI = val;
 
   pattValTmp->valType = OGR_INT;
   pattValTmp->value = pAVI;
 
-  att_array = (char *)realloc(att_array, 6 * (n_attr + 1));
-  strncpy(att_array + (6 * sizeof(char) * n_attr), acronym, 6);
-  n_attr++;
+  AddAttAcronym(acronym);
 
   attVal->Add(pattValTmp);
 
@@ -220,17 +261,16 @@ bool S57Obj::AddIntegerListAttribute(const char *acronym, int *pval,
 }
 
 bool S57Obj::AddDoubleAttribute(const char *acronym, double val) {
-  S57attVal *pattValTmp = new S57attVal;
+  S57attVal *pattValTmp =
+      m_arena ? m_arena->New<S57attVal>() : new S57attVal;
 
-  double *pAVI = (double *)malloc(sizeof(double));  // new double;
+  double *pAVI = (double *)ObjAlloc(sizeof(double));  // new double;
   *pAVI = val;
 
   pattValTmp->valType = OGR_REAL;
   pattValTmp->value = pAVI;
 
-  att_array = (char *)realloc(att_array, 6 * (n_attr + 1));
-  strncpy(att_array + (6 * sizeof(char) * n_attr), acronym, 6);
-  n_attr++;
+  AddAttAcronym(acronym);
 
   attVal->Add(pattValTmp);
 
@@ -243,17 +283,16 @@ bool S57Obj::AddDoubleListAttribute(const char *acronym, double *pval,
 }
 
 bool S57Obj::AddStringAttribute(const char *acronym, char *val) {
-  S57attVal *pattValTmp = new S57attVal;
+  S57attVal *pattValTmp =
+      m_arena ? m_arena->New<S57attVal>() : new S57attVal;
 
-  char *pAVS = (char *)malloc(strlen(val) + 1);  // new string
+  char *pAVS = (char *)ObjAlloc(strlen(val) + 1);  // new string
   strcpy(pAVS, val);
 
   pattValTmp->valType = OGR_STR;
   pattValTmp->value = pAVS;
 
-  att_array = (char *)realloc(att_array, 6 * (n_attr + 1));
-  strncpy(att_array + (6 * sizeof(char) * n_attr), acronym, 6);
-  n_attr++;
+  AddAttAcronym(acronym);
 
   attVal->Add(pattValTmp);
 
@@ -348,8 +387,8 @@ bool S57Obj::SetMultipointGeometry(MultipointGeometryDescriptor *pGeo,
 
   npt = pGeo->pointCount;
 
-  geoPtz = (double *)malloc(npt * 3 * sizeof(double));
-  geoPtMulti = (double *)malloc(npt * 2 * sizeof(double));
+  geoPtz = (double *)ObjAlloc(npt * 3 * sizeof(double));
+  geoPtMulti = (double *)ObjAlloc(npt * 2 * sizeof(double));
 
   double *pdd = geoPtz;
   double *pdl = geoPtMulti;
@@ -72,7 +72,13 @@ of segments will be higher, though it should be managable with tracks with
 millions of points.
 */
 
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -127,13 +133,93 @@ class OCPNStopWatch {
 };
 #endif
 
+//  Track points are allocated from blocks of kTrackPointBlock points, each
+//  with its own free list.  A block is returned to the system as soon as
+//  its last point is deleted, so the pool holds at most one partly used
+//  block per kTrackPointBlock live points, plus the fragmentation.
+static const size_t kTrackPointBlock = 4096;
+
+namespace {
+union TrackPointSlot {
+  TrackPointSlot *next;
+  alignas(TrackPoint) char storage[sizeof(TrackPoint)];
+};
+
+struct TrackPointBlock {
+  TrackPointSlot slots[kTrackPointBlock];
+  TrackPointSlot *free_list;
+  size_t live;
+};
+
+struct TrackPointPool {
+  std::mutex mutex;
+  std::map<const void *, TrackPointBlock *> blocks;  // by address
+  std::set<TrackPointBlock *> partial;  // blocks with free slots
+};
+
+TrackPointPool &GetTrackPointPool() {
+  static TrackPointPool *pool = new TrackPointPool;  // never destructed
+  return *pool;
+}
+}  // namespace
+
+void *TrackPoint::operator new(size_t size) {
+  //  Derived classes, if any, are not pooled
+  if (size != sizeof(TrackPoint)) return ::operator new(size);
+
+  TrackPointPool &pool = GetTrackPointPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  if (pool.partial.empty()) {
+    TrackPointBlock *block = new TrackPointBlock;
+    for (size_t i = 0; i < kTrackPointBlock - 1; i++)
+      block->slots[i].next = &block->slots[i + 1];
+    block->slots[kTrackPointBlock - 1].next = nullptr;
+    block->free_list = block->slots;
+    block->live = 0;
+    pool.blocks[block->slots] = block;
+    pool.partial.insert(block);
+  }
+
+  //  The lowest block first, so that the others can empty
+  TrackPointBlock *block = *pool.partial.begin();
+  TrackPointSlot *slot = block->free_list;
+  block->free_list = slot->next;
+  block->live++;
+  if (!block->free_list) pool.partial.erase(block);
+  return slot;
+}
+
+void TrackPoint::operator delete(void *p, size_t size) {
+  if (!p) return;
+  if (size != sizeof(TrackPoint)) {
+    ::operator delete(p);
+    return;
+  }
+
+  TrackPointPool &pool = GetTrackPointPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  auto it = --pool.blocks.upper_bound(p);
+  TrackPointBlock *block = it->second;
+  TrackPointSlot *slot = static_cast<TrackPointSlot *>(p);
+  if (!block->free_list) pool.partial.insert(block);
+  slot->next = block->free_list;
+  block->free_list = slot;
+  if (--block->live == 0) {
+    pool.partial.erase(block);
+    pool.blocks.erase(it);
+    delete block;
+  }
+}
+
+const int64_t TrackPoint::kNoTime = INT64_MIN;
+
 TrackPoint::TrackPoint(double lat, double lon, wxString ts)
-    : m_lat(lat), m_lon(lon), m_GPXTrkSegNo(1) {
+    : m_lat(lat), m_lon(lon), m_GPXTrkSegNo(1), m_time(kNoTime) {
   SetCreateTime(ts);
 }
 
 TrackPoint::TrackPoint(double lat, double lon, wxDateTime dt)
-    : m_lat(lat), m_lon(lon), m_GPXTrkSegNo(1) {
+    : m_lat(lat), m_lon(lon), m_GPXTrkSegNo(1), m_time(kNoTime) {
   SetCreateTime(dt);
 }
 
@@ -141,34 +227,69 @@ TrackPoint::TrackPoint(double lat, double lon, wxDateTime dt)
 TrackPoint::TrackPoint(TrackPoint *orig)
     : m_lat(orig->m_lat),
       m_lon(orig->m_lon),
-      m_GPXTrkSegNo(1) {
-  SetCreateTime(orig->GetCreateTime());
-}
+      m_GPXTrkSegNo(1),
+      m_time(orig->m_time) {}
 
 TrackPoint::~TrackPoint() { }
 
 wxDateTime TrackPoint::GetCreateTime() {
-  wxDateTime CreateTimeX;
-  ParseGPXDateTime(CreateTimeX, wxString(m_stimestring.c_str()));
-  return CreateTimeX;
+  if (m_time == kNoTime) return wxDateTime();
+  return wxDateTime((time_t)m_time);
 }
 
 void TrackPoint::SetCreateTime(wxDateTime dt) {
-  wxString ts;
-  if (dt.IsValid())
-    ts = dt.FormatISODate()
-             .Append(_T("T"))
-             .Append(dt.FormatISOTime())
-             .Append(_T("Z"));
+  m_time = dt.IsValid() ? (int64_t)dt.GetTicks() : kNoTime;
+}
 
-  SetCreateTime(ts);
+std::string TrackPoint::GetTimeString() {
+  if (m_time == kNoTime) return std::string();
+  wxDateTime dt = GetCreateTime();
+  wxString ts = dt.FormatISODate()
+                    .Append(_T("T"))
+                    .Append(dt.FormatISOTime())
+                    .Append(_T("Z"));
+  return ts.ToStdString();
+}
+
+//  The n decimal digits at p, and nothing else
+static bool ParseTimeDigits(const char *p, int n, int &value) {
+  value = 0;
+  for (int i = 0; i < n; i++) {
+    if (p[i] < '0' || p[i] > '9') return false;
+    value = value * 10 + (p[i] - '0');
+  }
+  return true;
 }
 
 void TrackPoint::SetCreateTime(wxString ts) {
-  if (ts.Length()) {
-    m_stimestring = ts.mb_str();
-  } else
-    m_stimestring = "";
+  m_time = kNoTime;
+  if (!ts.Length()) return;
+
+  //  Nearly all GPX files, and all we write, use this exact form.  Read it
+  //  the way ParseGPXDateTime() does, without going through ParseFormat().
+  //  Anything else, down to a sign or a space in a field, is left to
+  //  ParseGPXDateTime().
+  int y, mo, d, h, mi, sec;
+  wxScopedCharBuffer buf = ts.utf8_str();
+  const char *t = buf.data();
+  if (buf.length() == strlen("YYYY-MM-DDTHH:MM:SSZ") &&
+      ParseTimeDigits(t, 4, y) && t[4] == '-' &&
+      ParseTimeDigits(t + 5, 2, mo) && t[7] == '-' &&
+      ParseTimeDigits(t + 8, 2, d) && t[10] == 'T' &&
+      ParseTimeDigits(t + 11, 2, h) && t[13] == ':' &&
+      ParseTimeDigits(t + 14, 2, mi) && t[16] == ':' &&
+      ParseTimeDigits(t + 17, 2, sec) && t[19] == 'Z' && mo >= 1 &&
+      mo <= 12 && d >= 1 &&
+      d <= wxDateTime::GetNumberOfDays((wxDateTime::Month)(mo - 1), y) &&
+      h < 24 && mi < 60 && sec < 60) {
+    wxDateTime dt(d, (wxDateTime::Month)(mo - 1), y, h, mi, sec);
+    if (dt.IsValid()) m_time = (int64_t)dt.GetTicks();
+    return;
+  }
+
+  wxDateTime dt;
+  ParseGPXDateTime(dt, ts);
+  if (dt.IsValid()) m_time = (int64_t)dt.GetTicks();
 }
 
 //---------------------------------------------------------------------------------
@@ -1,5 +1,3 @@
-#include <list>
-
 #include <wx/colour.h>
 #include <wx/gdicmn.h>
 #include <wx/pen.h>
@@ -91,46 +89,31 @@ void TrackGui::Finalize() {
 }
 
 
-void TrackGui::GetPointLists(ChartCanvas *cc,
-                             std::list<std::list<wxPoint> > &pointlists,
+void TrackGui::GetPointLists(ChartCanvas *cc, TrackLines &lines,
                              ViewPort &VP, const LLBBox &box) {
-
   if (!m_track.IsVisible() || m_track.GetnPoints() == 0) return;
   Finalize();
-  //    OCPNStopWatch sw;
-  Segments(cc, pointlists, box, VP.view_scale_ppm);
-#if 0
-    if(GetnPoints() > 40000) {
-        double t = sw.GetTime();
-        double c = 0;
-        for(std::list< std::list<wxPoint> >::iterator lines = pointlists.begin();
-        lines != pointlists.end(); lines++) {
-            if(lines->size() > 1)
-                c += lines->size();
-                continue;
-        }
-        printf("assemble time %f %f segments %f seg/ms\n", sw.GetTime(), c, c/t);
-    }
-#endif
+  Segments(cc, lines, box, VP.view_scale_ppm);
 
   //    Add last segment, dynamically, maybe.....
   // we should not add this segment if it is not on the screen...
   if (m_track.IsRunning()) {
-    std::list<wxPoint> new_list;
-    pointlists.push_back(new_list);
-    AddPointToList(cc, pointlists, m_track.TrackPoints.size() - 1);
+    lines.NewLine();
+    AddPointToList(cc, lines, m_track.TrackPoints.size() - 1);
     wxPoint r;
     cc->GetCanvasPointPix(gLat, gLon, &r);
-    pointlists.back().push_back(r);
+    lines.points.push_back(r);
   }
 }
 
 void TrackGui::Draw(ChartCanvas* cc, ocpnDC& dc, ViewPort& VP,
                     const LLBBox& box) {
-  std::list<std::list<wxPoint> > pointlists;
-  GetPointLists(cc, pointlists, VP, box);
+  //  Shared by all tracks and canvases, drawing is on the GUI thread only
+  static TrackLines lines;
+  lines.Clear();
+  GetPointLists(cc, lines, VP, box);
 
-  if (!pointlists.size()) return;
+  if (!lines.GetCount()) return;
 
   //  Establish basic colour
   wxColour basic_colour;
@@ -147,13 +130,7 @@ void TrackGui::Draw(ChartCanvas* cc, ocpnDC& dc, ViewPort& VP,
   if (m_track.m_Colour == wxEmptyString) {
     col = basic_colour;
   } else {
-    for (unsigned int i = 0; i < sizeof(::GpxxColorNames) / sizeof(wxString);
-         i++) {
-      if (m_track.m_Colour == ::GpxxColorNames[i]) {
-        col = ::GpxxColors[i];
-        break;
-      }
-    }
+    col = GetGpxxColor(m_track.m_Colour);
   }
 
   double radius = 0.;
@@ -166,37 +143,32 @@ void TrackGui::Draw(ChartCanvas* cc, ocpnDC& dc, ViewPort& VP,
   {
     dc.SetPen(*wxThePenList->FindOrCreatePen(col, width, style));
     dc.SetBrush(*wxTheBrushList->FindOrCreateBrush(col, wxBRUSHSTYLE_SOLID));
-    for (std::list<std::list<wxPoint> >::iterator lines = pointlists.begin();
-         lines != pointlists.end(); lines++) {
-      // convert from linked list to array
-      wxPoint *points = new wxPoint[lines->size()];
-      int i = 0;
-      for (std::list<wxPoint>::iterator line = lines->begin();
-           line != lines->end(); line++) {
-        points[i] = *line;
-        i++;
-      }
 
-      int hilite_width = radius;
+    int hilite_width = radius;
+    wxPen HiPen;
+    if (hilite_width >= 1.0) {
+      wxColor trackLine_dim_colour = GetDimColor(g_colourTrackLineColour);
+      wxColour hilt(trackLine_dim_colour.Red(), trackLine_dim_colour.Green(),
+                    trackLine_dim_colour.Blue(), 128);
+      HiPen = wxPen(hilt, hilite_width, wxPENSTYLE_SOLID);
+    }
+
+    for (size_t l = 0; l < lines.GetCount(); l++) {
+      int n = lines.LineSize(l);
+      if (n < 2) continue;
+      wxPoint *points = lines.Line(l);
+
       if (hilite_width >= 1.0) {
         wxPen psave = dc.GetPen();
 
-        dc.StrokeLines(i, points);
-
-        wxColor trackLine_dim_colour = GetDimColor(g_colourTrackLineColour);
-        wxColour hilt(trackLine_dim_colour.Red(), trackLine_dim_colour.Green(),
-                      trackLine_dim_colour.Blue(), 128);
+        dc.StrokeLines(n, points);
 
-        wxPen HiPen(hilt, hilite_width, wxPENSTYLE_SOLID);
         dc.SetPen(HiPen);
-
-        dc.StrokeLines(i, points);
+        dc.StrokeLines(n, points);
 
         dc.SetPen(psave);
       } else
-        dc.StrokeLines(i, points);
-
-      delete[] points;
+        dc.StrokeLines(n, points);
     }
   }
 
@@ -205,21 +177,18 @@ void TrackGui::Draw(ChartCanvas* cc, ocpnDC& dc, ViewPort& VP,
 }
 
 // Entry to recursive Assemble at the head of the SubTracks tree
-void TrackGui::Segments(ChartCanvas *cc,
-                        std::list<std::list<wxPoint> > &pointlists,
-                        const LLBBox &box, double scale) {
+void TrackGui::Segments(ChartCanvas *cc, TrackLines &lines, const LLBBox &box,
+                        double scale) {
   if (!m_track.SubTracks.size()) return;
 
   int level = m_track.SubTracks.size() - 1, last = -2;
-  Assemble(cc, pointlists, box, 1 / scale / scale, last, level, 0);
+  Assemble(cc, lines, box, 1 / scale / scale, last, level, 0);
 }
 
 /* assembles lists of line strips from the given track recursively traversing
    the subtracks data */
-void TrackGui::Assemble(ChartCanvas *cc,
-                        std::list<std::list<wxPoint> > &pointlists,
-                        const LLBBox &box, double scale, int &last, int level,
-                        int pos) {
+void TrackGui::Assemble(ChartCanvas *cc, TrackLines &lines, const LLBBox &box,
+                        double scale, int &last, int level, int pos) {
   if (pos == (int)m_track.SubTracks[level].size()) return;
 
   SubTrack &s = m_track.SubTracks[level][pos];
@@ -228,42 +197,34 @@ void TrackGui::Assemble(ChartCanvas *cc,
   if (s.m_scale < scale) {
     pos <<= level;
 
-    if (last < pos - 1) {
-      std::list<wxPoint> new_list;
-      pointlists.push_back(new_list);
-    }
+    if (last < pos - 1) lines.NewLine();
 
-    if (last < pos) AddPointToList(cc, pointlists, pos);
+    if (last < pos) AddPointToList(cc, lines, pos);
     last = wxMin(pos + (1 << level), m_track.TrackPoints.size() - 1);
-    AddPointToList(cc, pointlists, last);
+    AddPointToList(cc, lines, last);
   } else {
-    Assemble(cc, pointlists, box, scale, last, level - 1, pos << 1);
-    Assemble(cc, pointlists, box, scale, last, level - 1, (pos << 1) + 1);
+    Assemble(cc, lines, box, scale, last, level - 1, pos << 1);
+    Assemble(cc, lines, box, scale, last, level - 1, (pos << 1) + 1);
   }
 }
 
-void TrackGui::AddPointToList(ChartCanvas *cc,
-                              std::list<std::list<wxPoint> > &pointlists, int n) {
+void TrackGui::AddPointToList(ChartCanvas *cc, TrackLines &lines, int n) {
   wxPoint r(INVALID_COORD, INVALID_COORD);
   if ((size_t)n < m_track.TrackPoints.size())
     cc->GetCanvasPointPix(m_track.TrackPoints[n]->m_lat, m_track.TrackPoints[n]->m_lon, &r);
 
-  std::list<wxPoint> &pointlist = pointlists.back();
+  if (lines.starts.empty()) lines.NewLine();
+  size_t size = lines.BackSize();
   if (r.x == INVALID_COORD) {
-    if (pointlist.size()) {
-      std::list<wxPoint> new_list;
-      pointlists.push_back(new_list);
-    }
+    if (size) lines.NewLine();
     return;
   }
 
-  if (pointlist.size() == 0)
-    pointlist.push_back(r);
+  if (size == 0)
+    lines.points.push_back(r);
   else {
-    wxPoint l = pointlist.back();
+    wxPoint l = lines.points.back();
     // ensure the segment is at least 2 pixels
-    if ((abs(r.x - l.x) > 1) || (abs(r.y - l.y) > 1)) pointlist.push_back(r);
+    if ((abs(r.x - l.x) > 1) || (abs(r.y - l.y) > 1)) lines.points.push_back(r);
   }
 }
-
-
@@ -0,0 +1,152 @@
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "history_buffer.h"
+
+// Min and max of the last window samples, NaN if they have no values.
+static void WindowMinMax(const std::vector<double>& all, size_t window,
+                         double& min, double& max) {
+  min = max = NAN;
+  for (size_t k = all.size() - std::min(window, all.size()); k < all.size();
+       k++) {
+    if (std::isnan(all[k])) continue;
+    if (std::isnan(min) || all[k] < min) min = all[k];
+    if (std::isnan(max) || all[k] > max) max = all[k];
+  }
+}
+
+TEST(HistoryBuffer, SlidingMinMax) {
+  const int size = 16;
+  HistoryBuffer history(2, size, 1);
+  std::vector<double> all[2];
+  unsigned seed = 12345;
+  for (int n = 0; n < 500; n++) {
+    double values[2];
+    for (int c = 0; c < 2; c++) {
+      seed = seed * 1103515245 + 12345;
+      values[c] = (seed >> 16) % 100;
+      // Runs of NaN, long enough to empty the window now and then
+      if (c == 1 && n % 100 >= 70 && n % 100 < 90) values[c] = NAN;
+      all[c].push_back(values[c]);
+    }
+    history.Add(1000 + n, values);
+
+    ASSERT_EQ(history.GetCount(), std::min(n + 1, size));
+    for (int c = 0; c < 2; c++) {
+      double min, max;
+      WindowMinMax(all[c], size, min, max);
+      if (std::isnan(min)) {
+        EXPECT_TRUE(std::isnan(history.GetMin(c))) << n;
+        EXPECT_TRUE(std::isnan(history.GetMax(c))) << n;
+      } else {
+        EXPECT_EQ(history.GetMin(c), min) << n;
+        EXPECT_EQ(history.GetMax(c), max) << n;
+      }
+    }
+  }
+}
+
+TEST(HistoryBuffer, WrapsAroundOldestFirst) {
+  const int size = 8;
+  HistoryBuffer history(1, size, 1);
+  EXPECT_EQ(history.GetCount(), 0);
+  EXPECT_TRUE(std::isnan(history.GetMin(0)));
+  for (int n = 0; n < 3 * size + 3; n++) {
+    double v = n * 10;
+    history.Add(1000 + n, &v);
+    int count = history.GetCount();
+    ASSERT_EQ(count, std::min(n + 1, size));
+    for (int idx = 0; idx < count; idx++) {
+      int sample = n + 1 - count + idx;
+      EXPECT_EQ(history.GetValue(0, idx), sample * 10.);
+      EXPECT_EQ(history.GetTime(idx), 1000 + sample);
+    }
+  }
+  history.Clear();
+  EXPECT_EQ(history.GetCount(), 0);
+  EXPECT_TRUE(std::isnan(history.GetMax(0)));
+}
+
+TEST(HistoryBuffer, TierRollover) {
+  // Tiers of 8 samples, each further one the means of 4 of the one before.
+  const int size = 8, factor = 4;
+  HistoryBuffer history(2, size, 3, factor);
+  const int n = 150;
+  for (int k = 0; k < n; k++) {
+    double values[2] = {(double)k, k % 8 < 4 ? NAN : (double)k};
+    history.Add(1000 + k, values);
+  }
+
+  // Sample s of tier t is the mean of samples s * 4^t to (s + 1) * 4^t - 1,
+  // stamped with the time of the last of them; only whole groups are done.
+  for (int tier = 0; tier < 3; tier++) {
+    int span = tier == 0 ? 1 : tier == 1 ? factor : factor * factor;
+    int done = n / span;
+    ASSERT_EQ(history.GetCount(tier), std::min(done, size)) << tier;
+    double min = 1e9, max = -1e9;
+    for (int idx = 0; idx < history.GetCount(tier); idx++) {
+      int s = done - history.GetCount(tier) + idx;
+      int first = s * span, last = (s + 1) * span - 1;
+      EXPECT_EQ(history.GetTime(idx, tier), 1000 + last) << tier;
+      EXPECT_DOUBLE_EQ(history.GetValue(0, idx, tier), (first + last) / 2.)
+          << tier;
+      min = std::min(min, (first + last) / 2.);
+      max = std::max(max, (first + last) / 2.);
+
+      // NaN is left out of the means; a group of NaN only is NaN.
+      double sum = 0;
+      int values = 0;
+      for (int k = first; k <= last; k++)
+        if (k % 8 >= 4) sum += k, values++;
+      double v = history.GetValue(1, idx, tier);
+      if (values)
+        EXPECT_DOUBLE_EQ(v, sum / values) << tier << " " << s;
+      else
+        EXPECT_TRUE(std::isnan(v)) << tier << " " << s;
+    }
+    EXPECT_DOUBLE_EQ(history.GetMin(0, tier), min);
+    EXPECT_DOUBLE_EQ(history.GetMax(0, tier), max);
+  }
+}
+
+TEST(HistoryBuffer, SaveAndLoad) {
+  const char* path = "/tmp/history_buffer_test.dat";
+  HistoryBuffer history(2, 8, 3, 4);
+  for (int k = 0; k < 75; k++) {
+    double values[2] = {sin(k * 0.1), (double)(k % 7)};
+    history.Add(1000 + 60 * k, values);
+  }
+  ASSERT_TRUE(history.Save(path));
+
+  HistoryBuffer loaded(2, 8, 3, 4);
+  ASSERT_TRUE(loaded.Load(path));
+  // Adding goes on where it stopped, the means in progress included.
+  for (int k = 75; k < 90; k++) {
+    double values[2] = {sin(k * 0.1), (double)(k % 7)};
+    history.Add(1000 + 60 * k, values);
+    loaded.Add(1000 + 60 * k, values);
+  }
+  for (int tier = 0; tier < 3; tier++) {
+    ASSERT_EQ(loaded.GetCount(tier), history.GetCount(tier));
+    for (int c = 0; c < 2; c++) {
+      EXPECT_EQ(loaded.GetMin(c, tier), history.GetMin(c, tier));
+      EXPECT_EQ(loaded.GetMax(c, tier), history.GetMax(c, tier));
+      for (int idx = 0; idx < history.GetCount(tier); idx++) {
+        EXPECT_EQ(loaded.GetValue(c, idx, tier), history.GetValue(c, idx, tier));
+        EXPECT_EQ(loaded.GetTime(idx, tier), history.GetTime(idx, tier));
+      }
+    }
+  }
+
+  // Not into another layout.
+  HistoryBuffer other(2, 16, 3, 4);
+  EXPECT_FALSE(other.Load(path));
+  EXPECT_EQ(other.GetCount(), 0);
+  remove(path);
+  EXPECT_FALSE(loaded.Load(path));
+}
@@ -0,0 +1,381 @@
+#include <stdio.h>
+#include <math.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "GribTimeline.h"
+#include "GribV1Record.h"
+
+// A lat/lon grid, corners in millidegrees, columns first.
+struct Grib1Grid {
+  int ni, nj;
+  int la1, lo1, la2, lo2;
+};
+
+static void PutSigned3(std::vector<unsigned char>& v, size_t at, int x) {
+  unsigned m = x < 0 ? -x : x;
+  v[at] = (m >> 16 & 0x7f) | (x < 0 ? 0x80 : 0);
+  v[at + 1] = m >> 8 & 0xff;
+  v[at + 2] = m & 0xff;
+}
+
+// A GRIB1 message with 8 bit values, those below 0 missing from a bitmap.
+static std::vector<unsigned char> MakeGrib1(unsigned char center,
+                                            unsigned char model,
+                                            unsigned char param,
+                                            const Grib1Grid& grid,
+                                            const std::vector<int>& values) {
+  bool bitmap = false;
+  for (int v : values) bitmap |= v < 0;
+  std::vector<unsigned char> pds = {
+      0, 0, 28,     // section length
+      2,            // table version
+      center, model,
+      255,          // grid id
+      (unsigned char)(bitmap ? 0xc0 : 0x80),  // GDS, BMS
+      param, 1, 0, 0,           // surface
+      24, 1, 15, 12, 0,         // 2024-01-15 12:00
+      1, 0, 0, 0,               // hours, P1, P2, time range
+      0, 0, 0, 21, 0, 0, 0};    // century 21, D = 0
+  std::vector<unsigned char> gds = {
+      0, 0, 32, 0, 255, 0,
+      0, 0, 0, 0,               // Ni, Nj
+      0, 0, 0, 0, 0, 0,         // La1, Lo1
+      0x80,
+      0, 0, 0, 0, 0, 0,         // La2, Lo2
+      0, 0, 0, 0,               // Di, Dj, recomputed by the reader
+      0,                        // scan mode
+      0, 0, 0, 0};
+  gds[6] = grid.ni >> 8, gds[7] = grid.ni & 0xff;
+  gds[8] = grid.nj >> 8, gds[9] = grid.nj & 0xff;
+  PutSigned3(gds, 10, grid.la1);
+  PutSigned3(gds, 13, grid.lo1);
+  PutSigned3(gds, 17, grid.la2);
+  PutSigned3(gds, 20, grid.lo2);
+  if (grid.la2 > grid.la1) gds[27] = 0x40;  // j positive
+  std::vector<unsigned char> bms = {0, 0, 0, 0, 0, 0};
+  std::vector<unsigned char> bds = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8};
+  for (size_t n = 0; n < values.size(); n++) {
+    if (n % 8 == 0) bms.push_back(0);
+    if (values[n] < 0) continue;
+    bms.back() |= 0x80 >> n % 8;
+    bds.push_back(values[n]);
+  }
+  bms[1] = bms.size() >> 8;
+  bms[2] = bms.size() & 0xff;
+  bds[1] = bds.size() >> 8;
+  bds[2] = bds.size() & 0xff;
+
+  std::vector<unsigned char> msg = {'G', 'R', 'I', 'B', 0, 0, 0, 1};
+  msg.insert(msg.end(), pds.begin(), pds.end());
+  msg.insert(msg.end(), gds.begin(), gds.end());
+  if (bitmap) msg.insert(msg.end(), bms.begin(), bms.end());
+  msg.insert(msg.end(), bds.begin(), bds.end());
+  for (char c : std::string("7777")) msg.push_back(c);
+  msg[4] = msg.size() >> 16;
+  msg[5] = msg.size() >> 8 & 0xff;
+  msg[6] = msg.size() & 0xff;
+  return msg;
+}
+
+// On a 3 x 2 grid from 0, 0 to 2 E, 1 N.
+static std::vector<unsigned char> MakeGrib1(unsigned char center,
+                                            unsigned char model,
+                                            unsigned char param,
+                                            const std::vector<int>& values) {
+  return MakeGrib1(center, model, param, {3, 2, 0, 0, 1000, 2000}, values);
+}
+
+static GribV1Record* ReadGrib1(const std::vector<unsigned char>& msg) {
+  const char* path = "/tmp/grib1_test.grb";
+  FILE* f = fopen(path, "wb");
+  fwrite(msg.data(), 1, msg.size(), f);
+  fclose(f);
+  ZUFILE* file = zu_open(path, "rb", ZU_COMPRESS_NONE);
+  GribV1Record* rec = new GribV1Record(file, 0);
+  zu_close(file);
+  remove(path);
+  return rec;
+}
+
+TEST(GribV1Record, ScaledAfterDecode) {
+  // GFS precipitation rate is converted from mm/s to mm/h when the record
+  // is read, before its data is unpacked.
+  std::vector<int> values = {0, 1, 2, 3, 4, 5};
+  GribV1Record* rec = ReadGrib1(MakeGrib1(7, 96, GRB_PRECIP_RATE, values));
+  ASSERT_TRUE(rec->isOk());
+  ASSERT_TRUE(rec->decodeData());
+  for (int j = 0; j < 2; j++)
+    for (int i = 0; i < 3; i++)
+      EXPECT_DOUBLE_EQ(rec->getValue(i, j), values[j * 3 + i] * 3600.);
+  delete rec;
+
+  // Not scaled for other centers.
+  rec = ReadGrib1(MakeGrib1(78, 96, GRB_PRECIP_RATE, values));
+  ASSERT_TRUE(rec->isOk());
+  ASSERT_TRUE(rec->decodeData());
+  EXPECT_DOUBLE_EQ(rec->getValue(2, 1), 5.);
+  delete rec;
+}
+
+// Record sets at uneven times with gaps, as a GRIB file has them.
+class GribTimelineTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    const int hours[] = {0, 3, 6, 12};
+    for (int k = 0; k < 4; k++) {
+      GribRecordSet* set = new GribRecordSet(k);
+      set->m_Reference_Time = kStart + hours[k] * 3600;
+      std::vector<int> vx, vy, press, dir;
+      for (int n = 0; n < 6; n++) {
+        vx.push_back((7 * n + 31 * k) % 40);
+        vy.push_back((11 * n + 17 * k) % 40);
+        press.push_back(100 + 20 * k + n);
+        dir.push_back((60 * k + 45 * n) % 256);
+      }
+      Add(set, Idx_WIND_VX, GRB_WIND_VX, vx);
+      Add(set, Idx_WIND_VY, GRB_WIND_VY, vy);
+      if (k != 1) Add(set, Idx_PRESSURE, GRB_PRESSURE, press);
+      if (k != 2) Add(set, Idx_WVDIR, GRB_WVDIR, dir);
+      sets.push_back(set);
+    }
+  }
+
+  void TearDown() override {
+    for (GribRecordSet* set : sets) delete set;
+  }
+
+  static void Add(GribRecordSet* set, int idx, int param,
+                  const std::vector<int>& values) {
+    GribV1Record* rec = ReadGrib1(MakeGrib1(7, 96, param, values));
+    ASSERT_TRUE(rec->isOk());
+    ASSERT_TRUE(rec->decodeData());
+    set->SetUnRefGribRecord(idx, rec);
+  }
+
+  // The interpolation as GRIBUICtrlBar::GetTimeLineRecordSet did it before
+  // the timeline cache, scanning all sets for each parameter.
+  void Reference(time_t time, GribRecordSet& out) {
+    for (int i = 0; i < Idx_COUNT; i++) {
+      GribRecordSet *GRS1 = NULL, *GRS2 = NULL;
+      GribRecord *GR1 = NULL, *GR2 = NULL;
+
+      if (out.m_GribRecordPtrArray[i]) continue;
+
+      for (GribRecordSet* GRS : sets) {
+        GribRecord* GR = GRS->m_GribRecordPtrArray[i];
+        if (!GR) continue;
+        time_t curtime = GRS->m_Reference_Time;
+        if (curtime <= time) GRS1 = GRS, GR1 = GR;
+        if (curtime >= time) {
+          GRS2 = GRS, GR2 = GR;
+          break;
+        }
+      }
+      if (!GR1 || !GR2) continue;
+
+      time_t mintime = sets[0]->m_Reference_Time;
+      double minute2 = (GRS2->m_Reference_Time - mintime) / 60;
+      double minute1 = (GRS1->m_Reference_Time - mintime) / 60;
+      double nminute = (time - mintime) / 60;
+      if (minute2 < minute1 || nminute < minute1 || nminute > minute2) continue;
+      if (minute1 == minute2) {
+        out.m_GribRecordPtrArray[i] = GR1;
+        continue;
+      }
+      double interp_const = (nminute - minute1) / (minute2 - minute1);
+
+      if (i < Idx_WIND_VY) {
+        GribRecord* GR1y = GRS1->m_GribRecordPtrArray[i + Idx_WIND_VY];
+        GribRecord* GR2y = GRS2->m_GribRecordPtrArray[i + Idx_WIND_VY];
+        if (GR1y && GR2y) {
+          GribRecord* Ry;
+          out.SetUnRefGribRecord(
+              i, GribRecord::Interpolated2DRecord(Ry, *GR1, *GR1y, *GR2, *GR2y,
+                                                  interp_const));
+          out.SetUnRefGribRecord(i + Idx_WIND_VY, Ry);
+          continue;
+        }
+      } else if (i <= Idx_WIND_VY300 || i == Idx_SEACURRENT_VY)
+        continue;
+      out.SetUnRefGribRecord(i, GribRecord::InterpolatedRecord(
+                                    *GR1, *GR2, interp_const, i == Idx_WVDIR));
+    }
+  }
+
+  static const time_t kStart = 1705320000;  // 2024-01-15 12:00 UTC
+  std::vector<GribRecordSet*> sets;
+};
+
+TEST_F(GribTimelineTest, MatchesScanOfAllSets) {
+  GribTimelineCache cache(sets);
+  GribTimelineCache prefetched(sets);
+
+  // Before, at and between the sets, off the minute, and after them.
+  std::vector<time_t> times;
+  for (time_t t = kStart - 3600; t <= kStart + 13 * 3600; t += 1800)
+    times.push_back(t);
+  times.push_back(kStart + 4 * 3600 + 90);
+  prefetched.Prefetch(times);
+
+  int present = 0;
+  for (time_t t : times) {
+    GribRecordSet expected(0);
+    Reference(t, expected);
+    std::shared_ptr<GribTimelineStep> step = cache.GetStep(t);
+    std::shared_ptr<GribTimelineStep> ahead = prefetched.GetStep(t);
+    EXPECT_EQ(step->time, t);
+    for (int i = 0; i < Idx_COUNT; i++) {
+      GribRecord* want = expected.m_GribRecordPtrArray[i];
+      for (GribRecord* got : {step->records[i], ahead->records[i]}) {
+        ASSERT_EQ(got == NULL, want == NULL) << "time " << t << " idx " << i;
+        if (!want) continue;
+        for (int j = 0; j < 2; j++)
+          for (int k = 0; k < 3; k++)
+            EXPECT_DOUBLE_EQ(got->getValue(k, j), want->getValue(k, j))
+                << "time " << t << " idx " << i;
+      }
+      if (want) present++;
+    }
+    // Asked again, the kept step.
+    EXPECT_EQ(cache.GetStep(t), step);
+  }
+  // Wind at all times in range, pressure and direction across their gaps.
+  EXPECT_EQ(present, 4 * 26);
+}
+
+TEST_F(GribTimelineTest, DropsLeastRecentlyUsedOverLimit) {
+  const time_t a = kStart + 1800, b = kStart + 3600, c = kStart + 5400,
+               d = kStart + 7200;
+  size_t bytes = GribTimelineCache(sets).GetStep(a)->bytes;
+
+  GribTimelineCache cache(sets, 3 * bytes);
+  std::shared_ptr<GribTimelineStep> first = cache.GetStep(a);
+  EXPECT_EQ(first->bytes, bytes);
+  cache.GetStep(b);
+  cache.GetStep(c);
+  EXPECT_EQ(cache.GetKeptTimes(), std::vector<time_t>({c, b, a}));
+  cache.GetStep(a);
+  EXPECT_EQ(cache.GetKeptTimes(), std::vector<time_t>({a, c, b}));
+  cache.GetStep(d);
+  EXPECT_EQ(cache.GetKeptTimes(), std::vector<time_t>({d, a, c}));
+  cache.GetStep(b);
+  EXPECT_EQ(cache.GetKeptTimes(), std::vector<time_t>({b, d, a}));
+
+  // A dropped step lives on with those still using it.
+  cache.GetStep(c);
+  EXPECT_EQ(cache.GetKeptTimes(), std::vector<time_t>({c, b, d}));
+  EXPECT_EQ(first->time, a);
+  EXPECT_TRUE(first->records[Idx_WIND_VX] != NULL);
+  EXPECT_NE(cache.GetStep(a), first);
+
+  // The latest step is kept whatever its size.
+  GribTimelineCache tiny(sets, 1);
+  tiny.GetStep(a);
+  tiny.GetStep(b);
+  EXPECT_EQ(tiny.GetKeptTimes(), std::vector<time_t>({b}));
+}
+
+// Samples a grid across the antimeridian, with j negative, and a grid
+// around the world, with holes, on and around their edges.
+TEST(GribGridSampler, MatchesSinglePointsAcrossEdges) {
+  const Grib1Grid pacific = {21, 11, 20000, 170000, 10000, -170000};
+  const Grib1Grid world = {360, 7, -3000, 0, 3000, 359000};
+  for (const Grib1Grid& grid : {pacific, world}) {
+    std::vector<int> vx, vy;
+    for (int j = 0; j < grid.nj; j++)
+      for (int i = 0; i < grid.ni; i++) {
+        bool hole = (7 * i + 3 * j) % 23 == 0;
+        vx.push_back(hole ? -1 : (37 * i + 91 * j) % 250);
+        vy.push_back(hole ? -1 : (53 * i + 29 * j) % 250);
+      }
+    GribV1Record* rx = ReadGrib1(MakeGrib1(7, 96, GRB_WIND_VX, grid, vx));
+    GribV1Record* ry = ReadGrib1(MakeGrib1(7, 96, GRB_WIND_VY, grid, vy));
+    ASSERT_TRUE(rx->isOk() && rx->decodeData());
+    ASSERT_TRUE(ry->isOk() && ry->decodeData());
+
+    double lo1 = grid.lo1 / 1000., la1 = grid.la1 / 1000.;
+    double lo2 = grid.lo2 / 1000. + (grid.lo2 < grid.lo1 ? 360 : 0);
+    double la2 = grid.la2 / 1000.;
+    double di = (lo2 - lo1) / (grid.ni - 1), dj = (la2 - la1) / (grid.nj - 1);
+    ASSERT_DOUBLE_EQ(rx->getDi(), di);
+    ASSERT_DOUBLE_EQ(rx->getDj(), dj);
+
+    // The edges, just inside and outside them, and once more around the
+    // world on both sides; then points all over.
+    std::vector<double> lons, lats;
+    for (double turn : {-360., 0., 360.})
+      for (double lon : {lo1, lo2, lo2 + di, lo1 - 1e-3, lo1 + 1e-3,
+                         lo2 - 1e-3, lo2 + 1e-3, lo1 + 2.5 * di})
+        lons.push_back(lon + turn);
+    for (double lon = -541; lon < 541; lon += 7.3) lons.push_back(lon);
+    for (double lat : {la1, la2, la1 + 1e-3, la1 - 1e-3, la2 + 1e-3,
+                       la2 - 1e-3})
+      lats.push_back(lat);
+    for (double lat = -21; lat < 21; lat += 0.23) lats.push_back(lat);
+    std::vector<double> px, py;
+    for (double lon : lons)
+      for (double lat : lats) px.push_back(lon), py.push_back(lat);
+    int n = px.size();
+
+    GribGridSampler sampler(rx), vectors(rx, ry);
+    std::vector<double> values(n), M(n), A(n);
+    for (bool interpolate : {true, false}) {
+      for (bool dir : {false, true}) {
+        sampler.getValues(n, px.data(), py.data(), values.data(), interpolate,
+                          dir);
+        for (int k = 0; k < n; k++)
+          ASSERT_EQ(values[k],
+                    rx->getInterpolatedValue(px[k], py[k], interpolate, dir))
+              << px[k] << " " << py[k];
+      }
+      vectors.getVectors(n, px.data(), py.data(), M.data(), A.data(),
+                         interpolate);
+      for (int k = 0; k < n; k++) {
+        double m = GRIB_NOTDEF, a = GRIB_NOTDEF;
+        GribRecord::getInterpolatedValues(m, a, rx, ry, px[k], py[k],
+                                          interpolate);
+        ASSERT_EQ(M[k], m) << px[k] << " " << py[k];
+        ASSERT_EQ(A[k], a) << px[k] << " " << py[k];
+      }
+    }
+
+    // Nothing off the grid.
+    int inside = 0;
+    for (int k = 0; k < n; k++) {
+      double x = px[k] - 360 * floor((px[k] - lo1) / 360);
+      if (py[k] < std::min(la1, la2) || py[k] > std::max(la1, la2) ||
+          x > lo2 + (grid.ni * di >= 360 ? di : 0))
+        EXPECT_EQ(sampler.getValue(px[k], py[k]), GRIB_NOTDEF)
+            << px[k] << " " << py[k];
+      else
+        inside++;
+    }
+    EXPECT_GT(inside, n / 50);
+
+    // The nodes, from all sides of the world.  Past the last column of the
+    // world grid is its first one.
+    for (double turn : {-360., 0., 360.})
+      for (int j = 0; j < grid.nj; j++)
+        for (int i = 0; i <= grid.ni; i++) {
+          double x = lo1 + i * di + turn, y = la1 + j * dj;
+          int wrap = i % grid.ni;
+          if (i == grid.ni && grid.ni * di < 360) {
+            EXPECT_EQ(sampler.getValue(x, y, false), GRIB_NOTDEF);
+            continue;
+          }
+          int v = vx[j * grid.ni + wrap];
+          EXPECT_EQ(sampler.getValue(x, y, false), v < 0 ? GRIB_NOTDEF : v)
+              << x << " " << y;
+          EXPECT_EQ(sampler.getValue(x, y), sampler.getValue(lo1 + wrap * di, y))
+              << x << " " << y;
+        }
+    delete rx;
+    delete ry;
+  }
+}
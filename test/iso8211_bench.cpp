@@ -0,0 +1,88 @@
+// Time to read back a synthetic ISO 8211 module of 200k S-57 like feature
+// records, about 20 MB.  Not a test; run by hand:
+//
+//     $ cmake --build . --target iso8211_bench && test/iso8211_bench [path]
+//
+// The module is written to path, default /tmp/iso8211_bench.000, when it
+// does not exist yet.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "iso8211.h"
+
+static bool WriteModule(const char* path, int n_records) {
+  DDFModule module;
+  DDFFieldDefn* id = new DDFFieldDefn();
+  id->Create("0001", "ISO 8211 Record Identifier", "", dsc_elementary,
+             dtc_bit_string, "(b12)");
+  module.AddField(id);
+  DDFFieldDefn* frid = new DDFFieldDefn();
+  frid->Create("FRID", "Feature record identifier field", "", dsc_vector,
+               dtc_mixed_data_type);
+  frid->AddSubfield("RCNM", "b11");
+  frid->AddSubfield("RCID", "b14");
+  frid->AddSubfield("OBJL", "b12");
+  module.AddField(frid);
+  DDFFieldDefn* attf = new DDFFieldDefn();
+  attf->Create("ATTF", "Feature record attribute field", "*", dsc_array,
+               dtc_mixed_data_type);
+  attf->AddSubfield("ATTL", "b12");
+  attf->AddSubfield("ATVL", "A");
+  module.AddField(attf);
+  module.Initialize();
+  if (!module.Create(path)) return false;
+  for (int i = 0; i < n_records; i++) {
+    DDFRecord record(&module);
+    record.AddField(id);
+    record.SetIntSubfield("0001", 0, "", 0, i);
+    record.AddField(frid);
+    record.SetIntSubfield("FRID", 0, "RCNM", 0, 100);
+    record.SetIntSubfield("FRID", 0, "RCID", 0, i);
+    record.SetIntSubfield("FRID", 0, "OBJL", 0, i % 300);
+    record.AddField(attf);
+    for (int k = 0; k < 1 + i % 4; k++) {
+      std::string value = "v" + std::to_string(i) + "_" + std::to_string(k);
+      record.SetIntSubfield("ATTF", 0, "ATTL", k, 100 + k);
+      record.SetStringSubfield("ATTF", 0, "ATVL", k, value.c_str());
+    }
+    record.Write();
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* path = argc > 1 ? argv[1] : "/tmp/iso8211_bench.000";
+  FILE* f = fopen(path, "rb");
+  if (f)
+    fclose(f);
+  else if (!WriteModule(path, 200000)) {
+    fprintf(stderr, "Cannot write %s\n", path);
+    return 1;
+  }
+
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    DDFModule module;
+    if (!module.Open(path)) return 1;
+    long n = 0, sum = 0;
+    for (int pass = 0; pass < 2; pass++) {
+      module.Rewind();
+      while (DDFRecord* r = module.ReadRecord()) {
+        n++;
+        sum += r->GetIntSubfield("FRID", 0, "RCID", 0);
+        DDFField* field = r->FindField("ATTF");
+        if (!field) continue;
+        for (int k = 0; k < field->GetRepeatCount(); k++)
+          sum += strlen(r->GetStringSubfield("ATTF", 0, "ATVL", k));
+      }
+    }
+    module.Close();
+    auto end = std::chrono::steady_clock::now();
+    printf("%ld records read, checksum %ld, %.1f ms\n", n, sum,
+           std::chrono::duration<double, std::milli>(end - start).count());
+  }
+  return 0;
+}
@@ -0,0 +1,120 @@
+// Definitions of the globals used by the model sources, shared by the
+// tests and the benchmarks.
+
+#include "config.h"
+
+#include <vector>
+
+#include <wx/colour.h>
+#include <wx/gdicmn.h>
+#include <wx/log.h>
+#include <wx/string.h>
+
+#include "ais_decoder.h"
+#include "base_platform.h"
+#include "route.h"
+#include "routeman.h"
+#include "select.h"
+#include "track.h"
+
+class AISTargetAlertDialog;
+class Multiplexer;
+class s52plib;
+
+bool g_bAIS_ACK_Timeout;
+bool g_bAIS_CPA_Alert_Suppress_Moored;
+bool g_bCPAMax;
+bool g_bCPAWarn;
+bool g_bHideMoored;
+bool g_bTCPA_Max;
+double g_AckTimeout_Mins;
+double g_CPAMax_NM;
+double g_CPAWarn_NM;
+double g_ShowMoored_Kts;
+double g_TCPA_Max;
+bool g_bShowMag;
+bool g_bShowTrue;
+bool bGPSValid;
+bool g_bInlandEcdis;
+bool g_bRemoveLost;
+bool g_bMarkLost;
+bool g_bShowScaled;
+bool g_bAllowShowScaled;
+bool g_bAISRolloverShowCOG;
+bool g_bAISRolloverShowCPA;
+bool g_bAISShowTracks;
+bool g_bAISRolloverShowClass;
+
+Multiplexer* g_pMUX;
+std::vector<Track*> g_TrackList;
+int g_WplAction;
+AISTargetAlertDialog* g_pais_alert_dialog_active;
+wxString AISTargetNameFileName;
+double g_AISShowTracks_Mins;
+bool g_bAIS_CPA_Alert;
+Route *pAISMOBRoute;
+double g_RemoveLost_Mins;
+double g_MarkLost_Mins;
+float g_selection_radius_mm;
+float g_selection_radius_touch_mm;
+int g_nCOMPortCheck = 32;
+bool g_benableUDPNullHeader;
+
+BasePlatform* g_BasePlatform = 0;
+bool g_bportable = false;
+wxString g_winPluginDir;
+void* g_pi_manager = reinterpret_cast<void*>(1L);
+wxString g_compatOS = PKG_TARGET;
+wxString g_compatOsVersion = PKG_TARGET_VERSION;
+
+Select* pSelect;
+double g_n_arrival_circle_radius;
+double g_PlanSpeed;
+bool g_bTrackDaily;
+int g_trackFilterMax;
+wxString g_default_routepoint_icon;
+double g_TrackDeltaDistance;
+float g_fWaypointRangeRingsStep;
+float g_ChartScaleFactorExp;
+wxString g_default_wp_icon;
+bool g_btouch;
+int g_iWaypointRangeRingsNumber;
+int g_iWaypointRangeRingsStepUnits;
+wxColour g_colourWaypointRangeRingsColour;
+bool g_bUseWptScaMin;
+int g_iWpt_ScaMin;
+bool g_bShowWptName;
+int g_LayerIdx;
+bool g_bOverruleScaMin;
+int g_nTrackPrecision;
+bool g_bIsNewLayer;
+RouteList *pRouteList;
+WayPointman* pWayPointMan;
+int g_route_line_width;
+int g_track_line_width;
+RoutePoint* pAnchorWatchPoint1 = 0;
+RoutePoint* pAnchorWatchPoint2 = 0;
+bool g_bAllowShipToActive;
+wxRect g_blink_rect;
+bool g_bMagneticAPB;
+
+Routeman* g_pRouteMan;
+s52plib* ps52plib = 0;
+
+namespace safe_mode {
+bool get_mode() { return false; }
+}  // namespace safe_mode
+
+wxString g_catalog_custom_url;
+wxString g_catalog_channel;
+wxLog* g_logger;
+AisDecoder* g_pAIS;
+Select* pSelectAIS;
+
+/* comm_bridge context. */
+
+// navutil_base context
+
+int g_iDistanceFormat = 0;
+int g_iSDMMFormat = 0;
+int g_iSpeedFormat = 0;
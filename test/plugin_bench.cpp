@@ -0,0 +1,117 @@
+// Cost per message of delivering n0183 and Signal K messages to 1, 8 and
+// 32 plugin-like listeners, either parsing the text in each listener or
+// sharing the parsed message.  Not a test; run by hand:
+//
+//     $ cmake --build . --target plugin_bench && test/plugin_bench
+
+#include "config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wx/app.h>
+#include <wx/event.h>
+#include <wx/jsonreader.h>
+#include <wx/jsonval.h>
+#include <wx/tokenzr.h>
+
+#include "comm_navmsg_bus.h"
+#include "ocpn_plugin.h"
+
+wxDEFINE_EVENT(EVT_N0183, ObservedEvt);
+wxDEFINE_EVENT(EVT_SIGNALK, ObservedEvt);
+
+static auto shared_navaddr_none = std::make_shared<NavAddr>();
+
+class FanOutApp : public wxAppConsole {
+public:
+  class Sink : public wxEvtHandler {
+  public:
+    Sink(bool shared) {
+      n0183_listener = GetListener(NMEA0183Id("GPRMC"), EVT_N0183, this);
+      signalk_listener = GetListener(SignalkId("self"), EVT_SIGNALK, this);
+      Bind(EVT_N0183, [this, shared](ObservedEvt ev) {
+        if (shared) {
+          fields = GetN0183Fields(NMEA0183Id("GPRMC"), ev);
+          return;
+        }
+        wxString sentence(GetN0183Payload(NMEA0183Id("GPRMC"), ev));
+        wxStringTokenizer tkz(sentence.Mid(1).BeforeFirst('*'), ",",
+                              wxTOKEN_RET_EMPTY_ALL);
+        auto parsed = std::make_shared<std::vector<std::string>>();
+        while (tkz.HasMoreTokens())
+          parsed->push_back(tkz.GetNextToken().ToStdString());
+        fields = parsed;
+      });
+      Bind(EVT_SIGNALK, [this, shared](ObservedEvt ev) {
+        if (shared) {
+          doc = GetSignalkDocument(SignalkId("self"), ev);
+          return;
+        }
+        auto msg = UnpackEvtPointer<SignalkMsg>(ev);
+        auto root = std::make_shared<wxJSONValue>();
+        wxJSONReader reader;
+        if (reader.Parse(msg->raw_message, root.get()) == 0) doc = root;
+      });
+    }
+    std::shared_ptr<ObservableListener> n0183_listener;
+    std::shared_ptr<ObservableListener> signalk_listener;
+    std::shared_ptr<const std::vector<std::string>> fields;
+    std::shared_ptr<const wxJSONValue> doc;
+  };
+
+  FanOutApp(int n_sinks, bool shared, int n_msgs) : wxAppConsole() {
+    for (int i = 0; i < n_sinks; i++)
+      sinks.push_back(std::make_shared<Sink>(shared));
+    auto& bus = NavMsgBus::GetInstance();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n_msgs; i++) {
+      bus.Notify(std::make_shared<const Nmea0183Msg>(
+          "GPRMC",
+          "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,"
+          "W*6A\r\n",
+          shared_navaddr_none));
+      ProcessPendingEvents();
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < n_msgs; i++) {
+      bus.Notify(std::make_shared<const SignalkMsg>(
+          "vessels.self", "vessels.self",
+          "{\"context\":\"vessels.self\",\"updates\":[{\"values\":"
+          "[{\"path\":\"navigation.speedOverGround\",\"value\":3.85},"
+          "{\"path\":\"navigation.courseOverGroundTrue\",\"value\":"
+          "1.52}]}]}"));
+      ProcessPendingEvents();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    n0183_us = std::chrono::duration<double, std::micro>(mid - start).count() /
+               n_msgs;
+    signalk_us =
+        std::chrono::duration<double, std::micro>(end - mid).count() / n_msgs;
+  }
+
+  std::vector<std::shared_ptr<Sink>> sinks;
+  double n0183_us;
+  double signalk_us;
+};
+
+int main(int argc, char** argv) {
+  const int n_msgs = 2000;
+  for (int n : {1, 8, 32}) {
+    double cost[2][2];
+    for (int shared = 0; shared < 2; shared++) {
+      FanOutApp app(n, shared, n_msgs);
+      cost[shared][0] = app.n0183_us;
+      cost[shared][1] = app.signalk_us;
+    }
+    printf("%2d plugins, us per message: n0183 %.1f parsed by each, %.1f "
+           "shared; Signal K %.1f parsed by each, %.1f shared\n",
+           n, cost[0][0], cost[1][0], cost[0][1], cost[1][1]);
+  }
+  return 0;
+}
@@ -1,13 +1,20 @@
 #include "config.h"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <thread>
 
 #include <wx/event.h>
 #include <wx/app.h>
+#include <wx/jsonreader.h>
+#include <wx/jsonval.h>
+#include <wx/tokenzr.h>
 
 #include <gtest/gtest.h>
 
@@ -21,114 +28,39 @@
 #include "comm_drv_registry.h"
 #include "comm_navmsg_bus.h"
 #include "config_vars.h"
+#include "gpx_stream_reader.h"
+#include "iso8211.h"
+#include "nav_history.h"
+#include "navutil_base.h"
 #include "observable_confvar.h"
+#include "ocpn_plugin.h"
 #include "ocpn_types.h"
 #include "own_ship.h"
 #include "routeman.h"
 #include "select.h"
+#include "track.h"
+#include "s52s57.h"
+#include "LLRTree.h"
+#include "bbox.h"
+#include "poly_clip.h"
+#include "LUPMatcher.h"
+#include "S57FeatureStore.h"
+#include "SpanFill.h"
+#include "TextDeclutter.h"
+
+#ifdef HAVE_GLU_TESS
+#ifdef __APPLE__
+#include <OpenGL/glu.h>
+typedef void (*_GLUfuncptr)();
+#else
+#include <GL/glu.h>
+#endif
+#endif
 
-class AISTargetAlertDialog;
-class Multiplexer;
-
-bool g_bAIS_ACK_Timeout;
-bool g_bAIS_CPA_Alert_Suppress_Moored;
-bool g_bCPAMax;
-bool g_bCPAWarn;
-bool g_bHideMoored;
-bool g_bTCPA_Max;
-double g_AckTimeout_Mins;
-double g_CPAMax_NM;
-double g_CPAWarn_NM;
-double g_ShowMoored_Kts;
-double g_TCPA_Max;
-bool g_bShowMag;
-bool g_bShowTrue;
-bool bGPSValid;
-bool g_bInlandEcdis;
-bool g_bRemoveLost;
-bool g_bMarkLost;
-bool g_bShowScaled;
-bool g_bAllowShowScaled;
-bool g_bAISRolloverShowCOG;
-bool g_bAISRolloverShowCPA;
-bool g_bAISShowTracks;
-bool g_bAISRolloverShowClass;
-
-Multiplexer* g_pMUX;
-std::vector<Track*> g_TrackList;
-int g_WplAction;
-AISTargetAlertDialog* g_pais_alert_dialog_active;
-wxString AISTargetNameFileName;
-double g_AISShowTracks_Mins;
-bool g_bAIS_CPA_Alert;
-Route *pAISMOBRoute;
-double g_RemoveLost_Mins;
-double g_MarkLost_Mins;
-float g_selection_radius_mm;
-float g_selection_radius_touch_mm;
-int g_nCOMPortCheck = 32;
-bool g_benableUDPNullHeader;
-
-BasePlatform* g_BasePlatform = 0;
-bool g_bportable = false;
-wxString g_winPluginDir;
-void* g_pi_manager = reinterpret_cast<void*>(1L);
-wxString g_compatOS = PKG_TARGET;
-wxString g_compatOsVersion = PKG_TARGET_VERSION;
-
-Select* pSelect;
-double g_n_arrival_circle_radius;
-double g_PlanSpeed;
-bool g_bTrackDaily;
-int g_trackFilterMax;
-wxString g_default_routepoint_icon;
-double g_TrackDeltaDistance;
-float g_fWaypointRangeRingsStep;
-float g_ChartScaleFactorExp;
-wxString g_default_wp_icon;
-bool g_btouch;
-int g_iWaypointRangeRingsNumber;
-int g_iWaypointRangeRingsStepUnits;
-wxColour g_colourWaypointRangeRingsColour;
-bool g_bUseWptScaMin;
-int g_iWpt_ScaMin;
-bool g_bShowWptName;
-int g_LayerIdx;
-bool g_bOverruleScaMin;
-int g_nTrackPrecision;
-bool g_bIsNewLayer;
-RouteList *pRouteList;
-WayPointman* pWayPointMan;
-int g_route_line_width;
-int g_track_line_width;
-RoutePoint* pAnchorWatchPoint1 = 0;
-RoutePoint* pAnchorWatchPoint2 = 0;
-bool g_bAllowShipToActive;
-wxRect g_blink_rect;
-bool g_bMagneticAPB;
-
-Routeman* g_pRouteMan;
-
-
-
-namespace safe_mode {
-bool get_mode() { return false; }
-}  // namespace safe_mode
-
-wxString g_catalog_custom_url;
-wxString g_catalog_channel;
-wxLog* g_logger;
-AisDecoder* g_pAIS;
-Select* pSelectAIS;
-
-/* comm_bridge context. */
-
-
-// navutil_base context
-
-int g_iDistanceFormat = 0;
-int g_iSDMMFormat = 0;
-int g_iSpeedFormat = 0;
+extern BasePlatform* g_BasePlatform;
+extern AisDecoder* g_pAIS;
+extern Select* pSelect;
+extern Select* pSelectAIS;
 
 wxDEFINE_EVENT(EVT_FOO, ObservedEvt);
 wxDEFINE_EVENT(EVT_BAR, ObservedEvt);
@@ -456,6 +388,69 @@ class ObsTorture : public wxAppConsole {
   }
 };
 
+/**
+ * n_sinks plugin-like listeners getting an n0183 and a Signal K message,
+ * either parsing the text themselves as plugins given the sentence or the
+ * JSON text do, or sharing the parsed messages.
+ */
+class PluginFanOutApp : public wxAppConsole {
+public:
+  class Sink : public wxEvtHandler {
+  public:
+    Sink(bool shared) {
+      n0183_listener = GetListener(NMEA0183Id("GPRMC"), EVT_FOO, this);
+      signalk_listener = GetListener(SignalkId("self"), EVT_BAR, this);
+      Bind(EVT_FOO, [this, shared](ObservedEvt ev) {
+        if (shared) {
+          fields = GetN0183Fields(NMEA0183Id("GPRMC"), ev);
+          return;
+        }
+        wxString sentence(GetN0183Payload(NMEA0183Id("GPRMC"), ev));
+        wxStringTokenizer tkz(sentence.Mid(1).BeforeFirst('*'), ",",
+                              wxTOKEN_RET_EMPTY_ALL);
+        auto parsed = std::make_shared<std::vector<std::string>>();
+        while (tkz.HasMoreTokens())
+          parsed->push_back(tkz.GetNextToken().ToStdString());
+        fields = parsed;
+      });
+      Bind(EVT_BAR, [this, shared](ObservedEvt ev) {
+        if (shared) {
+          doc = GetSignalkDocument(SignalkId("self"), ev);
+          return;
+        }
+        auto msg = UnpackEvtPointer<SignalkMsg>(ev);
+        auto root = std::make_shared<wxJSONValue>();
+        wxJSONReader reader;
+        if (reader.Parse(msg->raw_message, root.get()) == 0) doc = root;
+      });
+    }
+    std::shared_ptr<ObservableListener> n0183_listener;
+    std::shared_ptr<ObservableListener> signalk_listener;
+    std::shared_ptr<const std::vector<std::string>> fields;
+    std::shared_ptr<const wxJSONValue> doc;
+  };
+
+  PluginFanOutApp(int n_sinks, bool shared) : wxAppConsole() {
+    for (int i = 0; i < n_sinks; i++)
+      sinks.push_back(std::make_shared<Sink>(shared));
+    auto& bus = NavMsgBus::GetInstance();
+    bus.Notify(std::make_shared<const Nmea0183Msg>(
+        "GPRMC",
+        "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,"
+        "W*6A\r\n",
+        shared_navaddr_none));
+    bus.Notify(std::make_shared<const SignalkMsg>(
+        "vessels.self", "vessels.self",
+        "{\"context\":\"vessels.self\",\"updates\":[{\"values\":"
+        "[{\"path\":\"navigation.speedOverGround\",\"value\":3.85},"
+        "{\"path\":\"navigation.courseOverGroundTrue\",\"value\":"
+        "1.52}]}]}"));
+    ProcessPendingEvents();
+  }
+
+  std::vector<std::shared_ptr<Sink>> sinks;
+};
+
 class SillyDriver : public AbstractCommDriver {
 public:
   SillyDriver() : AbstractCommDriver(NavAddr::Bus::TestBus, "silly") {}
@@ -540,6 +535,27 @@ TEST(Observable, torture) {
   EXPECT_EQ(int_result0, 10);
 }
 
+TEST(Messaging, PluginFanOut) {
+  wxLog::SetActiveTarget(&defaultLog);
+  const std::vector<std::string> expected = {
+      "GPRMC",  "123519", "A",      "4807.038", "N",     "01131.000",
+      "E",      "022.4",  "084.4",  "230394",   "003.1", "W"};
+  for (int shared = 0; shared < 2; shared++) {
+    PluginFanOutApp app(8, shared);
+    for (auto& sink : app.sinks) {
+      ASSERT_TRUE(sink->fields);
+      EXPECT_EQ(*sink->fields, expected);
+      ASSERT_TRUE(sink->doc);
+      EXPECT_EQ((*sink->doc)["updates"][0]["values"][0]["value"].AsDouble(),
+                3.85);
+      if (shared) {  // one parsed message for all of them
+        EXPECT_EQ(sink->fields, app.sinks[0]->fields);
+        EXPECT_EQ(sink->doc, app.sinks[0]->doc);
+      }
+    }
+  }
+}
+
 TEST(Drivers, Registry) {
   wxLog::SetActiveTarget(&defaultLog);
   auto driver = std::make_shared<SillyDriver>();
@@ -734,3 +750,868 @@ TEST(AIS, AISVDM) {
     EXPECT_NEAR(found->second->Lon, -3.65751, 0.0001);
   }
 }
+
+TEST(TextDeclutter, MatchesLinearScan) {
+  // Place a dense set of labels the way s52plib does, and check that the
+  // grid gives the same accept/reject decisions as the plain list scan.
+  const int kLabels = 4000;
+  std::vector<S52_TextC> texts(kLabels);
+  std::vector<S52_TextC*> linear;
+  TextDeclutterGrid grid;
+  srand(4711);
+
+  size_t accepted = 0;
+  for (auto& t : texts) {
+    t.rText = wxRect(rand() % 2200 - 100, rand() % 1300 - 100,
+                     8 + rand() % 120, 8 + rand() % 20);
+    bool linear_hit = false;
+    for (auto other : linear) {
+      if (other != &t && other->rText.Intersects(t.rText)) {
+        linear_hit = true;
+        break;
+      }
+    }
+    EXPECT_EQ(linear_hit, grid.Overlaps(t.rText, &t));
+    if (!linear_hit) {
+      linear.push_back(&t);
+      grid.Add(&t);
+      accepted++;
+    }
+  }
+  EXPECT_EQ(grid.GetCount(), accepted);
+
+  // A member whose rect grows must be found under its new cells.
+  S52_TextC* moved = linear.front();
+  moved->rText = wxRect(5000, 5000, 400, 400);
+  grid.Add(moved);
+  EXPECT_TRUE(grid.Overlaps(wxRect(5300, 5300, 10, 10), nullptr));
+  EXPECT_FALSE(grid.Overlaps(wxRect(5300, 5300, 10, 10), moved));
+
+  grid.Clear();
+  EXPECT_FALSE(grid.Contains(moved));
+  EXPECT_FALSE(grid.Overlaps(wxRect(5300, 5300, 10, 10), nullptr));
+}
+
+// The string based attribute matcher FindBestLUP() used before LUP
+// conditions were compiled, kept here as the reference implementation.
+static int LegacyLUPAttMatches(LUPrec* lup, const char* att_array, int n_attr,
+                               wxArrayOfS57attVal* attVal) {
+  int countATT = 0;
+  for (char* slatc : lup->ATTArray) {
+    if (slatc && (strlen(slatc) < 6)) continue;
+    if (!slatc) continue;
+    char* slatv = slatc + 6;
+    const char* currATT = att_array;
+    for (int attIdx = 0; attIdx < n_attr; attIdx++, currATT += 6) {
+      if (strncmp(slatc, currATT, 6)) continue;
+      if (!strncmp(slatv, " ", 1)) ++countATT;
+      else if (strncmp(slatv, "?", 1)) {
+        S57attVal* v = attVal->Item(attIdx);
+        bool match = false;
+        if (v->valType == OGR_INT)
+          match = atoi(slatv) == *(int*)(v->value);
+        else if (v->valType == OGR_REAL) {
+          double obj_val = *(double*)(v->value);
+          float att_val = atof(slatv);
+          match = fabs(obj_val - att_val) < 1e-6 && obj_val == att_val;
+        } else if (v->valType == OGR_STR)
+          match = !strcmp((char*)v->value, slatv);
+        if (match) ++countATT;
+      }
+      break;
+    }
+  }
+  return countATT;
+}
+
+TEST(LUPMatcher, MatchesLegacyStringCompare) {
+  const char* acronyms[] = {"DRVAL1", "DRVAL2", "CATLAM", "COLOUR",
+                            "OBJNAM", "VALSOU", "QUAPOS", "CONDTN"};
+  const char* values[] = {"",  " ",   "?",    "1",  "2",   "3",
+                          "5.5", "1,3", "10.0", "abc", "2.0"};
+  srand(1234);
+
+  // A pool of LUPs, compiled the way ChartSymbols::BuildLookup() does
+  std::vector<LUPrec*> lups;
+  for (int i = 0; i < 200; i++) {
+    LUPrec* lup = new LUPrec();
+    int natt = rand() % 4;
+    for (int j = 0; j < natt; j++) {
+      std::string s = std::string(acronyms[rand() % 8]) + values[rand() % 11];
+      char* att = (char*)calloc(s.size() + 2, 1);
+      memcpy(att, s.c_str(), s.size());
+      lup->ATTArray.push_back(att);
+    }
+    CompileLUPAttributes(lup);
+    lups.push_back(lup);
+  }
+
+  for (int k = 0; k < 500; k++) {
+    int n_attr = 1 + rand() % 6;
+    std::string att_array;
+    wxArrayOfS57attVal attVal;
+    std::vector<int> ints(n_attr);
+    std::vector<double> reals(n_attr);
+    std::vector<std::string> strs(n_attr);
+    for (int a = 0; a < n_attr; a++) {
+      att_array += acronyms[rand() % 8];
+      S57attVal* v = new S57attVal;
+      switch (rand() % 3) {
+        case 0:
+          ints[a] = rand() % 4;
+          v->valType = OGR_INT;
+          v->value = &ints[a];
+          break;
+        case 1:
+          reals[a] = (rand() % 2) ? 5.5 : 2.0;
+          v->valType = OGR_REAL;
+          v->value = &reals[a];
+          break;
+        default:
+          strs[a] = values[rand() % 11];
+          v->valType = OGR_STR;
+          v->value = (void*)strs[a].c_str();
+      }
+      attVal.Add(v);
+    }
+
+    ObjAttIndex index(att_array.c_str(), n_attr);
+    LUPrec* legacy_best = nullptr;
+    LUPrec* best = nullptr;
+    for (auto lup : lups) {
+      if (lup->ATTArray.empty()) continue;
+      int legacy = LegacyLUPAttMatches(lup, att_array.c_str(), n_attr, &attVal);
+      int compiled = CountLUPAttMatches(lup, index, &attVal);
+      EXPECT_EQ(legacy, compiled);
+      int n = lup->ATTArray.size();
+      if (!legacy_best && legacy == n) legacy_best = lup;
+      if (!best && compiled == n) best = lup;
+    }
+    EXPECT_EQ(legacy_best, best);
+    for (size_t a = 0; a < attVal.GetCount(); a++) delete attVal[a];
+  }
+
+  for (auto lup : lups) {
+    for (char* att : lup->ATTArray) free(att);
+    free(lup->ATTCond);
+    delete lup;
+  }
+}
+
+TEST(SpanFill, SimdMatchesLegacy) {
+  // The s52plib dda_tri() pixel loops, as they were before the span
+  // routines, including the floating point pattern blends.
+  auto legacy_32 = [](unsigned char* px, int n, const unsigned char* row,
+                      int x, int w) {
+    for (int i = 0; i < n; i++, px += 4) {
+      const unsigned char* pp = row + ((x + i) % w) * 4;
+      if (pp[3] > 128) {
+        double da = (double)pp[3] / 256.;
+        for (int k = 0; k < 3; k++) px[k] = (unsigned char)(pp[k] * da);
+      }
+    }
+  };
+  auto legacy_24 = [](unsigned char* px, int n, const unsigned char* row,
+                      int x, int w) {
+    for (int i = 0; i < n; i++, px += 3) {
+      const unsigned char* pp = row + ((x + i) % w) * 4;
+      double da = (double)pp[3] / 256.;
+      for (int k = 0; k < 3; k++)
+        px[k] = (unsigned char)(px[k] * (1.0 - da) + pp[k] * da);
+    }
+  };
+
+  // The resolved set is the widest one this CPU runs, AVX2 implies SSE2
+  std::vector<const SpanRoutines*> sets = {SpanFill_generic_routines()};
+  std::string name = SpanFill_ResolveRoutines();
+  if (name != "generic" && SpanFill_sse2_routines())
+    sets.push_back(SpanFill_sse2_routines());
+  if (name == "avx2") sets.push_back(SpanFill_avx2_routines());
+  srand(2024);
+
+  for (int i = 0; i < 2000; i++) {
+    int w = 1 + rand() % 70;
+    int x = rand() % w;
+    int n = rand() % 300;
+    std::vector<unsigned char> row(w * 4);
+    for (auto& b : row) b = rand();
+    std::vector<unsigned char> canvas(n * 4 + 16);
+    for (auto& b : canvas) b = rand();
+    unsigned char c24[3] = {(unsigned char)rand(), (unsigned char)rand(),
+                            (unsigned char)rand()};
+    uint32_t c32 = rand();
+
+    auto want_p32 = canvas;
+    legacy_32(want_p32.data(), n, row.data(), x, w);
+    auto want_p24 = canvas;
+    legacy_24(want_p24.data(), n, row.data(), x, w);
+    auto want_f24 = canvas;
+    for (int j = 0; j < n; j++) memcpy(&want_f24[j * 3], c24, 3);
+    auto want_f32 = canvas;
+    for (int j = 0; j < n; j++) memcpy(&want_f32[j * 4], &c32, 4);
+
+    for (auto set : sets) {
+      auto got = canvas;
+      set->pattern_32(got.data(), n, row.data(), x, w);
+      EXPECT_EQ(got, want_p32) << set->name;
+      got = canvas;
+      set->pattern_24(got.data(), n, row.data(), x, w);
+      EXPECT_EQ(got, want_p24) << set->name;
+      got = canvas;
+      set->fill_24(got.data(), n, c24);
+      EXPECT_EQ(got, want_f24) << set->name;
+      got = canvas;
+      set->fill_32(got.data(), n, c32);
+      EXPECT_EQ(got, want_f32) << set->name;
+    }
+  }
+}
+
+TEST(LLRTree, MatchesLinearScan) {
+  // Chart sized boxes, searched with pick sized boxes, must give the same
+  // ids as testing every box.
+  srand(1852);
+  for (int n : {0, 1, 16, 17, 3000}) {
+    std::vector<double> boxes;
+    LLRTree tree;
+    for (int i = 0; i < n; i++) {
+      double lat = (rand() % 10000) / 100. - 50.;
+      double lon = (rand() % 36000) / 100. - 180.;
+      double dlat = (rand() % 100) / 200., dlon = (rand() % 100) / 200.;
+      boxes.insert(boxes.end(), {lat, lon, lat + dlat, lon + dlon});
+      tree.Insert(lat, lon, lat + dlat, lon + dlon, i);
+    }
+    tree.Build();
+    EXPECT_EQ(tree.GetCount(), (size_t)n);
+
+    for (int q = 0; q < 500; q++) {
+      double lat = (rand() % 10000) / 100. - 50.;
+      double lon = (rand() % 36000) / 100. - 180.;
+      double r = (rand() % 100) / 100.;
+      std::vector<int> got;
+      tree.Search(lat - r, lon - r, lat + r, lon + r, got);
+      std::sort(got.begin(), got.end());
+
+      std::vector<int> want;
+      for (int i = 0; i < n; i++) {
+        const double* b = &boxes[i * 4];
+        if (b[2] >= lat - r && b[0] <= lat + r && b[3] >= lon - r &&
+            b[1] <= lon + r)
+          want.push_back(i);
+      }
+      EXPECT_EQ(got, want);
+    }
+  }
+}
+
+// The s52plib ObjectRenderCheckPos() and ObjectRenderCheckCat() tests,
+// with the soundings shown and without the mariner's standard filters.
+static bool S52Drawn(const S57FeatureInfo& info, const LUPrec& lup,
+                     DisCat category, const LLBBox& vp, DisCat display,
+                     double scale, double mod) {
+  if (info.has_box) {
+    if (vp.GetMaxLat() < info.lat_min || vp.GetMinLat() > info.lat_max)
+      return false;
+    bool in_lon = false;
+    for (double shift : {0., 360., -360.})
+      in_lon |= vp.GetMaxLon() >= info.lon_min + shift &&
+                vp.GetMinLon() <= info.lon_max + shift;
+    if (!in_lon) return false;
+  }
+
+  bool cat_ok;
+  if (display == DISPLAYBASE)
+    cat_ok = category == DISPLAYBASE;
+  else if (display == STANDARD)
+    cat_ok = category == DISPLAYBASE || category == STANDARD;
+  else
+    cat_ok = true;
+  if (!strncmp(lup.OBCL, "SOUNDG", 6)) cat_ok = true;
+  if (!cat_ok) return false;
+
+  if (lup.DISC == DISPLAYBASE || lup.DPRI == PRIO_GROUP1) return true;
+  return scale <= info.scamin * std::max(mod, 1.);
+}
+
+TEST(S57FeatureStore, CullingKeepsDrawnObjects) {
+  // Random objects, views and settings: the objects s52plib draws must be
+  // the same, in the same order, whether a list is walked whole or culled
+  // through the store.  CS procedures change the category of some objects
+  // after the store is built.
+  srand(1569);
+  const DisCat cats[] = {DISPLAYBASE, STANDARD, OTHER};
+  const int n = 3000;
+  std::vector<LUPrec> lups(n);
+  std::vector<ObjRazRules> rules(n);
+  std::vector<S57FeatureInfo> infos(n);
+  std::vector<DisCat> drawn_cat(n);
+
+  S57FeatureStore store;
+  store.Clear();
+  for (int i = 0; i < n; i++) {
+    LUPrec& lup = lups[i];
+    strcpy(lup.OBCL, rand() % 20 ? "DEPARE" : "SOUNDG");
+    lup.DPRI = rand() % 10 ? PRIO_AREA_1 : PRIO_GROUP1;
+    lup.DISC = cats[rand() % 3];
+
+    S57FeatureInfo& info = infos[i];
+    info.has_box = rand() % 50 != 0;
+    info.lat_min = (rand() % 2000) / 100. - 10.;
+    info.lon_min = (rand() % 36000) / 100. - 180.;
+    info.lat_max = info.lat_min + (rand() % 100) / 100.;
+    info.lon_max = info.lon_min + (rand() % 100) / 100.;
+    info.scamin = 1000 * (1 + rand() % 200);
+    info.category = cats[rand() % 3];
+    info.category_mutable = rand() % 10 == 0;
+    drawn_cat[i] = info.category_mutable ? cats[rand() % 3] : info.category;
+
+    rules[i].LUP = &lup;
+    rules[i].obj = nullptr;
+    store.Add(0, i % 2 ? 3 : 0, &rules[i], info);  // points and areas
+  }
+
+  size_t culled = 0;
+  for (int q = 0; q < 300; q++) {
+    double lat = (rand() % 2000) / 100. - 10.;
+    double lon = (rand() % 36000) / 100. - 180.;
+    double r = (rand() % 300) / 100.;
+    LLBBox vp;
+    vp.Set(lat - r, lon - r, lat + r, lon + r);
+    double ppm = 0.001 * (1 + rand() % 100);
+    double scale = 1000. * (1 + rand() % 2000);
+    DisCat display = cats[rand() % 3];
+    double mod = pow(8., (rand() % 11 - 5) / 5.);
+
+    S57CullParms cull = S57FeatureStore::MakeCullParms(vp, ppm, scale);
+    cull.chart_scale = scale;
+    cull.display_category = display == OTHER ? 0 : (char)display;
+
+    for (int type : {0, 3}) {
+      std::vector<int> whole, through_store;
+      for (int i = type ? 1 : 0; i < n; i += 2) {
+        if (S52Drawn(infos[i], lups[i], drawn_cat[i], vp, display, scale, mod))
+          whole.push_back(i);
+      }
+      size_t walked = 0;
+      store.ForEach(0, type, cull, [&](ObjRazRules* rz) {
+        walked++;
+        int i = rz - rules.data();
+        if (S52Drawn(infos[i], lups[i], drawn_cat[i], vp, display, scale, mod))
+          through_store.push_back(i);
+      });
+      EXPECT_EQ(whole, through_store);
+      culled += store.GetCount(0, type) - walked;
+    }
+  }
+  EXPECT_GT(culled, 0u);
+}
+
+// Winding number of contours around (x, y), x and y interleaved.
+static int WindingNumber(const std::vector<double>& xy,
+                         const std::vector<size_t>& starts, double x,
+                         double y) {
+  int w = 0;
+  for (size_t c = 0; c + 1 < starts.size(); c++) {
+    for (size_t i = starts[c]; i < starts[c + 1]; i++) {
+      size_t j = i + 1 < starts[c + 1] ? i + 1 : starts[c];
+      double ax = xy[2 * i], ay = xy[2 * i + 1];
+      double bx = xy[2 * j], by = xy[2 * j + 1];
+      double cross = (bx - ax) * (y - ay) - (by - ay) * (x - ax);
+      if (ay <= y && by > y && cross > 0) w++;
+      if (ay > y && by <= y && cross < 0) w--;
+    }
+  }
+  return w;
+}
+
+TEST(PolyClipper, MatchesWindingRules) {
+  // Random polygons, crossing themselves and, on a grid, sharing edges and
+  // corners: at points off all edges the result must be inside exactly when
+  // the operation says so, with the winding number of the inputs nonzero.
+  srand(1943);
+  PolyClipper clipper;
+  std::vector<double> in[2], out;
+  std::vector<size_t> in_starts[2], starts;
+  for (int trial = 0; trial < 300; trial++) {
+    clipper.Clear();
+    for (int p = 0; p < 2; p++) {
+      in[p].clear();
+      in_starts[p].assign(1, 0);
+      int contours = 1 + rand() % 3;
+      for (int c = 0; c < contours; c++) {
+        size_t n = 3 + rand() % 6;
+        for (size_t i = 0; i < 2 * n; i++) {
+          double off_grid = trial & 1 ? 0 : rand() % 100 / 100.;
+          in[p].push_back(rand() % 9 + off_grid);
+        }
+        clipper.AddContour(p, n, &in[p][2 * in_starts[p].back()]);
+        in_starts[p].push_back(in_starts[p].back() + n);
+      }
+    }
+
+    for (int op = PolyClipper::INTERSECTION; op <= PolyClipper::DIFFERENCE;
+         op++) {
+      clipper.Execute((PolyClipper::Operation)op, out, starts);
+      for (int q = 0; q < 200; q++) {  // not on any line between grid points
+        double x = rand() % 9000 / 1000. + .00031;
+        double y = rand() % 9000 / 1000. + .00017;
+        bool a = WindingNumber(in[0], in_starts[0], x, y) != 0;
+        bool b = WindingNumber(in[1], in_starts[1], x, y) != 0;
+        bool want = op == PolyClipper::INTERSECTION ? a && b
+                    : op == PolyClipper::UNION      ? a || b
+                                                    : a && !b;
+        EXPECT_EQ(WindingNumber(out, starts, x, y) != 0, want)
+            << "trial " << trial << " op " << op << " at " << x << " " << y;
+      }
+    }
+  }
+}
+
+// Whether (x, y) is closer than d to any edge of the contours.
+static bool NearEdge(const std::vector<double>& xy,
+                     const std::vector<size_t>& starts, double x, double y,
+                     double d) {
+  for (size_t c = 0; c + 1 < starts.size(); c++) {
+    for (size_t i = starts[c]; i < starts[c + 1]; i++) {
+      size_t j = i + 1 < starts[c + 1] ? i + 1 : starts[c];
+      double ax = xy[2 * i], ay = xy[2 * i + 1];
+      double dx = xy[2 * j] - ax, dy = xy[2 * j + 1] - ay;
+      double len2 = dx * dx + dy * dy;
+      double t = len2 > 0 ? ((x - ax) * dx + (y - ay) * dy) / len2 : 0;
+      t = t < 0 ? 0 : t > 1 ? 1 : t;
+      double ex = ax + t * dx - x, ey = ay + t * dy - y;
+      if (ex * ex + ey * ey < d * d) return true;
+    }
+  }
+  return false;
+}
+
+TEST(PolyClipper, MatchesWindingRulesOnLatLonGrids) {
+  // As above on fine grids far from the origin, where edges crossing at a
+  // grid point meet there only to within rounding.
+  srand(1944);
+  PolyClipper clipper;
+  std::vector<double> in[2], out;
+  std::vector<size_t> in_starts[2], starts;
+  const double steps[] = {0.01, 0.001, 6e-6, 1e-7};
+  for (int trial = 0; trial < 1000; trial++) {
+    double lon = -180 + rand() % 360 + rand() % 1000 * 0.001;
+    double lat = -80 + rand() % 160 + rand() % 1000 * 0.001;
+    double step = steps[trial % 4];
+    clipper.Clear();
+    for (int p = 0; p < 2; p++) {
+      in[p].clear();
+      size_t n = 3 + rand() % 6;
+      for (size_t i = 0; i < n; i++) {
+        in[p].push_back(lon + step * (rand() % 9));
+        in[p].push_back(lat + step * (rand() % 9));
+      }
+      in_starts[p] = {0, n};
+      clipper.AddContour(p, n, in[p].data());
+    }
+    for (int op = PolyClipper::INTERSECTION; op <= PolyClipper::DIFFERENCE;
+         op++) {
+      clipper.Execute((PolyClipper::Operation)op, out, starts);
+      for (int q = 0; q < 200; q++) {
+        double x = lon + step * (rand() % 900 / 100. + .0031);
+        double y = lat + step * (rand() % 900 / 100. + .0017);
+        if (NearEdge(in[0], in_starts[0], x, y, step * 1e-3) ||
+            NearEdge(in[1], in_starts[1], x, y, step * 1e-3))
+          continue;
+        bool a = WindingNumber(in[0], in_starts[0], x, y) != 0;
+        bool b = WindingNumber(in[1], in_starts[1], x, y) != 0;
+        bool want = op == PolyClipper::INTERSECTION ? a && b
+                    : op == PolyClipper::UNION      ? a || b
+                                                    : a && !b;
+        EXPECT_EQ(WindingNumber(out, starts, x, y) != 0, want)
+            << "trial " << trial << " op " << op << " at " << x << " " << y;
+      }
+    }
+  }
+}
+
+#ifdef HAVE_GLU_TESS
+// A counter clockwise polygon with its corners on a grid of step degrees
+// from (lon, lat): a rectangle, an L or the convex hull of random grid
+// points, down to a triangle.
+static std::vector<double> GridPolygon(double lon, double lat, double step) {
+  auto x = [&](int i) { return lon + i * step; };
+  auto y = [&](int i) { return lat + i * step; };
+  int x0 = rand() % 5, x1 = x0 + 2 + rand() % 6;
+  int y0 = rand() % 5, y1 = y0 + 2 + rand() % 6;
+  int xm = x0 + 1 + rand() % (x1 - x0 - 1);
+  int ym = y0 + 1 + rand() % (y1 - y0 - 1);
+  switch (rand() % 4) {
+    case 0:
+      return {x(x0), y(y0), x(x1), y(y0), x(x1), y(y1), x(x0), y(y1)};
+    case 1:
+      return {x(x0), y(y0), x(x1), y(y0), x(x1), y(ym),
+              x(xm), y(ym), x(xm), y(y1), x(x0), y(y1)};
+    default: {
+      typedef std::pair<int, int> GridPoint;
+      int n = rand() % 4 == 0 ? 3 : 3 + rand() % 6;
+      std::vector<GridPoint> pts;
+      for (int i = 0; i < n; i++) pts.push_back({rand() % 10, rand() % 10});
+      std::sort(pts.begin(), pts.end());
+      pts.erase(std::unique(pts.begin(), pts.end()), pts.end());
+      auto cross = [](GridPoint o, GridPoint a, GridPoint b) {
+        return (a.first - o.first) * (b.second - o.second) -
+               (a.second - o.second) * (b.first - o.first);
+      };
+      // Monotone chain, lower then upper hull
+      std::vector<GridPoint> hull(2 * pts.size());
+      size_t k = 0;
+      for (size_t i = 0; i < pts.size(); i++) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+        hull[k++] = pts[i];
+      }
+      for (size_t i = pts.size() - 1, t = k + 1; i-- > 0;) {
+        while (k >= t && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+        hull[k++] = pts[i];
+      }
+      if (k < 4) return GridPolygon(lon, lat, step);  // all in a line
+      std::vector<double> xy;
+      for (size_t i = 0; i + 1 < k; i++) {
+        xy.push_back(x(hull[i].first));
+        xy.push_back(y(hull[i].second));
+      }
+      return xy;
+    }
+  }
+}
+
+struct GluClip {
+  std::deque<std::array<double, 3>> vertices;
+  std::vector<double>* xy;
+  std::vector<size_t>* starts;
+};
+
+static void GluVertex(GLvoid* vertex, void* data) {
+  GluClip* clip = static_cast<GluClip*>(data);
+  const double* p = static_cast<const double*>(vertex);
+  clip->xy->push_back(p[0]);
+  clip->xy->push_back(p[1]);
+}
+
+static void GluEnd(void* data) {
+  GluClip* clip = static_cast<GluClip*>(data);
+  clip->starts->push_back(clip->xy->size() / 2);
+}
+
+static void GluCombine(GLdouble coords[3], void* vertex_data[4],
+                       GLfloat weight[4], void** out, void* data) {
+  GluClip* clip = static_cast<GluClip*>(data);
+  clip->vertices.push_back({coords[0], coords[1], coords[2]});
+  *out = clip->vertices.back().data();
+}
+
+// A op B the way LLRegion did it with the GLU tessellator.
+static void GluExecute(PolyClipper::Operation op,
+                       const std::vector<double> in[2],
+                       std::vector<double>& xy, std::vector<size_t>& starts) {
+  GluClip clip;
+  clip.xy = &xy;
+  clip.starts = &starts;
+  xy.clear();
+  starts.assign(1, 0);
+  GLUtesselator* tess = gluNewTess();
+  gluTessCallback(tess, GLU_TESS_VERTEX_DATA, (_GLUfuncptr)&GluVertex);
+  gluTessCallback(tess, GLU_TESS_END_DATA, (_GLUfuncptr)&GluEnd);
+  gluTessCallback(tess, GLU_TESS_COMBINE_DATA, (_GLUfuncptr)&GluCombine);
+  gluTessProperty(tess, GLU_TESS_WINDING_RULE,
+                  op == PolyClipper::INTERSECTION
+                      ? GLU_TESS_WINDING_ABS_GEQ_TWO
+                      : GLU_TESS_WINDING_POSITIVE);
+  gluTessProperty(tess, GLU_TESS_BOUNDARY_ONLY, GL_TRUE);
+  gluTessNormal(tess, 0, 0, 1);
+  gluTessBeginPolygon(tess, &clip);
+  for (int p = 0; p < 2; p++) {
+    size_t n = in[p].size() / 2;
+    bool reverse = p == 1 && op == PolyClipper::DIFFERENCE;
+    gluTessBeginContour(tess);
+    for (size_t i = 0; i < n; i++) {
+      size_t k = reverse ? n - 1 - i : i;
+      clip.vertices.push_back({in[p][2 * k], in[p][2 * k + 1], 0});
+      gluTessVertex(tess, clip.vertices.back().data(),
+                    clip.vertices.back().data());
+    }
+    gluTessEndContour(tess);
+  }
+  gluTessEndPolygon(tess);
+  gluDeleteTess(tess);
+}
+
+TEST(PolyClipper, MatchesGluOnLatLonGrids) {
+  // GLU places the corners it makes itself only to about float precision,
+  // so points near either result's edges are left out.
+  srand(1945);
+  PolyClipper clipper;
+  std::vector<double> in[2], out, glu_out;
+  std::vector<size_t> in_starts[2], starts, glu_starts;
+  for (int trial = 0; trial < 2000; trial++) {
+    double lon = -180 + rand() % 360 + rand() % 1000 * 0.001;
+    double lat = -80 + rand() % 160 + rand() % 1000 * 0.001;
+    double step = trial & 1 ? 0.001 : 0.01;
+    clipper.Clear();
+    for (int p = 0; p < 2; p++) {
+      in[p] = GridPolygon(lon, lat, step);
+      in_starts[p] = {0, in[p].size() / 2};
+      clipper.AddContour(p, in[p].size() / 2, in[p].data());
+    }
+    for (int op = PolyClipper::INTERSECTION; op <= PolyClipper::DIFFERENCE;
+         op++) {
+      clipper.Execute((PolyClipper::Operation)op, out, starts);
+      GluExecute((PolyClipper::Operation)op, in, glu_out, glu_starts);
+      for (int q = 0; q < 100; q++) {
+        double x = lon + step * (rand() % 1200 / 100. + .0031);
+        double y = lat + step * (rand() % 1200 / 100. + .0017);
+        if (NearEdge(in[0], in_starts[0], x, y, step * .05) ||
+            NearEdge(in[1], in_starts[1], x, y, step * .05) ||
+            NearEdge(glu_out, glu_starts, x, y, step * .05))
+          continue;
+        EXPECT_EQ(WindingNumber(out, starts, x, y) != 0,
+                  WindingNumber(glu_out, glu_starts, x, y) != 0)
+            << "trial " << trial << " op " << op << " at " << x << " " << y;
+      }
+    }
+  }
+}
+#endif
+
+TEST(TrackPoint, TimeMatchesParseGPXDateTime) {
+  // The fast path for plain UTC times must read every string, valid or
+  // not, exactly as ParseGPXDateTime() does.
+  const char* times[] = {
+      "2024-01-15T12:34:56Z",   "2000-02-29T00:00:00Z",
+      "1999-12-31T23:59:59Z",   "2024-01-15T12:34:56.789Z",
+      "2024-01-15T12:34:56.5Z", "2024-01-15T12:34:56+02:00",
+      "2024-01-15T12:34:56-03:30", "2024-01--5T12:34:56Z",
+      "2024-01-+5T12:34:56Z",   "2024-01- 5T12:34:56Z",
+      "2024-1-15T12:34:56Z",    "2023-02-29T12:00:00Z",
+      "2024-13-01T00:00:00Z",   "2024-01-15T24:00:00Z",
+      "2024-01-15 12:34:56Z",   "2024-01-15T12:34:56z",
+      "-2024-01-15T12:34:56Z",  "garbage",
+      ""};
+  for (const char* t : times) {
+    wxString ts(t);
+    TrackPoint tp(0., 0., ts);
+    wxDateTime want;
+    if (ts.Length()) ParseGPXDateTime(want, ts);
+    wxDateTime got = tp.GetCreateTime();
+    EXPECT_EQ(got.IsValid(), want.IsValid()) << t;
+    if (got.IsValid() && want.IsValid())
+      EXPECT_EQ(got.GetTicks(), want.GetTicks()) << t;
+  }
+}
+
+TEST(GpxStreamReader, SplitsObjectsAndPoints) {
+  // The same fragments however the file is cut into pieces, comments and
+  // CDATA sections with markup in them included.
+  const std::string gpx =
+      "<?xml version=\"1.0\"?>\n"
+      "<gpx creator=\"OpenCPN\">\n"
+      " <!-- <wpt> -->\n"
+      " <wpt lat=\"1\" lon=\"2\"><name><![CDATA[<a>]]></name></wpt>\n"
+      " <wpt lat=\"3\" lon=\"4\"/>\n"
+      " <trk><name>T</name><trkseg>"
+      "<trkpt lat=\"1\" lon=\"1\"><time>2024-01-01T00:00:00Z</time></trkpt>"
+      "<trkpt lat=\"2\" lon=\"2\"/><trkpt lat=\"3\" lon=\"3\"></trkpt>"
+      "</trkseg><trkseg/>"
+      "<extensions><x a=\">\"/></extensions></trk>\n"
+      "</gpx>\n";
+
+  std::vector<std::string> expected;
+  for (size_t piece : {gpx.size(), (size_t)1, (size_t)5}) {
+    std::vector<std::string> got;
+    GpxStreamReader::Handler handler;
+    handler.on_root = [&](const std::string& xml) { got.push_back(xml); };
+    handler.on_object = [&](const std::string& xml) { got.push_back(xml); };
+    handler.on_points = [&](const std::string& xml, int segment) {
+      got.push_back(std::to_string(segment) + xml);
+    };
+    handler.on_track_end = [&](const std::string& xml, int n_segments) {
+      got.push_back(std::to_string(n_segments) + xml);
+    };
+    GpxStreamReader reader(handler, 2);
+    for (size_t i = 0; i < gpx.size(); i += piece) {
+      size_t n = std::min(piece, gpx.size() - i);
+      EXPECT_TRUE(reader.Feed(gpx.data() + i, n));
+    }
+    EXPECT_TRUE(reader.Finish());
+
+    if (expected.empty()) {
+      expected = got;
+      ASSERT_EQ(got.size(), 7u);
+      EXPECT_EQ(got[0], "<gpx creator=\"OpenCPN\"></gpx>");
+      EXPECT_EQ(got[1],
+                "<wpt lat=\"1\" lon=\"2\"><name><![CDATA[<a>]]></name></wpt>");
+      EXPECT_EQ(got[2], "<wpt lat=\"3\" lon=\"4\"/>");
+      EXPECT_EQ(got[3],
+                "1<trkseg><trkpt lat=\"1\" lon=\"1\"><time>2024-01-01T00:00:00Z"
+                "</time></trkpt><trkpt lat=\"2\" lon=\"2\"/></trkseg>");
+      EXPECT_EQ(got[4],
+                "1<trkseg><trkpt lat=\"3\" lon=\"3\"></trkpt></trkseg>");
+      EXPECT_EQ(got[5], "2<trkseg></trkseg>");
+      EXPECT_EQ(got[6],
+                "2<trk><name>T</name><extensions><x a=\">\"/></extensions></trk>");
+    }
+    EXPECT_EQ(got, expected);
+  }
+}
+
+TEST(NavHistory, StoreAndQuery) {
+  const std::string path = "/tmp/nav_history_test.db";
+  for (const char* suffix : {"", "-wal", "-shm"})
+    std::remove((path + suffix).c_str());
+
+  NavHistory& history = NavHistory::GetInstance();
+  ASSERT_TRUE(history.Start(path));
+
+  // Recent samples are kept as recorded, one per second.
+  time_t now = time(0);
+  for (int i = 0; i < 1500; i++)
+    history.Add(NavHistory::Series::Sog, now - 2000 + i, i * 0.01);
+  history.Add(NavHistory::Series::Sog, now - 501, 99.);
+
+  // Older ones are replaced by their means per minute.
+  time_t old = now - 10 * 24 * 3600;
+  old -= old % 60;
+  for (int i = 0; i < 600; i++)
+    history.Add(NavHistory::Series::Depth, old + i, i % 60);
+  history.Add(NavHistory::Series::Cog, old, 350.);
+  history.Add(NavHistory::Series::Cog, old + 1, 10.);
+  history.Add(NavHistory::Series::Lon, old, 179.9);
+  history.Add(NavHistory::Series::Lon, old + 1, -179.9);
+  // A minute partly in a chunk still kept is not averaged yet.
+  for (int i = 0; i < 630; i++)
+    history.Add(NavHistory::Series::Tws, old + 630 + i, 10.);
+  history.Add(NavHistory::Series::Tws, now, 10.);
+  history.Flush();
+
+  auto sog = history.Query("sog", now - 3000, now);
+  ASSERT_EQ(sog.size(), 1500u);
+  for (int i = 0; i < 1500; i++) {
+    EXPECT_EQ(sog[i].time, now - 2000 + i);
+    EXPECT_NEAR(sog[i].value, i * 0.01, 1e-9);
+  }
+  size_t minutes = (now - 501) / 60 - (now - 2000) / 60 + 1;
+  EXPECT_EQ(history.Query("sog", now - 3000, now, 60).size(), minutes);
+
+  auto depth = history.Query("depth", old - 60, old + 600);
+  ASSERT_EQ(depth.size(), 10u);
+  for (const NavHistorySample& s : depth) EXPECT_NEAR(s.value, 29.5, 1e-9);
+
+  auto cog = history.Query("cog", old - 60, old + 600);
+  ASSERT_EQ(cog.size(), 1u);
+  EXPECT_NEAR(std::remainder(cog[0].value, 360.), 0., 1e-6);
+
+  auto lon = history.Query("lon", old - 60, old + 600);
+  ASSERT_EQ(lon.size(), 1u);
+  EXPECT_NEAR(std::fabs(lon[0].value), 180., 1e-6);
+  EXPECT_TRUE(lon[0].value >= -180. && lon[0].value <= 180.);
+
+  auto tws = history.Query("tws", old + 1200, old + 1259);
+  EXPECT_EQ(tws.size(), 60u);
+  EXPECT_EQ(history.Query("tws", old, old + 1259, 60).size(), 11u);
+
+  EXPECT_TRUE(history.Query("speed", 0, now).empty());
+  EXPECT_EQ(NavHistory::GetSeriesDecimals("lat"), 6);
+  EXPECT_EQ(NavHistory::GetSeriesDecimals("sog"), 2);
+  EXPECT_EQ(NavHistory::GetSeriesDecimals("cog"), 1);
+  EXPECT_EQ(NavHistory::GetSeriesDecimals("speed"), -1);
+
+  // What was queued is written on stop, and found again on restart.
+  history.Add(NavHistory::Series::Sog, now + 1, 1.);
+  history.Stop();
+  ASSERT_TRUE(history.Start(path));
+  EXPECT_EQ(history.Query("sog", 0, now + 1).size(), 1501u);
+  history.Stop();
+}
+
+TEST(ISO8211, MappedRoundTrip) {
+  const char* path = "/tmp/iso8211_test.000";
+  const int n_records = 300;
+  {
+    DDFModule module;
+    DDFFieldDefn* id = new DDFFieldDefn();
+    id->Create("0001", "ISO 8211 Record Identifier", "", dsc_elementary,
+               dtc_bit_string, "(b12)");
+    module.AddField(id);
+    DDFFieldDefn* frid = new DDFFieldDefn();
+    frid->Create("FRID", "Feature record identifier field", "", dsc_vector,
+                 dtc_mixed_data_type);
+    frid->AddSubfield("RCNM", "b11");
+    frid->AddSubfield("RCID", "b14");
+    frid->AddSubfield("OBJL", "b12");
+    module.AddField(frid);
+    DDFFieldDefn* attf = new DDFFieldDefn();
+    attf->Create("ATTF", "Feature record attribute field", "*", dsc_array,
+                 dtc_mixed_data_type);
+    attf->AddSubfield("ATTL", "b12");
+    attf->AddSubfield("ATVL", "A");
+    module.AddField(attf);
+    module.Initialize();
+    ASSERT_TRUE(module.Create(path));
+    for (int i = 0; i < n_records; i++) {
+      DDFRecord record(&module);
+      record.AddField(id);
+      record.SetIntSubfield("0001", 0, "", 0, i);
+      record.AddField(frid);
+      record.SetIntSubfield("FRID", 0, "RCNM", 0, 100);
+      record.SetIntSubfield("FRID", 0, "RCID", 0, i);
+      record.SetIntSubfield("FRID", 0, "OBJL", 0, i % 300);
+      record.AddField(attf);
+      for (int k = 0; k < 1 + i % 4; k++) {
+        std::string value = "v" + std::to_string(i) + "_" + std::to_string(k);
+        record.SetIntSubfield("ATTF", 0, "ATTL", k, 100 + k);
+        record.SetStringSubfield("ATTF", 0, "ATVL", k, value.c_str());
+      }
+      record.Write();
+    }
+  }
+
+  DDFModule module;
+  ASSERT_TRUE(module.Open(path));
+  EXPECT_TRUE(module.IsFileMapped());
+  DDFRecord* clone = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    module.Rewind();
+    int n = 0;
+    for (DDFRecord* r = module.ReadRecord(); r; r = module.ReadRecord(), n++) {
+      ASSERT_LT(n, n_records);
+      EXPECT_EQ(r->GetIntSubfield("FRID", 0, "RCID", 0), n);
+      EXPECT_EQ(r->GetIntSubfield("FRID", 0, "OBJL", 0), n % 300);
+      DDFField* field = r->FindField("ATTF");
+      ASSERT_TRUE(field);
+      ASSERT_EQ(field->GetRepeatCount(), 1 + n % 4);
+      for (int k = 0; k < 1 + n % 4; k++) {
+        std::string value = "v" + std::to_string(n) + "_" + std::to_string(k);
+        EXPECT_EQ(r->GetIntSubfield("ATTF", 0, "ATTL", k), 100 + k);
+        EXPECT_STREQ(r->GetStringSubfield("ATTF", 0, "ATVL", k),
+                     value.c_str());
+      }
+      if (pass == 0 && n == 10) clone = r->Clone();
+    }
+    EXPECT_EQ(n, n_records);
+  }
+
+  // Changes to a clone or to the record read stay out of the mapping.
+  ASSERT_TRUE(clone);
+  clone->SetStringSubfield("ATTF", 0, "ATVL", 0, "a longer value than before");
+  EXPECT_STREQ(clone->GetStringSubfield("ATTF", 0, "ATVL", 0),
+               "a longer value than before");
+  module.Rewind();
+  DDFRecord* first = module.ReadRecord();
+  ASSERT_TRUE(first);
+  first->SetStringSubfield("ATTF", 0, "ATVL", 0, "xx");
+  module.Rewind();
+  first = module.ReadRecord();
+  ASSERT_TRUE(first);
+  EXPECT_STREQ(first->GetStringSubfield("ATTF", 0, "ATVL", 0), "v0_0");
+  for (int i = 1; i < 10; i++) module.ReadRecord();
+  DDFRecord* cloned = module.ReadRecord();
+  ASSERT_TRUE(cloned);
+  EXPECT_STREQ(cloned->GetStringSubfield("ATTF", 0, "ATVL", 0), "v10_0");
+  module.Close();
+  std::remove(path);
+}